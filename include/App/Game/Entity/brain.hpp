@@ -7,6 +7,50 @@ namespace ztd {
     struct entity_t;
 }
 
+enum struct ai_path_status : u32 {
+    none,       // never asked for, or the request was dropped and should be sent again
+    pending,    // waiting on the navigation service
+    found,
+    partial,    // the goal wasnt reachable, the path ends as close as it could get
+    failed,
+};
+
+// filled in by ztd::nav::navigation_update on the main thread, brains only read it while they tick
+struct ai_path_t {
+    static constexpr u32 max_points = 16;
+
+    stack_buffer<v3f, max_points> path = {};
+    u32 next{0};                // first corner that hasnt been reached
+
+    ai_path_status status{ai_path_status::none};
+    u32 request{0};             // ticket of the last request, results for older ones are dropped
+    v3f goal{0.0f};
+    f32 time{0.0f};             // blackboard time of the last request
+
+    b32 is_valid() const {
+        return (status == ai_path_status::found || status == ai_path_status::partial) && path.empty() == false;
+    }
+
+    b32 is_stale(v3f new_goal, f32 now, f32 repath_time = 0.5f, f32 repath_distance = 2.0f) const {
+        if (status == ai_path_status::pending) return 0;
+        if (status == ai_path_status::none) return 1;
+        return now - time > repath_time || glm::distance(goal, new_goal) > repath_distance;
+    }
+
+    // skips the corners that are already within reach on the xz plane
+    v3f next_point(v3f self, f32 reach = 0.5f) {
+        assert(path.empty() == false);
+        while (next + 1 < path.count()) {
+            const v3f delta = path[next] - self;
+            if (delta.x * delta.x + delta.z * delta.z > reach * reach) {
+                break;
+            }
+            next++;
+        }
+        return path[next];
+    }
+};
+
 struct blackboard_t {
     arena_t* arena=0;
 
@@ -23,6 +67,8 @@ struct blackboard_t {
     v3f aim = {};
     f32 time{0.0f};
 
+    ai_path_t path{}; // toward "target"
+
     b32& get_bool(key_type key) {
         return *utl::hash_get(&bools, key, arena);
     }
@@ -636,10 +682,6 @@ struct interest_point_t {
     interest_type type{interest_type::size};
 };
 
-struct ai_path_t {
-    stack_buffer<v3f, 16> path = {};
-};
-
 struct skull_brain_t {
     ztd::entity_t* owner{0};
     // stack_buffer<skull_brain_t*, 16> neighbors = {};
@@ -745,7 +787,15 @@ struct move_toward_t : public bt::behavior_t {
 
             auto distance = glm::length(delta);
             if (distance > 2.0f) {
-                blkbrd->move = delta;
+                // walk the navmesh path when it was asked for this target
+                auto& path = blkbrd->path;
+                if (path.is_valid() && glm::distance(path.goal, *target) < 2.0f) {
+                    const v3f corner = path.next_point(*self);
+                    DEBUG_DIAGRAM(corner);
+                    blkbrd->move = corner - *self;
+                } else {
+                    blkbrd->move = delta;
+                }
             } else {
                 blkbrd->move = -math::clamp_length(delta, 2.0f, 6.0f);
             }
@@ -5,7 +5,35 @@
 #include "App/Game/Entity/entity_db.hpp"
 #include "App/Game/Physics/player_movement.hpp"
 
-#define BRAIN_BEHAVIOR_FUNCTION(name) static void name(ztd::world_t* world, ztd::entity_t* entity, brain_t* brain, f32 dt)
+// Note(Zack): brains tick on job threads, the watched tunables are read once per frame on the main thread and passed down
+struct brain_tunables_t {
+    f32 max_ground_speed{3.60f};
+    f32 max_air_speed{0.3f};
+    f32 ground_accel{2.2f}; // source engine 5.6 default
+    f32 air_accel{0.5f};
+    f32 friction{9.1f};
+    f32 gravity_strength{1.0f};
+
+    f32 skull_air_accel{5.0f};
+    f32 skull_max_air_speed{5.0f};
+};
+
+// main thread only
+inline brain_tunables_t
+brain_read_tunables() {
+    local_persist brain_tunables_t tunables{};
+    DEBUG_WATCH(&tunables.max_ground_speed);
+    DEBUG_WATCH(&tunables.max_air_speed);
+    DEBUG_WATCH(&tunables.ground_accel);
+    DEBUG_WATCH(&tunables.air_accel);
+    DEBUG_WATCH(&tunables.friction);
+    DEBUG_WATCH(&tunables.gravity_strength);
+    DEBUG_WATCH(&tunables.skull_air_accel);
+    DEBUG_WATCH(&tunables.skull_max_air_speed);
+    return tunables;
+}
+
+#define BRAIN_BEHAVIOR_FUNCTION(name) static void name(ztd::world_t* world, ztd::entity_t* entity, brain_t* brain, const brain_tunables_t& tunables, f32 dt)
 
 void entity_blackboard_common(ztd::entity_t* entity) {
     auto* brain = &entity->brain;
@@ -23,8 +51,10 @@ void entity_blackboard_common(ztd::entity_t* entity) {
     *health = entity->stats.character.health.current;
     *self = entity->global_transform().origin;
 
-    *rng = entity->world->entropy.randv<v3f>();
-    *rng_move = *self + entity->world->entropy.randnv<v3f>() * planes::xz * 10.0f;
+    // brains can tick on any thread, seed per entity instead of pulling from the world entropy
+    utl::rng::random_t<utl::rng::xor64_random_t> entropy{(entity->world->frame_seed ^ utl::rng::fnv_hash_u64(entity->id)) | 1};
+    *rng = entropy.randv<v3f>();
+    *rng_move = *self + entropy.randnv<v3f>() * planes::xz * 10.0f;
 }
 
 BRAIN_BEHAVIOR_FUNCTION(player_behavior) {
@@ -119,23 +149,17 @@ BRAIN_BEHAVIOR_FUNCTION(player_behavior) {
         wishdir = glm::normalize(wishdir);
     }
 
-    local_persist f32 max_ground_speed = 3.60f; DEBUG_WATCH(&max_ground_speed); //->max_f32 = 10.0f;
-    local_persist f32 max_air_speed = 0.3f; DEBUG_WATCH(&max_air_speed); //->max_f32 = 4.0f;
-    local_persist f32 ground_accel = 2.2f; DEBUG_WATCH(&ground_accel); //->max_f32 = 6.0f; // source engine 5.6 default
-    local_persist f32 air_accel = 0.5f; DEBUG_WATCH(&air_accel); //->max_f32 = 3.0f;
-    local_persist f32 friction = 9.1f; DEBUG_WATCH(&friction); // ->max_f32 = 10.0f;
-    local_persist f32 gravity_strength = 1.0f; DEBUG_WATCH(&gravity_strength);
-    f32 max_speed = is_on_ground ? max_ground_speed : max_air_speed;
-    f32 accel = is_on_ground ? ground_accel : air_accel;
+    f32 max_speed = is_on_ground ? tunables.max_ground_speed : tunables.max_air_speed;
+    f32 accel = is_on_ground ? tunables.ground_accel : tunables.air_accel;
     
     auto movement = is_on_ground ? quake_ground_move : quake_air_move;
-    rigidbody->velocity = movement(wishdir, rigidbody->velocity, friction, accel, max_speed, dt);
+    rigidbody->velocity() = movement(wishdir, rigidbody->velocity(), tunables.friction, accel, max_speed, dt);
     if (is_on_ground == false) {
-        rigidbody->velocity.y -= 9.81f * 0.05f * dt * gravity_strength;
+        rigidbody->velocity().y -= 9.81f * 0.05f * dt * tunables.gravity_strength;
     } else {
-        // rigidbody->velocity.y = 0.0f;
+        // rigidbody->velocity().y = 0.0f;
     }
-        // rigidbody->force += ((glm::normalize(planes::xz * forward) * move.z + right * move.x) * dt * move_speed);
+        // rigidbody->force() += ((glm::normalize(planes::xz * forward) * move.z + right * move.x) * dt * move_speed);
     // }
 
     if (player->primary_weapon.entity) {
@@ -155,7 +179,7 @@ BRAIN_BEHAVIOR_FUNCTION(player_behavior) {
 
     cc.hand = tween::lerp_dt(player->camera_controller.hand, axis::forward + axis::up * .9f, 0.05f, dt);
 
-    rigidbody->angular_velocity = v3f{0.0f};
+    rigidbody->angular_velocity() = v3f{0.0f};
 
     if (do_input && pc.emote) {
         cc.emote1();
@@ -167,7 +191,7 @@ BRAIN_BEHAVIOR_FUNCTION(player_behavior) {
         audio->emit_event(sound_event::jump_dirt, world_position); // this event has audio lag in it
 
         cc.just_jumped();
-        rigidbody->velocity.y = 0.3f;// 50.0f * dt;
+        rigidbody->velocity().y = 0.3f;// 50.0f * dt;
         cc.hand_velocity += axis::up;
     }
     
@@ -254,37 +278,32 @@ BRAIN_BEHAVIOR_FUNCTION(player_behavior) {
         
         // spawn the bullets from the gun
         range_u64(bullet, 0, fired) {
-            auto* b = weapon.bullet_fn(
+            // pooled bullets dont return an entity, so the effect rides along in the bullet
+            bullets[bullet].effects = player->primary_weapon.entity->stats.effect;
+            weapon.bullet_fn(
                 world, ztd::db::misc::plasma_bullet,
                 bullets[bullet]
             );
-            b->stats.effect = player->primary_weapon.entity->stats.effect;
-            // b->stats.weapon = player->primary_weapon.entity->stats.weapon;
         }
 
         end_temporary_memory(fire_arena);
     }
 }
 
+// hits per brain reserved by ztd::world_query_brain_nearby
+constexpr u64 nearby_hit_count = 256;
+
+// near is the brains slice of this frames batched neighbourhood query, entity_t::nearby
 template <size_t N>
 void collect_nearby(
-    arena_t* arena,
-    auto* physics, 
-    stack_buffer<interest_point_t, N>& buffer, 
-    v3f position, 
-    f32 distance
+    std::span<const physics::overlap_batch_hit_t> near,
+    stack_buffer<interest_point_t, N>& buffer
 ) {
     buffer.clear();
 
-    auto* near = physics->sphere_overlap_world(
-        arena,
-        position,
-        distance
-    );
-
-    range_u64(i, 0, near->hit_count) {
+    range_u64(i, 0, near.size()) {
         if (buffer.is_full()) break;
-        auto* rb = (physics::rigidbody_t*)near->hits[i].user_data;
+        auto* rb = (physics::rigidbody_t*)near[i].user_data;
         auto* n = (ztd::entity_t*)rb->user_data;
         interest_point_t interest = {};
         interest.data = n;
@@ -296,24 +315,15 @@ void collect_nearby(
 
 template <size_t N>
 void collect_nearby_enemy(
-    arena_t* arena,
-    auto* physics, 
+    std::span<const physics::overlap_batch_hit_t> near,
     stack_buffer<interest_point_t, N>& buffer, 
-    v3f position, 
-    f32 distance,
     std::span<brain_type> enemy_types
 ) {
     buffer.clear();
 
-    auto* near = physics->sphere_overlap_world(
-        arena,
-        position,
-        distance
-    );
-
-    range_u64(i, 0, near->hit_count) {
+    range_u64(i, 0, near.size()) {
         if (buffer.is_full()) break;
-        auto* rb = (physics::rigidbody_t*)near->hits[i].user_data;
+        auto* rb = (physics::rigidbody_t*)near[i].user_data;
         auto* n = (ztd::entity_t*)rb->user_data;
 
         if (std::find(enemy_types.begin(), enemy_types.end(), n->brain.type) == enemy_types.end()) {
@@ -330,24 +340,14 @@ void collect_nearby_enemy(
 
 template <size_t N>
 void collect_nearby(
-    arena_t* arena,
-    auto* world,
-    auto* physics, 
-    stack_buffer<skull_brain_t*, N>& buffer, 
-    v3f position, 
-    f32 distance
+    std::span<const physics::overlap_batch_hit_t> near,
+    stack_buffer<skull_brain_t*, N>& buffer
 ) {
     buffer.clear();
 
-    auto* near = physics->sphere_overlap_world(
-        arena,
-        position,
-        distance
-    );
-
-    range_u64(i, 0, near->hit_count) {
+    range_u64(i, 0, near.size()) {
         if (buffer.is_full()) break;
-        auto* rb = (physics::rigidbody_t*)near->hits[i].user_data;
+        auto* rb = (physics::rigidbody_t*)near[i].user_data;
         auto* n = (ztd::entity_t*)rb->user_data;
         
         if (n->brain.type != brain_type::flyer) {
@@ -378,11 +378,8 @@ BRAIN_BEHAVIOR_FUNCTION(person_behavior) {
     stack_buffer<interest_point_t, 32> buffer = {};
     brain_type enemy_types[] = {brain_type::player, brain_type::flyer};
     collect_nearby_enemy(
-        &world->frame_arena.get(),
-        physics,
+        entity->nearby,
         buffer,
-        entity->global_transform().origin,
-        20.0f,
         enemy_types
     );
 
@@ -407,6 +404,11 @@ BRAIN_BEHAVIOR_FUNCTION(person_behavior) {
         }
     }
 
+    // paths are solved after the brains tick, until then the last one is followed
+    if (*has_target && blkbrd.path.is_stale(*target, blkbrd.time)) {
+        ztd::nav::navigation_request_path(world->navigation, position, *target, &blkbrd.path, blkbrd.time);
+    }
+
     brain->person.tree.tick(dt, &blkbrd);
 
     v3f move = blkbrd.move;
@@ -421,25 +423,17 @@ BRAIN_BEHAVIOR_FUNCTION(person_behavior) {
         wishdir = glm::normalize(wishdir);
     }
 
-    local_persist f32 max_ground_speed = 3.60f; DEBUG_WATCH(&max_ground_speed); //->max_f32 = 10.0f;
-    local_persist f32 max_air_speed = 0.3f; DEBUG_WATCH(&max_air_speed); //->max_f32 = 4.0f;
-    local_persist f32 ground_accel = 2.2f; DEBUG_WATCH(&ground_accel); //->max_f32 = 6.0f; // source engine 5.6 default
-    local_persist f32 air_accel = 0.5f; DEBUG_WATCH(&air_accel); //->max_f32 = 3.0f;
-    local_persist f32 friction = 9.1f; DEBUG_WATCH(&friction); //->max_f32 = 10.0f;
-    local_persist f32 gravity_strength = 1.0f; DEBUG_WATCH(&gravity_strength);
-    f32 max_speed = is_on_ground ? max_ground_speed : max_air_speed;
-    f32 accel = is_on_ground ? ground_accel : air_accel;
+    f32 max_speed = is_on_ground ? tunables.max_ground_speed : tunables.max_air_speed;
+    f32 accel = is_on_ground ? tunables.ground_accel : tunables.air_accel;
     
     auto movement = is_on_ground ? quake_ground_move : quake_air_move;
-    rigidbody->velocity = movement(wishdir, rigidbody->velocity, friction, accel, max_speed, dt);
+    rigidbody->velocity() = movement(wishdir, rigidbody->velocity(), tunables.friction, accel, max_speed, dt);
     if (is_on_ground == false) {
-        rigidbody->velocity.y -= 9.81f * 0.05f * dt * gravity_strength;
+        rigidbody->velocity().y -= 9.81f * 0.05f * dt * tunables.gravity_strength;
     } 
     
-    rigidbody->angular_velocity = v3f{0.0f};
+    rigidbody->angular_velocity() = v3f{0.0f};
 
-    entity->transform.look_at(entity->transform.origin + rigidbody->velocity * planes::xz);
-    
 }
 
 BRAIN_BEHAVIOR_FUNCTION(skull_behavior) {
@@ -451,11 +445,8 @@ BRAIN_BEHAVIOR_FUNCTION(skull_behavior) {
     stack_buffer<interest_point_t, 32> buffer = {};
     brain_type enemy_types[] = {brain_type::player, brain_type::person};
     collect_nearby_enemy(
-        &world->frame_arena.get(),
-        physics,
+        entity->nearby,
         buffer,
-        entity->global_transform().origin,
-        120.0f,
         enemy_types
     );
 
@@ -472,7 +463,7 @@ BRAIN_BEHAVIOR_FUNCTION(skull_behavior) {
 
     if (target) {
 
-        auto vel = entity->physics.rigidbody->velocity;
+        auto vel = entity->physics.rigidbody->velocity();
         auto s = glm::length(vel);
 
         v3f to_target = target->global_transform().origin - entity->global_transform().origin;
@@ -482,12 +473,10 @@ BRAIN_BEHAVIOR_FUNCTION(skull_behavior) {
             to_target.y = 5.0f;
         }
 
-        local_persist f32 skull_air_accel = 5.0f; DEBUG_WATCH(&skull_air_accel);//->max_f32 = 10.0f;
-        local_persist f32 skull_max_air_speed = 5.0f; DEBUG_WATCH(&skull_max_air_speed);//->max_f32 = 10.0f;
-
-        v3f target_vel = quake_air_move(glm::normalize(to_target), vel, 0.0f, skull_air_accel, skull_max_air_speed, dt);
+        v3f target_vel = quake_air_move(glm::normalize(to_target), vel, 0.0f, tunables.skull_air_accel, tunables.skull_max_air_speed, dt);
         
-        rb->set_velocity(target_vel);
+        entity->physics.velocity = target_vel;
+        entity->physics.flags |= ztd::PhysicsEntityFlags_SetVelocity;
     }
     // rb->add_force();
 }
\ No newline at end of file
@@ -36,15 +36,18 @@ struct entity_t {
     entity_t*   next{nullptr};
     entity_t*   parent{nullptr};
     entity_t*   next_id_hash{nullptr};
+    u32         alive_index{0}; // slot in world_t::alive_entities
 
     entity_t* first_child{nullptr};
     entity_t* next_child{nullptr};
 
-    brain_id    brain_id{uid::invalid_id};
+    ::brain_id  brain_id{uid::invalid_id};
     brain_t     brain{};
+    std::span<const physics::overlap_batch_hit_t> nearby{}; // written by world_query_brain_nearby, frame arena
 
     math::transform_t   transform;
-    // math::transform_t   _global_transform;
+    math::transform_t   _global_transform;  // written by world_update_transforms
+    math::transform_t   _cached_transform;  // local transform _global_transform was built from
 
     math::rect3d_t        aabb;
 
@@ -55,13 +58,29 @@ struct entity_t {
     void dirty_transform() {
         flags |= EntityFlags_DirtyTransform;
         
-        for (auto* child = first_child; child; node_next(child)) {
+        for (auto* child = first_child; child; child = child->next_child) {
             child->dirty_transform();
         }
     }
 
+    // Note(Zack): transforms get written directly all over the place, so rather than trusting
+    // everyone to call dirty_transform the cache is only used while nothing up the chain has
+    // changed since world_update_transforms, comparing is a lot cheaper than the matrix chain
+    b32 global_transform_is_cached() const {
+        for (auto* e = this; e; e = e->parent) {
+            if ((e->flags & EntityFlags_DirtyTransform) ||
+                std::memcmp(&e->transform, &e->_cached_transform, sizeof(math::transform_t)) != 0) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
     math::transform_t global_transform() const {
         if (parent) {
+            if (global_transform_is_cached()) {
+                return _global_transform;
+            }
             return math::transform_t{parent->global_transform().to_matrix() * transform.to_matrix()};
         }
         return transform;
@@ -77,7 +96,7 @@ struct entity_t {
         // u32 object_id{0};
         // u32 indirect_start{0};
 
-        particle_system_id particle_system_id{uid::invalid_id};
+        ::particle_system_id particle_system_id{uid::invalid_id};
         particle_system_t* particle_system{0};
 
         rendering::lighting::point_light_t* light{0};        
@@ -171,10 +190,16 @@ struct entity_t {
         u32 flags{0};
         physics::rigidbody_t* rigidbody;
         v3f impulse{0.0f};
+        v3f velocity{0.0f};
 
         void queue_free() {
             flags |= PhysicsEntityFlags_Dying;
         }
+
+        void queue_impulse(const v3f& i) {
+            impulse += i;
+            flags |= PhysicsEntityFlags_Impulse;
+        }
     } physics{};
 
     struct stats_t {
@@ -234,6 +259,7 @@ struct entity_t {
         }
         child->parent = nullptr;
         child->transform = child_transform;
+        child->dirty_transform();
     }
 
     void add_child(entity_t* child, bool maintain_world_pos = false) {
@@ -247,6 +273,7 @@ struct entity_t {
         if (!maintain_world_pos) {
             child->transform = math::transform_t{};
         }
+        child->dirty_transform();
     }
 };
 
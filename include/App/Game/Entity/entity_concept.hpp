@@ -20,9 +20,10 @@ concept CEntity = requires(EntityType entity) {
 enum EntityFlags : u64 {
     EntityFlags_Breakpoint = BIT(0),
     // EntityFlags_Spatial = BIT(1), // is this really needed??
-    EntityFlags_DirtyTransform = BIT(2), // is this really needed??
+    EntityFlags_DirtyTransform = BIT(2), // cached global transform is stale, see world_update_transforms
     EntityFlags_Pickupable = BIT(3),
     EntityFlags_Interactable = BIT(4),
+    EntityFlags_ScriptHook = BIT(5), // has a lua hook in world->script_hooks
     EntityFlags_Dying = BIT(11),
     EntityFlags_Dead = BIT(12),
 };
@@ -34,6 +35,8 @@ enum PhysicsEntityFlags {
     PhysicsEntityFlags_Trigger = BIT(2),
     PhysicsEntityFlags_Character = BIT(3),
     PhysicsEntityFlags_Kinematic = BIT(4),
+    PhysicsEntityFlags_SetVelocity = BIT(5), // velocity is applied on the main thread
+    PhysicsEntityFlags_Impulse = BIT(6), // impulse is applied on the main thread
 
     PhysicsEntityFlags_Dying = BIT(11),
 };
@@ -23,7 +23,7 @@ export_fn(void) on_trigger_set_light_probe(physics::rigidbody_t* trigger, physic
     auto* other_e = (ztd::entity_t*)other->user_data;
     auto* world = (ztd::world_t*)trigger->api->user_world;
     
-    if (other_e->type == ztd::entity_type::player) {
+    if (other_e->type == ztd::entity_type::player && world->render_system()) {
         auto& min = world->render_system()->light_probe_settings_buffer.pool[0].aabb_min;
         auto& max = world->render_system()->light_probe_settings_buffer.pool[0].aabb_max;
         auto center = (min+max)*0.5f;
@@ -157,7 +157,7 @@ platform_1000 {
 export_fn(void) co_platform(coroutine_t* co, frame_arena_t& frame_arena) {
     // return;
     auto* e = (ztd::entity_t*)co->data;
-    auto& y_pos = e->physics.rigidbody->position.y;
+    auto& y_pos = e->physics.rigidbody->position().y;
 
     const auto lerp = tween::generic<f32>(tween::in_out_elastic);
     auto* stack = co_stack(co, frame_arena);
@@ -169,8 +169,8 @@ export_fn(void) co_platform(coroutine_t* co, frame_arena_t& frame_arena) {
         *start = y_pos;
         *end = math::fcmp(*start, 20.0f) ? 0.0f : 20.0f;
 
-        DEBUG_DIAGRAM(e->physics.rigidbody->position.y);
-        DEBUG_DIAGRAM(v3f(e->physics.rigidbody->position.x, *end, e->physics.rigidbody->position.z));
+        DEBUG_DIAGRAM(e->physics.rigidbody->position().y);
+        DEBUG_DIAGRAM(v3f(e->physics.rigidbody->position().x, *end, e->physics.rigidbody->position().z));
 
         // Platform.audio.play_sound(assets::sounds::unlock.id);
 
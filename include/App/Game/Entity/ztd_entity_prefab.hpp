@@ -27,16 +27,42 @@ struct mod_function {
     {
     }
 
+    // Note(Zack): literals and captureless lambdas need two conversions to get here, msvc allows that gcc doesnt
+    template <size_t L>
+    constexpr mod_function(const char (&func)[L]) 
+        : mod_function{std::string_view{func}}
+    {
+    }
+
+    template <typename Lambda>
+    requires (std::is_convertible_v<Lambda, Function> && !std::is_same_v<Lambda, Function>)
+    constexpr mod_function(Lambda f) 
+        : function{f}
+    {
+    }
+
     constexpr mod_function<Function>& operator=(const Function& f) {
         function = f;
         return *this;
     } 
 
+    template <typename Lambda>
+    requires (std::is_convertible_v<Lambda, Function> && !std::is_same_v<Lambda, Function>)
+    constexpr mod_function<Function>& operator=(Lambda f) {
+        function = f;
+        return *this;
+    } 
+
     constexpr mod_function<Function>& operator=(std::string_view s) {
         *this = mod_function<Function>{s};
         return *this;
     } 
 
+    template <size_t L>
+    constexpr mod_function<Function>& operator=(const char (&s)[L]) {
+        return *this = std::string_view{s};
+    } 
+
     constexpr operator bool() const {
         return function || name[0];
     }
@@ -109,15 +135,18 @@ struct prefab_t {
         struct shape_t {
             physics::collider_shape_type shape{physics::collider_shape_type::NONE};
             u32 flags{};
+            // Note(Zack): gcc doesnt allow types declared inside an anonymous union
+            struct box_t {
+                v3f size{};
+            };
+            struct capsule_t {
+                f32 radius;
+                f32 height;
+            };
             union {
-                struct box_t {
-                    v3f size{};
-                } box;
+                box_t box{};
                 math::sphere_t sphere;
-                struct capsule_t {
-                    f32 radius;
-                    f32 height;
-                } capsule;
+                capsule_t capsule;
             };
         };
         std::optional<shape_t> shapes[8]{}; 
@@ -133,7 +162,7 @@ struct prefab_t {
     std::optional<particle_system_settings_t> emitter{};
     // std::optional<item::effect_t> effect{}; // @version 3 removed
 
-    brain_type brain_type = brain_type::invalid;
+    ::brain_type brain_type = ::brain_type::invalid;
 
     u32 inventory_size=0; // @version 1 - added
 
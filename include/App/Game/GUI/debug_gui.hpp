@@ -91,7 +91,7 @@ void draw_fixed_arena(
         tag;
         tag = tag->next
     ) {
-        u64 alloc_size = tag->type_size * tag->count;
+        u64 alloc_size = tag->size();
         u64 tag_memory = u64(tag);
         u64 start_memory = u64(tag + 1);
         u64 block_start = u64(arena->start);
@@ -122,7 +122,8 @@ void draw_fixed_arena(
             math::rect2d_t tooltip;
             tooltip.min = mouse + v2f{3.0f};
 
-            auto tooltip_text = fmt_str("{}[{}]: {}|{}", tag->type_name, tag->count, utl::trim_filename(tag->file_name), tag->line_number);
+            const auto& site = tag->callsite();
+            auto tooltip_text = fmt_str("{}[{}]: {}|{}", site.type_name, tag->count, utl::trim_filename(site.file_name), site.line_number);
 
             tooltip.max = tooltip.min + gfx::font_get_size(imgui.ctx.font, tooltip_text);
             
@@ -188,7 +189,7 @@ void draw_arena_panel(
     f32 unused_percent = f32(f64(total_used) / f64(total_size));
 
     node_for(auto, arena->tags, tag) {
-        math::update_statistic(memory_stat, f64(tag->type_size * tag->count));
+        math::update_statistic(memory_stat, f64(tag->size()));
     }
 
     math::end_statistic(memory_stat);
@@ -306,7 +307,7 @@ void draw_arena(
 
         u64 block_id = tag->block_id;
         u64 tag_start_memory =  u64(tag) - u64(blocks[block_id].start);
-        u64 alloc_size = tag->type_size * tag->count;
+        u64 alloc_size = tag->size();
         u64 start_memory =  u64(tag + 1);
         if (tag_start_memory + alloc_size > blocks[block_id].size) {
             block_id += 1;
@@ -345,7 +346,8 @@ void draw_arena(
             math::rect2d_t tooltip;
             tooltip.min = mouse + v2f{3.0f};
 
-            auto tooltip_text = fmt_str("{}[{}]: {}|{}", tag->type_name, tag->count, utl::trim_filename(tag->file_name), tag->line_number);
+            const auto& site = tag->callsite();
+            auto tooltip_text = fmt_str("{}[{}]: {}|{}", site.type_name, tag->count, utl::trim_filename(site.file_name), site.line_number);
 
             tooltip.max = tooltip.min + gfx::font_get_size(imgui.ctx.font, tooltip_text);
             
@@ -861,7 +863,7 @@ animation_browser(
             }
             auto& resource = pack_file->table[rf];
             if (im::text(imgui, fmt_sv("- {} ------ {}{}", resource.name.c_data, math::pretty_bytes(resource.size), math::pretty_bytes_postfix(resource.size)))) {
-                selection = utl::hash_get(&game_state->animations, pack_file->table[rf].name.sv());
+                selection = game_state_get_skeletal_mesh(game_state, pack_file->table[rf].name.sv());
             }
         }
     };
@@ -1230,7 +1232,7 @@ draw_entity_gui(auto* game_state, auto& imgui) {
                         break;
                 }
                 if (e->physics.rigidbody) {
-                    im::text(imgui, fmt_sv("Velocity: {}", e->physics.rigidbody->velocity));
+                    im::text(imgui, fmt_sv("Velocity: {}", e->physics.rigidbody->velocity()));
                 }
 
                 switch(e->type) {
@@ -1324,7 +1326,7 @@ void draw_release_info(auto* game_state) {
 #endif
     local_persist f32 last_fps = game_state->input().dt;
     local_persist f32 lag_timer;
-    auto fps_delta = 1000.0f * std::fabsf(game_state->input().dt-last_fps);
+    auto fps_delta = 1000.0f * std::fabs(game_state->input().dt-last_fps);
 
     if (fps_delta > 5.0f) {
         lag_timer += 1.0f;
@@ -1624,13 +1626,19 @@ draw_gui(game_memory_t* game_memory) {
                     im::end_scroll_rect(imgui, &scroll, &rect);
                 };
 
+                if (im::text(imgui, fmt_sv("- Export Trace ({} dropped events)", tables[0]->dropped_event_count + (tables[1] ? tables[1]->dropped_event_count : 0)))) {
+                    const std::string_view module_names[] = { "game"sv, "physics"sv };
+                    export_debug_trace(std::span{tables}, std::span{module_names}, "profile_trace.json");
+                }
+
                 size_t record_count = 0;
                 range_u64(t, 0, array_count(tables)) {
                     size_t size = table_sizes[t];
                     auto* table = tables[t];
                     range_u64(i, 0, size) {
                         auto* record = table->records + i;
-                        const auto cycle = record->history[record->hist_id?record->hist_id-1:array_count(record->history)-1];
+                        const u64 hist_id = record->hist_id.load(std::memory_order_relaxed) % array_count(record->history);
+                        const auto cycle = record->history[hist_id?hist_id-1:array_count(record->history)-1];
 
                         if (record->func_name == nullptr) continue;
 
@@ -2042,29 +2050,69 @@ draw_gui(game_memory_t* game_memory) {
                         // draw_arena(imgui, arena_rect, display_arenas[i]);
 
 
-                        /*
-                        auto tag_count = node_count(display_arenas[i]->tags);
-                        im::text(imgui, fmt_sv("- Tags: {}", tag_count));
-                        auto* start = display_arenas[i]->tags;
-                        node_for(auto, start, tag) {
-                            if (im::text(imgui, fmt_sv("--- {}[{}]: {}() | {}({}) | {}{}", 
-                                tag->type_name, 
-                                tag->count, 
-                                tag->function_name, 
-                                utl::trim_filename(tag->file_name), 
-                                tag->line_number,
-                                math::pretty_bytes(tag->type_size * tag->count),
-                                math::pretty_bytes_postfix(tag->type_size * tag->count)
-                            ))) {
-                                std::system(fmt_sv("code -g {}:{}:0", tag->file_name, tag->line_number).data());
-                            }
-                        }
-                        */
                     }
                 }
                 for (size_t i = 0; i < array_count(display_pools); i++) {
                     im::text(imgui, pool_display_info(display_pools[i], display_pool_names[i]));
                 }
+                const auto& lua_stats = game_state->game_world->L.user_data.allocator.stats;
+                im::text(imgui, fmt_sv("- Lua Heap: {}{} in use, {}{} reserved, {} allocs, {} frees, {} in place",
+                    math::pretty_bytes(lua_stats.bytes_in_use), math::pretty_bytes_postfix(lua_stats.bytes_in_use),
+                    math::pretty_bytes(lua_stats.bytes_reserved), math::pretty_bytes_postfix(lua_stats.bytes_reserved),
+                    lua_stats.allocations, lua_stats.frees, lua_stats.in_place_reallocations
+                ));
+                const auto* block_cache = arena_get_block_cache();
+                const u64 cached_bytes = block_cache->cached_bytes.load(std::memory_order_relaxed);
+                im::text(imgui, fmt_sv("- Block Cache: {}{} cached, {} hits, {} misses, {} releases",
+                    math::pretty_bytes(cached_bytes), math::pretty_bytes_postfix(cached_bytes),
+                    block_cache->stats.hits.load(std::memory_order_relaxed),
+                    block_cache->stats.misses.load(std::memory_order_relaxed),
+                    block_cache->stats.releases.load(std::memory_order_relaxed)
+                ));
+                arena_scratch_stats_t scratch_stats[arena_scratch_registry_t::max_threads];
+                const u32 scratch_count = arena_get_scratch_stats(scratch_stats);
+                range_u32(i, 0, scratch_count) {
+                    im::text(imgui, fmt_sv("--- Scratch[{}]: {}{} high water", i,
+                        math::pretty_bytes(scratch_stats[i].high_water), math::pretty_bytes_postfix(scratch_stats[i].high_water)
+                    ));
+                }
+#ifdef DEBUG_STATE
+                im::text(imgui, fmt_sv("- Debug Draws: {}/{}, {} dropped",
+                    DEBUG_STATE.draw_count, debug_state_t::draw_capacity, DEBUG_STATE.draw_dropped
+                ));
+#endif
+
+                local_persist bool show_sites = false;
+                if (im::text(imgui, fmt_sv("- Allocation Sites: {}", allocation_site_count() - 1), &show_sites)) {
+                    // heaviest sites first
+                    u32 order[allocation_site_table_t::capacity];
+                    const u32 site_count = allocation_site_count();
+                    range_u32(s, 0, site_count) {
+                        order[s] = s;
+                    }
+                    const u32 shown = std::min(site_count, 32u);
+                    std::partial_sort(order, order + shown, order + site_count, [](u32 a, u32 b) {
+                        return allocation_site_get(a).bytes.load(std::memory_order_relaxed) > allocation_site_get(b).bytes.load(std::memory_order_relaxed);
+                    });
+                    range_u32(s, 0, shown) {
+                        const auto& site = allocation_site_get(order[s]);
+                        const u64 bytes = site.bytes.load(std::memory_order_relaxed);
+                        if (bytes == 0) {
+                            break;
+                        }
+                        if (im::text(imgui, fmt_sv("--- {}: {}() | {}({}) | {}{} over {} allocs", 
+                            site.type_name, 
+                            site.function_name, 
+                            utl::trim_filename(site.file_name), 
+                            site.line_number,
+                            math::pretty_bytes(bytes),
+                            math::pretty_bytes_postfix(bytes),
+                            site.allocations.load(std::memory_order_relaxed)
+                        ))) {
+                            std::system(fmt_sv("code -g {}:{}:0", site.file_name, site.line_number).data());
+                        }
+                    }
+                }
             } else {
                 open_arena_window = 0;
                 open_arena_name = 0;
@@ -2090,7 +2138,7 @@ draw_gui(game_memory_t* game_memory) {
                 const bool on_wall = game_state->game_world->player->physics.rigidbody->flags & physics::rigidbody_flags::IS_ON_WALL;
                 im::text(imgui, fmt_sv("- On Ground: {}", on_ground?"true":"false"));
                 im::text(imgui, fmt_sv("- On Wall: {}", on_wall?"true":"false"));
-                const auto v = player->physics.rigidbody->velocity;
+                const auto v = player->physics.rigidbody->velocity();
                 const auto p = player->global_transform().origin;
                 im::text(imgui, fmt_sv("- Position: {}", p));
                 im::text(imgui, fmt_sv("- Velocity: {}", v));
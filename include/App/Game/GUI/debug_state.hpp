@@ -301,12 +301,8 @@ draw_console(
     }
 }
 
-enum struct debug_variable_type {
-    UINT32, INT32,
-    CBOOL, B32,
-    FLOAT32, FLOAT64,
-    VEC2, VEC3, WAYPOINT,
-    AABB, RAY, SPHERE, TEXT,
+enum struct debug_draw_type : u32 {
+    LINE, AABB, SPHERE, POINT,
     COUNT
 };
 
@@ -364,28 +360,62 @@ struct debug_watcher_t {
     };
 };
 
-struct debug_variable_t {
-    debug_variable_t* next{0};
-    std::string_view name{};
+// Note(Zack): a and b depend on type, line is start/end, aabb is min/max, sphere is origin with radius in b.x, point only uses a
+struct debug_draw_t {
+    debug_draw_type type{debug_draw_type::COUNT};
+    u32 color{0};
+    f32 expire_time{0.0f};
+    const char* name{0};
+    v3f a{0.0f};
+    v3f b{0.0f};
+};
 
-    debug_variable_type type{};
-    f32 time_stamp{0};
-    v4f color{1.0f};
+// Note(Zack): clip planes pulled from the rows of vp, xyz is the normal and w the offset
+inline void
+debug_frustum_planes(const m44& vp, v4f (&planes)[6]) {
+    const v4f r0{vp[0][0], vp[1][0], vp[2][0], vp[3][0]};
+    const v4f r1{vp[0][1], vp[1][1], vp[2][1], vp[3][1]};
+    const v4f r2{vp[0][2], vp[1][2], vp[2][2], vp[3][2]};
+    const v4f r3{vp[0][3], vp[1][3], vp[2][3], vp[3][3]};
+    planes[0] = r3 + r0; planes[1] = r3 - r0;
+    planes[2] = r3 + r1; planes[3] = r3 - r1;
+    planes[4] = r3 + r2; planes[5] = r3 - r2;
+    for (auto& plane: planes) {
+        plane /= glm::length(v3f{plane});
+    }
+}
 
-    union {
-        u32 as_u32;
-        i32 as_i32;
-        f32 as_f32;
-        f64 as_f64;
-        v2f as_v2f;
-        v3f as_v3f;
-        bool as_cbool;
-        math::rect3d_t as_aabb{};
-        math::ray_t as_ray;
-        math::sphere_t as_sphere;
-        math::waypoint_t as_waypoint;
-        stack_string<32> as_text;
-    };
+inline b32
+debug_sphere_visible(const v4f (&planes)[6], v3f center, f32 radius) {
+    for (const auto& plane: planes) {
+        if (glm::dot(v3f{plane}, center) + plane.w < -radius) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Note(Zack): single producer single consumer, the owning thread pushes and the main thread drains in collect_draws
+struct debug_draw_buffer_t {
+    static constexpr u64 capacity = 2048;
+
+    std::atomic<u64> owner{0};
+    std::atomic<u64> head{0};
+    std::atomic<u64> tail{0};
+    std::atomic<u64> dropped{0};
+
+    debug_draw_t draws[capacity];
+
+    b32 push(const debug_draw_t& draw) {
+        const u64 h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        draws[h % capacity] = draw;
+        head.store(h + 1, std::memory_order_release);
+        return 1;
+    }
 };
 
 struct debug_alert_t {
@@ -451,8 +481,23 @@ struct debug_state_t {
 
     v3f* selection = 0;
 
-    debug_variable_t* variables{0};
-    debug_variable_t* first_free{0};
+    // one buffer per thread, see thread_draw_buffer. room for every job thread plus render, audio and loaders
+    static constexpr u32 draw_buffer_count = utl::job_max_threads + 16;
+    debug_draw_buffer_t* draw_buffers{0};
+
+    static constexpr u32 draw_capacity = 1 << 14;
+    debug_draw_t* draws{0};
+    u32 draw_count{0};
+    u64 draw_dropped{0};
+    std::atomic<u64> draw_unbuffered{0}; // threads that found every buffer taken
+
+    // time is written by the platform between frames, threads read this copy instead
+    std::atomic<f32> frame_time{0.0f};
+
+    // main thread, before anything runs for the frame
+    void set_frame_time() {
+        frame_time.store(time, std::memory_order_relaxed);
+    }
 
     debug_watcher_t* watcher{0};
     debug_watcher_t* free_watch{0};
@@ -460,8 +505,6 @@ struct debug_state_t {
     char watcher_needle[64] = {};
     size_t watcher_wpos{0};
 
-    utl::hash_trie_t<std::string_view, u32>* path_ids = 0;
-
     debug_console_t* console;
 
     debug_watcher_t* create_watcher() {
@@ -477,6 +520,69 @@ struct debug_state_t {
         }
     }
 
+    debug_draw_buffer_t* thread_draw_buffer() {
+        struct cached_buffer_t {
+            debug_state_t* state;
+            debug_draw_buffer_t* buffer;
+        };
+        thread_local cached_buffer_t cached{};
+        if (cached.state == this) {
+            return cached.buffer;
+        }
+        if (draw_buffers == nullptr) {
+            return nullptr;
+        }
+
+        // Note(Zack): keyed on the os thread so a thread finds its old slot again after a reload
+        const u64 key = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        range_u32(i, 0, draw_buffer_count) {
+            auto* buffer = draw_buffers + i;
+            u64 expected = buffer->owner.load(std::memory_order_acquire);
+            if (expected == key ||
+                (expected == 0 && buffer->owner.compare_exchange_strong(expected, key, std::memory_order_acq_rel))
+            ) {
+                cached = {this, buffer};
+                return buffer;
+            }
+        }
+        return nullptr;
+    }
+
+    // main thread only, drops expired draws then drains every threads buffer into draws
+    void collect_draws() {
+        if (draw_buffers == nullptr) {
+            return;
+        }
+
+        const f32 now = frame_time.load(std::memory_order_relaxed);
+        u32 live = 0;
+        range_u32(i, 0, draw_count) {
+            if (draws[i].expire_time >= now) {
+                draws[live++] = draws[i];
+            }
+        }
+        draw_count = live;
+
+        range_u32(i, 0, draw_buffer_count) {
+            auto* buffer = draw_buffers + i;
+            if (buffer->owner.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            const u64 head = buffer->head.load(std::memory_order_acquire);
+            u64 tail = buffer->tail.load(std::memory_order_relaxed);
+            for (; tail < head; tail++) {
+                if (draw_count < draw_capacity) {
+                    draws[draw_count++] = buffer->draws[tail % debug_draw_buffer_t::capacity];
+                } else {
+                    draw_dropped++;
+                }
+            }
+            buffer->tail.store(tail, std::memory_order_release);
+            draw_dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        }
+        draw_dropped += draw_unbuffered.exchange(0, std::memory_order_relaxed);
+    }
+
     void begin_frame() {
         if (watcher) {
             if (free_watch) {
@@ -487,25 +593,7 @@ struct debug_state_t {
                 free_watch = watcher;
             }
         }
-        debug_variable_t* last = 0;
-        for(auto* var = variables; var;) {
-            if (time - var->time_stamp > timeout) {
-                if (last) {
-                    last->next = var->next;
-                    node_push(var, first_free);
-                    var = last->next;
-                    continue;
-                } else {
-                    node_next(variables);
-                    auto* ll = var->next;
-                    node_push(var, first_free);
-                    var = ll;
-                    continue;
-                }
-            }
-            last = var;
-            node_next(var);
-        }
+        collect_draws();
         watcher = nullptr;
         // arena_clear(&watch_arena);
     }
@@ -624,88 +712,158 @@ struct debug_state_t {
     
 
     void draw(gfx::gui::im::state_t& imgui, const m44& proj, const m44& view, const v4f& viewport) {
-        std::lock_guard lock{ticket};
         using namespace gfx::gui;
-        debug_variable_t* last = nullptr;
-        debug_variable_t* curr = variables;
-        // while (curr && time - curr->time_stamp > timeout) {
-        //     auto* next = curr->next;
-        //     node_next(variables);
-        //     node_push(curr, first_free);
-        //     curr = next;
-        // }
-        // while (curr) {
-        //     if (time - curr->time_stamp > timeout) {
-        //         last->next = curr->next;
-        //         node_push(curr, first_free);
-        //         curr = last->next;
-        //     } else {
-        //         last = curr;
-        //         node_next(curr);
-        //     }
-        // }
+        collect_draws();
 
         imgui.begin_free_drawing();
         defer {
             imgui.end_free_drawing();
         };
 
-        math::rect3d_t viewable{v3f{0.0f}, v3f{viewport.z, viewport.w, 1.0f}};
-
-        auto draw_point = [&](std::string_view name, auto point, auto color) {
-            if (glm::distance(point, focus_point) > focus_distance) return;
-            auto pos_ = math::world_to_screen(proj, view, viewport, point);
-            if (viewable.contains(pos_)) {
-                auto pos_up = swizzle::xy(math::world_to_screen(proj, view, viewport, point + axis::up * 0.05f));
-                auto pos = swizzle::xy(pos_);
-                draw_circle(&imgui.ctx, pos, glm::distance(pos_up, pos), gfx::color::to_color32(color));
-                draw_circle(&imgui.ctx, pos, glm::distance(pos_up, pos) * 0.66f, gfx::color::rgba::light_gray);
-                draw_string(&imgui.ctx, name, pos, gfx::color::to_color32(color));
+        const m44 vp = proj * view;
+
+        v4f planes[6];
+        debug_frustum_planes(vp, planes);
+
+        auto visible = [&](v3f center, f32 radius) {
+            return debug_sphere_visible(planes, center, radius);
+        };
+
+        auto to_screen = [&](v3f p, v2f* out) -> b32 {
+            const v4f clip = vp * v4f{p, 1.0f};
+            if (clip.w <= 0.0001f) {
+                return 0;
             }
+            *out = v2f{viewport.x, viewport.y} + (v2f{clip} / clip.w * 0.5f + 0.5f) * v2f{viewport.z, viewport.w};
+            return 1;
         };
 
-        node_for(auto, variables, var) {
-            // im::text(imgui, var->name);
-            if (var->type == debug_variable_type::VEC3) {
-                draw_point(var->name, var->as_v3f, var->color);
-            } else if (var->type == debug_variable_type::WAYPOINT) {
-                draw_point(var->name, var->as_waypoint.point, var->color);
-            } else if (var->type == debug_variable_type::AABB) {
-                const auto aabb_distance = glm::distance(var->as_aabb.center(), focus_point);
-                if (
-                    aabb_distance > focus_distance || 
-                    // var->as_aabb.contains(focus_point) || 
-                    aabb_distance < 1.0f
-                ) continue;
-
-                auto pos = (math::world_to_screen(proj, view, viewport, var->as_aabb.center()));
-                if (viewable.contains(pos)) {
-                    // string_render(&imgui.ctx, var->name, swizzle::xy(pos), gfx::color::rgba::yellow);
-                }
-                draw_aabb(&imgui.ctx, var->as_aabb, proj * view, 2.0f, gfx::color::to_color32(var->color));
+        constexpr u32 sphere_res = 16;
+        constexpr u32 point_res = 12;
+        constexpr f32 point_radius = 0.05f;
 
-            } else if (var->type == debug_variable_type::SPHERE) {
-                if (glm::distance(var->as_sphere.origin, focus_point) > focus_distance) continue;
-                auto ro_ = math::world_to_screen(proj, view, viewport, var->as_sphere.origin);
+        struct label_t {
+            const char* name;
+            v2f pos;
+            u32 color;
+        };
 
-                if (viewable.contains(ro_)) {
-                    auto ro = swizzle::xy(ro_);
+        auto scratch = begin_temporary_memory(arena_get_scratch());
+        defer { end_temporary_memory(scratch); };
+
+        // cull first so the line buffers are sized for what survives
+        auto* visible_draws = push_struct<u32>(scratch.arena, draw_count);
+        u32 visible_count = 0;
+        u64 max_segments = 0;
+        range_u32(i, 0, draw_count) {
+            const auto& d = draws[i];
+            switch (d.type) {
+                case debug_draw_type::LINE:
+                    if (glm::distance(d.a, focus_point) > focus_distance) continue;
+                    if (!visible((d.a + d.b) * 0.5f, glm::distance(d.a, d.b) * 0.5f)) continue;
+                    max_segments += 1;
+                    break;
+                case debug_draw_type::AABB: {
+                    const v3f center = (d.a + d.b) * 0.5f;
+                    const auto aabb_distance = glm::distance(center, focus_point);
+                    if (aabb_distance > focus_distance || aabb_distance < 1.0f) continue;
+                    if (!visible(center, glm::distance(d.a, d.b) * 0.5f)) continue;
+                    max_segments += 12;
+                }   break;
+                case debug_draw_type::SPHERE:
+                    if (glm::distance(d.a, focus_point) > focus_distance) continue;
+                    if (!visible(d.a, d.b.x)) continue;
+                    max_segments += 3 * sphere_res;
+                    break;
+                case debug_draw_type::POINT:
+                    if (glm::distance(d.a, focus_point) > focus_distance) continue;
+                    if (!visible(d.a, point_radius)) continue;
+                    max_segments += point_res;
+                    break;
+                default: continue;
+            }
+            visible_draws[visible_count++] = i;
+        }
 
-                    draw_wire_sphere(&imgui.ctx, var->as_sphere.origin, var->as_sphere.radius, proj * view, 3.0f, gfx::color::to_color32(var->color));
-                    draw_string(&imgui.ctx, var->name, ro, gfx::color::to_color32(var->color));
+        if (visible_count) {
+            auto* points = push_struct<v2f>(scratch.arena, max_segments * 2);
+            auto* colors = push_struct<u32>(scratch.arena, max_segments);
+            auto* labels = push_struct<label_t>(scratch.arena, visible_count);
+            u64 segment_count = 0;
+            u32 label_count = 0;
+
+            auto push_screen_segment = [&](v2f a, v2f b, u32 color) {
+                points[segment_count * 2 + 0] = a;
+                points[segment_count * 2 + 1] = b;
+                colors[segment_count++] = color;
+            };
+            auto push_segment = [&](v3f a, v3f b, u32 color) {
+                v2f sa, sb;
+                if (to_screen(a, &sa) && to_screen(b, &sb)) {
+                    push_screen_segment(sa, sb, color);
+                }
+            };
+            auto push_label = [&](const debug_draw_t& d) {
+                v2f pos;
+                if (d.name && to_screen(d.a, &pos)) {
+                    labels[label_count++] = label_t{d.name, pos, d.color};
                 }
+            };
+
+            range_u32(v, 0, visible_count) {
+                const auto& d = draws[visible_draws[v]];
+                switch (d.type) {
+                    case debug_draw_type::LINE:
+                        push_segment(d.a, d.b, d.color);
+                        push_label(d);
+                        break;
+                    case debug_draw_type::AABB:
+                        // corner bit i picks max on axis i, every edge flips one bit
+                        range_u32(c, 0, 8) {
+                            const v3f corner{c&1 ? d.b.x : d.a.x, c&2 ? d.b.y : d.a.y, c&4 ? d.b.z : d.a.z};
+                            for (u32 bit = 1; bit < 8; bit <<= 1) {
+                                if (c & bit) continue;
+                                const u32 o = c | bit;
+                                push_segment(corner, v3f{o&1 ? d.b.x : d.a.x, o&2 ? d.b.y : d.a.y, o&4 ? d.b.z : d.a.z}, d.color);
+                            }
+                        }
+                        break;
+                    case debug_draw_type::SPHERE: {
+                        const f32 r = d.b.x;
+                        range_u32(s, 0, sphere_res) {
+                            const f32 a0 = math::constants::tau32 * f32(s) / f32(sphere_res);
+                            const f32 a1 = math::constants::tau32 * f32(s+1) / f32(sphere_res);
+                            const v2f c0{glm::cos(a0) * r, glm::sin(a0) * r};
+                            const v2f c1{glm::cos(a1) * r, glm::sin(a1) * r};
+                            push_segment(d.a + v3f{c0.x, c0.y, 0.0f}, d.a + v3f{c1.x, c1.y, 0.0f}, d.color);
+                            push_segment(d.a + v3f{c0.x, 0.0f, c0.y}, d.a + v3f{c1.x, 0.0f, c1.y}, d.color);
+                            push_segment(d.a + v3f{0.0f, c0.x, c0.y}, d.a + v3f{0.0f, c1.x, c1.y}, d.color);
+                        }
+                        push_label(d);
+                    }   break;
+                    case debug_draw_type::POINT: {
+                        v2f center, up;
+                        if (!to_screen(d.a, &center) || !to_screen(d.a + axis::up * point_radius, &up)) break;
+                        const f32 r = glm::distance(center, up);
+                        range_u32(s, 0, point_res) {
+                            const f32 a0 = math::constants::tau32 * f32(s) / f32(point_res);
+                            const f32 a1 = math::constants::tau32 * f32(s+1) / f32(point_res);
+                            push_screen_segment(
+                                center + v2f{glm::cos(a0), glm::sin(a0)} * r,
+                                center + v2f{glm::cos(a1), glm::sin(a1)} * r,
+                                d.color
+                            );
+                        }
+                        push_label(d);
+                    }   break;
+                    default: break;
+                }
+            }
 
-            } else if (var->type == debug_variable_type::RAY) {
-                if (glm::distance(var->as_ray.origin, focus_point) > focus_distance) continue;
-                auto ro_ = math::world_to_screen(proj, view, viewport, var->as_ray.origin);
-                auto rd_ = math::world_to_screen(proj, view, viewport, var->as_ray.origin + var->as_ray.direction);
+            draw_lines(&imgui.ctx, points, colors, segment_count, 2.0f);
 
-                if (viewable.contains(ro_)) {
-                    auto ro = swizzle::xy(ro_);
-                    auto rd = swizzle::xy(rd_);
-                    draw_line(&imgui.ctx, ro, rd, 2.0f, gfx::color::to_color32(var->color));
-                    draw_string(&imgui.ctx, var->name, ro, gfx::color::to_color32(var->color));
-                }
+            range_u32(l, 0, label_count) {
+                draw_string(&imgui.ctx, labels[l].name, labels[l].pos, labels[l].color);
             }
         }
 
@@ -713,61 +871,41 @@ struct debug_state_t {
     }
 
     template <typename T>
-    debug_variable_t* add_time_variable(T val, std::string_view name, v4f color, f32 force_life = -1.0f) {
-        auto* var = add_variable(val, name, color);
-        if (force_life != -1.0f) {
-            const auto delta = timeout - force_life;
-            var->time_stamp = time - delta;
-        } else {
-            var->time_stamp = time;
+    void diagram(const T& val, const char* name, v4f color, f32 life = -1.0f) {
+        debug_draw_t draw{};
+        draw.name = name;
+        draw.color = gfx::color::to_color32(color);
+        draw.expire_time = frame_time.load(std::memory_order_relaxed) + (life < 0.0f ? timeout : life);
+
+        if constexpr (std::is_same_v<T, v3f>) {
+            draw.type = debug_draw_type::POINT;
+            draw.a = val;
+        } else if constexpr (std::is_same_v<T, math::waypoint_t>) {
+            draw.type = debug_draw_type::POINT;
+            draw.a = val.point;
+        } else if constexpr (std::is_same_v<T, math::ray_t>) {
+            draw.type = debug_draw_type::LINE;
+            draw.a = val.origin;
+            draw.b = val.origin + val.direction;
+        } else if constexpr (std::is_same_v<T, math::rect3d_t>) {
+            draw.type = debug_draw_type::AABB;
+            draw.a = val.min;
+            draw.b = val.max;
+        } else if constexpr (std::is_same_v<T, math::sphere_t>) {
+            draw.type = debug_draw_type::SPHERE;
+            draw.a = val.origin;
+            draw.b.x = val.radius;
         }
 
-        return var;
-    }
-
-    template <typename T>
-    debug_variable_t* add_variable(T val, std::string_view name, v4f color) {
-        std::lock_guard lock{ticket};
-        // auto* var = first_free ? first_free : push_struct<debug_variable_t>(&arena);
-        auto* var = first_free;
-        if (first_free) { 
-            node_next(first_free); 
-            new (var) debug_variable_t;
-        } else {
-            tag_struct(var, debug_variable_t, &arena);
+        // Note(Zack): scalars have nothing to draw, watch them instead
+        if (draw.type == debug_draw_type::COUNT) {
+            return;
         }
-        var->name = name;
-        var->color = color;
-        // if constexpr (std::is_same_v<T, ztd::entity_t>) { var->type = debug_variable_type::ENTITY; }
-        if constexpr (std::is_same_v<T, u32>) { var->type = debug_variable_type::UINT32; }
-        if constexpr (std::is_same_v<T, i32>) { var->type = debug_variable_type::INT32; }
-        if constexpr (std::is_same_v<T, bool>) { var->type = debug_variable_type::CBOOL; }
-        // if constexpr (std::is_same_v<T, f32>) { var->type = debug_variable_type::B32; }
-        if constexpr (std::is_same_v<T, f32>) { var->type = debug_variable_type::FLOAT32; }
-        if constexpr (std::is_same_v<T, f64>) { var->type = debug_variable_type::FLOAT64; }
-        if constexpr (std::is_same_v<T, v2f>) { var->type = debug_variable_type::VEC2; }
-        if constexpr (std::is_same_v<T, v3f>) { var->type = debug_variable_type::VEC3; }
-        if constexpr (std::is_same_v<T, math::ray_t>) { var->type = debug_variable_type::RAY; }
-        if constexpr (std::is_same_v<T, math::rect3d_t>) { var->type = debug_variable_type::AABB; }
-        if constexpr (std::is_same_v<T, math::sphere_t>) { var->type = debug_variable_type::SPHERE; }
-        if constexpr (std::is_same_v<T, std::string_view>) { 
-            var->type = debug_variable_type::TEXT; 
-            utl::copy(&var->as_text.buffer, val.data(), val.size());
-        } else if constexpr (std::is_same_v<T, math::waypoint_t>) { 
-            var->type = debug_variable_type::WAYPOINT;
-            var->as_waypoint = val;
-            b32 had = 0;
-            auto* id = utl::hash_get(&path_ids, name, &arena, &had);
-            if (!had) {
-                *id = 0;
-            }
-            var->as_waypoint.id = (*id)++;
+        if (auto* buffer = thread_draw_buffer()) {
+            buffer->push(draw);
         } else {
-            utl::copy(&var->as_u32, &val, sizeof(val));
+            draw_unbuffered.fetch_add(1, std::memory_order_relaxed);
         }
-
-        node_push(var, variables);
-        return var;
     }
 
     debug_watcher_t* get_watch_variable(std::string_view name) {
@@ -843,9 +981,9 @@ struct debug_state_t {
 
 #ifdef DEBUG_STATE
     #define DEBUG_WATCH(var) DEBUG_STATE.watch_variable((var), #var)
-    #define DEBUG_DIAGRAM(var) DEBUG_STATE.add_time_variable((var), #var, v4f{1.0f})
-    #define XDIAGRAM(var, color, time) DEBUG_STATE.add_time_variable((var), #var, color, time)
-    #define DEBUG_DIAGRAM_(var, time) DEBUG_STATE.add_time_variable((var), #var, v4f{1.0f}, (time))
+    #define DEBUG_DIAGRAM(var) DEBUG_STATE.diagram((var), #var, v4f{1.0f})
+    #define XDIAGRAM(var, color, time) DEBUG_STATE.diagram((var), #var, color, time)
+    #define DEBUG_DIAGRAM_(var, time) DEBUG_STATE.diagram((var), #var, v4f{1.0f}, (time))
     #define DEBUG_SET_FOCUS(point) DEBUG_STATE.focus_point = (point)
     #define DEBUG_SET_FOCUS_DISTANCE(distance) DEBUG_STATE.focus_distance = (distance)
     #define DEBUG_SET_TIMEOUT(time) DEBUG_STATE.timeout = (time)
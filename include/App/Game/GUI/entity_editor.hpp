@@ -13,6 +13,7 @@
 #include "App/game_state.hpp"
 
 #include <filesystem>
+#include <fmt/chrono.h>
 
 struct instanced_prefab_t {
     instanced_prefab_t* next = 0;
@@ -564,15 +565,17 @@ struct entity_editor_t {
     void save_to_file(const char* name) {
         std::ofstream file{name, std::ios::binary};
 
+        // raw version 1 layout, a prefab and a transform per placement
         world_save_file_header_t header {
             .prefab_count = dlist_count(prefabs), 
+            .VERSION = 1,
             .light_probe_count = 1,
             .light_probe_min = light_probe_settings.aabb.min,
             .light_probe_max = light_probe_settings.aabb.max,
             .light_probe_grid_size = light_probe_settings.grid_size
         };
         
-        file.write((char*)&header, sizeof(header));
+        file.write((char*)&header, offsetof(world_save_file_header_t, prefab_table_count));
 
         for(auto* prefab = prefabs.next;
             prefab != &prefabs;
@@ -594,23 +597,72 @@ struct entity_editor_t {
 
 template<>
 void utl::memory_blob_t::serialize<entity_editor_t>(arena_t* arena, const entity_editor_t& ee) {
+    // copies of a prefab are byte for byte identical, group the placements by those bytes
+    arena_t scratch = arena_create(megabytes(1));
+    defer {
+        arena_clear(&scratch);
+    };
+
+    const u32 placement_count = dlist_count(ee.prefabs);
+    tag_array(auto* placements, const instanced_prefab_t*, &scratch, placement_count);
+    tag_array(auto* placement_entry, u32, &scratch, placement_count);
+    tag_array(auto* table, const ztd::prefab_t*, &scratch, placement_count);
+    tag_array(auto* table_offsets, u32, &scratch, placement_count + 1);
+    utl::sid_hash_t table_hash{};
+
+    u32 table_count = 0;
+    u32 placement = 0;
+    for (auto* inst = ee.prefabs.next;
+        inst != &ee.prefabs;
+        node_next(inst)
+    ) {
+        assert(inst);
+        const sid_t key = sid(std::string_view{(const char*)&inst->prefab, sizeof(ztd::prefab_t)});
+        u64 entry = utl::sid_hash_find(&table_hash, key);
+        if (entry == utl::invalid_hash || std::memcmp(table[entry], &inst->prefab, sizeof(ztd::prefab_t)) != 0) {
+            entry = table_count++;
+            table[entry] = &inst->prefab;
+            table_offsets[entry] = 0;
+            utl::sid_hash_add(&table_hash, &scratch, key, entry);
+        }
+        placements[placement] = inst;
+        placement_entry[placement++] = safe_truncate_u64(entry);
+        table_offsets[entry]++;
+    }
+
+    // counts to offsets, then bucket the transforms so each prefab's placements are packed
+    u32 offset = 0;
+    range_u32(entry, 0, table_count) {
+        const u32 count = table_offsets[entry];
+        table_offsets[entry] = offset;
+        offset += count;
+    }
+    table_offsets[table_count] = offset;
+
+    tag_array(auto* cursor, u32, &scratch, table_count + 1);
+    utl::copy(cursor, table_offsets, sizeof(u32) * (table_count + 1));
+    tag_array(auto* transforms, math::transform_t, &scratch, placement_count);
+    range_u32(i, 0, placement_count) {
+        transforms[cursor[placement_entry[i]]++] = placements[i]->transform;
+    }
+
     world_save_file_header_t header {
-        .prefab_count = dlist_count(ee.prefabs), 
+        .prefab_count = placement_count, 
         .light_probe_count = 1,
         .light_probe_min = ee.light_probe_settings.aabb.min,
         .light_probe_max = ee.light_probe_settings.aabb.max,
-        .light_probe_grid_size = ee.light_probe_settings.grid_size
+        .light_probe_grid_size = ee.light_probe_settings.grid_size,
+        .prefab_table_count = table_count,
     };
         
     serialize(arena, header);
 
-    for (auto* inst = ee.prefabs.next;
-        inst != &ee.prefabs;
-        node_next(inst)
-    ) {
-        assert(inst);
-        serialize(arena, inst->prefab);
-        serialize(arena, inst->transform);
+    range_u32(entry, 0, table_count) {
+        serialize(arena, *table[entry]);
+        serialize(arena, u64{table_offsets[entry + 1] - table_offsets[entry]});
+        range_u32(i, table_offsets[entry], table_offsets[entry + 1]) {
+            serialize(arena, transforms[i]);
+        }
     }
 }
 
@@ -699,11 +751,11 @@ entity_editor_t::entity_editor_t(game_state_t* app_)
                 ee->end_event_group();
             };
 
-            range_u64(i, 0, header.prefab_count) {
-                auto prefab = blob.deserialize<ztd::prefab_t>(&ee->arena);
-                auto transform = blob.deserialize<math::transform_t>();
-                ee->instance_prefab(prefab, transform);
-            }
+            world_file_for_each_prefab(blob, header, &ee->arena, [&](const ztd::prefab_t& prefab, std::span<const math::transform_t> transforms) {
+                for (const auto& transform : transforms) {
+                    ee->instance_prefab(prefab, transform);
+                }
+            });
 
             if (header.light_probe_count > 0) {
                 ee->light_probe_settings.aabb.min = header.light_probe_min;
@@ -990,11 +1042,11 @@ ImGui_save_world_window(
                 ee->end_event_group();
             };
 
-            range_u64(i, 0, header.prefab_count) {
-                auto prefab = blob.deserialize<ztd::prefab_t>(&ee->arena);
-                auto transform = blob.deserialize<math::transform_t>();
-                ee->instance_prefab(prefab, transform);
-            }
+            world_file_for_each_prefab(blob, header, &ee->arena, [&](const ztd::prefab_t& prefab, std::span<const math::transform_t> transforms) {
+                for (const auto& transform : transforms) {
+                    ee->instance_prefab(prefab, transform);
+                }
+            });
 
             if (header.light_probe_count > 0) {
                 ee->light_probe_settings.aabb.min = header.light_probe_min;
@@ -1512,8 +1564,8 @@ void draw_browser_panel(gfx::gui::im::state_t& imgui, entity_editor_t* ee, const
                 math::rect2d_t name; \
                 std::tie(name, tabs) = math::cut_left(tabs, std::max(tab_min_width, text_size.x + 8.0f)); \
                 name.pad(1.0f); \
-                if (name.contains(mouse) && clicked) { selected_type = entity_editor_t::browser_type::##filter; } \
-                gfx::gui::draw_round_rect_outline(c, name, 2.0f, to_color32(v4f{0.0f, 0.0f, 0.0f, 0.5f}), selected_type == entity_editor_t::browser_type::##filter ? tab_colors[tab_count++] : modulate(tab_colors[tab_count++], 0.1f), border_thickness); \
+                if (name.contains(mouse) && clicked) { selected_type = entity_editor_t::browser_type::filter; } \
+                gfx::gui::draw_round_rect_outline(c, name, 2.0f, to_color32(v4f{0.0f, 0.0f, 0.0f, 0.5f}), selected_type == entity_editor_t::browser_type::filter ? tab_colors[tab_count++] : modulate(tab_colors[tab_count++], 0.1f), border_thickness); \
                 gfx::gui::draw_string(c, #name, name.min, text_color, font, shadow); \
             }
 
@@ -1566,7 +1618,7 @@ void draw_browser_panel(gfx::gui::im::state_t& imgui, entity_editor_t* ee, const
                                     }
                                     ee->close_browser(selected_type);
                                 case hot:
-                                    ee->tooltip = std::format("{}{} - {}", math::pretty_bytes(entry.file_size()), math::pretty_bytes_postfix(entry.file_size()), std::filesystem::last_write_time(entry.path()));
+                                    ee->tooltip = std::string_view{fmt_str("{}{} - {}", math::pretty_bytes(entry.file_size()), math::pretty_bytes_postfix(entry.file_size()), std::chrono::file_clock::to_sys(std::filesystem::last_write_time(entry.path())))};
                                 default: break;
                             };
                         }
@@ -2795,7 +2847,7 @@ entity_editor_render(entity_editor_t* ee) {
 
         // gfx::gui::draw_rect(c, right_panel, imgui.theme.fg_color);
         // gfx::gui::draw_rect(c, file_panel, imgui.theme.fg_color);
-        // gfx::gui::draw_rect(c, viewport, 1, math::zero_to(v2f{1.0f}), ~0ui32);
+        // gfx::gui::draw_rect(c, viewport, 1, math::zero_to(v2f{1.0f}), ~0u);
 
         if constexpr(false)
         {   // transform panel
@@ -3157,7 +3209,7 @@ entity_editor_update(entity_editor_t* ee) {
                 // }
                 auto transform = p->transform.to_matrix();
                 particle_system_update(p->particle_system, transform, dt);
-                // particle_system_sort_view(p->particle_system, transform, ee->camera.position, -ee->camera.forward());
+                // particle_system_sort_view(p->particle_system, transform, ee->camera.position, -ee->camera.forward(), &ee->arena);
                 particle_system_build_matrices(p->particle_system, p->transform.to_matrix(), instance, p->instance_count);
                 particle_system_build_colors(p->particle_system, color_instances, p->instance_count);
             }
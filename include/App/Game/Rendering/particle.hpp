@@ -178,9 +178,30 @@ utl::memory_blob_t::deserialize<particle_system_settings_t>(arena_t* arena) {
 }
 
 
+// Note(Zack): live particles are stored as structure of arrays so the update can run 8 at a time.
+// Every stream has room for max_count rounded up to 8, the kernels run over the padding instead of a tail loop
+struct particle_streams_t {
+    static constexpr u32 lane_count = 8;
+    static constexpr u32 stream_count = 20;
+
+    f32* position[3]{};
+    f32* velocity[3]{};
+    f32* orientation[4]{}; // x y z w
+    f32* angular_velocity[3]{};
+    f32* life_time{0};
+    f32* scale{0};
+    f32* color[4]{};
+    u32* sprite_index{0};
+
+    u32  capacity{0};
+};
+
+// every stream pointer above gets capacity floats out of one block, keep stream_count in step
+static_assert(offsetof(particle_streams_t, capacity) == sizeof(f32*) * particle_streams_t::stream_count);
+static_assert(sizeof(u32) == sizeof(f32));
+
 struct particle_system_t : public particle_system_settings_t {
-    // particle_t* particles;
-    buffer<particle_t> particles;
+    particle_streams_t particles;
     utl::rng::random_t<utl::rng::xor64_random_t> rng;
     u32 live_count{0};
     u32 instance_offset{0};
@@ -279,6 +300,67 @@ get_or_create_particle_system_from_cache(
     return replace;
 }
 
+inline static particle_t
+particle_system_get_particle(
+    const particle_system_t* system,
+    u64 i
+) {
+    const auto& s = system->particles;
+    particle_t particle;
+    particle.position = v3f{s.position[0][i], s.position[1][i], s.position[2][i]};
+    particle.life_time = s.life_time[i];
+    particle.orientation = quat{s.orientation[3][i], s.orientation[0][i], s.orientation[1][i], s.orientation[2][i]};
+    particle.color = v4f{s.color[0][i], s.color[1][i], s.color[2][i], s.color[3][i]};
+    particle.scale = s.scale[i];
+    particle.velocity = v3f{s.velocity[0][i], s.velocity[1][i], s.velocity[2][i]};
+    particle.angular_velocity = v3f{s.angular_velocity[0][i], s.angular_velocity[1][i], s.angular_velocity[2][i]};
+    particle.sprite_index = s.sprite_index[i];
+    return particle;
+}
+
+inline static void
+particle_system_set_particle(
+    particle_system_t* system,
+    u64 i,
+    const particle_t& particle
+) {
+    auto& s = system->particles;
+    range_u32(k, 0, 3) {
+        s.position[k][i] = particle.position[k];
+        s.velocity[k][i] = particle.velocity[k];
+        s.angular_velocity[k][i] = particle.angular_velocity[k];
+        s.orientation[k][i] = particle.orientation[k]; // glm quats are x y z w in memory
+    }
+    s.orientation[3][i] = particle.orientation.w;
+    range_u32(k, 0, 4) {
+        s.color[k][i] = particle.color[k];
+    }
+    s.life_time[i] = particle.life_time;
+    s.scale[i] = particle.scale;
+    s.sprite_index[i] = particle.sprite_index;
+}
+
+inline static void
+particle_system_move_particle(
+    particle_system_t* system,
+    u64 dst,
+    u64 src
+) {
+    auto& s = system->particles;
+    range_u32(k, 0, 3) {
+        s.position[k][dst] = s.position[k][src];
+        s.velocity[k][dst] = s.velocity[k][src];
+        s.angular_velocity[k][dst] = s.angular_velocity[k][src];
+    }
+    range_u32(k, 0, 4) {
+        s.orientation[k][dst] = s.orientation[k][src];
+        s.color[k][dst] = s.color[k][src];
+    }
+    s.life_time[dst] = s.life_time[src];
+    s.scale[dst] = s.scale[src];
+    s.sprite_index[dst] = s.sprite_index[src];
+}
+
 // user needs to check can spawn before calling
 inline static void 
 particle_system_spawn(
@@ -288,8 +370,8 @@ particle_system_spawn(
     const b32 world_space = system->is_world_space();
     // const m44 world_inv = glm::inverse(transform);
 
-    auto* particle = system->particles.data + system->live_count++;
-    *particle = system->template_particle;
+    particle_t spawned = system->template_particle;
+    auto* particle = &spawned;
     
     particle->life_time -= system->rng.range(system->life_random);
 
@@ -315,6 +397,8 @@ particle_system_spawn(
         particle->velocity = transform * v4f{particle->velocity, 0.0f};
         particle->angular_velocity = transform * v4f{particle->angular_velocity, 0.0f};
     }
+
+    particle_system_set_particle(system, system->live_count++, spawned);
 }
 
 inline static void 
@@ -323,11 +407,216 @@ particle_system_kill_particle(
     u64 i
 ) {
     if (system->live_count) {
-        std::swap(system->particles.data[i], system->particles.data[system->live_count-1]);
+        particle_system_move_particle(system, i, system->live_count-1);
         system->live_count--;
     }
 }
 
+// life, velocity, position and orientation for [0, count), count is rounded up to the lane count
+inline static void
+particle_system_integrate(
+    particle_system_t* system,
+    u32 count,
+    f32 dt
+) {
+    auto& s = system->particles;
+    const v3f acceleration = system->acceleration * dt;
+
+#if defined(__AVX2__)
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    const __m256 half_dt8 = _mm256_set1_ps(0.5f * dt);
+    const __m256 acc8[3] = {
+        _mm256_set1_ps(acceleration.x), _mm256_set1_ps(acceleration.y), _mm256_set1_ps(acceleration.z)
+    };
+
+    for (u32 i = 0; i < count; i += particle_streams_t::lane_count) {
+        _mm256_storeu_ps(s.life_time + i, _mm256_sub_ps(_mm256_loadu_ps(s.life_time + i), dt8));
+
+        __m256 v[3], q[4], w[3];
+        range_u32(k, 0, 3) {
+            v[k] = _mm256_add_ps(_mm256_loadu_ps(s.velocity[k] + i), acc8[k]);
+            _mm256_storeu_ps(s.velocity[k] + i, v[k]);
+            v[k] = _mm256_mul_ps(v[k], dt8);
+            w[k] = _mm256_loadu_ps(s.angular_velocity[k] + i);
+        }
+        range_u32(k, 0, 4) {
+            q[k] = _mm256_loadu_ps(s.orientation[k] + i);
+        }
+
+        // position += q * (v * dt), t = 2 * cross(q.xyz, v), v' = v + q.w * t + cross(q.xyz, t)
+        __m256 t[3];
+        t[0] = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_fmsub_ps(q[1], v[2], _mm256_mul_ps(q[2], v[1])));
+        t[1] = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_fmsub_ps(q[2], v[0], _mm256_mul_ps(q[0], v[2])));
+        t[2] = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_fmsub_ps(q[0], v[1], _mm256_mul_ps(q[1], v[0])));
+        const __m256 c[3] = {
+            _mm256_fmsub_ps(q[1], t[2], _mm256_mul_ps(q[2], t[1])),
+            _mm256_fmsub_ps(q[2], t[0], _mm256_mul_ps(q[0], t[2])),
+            _mm256_fmsub_ps(q[0], t[1], _mm256_mul_ps(q[1], t[0])),
+        };
+        range_u32(k, 0, 3) {
+            const __m256 moved = _mm256_add_ps(_mm256_fmadd_ps(q[3], t[k], v[k]), c[k]);
+            _mm256_storeu_ps(s.position[k] + i, _mm256_add_ps(_mm256_loadu_ps(s.position[k] + i), moved));
+        }
+
+        // q += q * quat(0, w) * 0.5 * dt, then normalize
+        const __m256 dw = _mm256_sub_ps(_mm256_setzero_ps(),
+            _mm256_fmadd_ps(q[0], w[0], _mm256_fmadd_ps(q[1], w[1], _mm256_mul_ps(q[2], w[2]))));
+        const __m256 dq[3] = {
+            _mm256_fmadd_ps(q[3], w[0], _mm256_fmsub_ps(q[1], w[2], _mm256_mul_ps(q[2], w[1]))),
+            _mm256_fmadd_ps(q[3], w[1], _mm256_fmsub_ps(q[2], w[0], _mm256_mul_ps(q[0], w[2]))),
+            _mm256_fmadd_ps(q[3], w[2], _mm256_fmsub_ps(q[0], w[1], _mm256_mul_ps(q[1], w[0]))),
+        };
+        range_u32(k, 0, 3) {
+            q[k] = _mm256_fmadd_ps(dq[k], half_dt8, q[k]);
+        }
+        q[3] = _mm256_fmadd_ps(dw, half_dt8, q[3]);
+
+        const __m256 length2 = _mm256_fmadd_ps(q[0], q[0], _mm256_fmadd_ps(q[1], q[1], _mm256_fmadd_ps(q[2], q[2], _mm256_mul_ps(q[3], q[3]))));
+        const __m256 inv_length = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(length2));
+        range_u32(k, 0, 4) {
+            _mm256_storeu_ps(s.orientation[k] + i, _mm256_mul_ps(q[k], inv_length));
+        }
+    }
+#else
+    range_u32(i, 0, count) {
+        s.life_time[i] -= dt;
+
+        v3f velocity{s.velocity[0][i], s.velocity[1][i], s.velocity[2][i]};
+        velocity += acceleration;
+        quat orientation{s.orientation[3][i], s.orientation[0][i], s.orientation[1][i], s.orientation[2][i]};
+        const v3f angular_velocity{s.angular_velocity[0][i], s.angular_velocity[1][i], s.angular_velocity[2][i]};
+        const v3f moved = orientation * (velocity * dt);
+
+        orientation += (orientation * glm::quat(0.0f, angular_velocity)) * (0.5f * dt);
+        orientation = glm::normalize(orientation);
+
+        range_u32(k, 0, 3) {
+            s.velocity[k][i] = velocity[k];
+            s.position[k][i] += moved[k];
+            s.orientation[k][i] = orientation[k];
+        }
+        s.orientation[3][i] = orientation.w;
+    }
+#endif
+}
+
+// scale and color over life time for [0, count), the curve type is picked once per batch
+inline static void
+particle_system_sample_curves(
+    particle_system_t* system,
+    u32 count
+) {
+    auto& s = system->particles;
+    using namespace gfx::color;
+
+    // t = 1 - life / template life
+    const f32 inv_life = 1.0f / system->template_particle.life_time;
+    const f32 scale_min = system->template_particle.scale * system->scale_over_life_time.min;
+    const f32 scale_size = system->template_particle.scale * system->scale_over_life_time.size();
+
+    constexpr u32 batch_size = 64;
+    alignas(32) f32 t[batch_size];
+
+    for (u32 begin = 0; begin < count; begin += batch_size) {
+        const u32 batch = std::min(batch_size, count - begin);
+
+#if defined(__AVX2__)
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 inv_life8 = _mm256_set1_ps(inv_life);
+        const __m256 scale_min8 = _mm256_set1_ps(scale_min);
+        const __m256 scale_size8 = _mm256_set1_ps(scale_size);
+        for (u32 i = 0; i < batch; i += particle_streams_t::lane_count) {
+            const __m256 t8 = _mm256_fnmadd_ps(_mm256_loadu_ps(s.life_time + begin + i), inv_life8, one);
+            _mm256_store_ps(t + i, t8);
+            _mm256_storeu_ps(s.scale + begin + i, _mm256_fmadd_ps(t8, scale_size8, scale_min8));
+        }
+#else
+        range_u32(i, 0, batch) {
+            t[i] = 1.0f - s.life_time[begin + i] * inv_life;
+            s.scale[begin + i] = scale_min + scale_size * t[i];
+        }
+#endif
+
+        switch (system->particle_color._type) {
+            case color_variant_type::uniform:
+            case color_variant_type::hex: {
+                const v4f color = system->particle_color.sample(0.0f);
+                range_u32(k, 0, 4) {
+                    std::fill(s.color[k] + begin, s.color[k] + begin + batch, color[k]);
+                }
+            } break;
+            case color_variant_type::range: {
+                const v4f min = system->particle_color.range.min;
+                const v4f size = system->particle_color.range.size();
+                range_u32(k, 0, 4) {
+                    range_u32(i, 0, batch) {
+                        s.color[k][begin + i] = size[k] * t[i] + min[k];
+                    }
+                }
+            } break;
+            default: {
+                range_u32(i, 0, batch) {
+                    const v4f color = system->particle_color.sample(t[i]);
+                    range_u32(k, 0, 4) {
+                        s.color[k][begin + i] = color[k];
+                    }
+                }
+            } break;
+        }
+    }
+}
+
+// swap removes every particle that ran out of life
+inline static void
+particle_system_compact(
+    particle_system_t* system
+) {
+    auto& s = system->particles;
+    for (u32 i = 0; i < system->live_count;) {
+        if (s.life_time[i] <= 0.0f) {
+            particle_system_move_particle(system, i, --system->live_count);
+        } else {
+            i++;
+        }
+    }
+}
+
+inline static void
+particle_system_compute_aabb(
+    particle_system_t* system
+) {
+    auto& s = system->particles;
+    system->aabb = {};
+    const u32 count = system->live_count;
+
+#if defined(__AVX2__)
+    const u32 full = count & ~(particle_streams_t::lane_count - 1);
+    if (full) {
+        range_u32(k, 0, 3) {
+            __m256 lo = _mm256_loadu_ps(s.position[k]);
+            __m256 hi = lo;
+            for (u32 i = particle_streams_t::lane_count; i < full; i += particle_streams_t::lane_count) {
+                const __m256 p = _mm256_loadu_ps(s.position[k] + i);
+                lo = _mm256_min_ps(lo, p);
+                hi = _mm256_max_ps(hi, p);
+            }
+            alignas(32) f32 lo_lanes[8], hi_lanes[8];
+            _mm256_store_ps(lo_lanes, lo);
+            _mm256_store_ps(hi_lanes, hi);
+            range_u32(l, 0, 8) {
+                system->aabb.min[k] = std::min(system->aabb.min[k], lo_lanes[l]);
+                system->aabb.max[k] = std::max(system->aabb.max[k], hi_lanes[l]);
+            }
+        }
+    }
+#else
+    const u32 full = 0;
+#endif
+    range_u32(i, full, count) {
+        system->aabb.expand(v3f{s.position[0][i], s.position[1][i], s.position[2][i]});
+    }
+}
+
 inline static void 
 particle_system_update(
     particle_system_t* system,
@@ -335,7 +624,6 @@ particle_system_update(
     f32 dt
 ) {
     system->spawn_timer -= dt;
-    system->aabb = {};
 
     while (system->spawn_timer <= 0.0f) {
         system->spawn_timer += system->spawn_rate;
@@ -354,34 +642,12 @@ particle_system_update(
         }
     }
 
-    range_u64(i, 0, system->live_count) {
-        restart_particle_update:
-        auto* particle = system->particles.data + i;
-        particle->life_time -= dt;
-
-        // Note(Zack): kill particle and restart loop
-        if (particle->life_time <= 0.0f) {
-            if (0 != --system->live_count) {
-                std::swap(*particle, system->particles.data[system->live_count]);
-                goto restart_particle_update;
-            }
-        }
-
-        const f32 life_alpha = particle->life_time / (system->template_particle.life_time);
-
-        particle->velocity += system->acceleration * dt;
-        particle->position += particle->orientation * (particle->velocity * dt);
-        particle->orientation += (particle->orientation * glm::quat(0.0f, particle->angular_velocity)) * (0.5f * dt);
-        particle->orientation = glm::normalize(particle->orientation);
-        particle->scale = system->template_particle.scale * system->scale_over_life_time.sample(1.0f-life_alpha);
-        // particle->color = v4f{1.0f};
-        particle->color = system->particle_color.sample(1.0f-life_alpha);
-
-        // if (particle->position.y < 0.0f) {
-        //     particle->velocity.y = 7.0f;
-        // }
-        system->aabb.expand(particle->position);
-    }
+    // the padding lanes are simulated too, they are never read
+    const u32 count = align_2n(system->live_count, particle_streams_t::lane_count);
+    particle_system_integrate(system, count, dt);
+    particle_system_compact(system);
+    particle_system_sample_curves(system, align_2n(system->live_count, particle_streams_t::lane_count));
+    particle_system_compute_aabb(system);
 }
 
 inline static void 
@@ -391,9 +657,9 @@ particle_system_build_colors(
 ) {
     assert(system->live_count <= color_count);
 
+    const auto& s = system->particles;
     range_u32(i, 0, system->live_count) {
-        auto* particle = system->particles.data + i;
-        data[i].color = particle->color;
+        data[i].color = v4f{s.color[0][i], s.color[1][i], s.color[2][i], s.color[3][i]};
     }
 }
 
@@ -408,11 +674,11 @@ particle_system_build_matrices(
     const b32 world_space = system->is_world_space();
 
     range_u32(i, 0, system->live_count) {
-        auto* particle = system->particles.data + i;
+        const auto particle = particle_system_get_particle(system, i);
         matrix[i] = math::transform_t{}
-            .translate(particle->position)
-            .rotate_quat(particle->orientation)
-            .scale(v3f{particle->scale})
+            .translate(particle.position)
+            .rotate_quat(particle.orientation)
+            .scale(v3f{particle.scale})
             .to_matrix();
 
         if (!world_space) {
@@ -426,11 +692,17 @@ inline static void
 particle_system_sort_view(
     particle_system_t* system,
     const m44& transform,
-    v3f camera_pos, v3f camera_forward
+    v3f camera_pos, v3f camera_forward,
+    arena_t* temp_arena
 ) {
     const b32 world_space = system->is_world_space();
 
-    std::span<particle_t> view{system->particles.data, system->live_count};
+    // gather into records, sort, then scatter back into the streams
+    auto* particles = push_bytes(temp_arena, sizeof(particle_t) * system->live_count);
+    std::span<particle_t> view{(particle_t*)particles, system->live_count};
+    range_u32(i, 0, system->live_count) {
+        view[i] = particle_system_get_particle(system, i);
+    }
 
     std::sort(view.begin(), view.end(), [&](auto& p0, auto& p1) {
         v3f pp0 = p0.position;
@@ -444,6 +716,10 @@ particle_system_sort_view(
         return glm::dot(d0, camera_forward) > glm::dot(d1, camera_forward);
         return glm::dot(d0, camera_forward) < glm::dot(d1, camera_forward);
     });
+
+    range_u32(i, 0, system->live_count) {
+        particle_system_set_particle(system, i, view[i]);
+    }
 }
 
 inline static particle_system_t*
@@ -454,17 +730,33 @@ particle_system_create(
     u64 seed = 0
 ) {
     tag_struct(auto* system, particle_system_t, system_arena);
-    tag_array(system->particles.data, particle_t, particle_arena?particle_arena:system_arena, max_particle_count);
 
-    system->particles.count =
-        system->max_count = max_particle_count;
+    auto& streams = system->particles;
+    streams.capacity = align_2n(max_particle_count, particle_streams_t::lane_count);
+    
+    // one block for every stream, zeroed so the padding lanes stay finite
+    const u64 stream_bytes = sizeof(f32) * streams.capacity;
+    auto* block = push_bytes(particle_arena?particle_arena:system_arena, stream_bytes * particle_streams_t::stream_count);
+    std::memset(block, 0, stream_bytes * particle_streams_t::stream_count);
+
+    f32* stream = (f32*)block;
+    auto next_stream = [&]() { auto* result = stream; stream += streams.capacity; return result; };
+    range_u32(k, 0, 3) streams.position[k] = next_stream();
+    range_u32(k, 0, 3) streams.velocity[k] = next_stream();
+    range_u32(k, 0, 4) streams.orientation[k] = next_stream();
+    range_u32(k, 0, 3) streams.angular_velocity[k] = next_stream();
+    streams.life_time = next_stream();
+    streams.scale = next_stream();
+    range_u32(k, 0, 4) streams.color[k] = next_stream();
+    streams.sprite_index = (u32*)next_stream();
+    assert((std::byte*)stream == block + stream_bytes * particle_streams_t::stream_count);
+
+    std::fill(streams.orientation[3], streams.orientation[3] + streams.capacity, 1.0f);
+
+    system->max_count = max_particle_count;
     system->live_count = 0;
     system->spawn_timer = 0.0f;
 
-    range_u64(i, 0, max_particle_count) {
-        system->particles.data[i].life_time = 0.0f;
-    }
-
     if (seed) system->rng.seed(seed);
 
     return system;
@@ -41,23 +41,17 @@ namespace rendering {
     template <umm Size>
     using probe_buffer_t = gfx::vul::storage_buffer_t<lighting::probe_t, Size>;
 
+    // mesh ids index straight into the chunks, get is called for every draw
     struct mesh_cache_t {
-        struct link_t : node_t<link_t> {
-            gfx::mesh_list_t mesh;
-        };
-
-        utl::deque<link_t> meshes;
+        utl::chunked_array_t<gfx::mesh_list_t> meshes;
 
         u64 add(arena_t* arena, const gfx::mesh_list_t& r) {
-            tag_struct(link_t* link, link_t, arena);
-            link->mesh = r;
-            meshes.push_back(link);
-            return meshes.size() - 1;
+            return meshes.push_back(arena, r);
         }
 
         gfx::mesh_list_t& get(u64 id) {
             assert(id < meshes.size() && "Mesh is not loaded");
-            return meshes[id]->mesh;
+            return meshes[id];
         }
     };
     
@@ -858,7 +852,7 @@ public:
         u32 total_instance_count{0};
 
         mesh_cache_t    mesh_cache{};
-        utl::str_hash_t mesh_hash{};
+        utl::sid_hash_t mesh_hash{};
 
         shader_cache_t  shader_cache{};
         texture_cache_t texture_cache{};
@@ -1023,7 +1017,7 @@ public:
         rs->vk_gfx = &state;
         rs->width = (u32)state.depth_stencil_texture.size.x;
         rs->height = (u32)state.depth_stencil_texture.size.y;
-        utl::str_hash_create(rs->mesh_hash);
+        utl::sid_hash_create(&rs->mesh_hash, &rs->arena, 1024);
         rs->frame_arena = arena_sub_arena(&rs->arena, system_t::frame_arena_size);
 
         tag_struct(rs->permanent_descriptor_allocator, gfx::vul::descriptor_allocator_t, &rs->arena, state.device); 
@@ -1347,7 +1341,7 @@ public:
 
             gfx::indirect_indexed_draw_t* draw_cmd = rs->get_frame_data().indexed_indirect_storage_buffer.pool.allocate(1);
             draw_cmd->index_count = meshes->meshes[i].index_count;
-            draw_cmd->instance_count = std::max(instance_count, 1ui32);
+            draw_cmd->instance_count = std::max(instance_count, 1u);
             draw_cmd->first_index = meshes->meshes[i].index_start;
             draw_cmd->vertex_offset = meshes->meshes[i].vertex_start;
             draw_cmd->first_instance = 0;
@@ -1578,7 +1572,7 @@ public:
         gfx::mesh_list_t& mesh
     ) {
         const auto mesh_id = rs->mesh_cache.add(&rs->arena, mesh);
-        utl::str_hash_add(rs->mesh_hash, name, mesh_id);
+        utl::sid_hash_add(&rs->mesh_hash, &rs->arena, sid(name), mesh_id);
 
         rs->rt_cache->build_blas(*rs->vk_gfx, mesh, rs->scene_context->vertices, rs->scene_context->indices);
 
@@ -1591,7 +1585,7 @@ public:
         std::string_view name
     ) {
         if (name.empty()) return std::numeric_limits<u64>::max();
-        auto id = utl::str_hash_find(rs->mesh_hash, name);
+        auto id = utl::sid_hash_find(&rs->mesh_hash, sid(name));
         if (id == utl::invalid_hash) {
             std::byte* file_data = utl::res::pack_file_get_file_by_name(rs->resource_file, name);
                         
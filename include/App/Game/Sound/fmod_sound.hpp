@@ -94,7 +94,8 @@ namespace fmod_sound {
         }
     };
 
-    sound_engine_t* init(arena_t* arena) {
+    // headless keeps every event and bank but mixes into nothing, and only when update is called
+    sound_engine_t* init(arena_t* arena, b32 headless = 0) {
         // FMOD_RESULT result;
 
         // constexpr auto pool_size = megabytes(128);
@@ -125,6 +126,10 @@ namespace fmod_sound {
 
         system->setNumListeners(1);
 
+        if (headless) {
+            assert_success( engine->fmod.core_system->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT) );
+        }
+
         assert_success( system->initialize(1024, FMOD_STUDIO_INIT_NORMAL, FMOD_INIT_NORMAL, 0) );
         
         FMOD::Studio::Bank* masterBank = NULL;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ztd_core.hpp"
+#include "projectile.hpp"
 
 
 namespace ztd {
@@ -43,4 +44,7 @@ namespace ztd::wep {
         ztd::world_t* world,
         const ztd::prefab_t& prefab,
         bullet_t bullet);
+
+    // sweeps every pooled projectile against the physics world, call after the physics step
+    void update_projectiles(ztd::world_t* world, f32 dt);
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ztd_core.hpp"
+
+namespace ztd::item {
+    struct effect_t;
+}
+
+namespace ztd::wep {
+
+    // Note(Zack): Bullets used to be full entities with a rigidbody, a kill coroutine and a trail emitter.
+    // The pool only keeps what a bullet needs in parallel arrays, the world moves all of them with
+    // one batch of swept rays a frame and hits go out through the world event list.
+    struct projectile_pool_t {
+        static constexpr u32 capacity = 2048;
+
+        u32 count{0};
+
+        v3f             position[capacity];
+        v3f             velocity[capacity];
+        f32             life_time[capacity];
+        f32             damage[capacity];
+        f32             gravity[capacity];
+        u32             layer[capacity]; // raycast mask, same as the rigidbody group the entity bullets used
+        item::effect_t* effect[capacity];
+    };
+
+    // main thread only, returns 0 when the pool is full
+    inline b32
+    projectile_spawn(
+        projectile_pool_t* pool,
+        v3f position, v3f velocity,
+        f32 life_time, f32 damage, f32 gravity,
+        u32 layer, item::effect_t* effect
+    ) {
+        if (pool->count == projectile_pool_t::capacity) {
+            return 0;
+        }
+        const u32 i = pool->count++;
+        pool->position[i] = position;
+        pool->velocity[i] = velocity;
+        pool->life_time[i] = life_time;
+        pool->damage[i] = damage;
+        pool->gravity[i] = gravity;
+        pool->layer[i] = layer;
+        pool->effect[i] = effect;
+        return 1;
+    }
+
+    // swaps the last projectile into i, so iterate backwards when removing
+    inline void
+    projectile_remove(projectile_pool_t* pool, u32 i) {
+        assert(i < pool->count);
+        const u32 last = --pool->count;
+        pool->position[i] = pool->position[last];
+        pool->velocity[i] = pool->velocity[last];
+        pool->life_time[i] = pool->life_time[last];
+        pool->damage[i] = pool->damage[last];
+        pool->gravity[i] = pool->gravity[last];
+        pool->layer[i] = pool->layer[last];
+        pool->effect[i] = pool->effect[last];
+    }
+
+    // the segment a projectile will cover this frame, length is the distance
+    inline v3f
+    projectile_sweep(const projectile_pool_t* pool, u32 i, f32 dt) {
+        return pool->velocity[i] * dt;
+    }
+
+    // moves the projectiles that didnt hit anything and drops the expired ones
+    inline void
+    projectile_integrate(projectile_pool_t* pool, f32 dt) {
+        for (u32 i = pool->count; i-- > 0;) {
+            pool->life_time[i] -= dt;
+            if (pool->life_time[i] <= 0.0f) {
+                projectile_remove(pool, i);
+                continue;
+            }
+            pool->position[i] += pool->velocity[i] * dt;
+            pool->velocity[i].y -= pool->gravity[i] * dt;
+        }
+    }
+}
@@ -0,0 +1,599 @@
+#pragma once
+
+#include "ztd_core.hpp"
+#include "App/Game/Entity/brain.hpp"
+
+#include "Recast/Recast.h"
+#include "Detour/DetourNavMesh.h"
+#include "Detour/DetourNavMeshBuilder.h"
+#include "Detour/DetourNavMeshQuery.h"
+
+// Note(Zack): Navigation mesh over the static physics geometry. The world hands over a world space
+// triangle soup, the mesh is split into a grid of tiles and every tile is built by Recast as a background
+// job, so they never run inside a frames job_wait. Without workers the tiles are built on the main thread
+// in navigation_update, one after another under the same budget as the path requests. Finished tiles are swapped into the Detour navmesh on the main thread in navigation_update,
+// so the navmesh and the query are only ever touched by the main thread.
+// Brains queue path requests from any thread, they are solved in batches under a per frame time budget
+// and written straight into the requesters ai_path_t.
+
+namespace ztd::nav {
+
+    struct settings_t {
+        f32 cell_size{0.3f};
+        f32 cell_height{0.2f};
+        f32 agent_height{2.0f};
+        f32 agent_radius{0.6f};
+        f32 agent_climb{0.9f};
+        f32 agent_max_slope{45.0f};
+        i32 tile_size{48}; // in cells
+        f32 region_min_size{8.0f};
+        f32 region_merge_size{20.0f};
+        f32 edge_max_length{12.0f};
+        f32 edge_max_error{1.3f};
+        f32 detail_sample_distance{6.0f};
+        f32 detail_sample_max_error{1.0f};
+    };
+
+    // world space, immutable while tiles are building
+    struct geometry_t {
+        v3f*            vertices{0};
+        u32             vertex_count{0};
+        i32*            indices{0}; // 3 per triangle
+        u32             triangle_count{0};
+        math::rect3d_t  aabb{};
+    };
+
+    enum struct tile_state : u32 {
+        empty,      // no walkable polys
+        queued,     // a job owns data
+        built,      // data is waiting to be swapped in on the main thread
+        live,       // the navmesh owns the data
+    };
+
+    struct tile_t {
+        std::atomic<tile_state> state{tile_state::empty};
+        b32         dirty{0};   // main thread, rebuilt with the next batch
+        b32         local{0};   // main thread, queued but no worker took it, built in navigation_update
+        i32         x{0};
+        i32         z{0};
+        u8*         data{0};    // dtAlloc'd, freed by the navmesh once it is added
+        i32         data_size{0};
+        dtTileRef   ref{0};
+    };
+
+    struct path_request_t {
+        v3f         start{};
+        v3f         end{};
+        ai_path_t*  path{0};
+        u32         ticket{0};
+    };
+
+    struct navigation_t {
+        static constexpr u32 max_tiles_per_axis = 64;
+        static constexpr u32 request_capacity = 1024;
+        static constexpr i32 max_path_polys = 256;
+        static constexpr i32 max_search_nodes = 2048;
+
+        settings_t      settings{};
+
+        arena_t         arena{};        // geometry and build jobs, cleared when nothing is building
+        geometry_t      geometry{};
+        utl::job_counter_t builds{};
+        u32             local_builds{0}; // tiles waiting for navigation_update to build them
+
+        dtNavMesh*      mesh{0};
+        dtNavMeshQuery* query{0};
+        dtQueryFilter   filter{};
+
+        math::rect3d_t  bounds{};
+        f32             tile_world_size{0.0f};
+        i32             tile_count_x{0};
+        i32             tile_count_z{0};
+        tile_t          tiles[max_tiles_per_axis * max_tiles_per_axis];
+
+        b32             rebuild_pending{0};
+        b32             rebuild_full{0};
+        math::rect3d_t  rebuild_area{};
+
+        // any thread appends, the main thread moves them into the pending ring each update
+        std::atomic<u32> incoming_count{0};
+        std::atomic<u32> next_ticket{0};
+        path_request_t  incoming[request_capacity];
+
+        path_request_t  pending[request_capacity];
+        u32             pending_head{0};
+        u32             pending_count{0};
+
+        struct stats_t {
+            u32 paths_solved{0};    // last update
+            u32 paths_waiting{0};   // left over for the next frame
+            u32 dropped_requests{0};
+            u32 tiles_swapped{0};
+        } stats;
+    };
+
+    inline navigation_t*
+    navigation_create(arena_t* arena, const settings_t& settings = {}) {
+        tag_struct(auto* nav, navigation_t, arena);
+        nav->settings = settings;
+        nav->arena = arena_create(megabytes(4));
+        nav->query = dtAllocNavMeshQuery();
+        nav->filter.setIncludeFlags(0xffff);
+        nav->filter.setExcludeFlags(0);
+        return nav;
+    }
+
+    inline void
+    navigation_free_mesh(navigation_t* nav) {
+        range_u32(i, 0, array_count(nav->tiles)) {
+            auto& tile = nav->tiles[i];
+            if (tile.state.load(std::memory_order_acquire) == tile_state::built && tile.data) {
+                dtFree(tile.data);
+            }
+            tile.state.store(tile_state::empty, std::memory_order_relaxed);
+            tile.dirty = 0;
+            tile.local = 0;
+            tile.data = 0;
+            tile.data_size = 0;
+            tile.ref = 0;
+        }
+        dtFreeNavMesh(nav->mesh);
+        nav->mesh = 0;
+        nav->tile_count_x = nav->tile_count_z = 0;
+        nav->local_builds = 0;
+    }
+
+    // waits for the tiles that are still building, the navigation_t memory belongs to the caller
+    inline void
+    navigation_destroy(navigation_t* nav, utl::job_system_t* jobs) {
+        if (!nav) return;
+        utl::job_wait(jobs, &nav->builds);
+        navigation_free_mesh(nav);
+        dtFreeNavMeshQuery(nav->query);
+        nav->query = 0;
+        arena_clear(&nav->arena);
+    }
+
+    inline b32
+    navigation_is_building(const navigation_t* nav) {
+        return nav->builds.is_done() == false || nav->local_builds;
+    }
+
+    // main thread, area = 0 rebuilds everything, the rebuild starts once the current batch of tiles is done
+    inline void
+    navigation_request_rebuild(navigation_t* nav, const math::rect3d_t* area = 0) {
+        if (area) {
+            nav->rebuild_area.expand(*area);
+        } else {
+            nav->rebuild_full = 1;
+        }
+        nav->rebuild_pending = 1;
+    }
+
+    // main thread, the caller fills in vertices and indices before calling navigation_start_rebuild
+    inline geometry_t*
+    navigation_begin_geometry(navigation_t* nav, u32 vertex_count, u32 triangle_count) {
+        assert(navigation_is_building(nav) == false);
+        arena_clear(&nav->arena);
+        nav->geometry = {};
+        tag_array(nav->geometry.vertices, v3f, &nav->arena, std::max(vertex_count, 1u));
+        tag_array(nav->geometry.indices, i32, &nav->arena, std::max(triangle_count * 3, 1u));
+        nav->geometry.vertex_count = vertex_count;
+        nav->geometry.triangle_count = triangle_count;
+        return &nav->geometry;
+    }
+
+    // job thread, only reads the geometry and writes its own tile
+    inline void
+    navigation_build_tile(navigation_t* nav, tile_t* tile) {
+        TIMED_FUNCTION;
+        const auto& s = nav->settings;
+        const auto& geometry = nav->geometry;
+
+        u8* data{0};
+        i32 data_size{0};
+        defer {
+            tile->data = data;
+            tile->data_size = data_size;
+            tile->state.store(tile_state::built, std::memory_order_release);
+        };
+
+        rcConfig cfg{};
+        cfg.cs = s.cell_size;
+        cfg.ch = s.cell_height;
+        cfg.walkableSlopeAngle = s.agent_max_slope;
+        cfg.walkableHeight = (i32)glm::ceil(s.agent_height / cfg.ch);
+        cfg.walkableClimb = (i32)glm::floor(s.agent_climb / cfg.ch);
+        cfg.walkableRadius = (i32)glm::ceil(s.agent_radius / cfg.cs);
+        cfg.maxEdgeLen = (i32)(s.edge_max_length / cfg.cs);
+        cfg.maxSimplificationError = s.edge_max_error;
+        cfg.minRegionArea = (i32)(s.region_min_size * s.region_min_size);
+        cfg.mergeRegionArea = (i32)(s.region_merge_size * s.region_merge_size);
+        cfg.maxVertsPerPoly = DT_VERTS_PER_POLYGON;
+        cfg.tileSize = s.tile_size;
+        cfg.borderSize = cfg.walkableRadius + 3;
+        cfg.width = cfg.tileSize + cfg.borderSize * 2;
+        cfg.height = cfg.tileSize + cfg.borderSize * 2;
+        cfg.detailSampleDist = s.detail_sample_distance < 0.9f ? 0.0f : cfg.cs * s.detail_sample_distance;
+        cfg.detailSampleMaxError = cfg.ch * s.detail_sample_max_error;
+
+        const f32 border = (f32)cfg.borderSize * cfg.cs;
+        cfg.bmin[0] = nav->bounds.min.x + (f32)tile->x * nav->tile_world_size - border;
+        cfg.bmin[1] = nav->bounds.min.y;
+        cfg.bmin[2] = nav->bounds.min.z + (f32)tile->z * nav->tile_world_size - border;
+        cfg.bmax[0] = nav->bounds.min.x + (f32)(tile->x + 1) * nav->tile_world_size + border;
+        cfg.bmax[1] = nav->bounds.max.y;
+        cfg.bmax[2] = nav->bounds.min.z + (f32)(tile->z + 1) * nav->tile_world_size + border;
+
+        auto scratch = begin_temporary_memory(arena_get_scratch());
+        defer { end_temporary_memory(scratch); };
+
+        // only the triangles that touch this tile
+        auto* triangles = push_struct<i32>(scratch.arena, geometry.triangle_count * 3);
+        i32 triangle_count = 0;
+        range_u32(t, 0, geometry.triangle_count) {
+            const i32* tri = geometry.indices + t * 3;
+            math::rect3d_t tri_aabb{};
+            tri_aabb.expand(geometry.vertices[tri[0]]);
+            tri_aabb.expand(geometry.vertices[tri[1]]);
+            tri_aabb.expand(geometry.vertices[tri[2]]);
+            if (tri_aabb.max.x < cfg.bmin[0] || tri_aabb.min.x > cfg.bmax[0] ||
+                tri_aabb.max.z < cfg.bmin[2] || tri_aabb.min.z > cfg.bmax[2]) {
+                continue;
+            }
+            std::memcpy(triangles + triangle_count * 3, tri, sizeof(i32) * 3);
+            triangle_count++;
+        }
+        if (triangle_count == 0) {
+            return;
+        }
+
+        rcContext ctx{false};
+        const f32* vertices = &geometry.vertices[0].x;
+        const i32 vertex_count = (i32)geometry.vertex_count;
+
+        rcHeightfield* solid = rcAllocHeightfield();
+        rcCompactHeightfield* chf = rcAllocCompactHeightfield();
+        rcContourSet* cset = rcAllocContourSet();
+        rcPolyMesh* pmesh = rcAllocPolyMesh();
+        rcPolyMeshDetail* dmesh = rcAllocPolyMeshDetail();
+        defer {
+            rcFreeHeightField(solid);
+            rcFreeCompactHeightfield(chf);
+            rcFreeContourSet(cset);
+            rcFreePolyMesh(pmesh);
+            rcFreePolyMeshDetail(dmesh);
+        };
+
+        if (!rcCreateHeightfield(&ctx, *solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch)) {
+            ztd_error(__FUNCTION__, "Failed to create heightfield for tile {} {}", tile->x, tile->z);
+            return;
+        }
+
+        auto* areas = push_struct<u8>(scratch.arena, triangle_count);
+        rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, vertices, vertex_count, triangles, triangle_count, areas);
+        if (!rcRasterizeTriangles(&ctx, vertices, vertex_count, triangles, areas, triangle_count, *solid, cfg.walkableClimb)) {
+            ztd_error(__FUNCTION__, "Failed to rasterize tile {} {}", tile->x, tile->z);
+            return;
+        }
+
+        rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *solid);
+        rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid);
+        rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *solid);
+
+        if (!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid, *chf) ||
+            !rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf) ||
+            !rcBuildDistanceField(&ctx, *chf) ||
+            !rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea) ||
+            !rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset)
+        ) {
+            ztd_error(__FUNCTION__, "Failed to build regions for tile {} {}", tile->x, tile->z);
+            return;
+        }
+        if (cset->nconts == 0) {
+            return;
+        }
+
+        if (!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *pmesh) ||
+            !rcBuildPolyMeshDetail(&ctx, *pmesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *dmesh)
+        ) {
+            ztd_error(__FUNCTION__, "Failed to build poly mesh for tile {} {}", tile->x, tile->z);
+            return;
+        }
+        if (pmesh->npolys == 0 || pmesh->nverts >= 0xffff) {
+            return;
+        }
+
+        // the default query filter skips polys without flags
+        range_u32(p, 0, (u32)pmesh->npolys) {
+            pmesh->flags[p] = (u16)(pmesh->areas[p] == RC_WALKABLE_AREA ? 1 : 0);
+        }
+
+        dtNavMeshCreateParams params{};
+        params.verts = pmesh->verts;
+        params.vertCount = pmesh->nverts;
+        params.polys = pmesh->polys;
+        params.polyAreas = pmesh->areas;
+        params.polyFlags = pmesh->flags;
+        params.polyCount = pmesh->npolys;
+        params.nvp = pmesh->nvp;
+        params.detailMeshes = dmesh->meshes;
+        params.detailVerts = dmesh->verts;
+        params.detailVertsCount = dmesh->nverts;
+        params.detailTris = dmesh->tris;
+        params.detailTriCount = dmesh->ntris;
+        params.walkableHeight = s.agent_height;
+        params.walkableRadius = s.agent_radius;
+        params.walkableClimb = s.agent_climb;
+        params.tileX = tile->x;
+        params.tileY = tile->z;
+        params.tileLayer = 0;
+        std::memcpy(params.bmin, pmesh->bmin, sizeof(params.bmin));
+        std::memcpy(params.bmax, pmesh->bmax, sizeof(params.bmax));
+        params.cs = cfg.cs;
+        params.ch = cfg.ch;
+        params.buildBvTree = true;
+
+        if (!dtCreateNavMeshData(&params, &data, &data_size)) {
+            ztd_error(__FUNCTION__, "Failed to create navmesh data for tile {} {}", tile->x, tile->z);
+            data = 0;
+            data_size = 0;
+        }
+    }
+
+    // sizes the tile grid to the geometry and makes a fresh navmesh, nothing can be building
+    inline b32
+    navigation_init_mesh(navigation_t* nav) {
+        navigation_free_mesh(nav);
+
+        const auto& geometry = nav->geometry;
+        if (geometry.triangle_count == 0) {
+            ztd_warn(__FUNCTION__, "No static geometry to build a navmesh from");
+            return 0;
+        }
+
+        nav->bounds = geometry.aabb;
+        nav->tile_world_size = (f32)nav->settings.tile_size * nav->settings.cell_size;
+
+        const v3f size = nav->bounds.size();
+        nav->tile_count_x = std::max(1, (i32)glm::ceil(size.x / nav->tile_world_size));
+        nav->tile_count_z = std::max(1, (i32)glm::ceil(size.z / nav->tile_world_size));
+        if (nav->tile_count_x > (i32)navigation_t::max_tiles_per_axis || nav->tile_count_z > (i32)navigation_t::max_tiles_per_axis) {
+            ztd_warn(__FUNCTION__, "Navmesh is {}x{} tiles, clamping to {}", nav->tile_count_x, nav->tile_count_z, navigation_t::max_tiles_per_axis);
+            nav->tile_count_x = std::min(nav->tile_count_x, (i32)navigation_t::max_tiles_per_axis);
+            nav->tile_count_z = std::min(nav->tile_count_z, (i32)navigation_t::max_tiles_per_axis);
+        }
+
+        const u32 tile_count = (u32)(nav->tile_count_x * nav->tile_count_z);
+        const i32 tile_bits = std::min((i32)std::bit_width(std::bit_ceil(tile_count)) - 1, 14);
+        dtNavMeshParams params{};
+        std::memcpy(params.orig, &nav->bounds.min, sizeof(params.orig));
+        params.tileWidth = nav->tile_world_size;
+        params.tileHeight = nav->tile_world_size;
+        params.maxTiles = (i32)tile_count;
+        params.maxPolys = 1 << (22 - tile_bits);
+
+        nav->mesh = dtAllocNavMesh();
+        if (!nav->mesh || dtStatusFailed(nav->mesh->init(&params)) ||
+            dtStatusFailed(nav->query->init(nav->mesh, navigation_t::max_search_nodes))
+        ) {
+            ztd_error(__FUNCTION__, "Failed to init navmesh");
+            dtFreeNavMesh(nav->mesh);
+            nav->mesh = 0;
+            return 0;
+        }
+
+        range_u32(i, 0, tile_count) {
+            auto& tile = nav->tiles[i];
+            tile.x = (i32)(i % (u32)nav->tile_count_x);
+            tile.z = (i32)(i / (u32)nav->tile_count_x);
+            tile.dirty = 1;
+        }
+        return 1;
+    }
+
+    // main thread, after the geometry is filled in. queues a job for every dirty tile
+    inline void
+    navigation_start_rebuild(navigation_t* nav, utl::job_system_t* jobs) {
+        TIMED_FUNCTION;
+        assert(navigation_is_building(nav) == false);
+
+        if (nav->rebuild_full || nav->mesh == 0) {
+            if (!navigation_init_mesh(nav)) {
+                nav->rebuild_pending = nav->rebuild_full = 0;
+                nav->rebuild_area = {};
+                return;
+            }
+        } else {
+            for (i32 z = 0; z < nav->tile_count_z; z++) {
+                for (i32 x = 0; x < nav->tile_count_x; x++) {
+                    math::rect3d_t tile_aabb{};
+                    tile_aabb.min = nav->bounds.min + v3f{(f32)x, 0.0f, (f32)z} * nav->tile_world_size;
+                    tile_aabb.max = tile_aabb.min + v3f{nav->tile_world_size, 0.0f, nav->tile_world_size};
+                    tile_aabb.min.y = nav->bounds.min.y;
+                    tile_aabb.max.y = nav->bounds.max.y;
+                    if (tile_aabb.intersect(nav->rebuild_area)) {
+                        nav->tiles[z * nav->tile_count_x + x].dirty = 1;
+                    }
+                }
+            }
+        }
+        nav->rebuild_pending = nav->rebuild_full = 0;
+        nav->rebuild_area = {};
+
+        u32 queued = 0;
+        range_u32(i, 0, (u32)(nav->tile_count_x * nav->tile_count_z)) {
+            auto* tile = nav->tiles + i;
+            if (!tile->dirty) continue;
+            tile->dirty = 0;
+            tile->state.store(tile_state::queued, std::memory_order_relaxed);
+            const b32 submitted = utl::job_run_background(jobs, &nav->arena, [nav, tile]() {
+                navigation_build_tile(nav, tile);
+            }, &nav->builds);
+            if (!submitted) {
+                tile->local = 1;
+                nav->local_builds++;
+            }
+            queued++;
+        }
+        ztd_info(__FUNCTION__, "Building {} navmesh tiles ({} on the main thread), {} triangles", 
+            queued, nav->local_builds, nav->geometry.triangle_count);
+    }
+
+    // main thread, swaps finished tiles into the navmesh
+    inline void
+    navigation_swap_tiles(navigation_t* nav) {
+        nav->stats.tiles_swapped = 0;
+        if (!nav->mesh) return;
+
+        range_u32(i, 0, (u32)(nav->tile_count_x * nav->tile_count_z)) {
+            auto& tile = nav->tiles[i];
+            if (tile.state.load(std::memory_order_acquire) != tile_state::built) {
+                continue;
+            }
+            if (tile.ref) {
+                nav->mesh->removeTile(tile.ref, 0, 0);
+                tile.ref = 0;
+            }
+            tile_state state = tile_state::empty;
+            if (tile.data) {
+                if (dtStatusFailed(nav->mesh->addTile(tile.data, tile.data_size, DT_TILE_FREE_DATA, 0, &tile.ref))) {
+                    ztd_error(__FUNCTION__, "Failed to add navmesh tile {} {}", tile.x, tile.z);
+                    dtFree(tile.data);
+                    tile.ref = 0;
+                } else {
+                    state = tile_state::live;
+                }
+            }
+            tile.data = 0;
+            tile.data_size = 0;
+            tile.state.store(state, std::memory_order_relaxed);
+            nav->stats.tiles_swapped++;
+        }
+    }
+
+    // any thread, returns 0 if the request wasnt queued, the path is left alone so it can be asked again
+    inline b32
+    navigation_request_path(navigation_t* nav, v3f start, v3f end, ai_path_t* path, f32 time) {
+        if (!nav || path->status == ai_path_status::pending) {
+            return 0;
+        }
+        const u32 slot = nav->incoming_count.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= navigation_t::request_capacity) {
+            return 0;
+        }
+        const u32 ticket = nav->next_ticket.fetch_add(1, std::memory_order_relaxed) + 1;
+        nav->incoming[slot] = path_request_t{start, end, path, ticket};
+
+        path->status = ai_path_status::pending;
+        path->request = ticket;
+        path->goal = end;
+        path->time = time;
+        return 1;
+    }
+
+    // main thread
+    inline ai_path_status
+    navigation_find_path(navigation_t* nav, v3f start, v3f end, ai_path_t* out) {
+        out->path.clear();
+        out->next = 0;
+        if (!nav->mesh) {
+            return ai_path_status::failed;
+        }
+
+        const f32 extents[3] = {2.0f, 4.0f, 2.0f};
+        dtPolyRef start_ref{0}, end_ref{0};
+        v3f start_point{}, end_point{};
+        if (dtStatusFailed(nav->query->findNearestPoly(&start.x, extents, &nav->filter, &start_ref, &start_point.x)) || !start_ref ||
+            dtStatusFailed(nav->query->findNearestPoly(&end.x, extents, &nav->filter, &end_ref, &end_point.x)) || !end_ref
+        ) {
+            return ai_path_status::failed;
+        }
+
+        dtPolyRef polys[navigation_t::max_path_polys];
+        i32 poly_count{0};
+        const dtStatus status = nav->query->findPath(start_ref, end_ref, &start_point.x, &end_point.x, &nav->filter, polys, &poly_count, navigation_t::max_path_polys);
+        if (dtStatusFailed(status) || poly_count == 0) {
+            return ai_path_status::failed;
+        }
+
+        const b32 partial = dtStatusDetail(status, DT_PARTIAL_RESULT) || polys[poly_count - 1] != end_ref;
+        if (partial) {
+            nav->query->closestPointOnPoly(polys[poly_count - 1], &end_point.x, &end_point.x, 0);
+        }
+
+        constexpr i32 max_corners = (i32)ai_path_t::max_points;
+        v3f corners[max_corners];
+        i32 corner_count{0};
+        if (dtStatusFailed(nav->query->findStraightPath(&start_point.x, &end_point.x, polys, poly_count, &corners[0].x, 0, 0, &corner_count, max_corners))) {
+            return ai_path_status::failed;
+        }
+        for (i32 i = 0; i < corner_count; i++) {
+            out->path.push(corners[i]);
+        }
+        return partial ? ai_path_status::partial : ai_path_status::found;
+    }
+
+    // main thread, builds the tiles no worker took until the budget runs out, at least one per call
+    inline void
+    navigation_build_local_tiles(navigation_t* nav, std::chrono::high_resolution_clock::time_point start, std::chrono::duration<f32, std::milli> budget) {
+        if (nav->local_builds == 0) return;
+        TIMED_FUNCTION;
+        range_u32(i, 0, (u32)(nav->tile_count_x * nav->tile_count_z)) {
+            auto* tile = nav->tiles + i;
+            if (!tile->local) continue;
+            tile->local = 0;
+            nav->local_builds--;
+            navigation_build_tile(nav, tile);
+            if (nav->local_builds == 0 || std::chrono::high_resolution_clock::now() - start > budget) {
+                break;
+            }
+        }
+    }
+
+    // main thread, after the brains are done for the frame. builds pending tiles if there are no workers,
+    // then solves queued paths until budget_ms runs out, at least one request is solved every call so 
+    // the queue always drains
+    inline void
+    navigation_update(navigation_t* nav, f32 budget_ms) {
+        TIMED_FUNCTION;
+        const auto start = std::chrono::high_resolution_clock::now();
+        const auto budget = std::chrono::duration<f32, std::milli>(budget_ms);
+        navigation_build_local_tiles(nav, start, budget);
+        navigation_swap_tiles(nav);
+
+        const u32 incoming = std::min(nav->incoming_count.exchange(0, std::memory_order_acquire), navigation_t::request_capacity);
+        range_u32(i, 0, incoming) {
+            const auto& request = nav->incoming[i];
+            if (nav->pending_count == navigation_t::request_capacity) {
+                // let the brain ask again
+                if (request.path->request == request.ticket) {
+                    request.path->status = ai_path_status::none;
+                }
+                nav->stats.dropped_requests++;
+                continue;
+            }
+            nav->pending[(nav->pending_head + nav->pending_count++) % navigation_t::request_capacity] = request;
+        }
+
+        nav->stats.paths_solved = 0;
+        while (nav->pending_count) {
+            const auto request = nav->pending[nav->pending_head];
+            nav->pending_head = (nav->pending_head + 1) % navigation_t::request_capacity;
+            nav->pending_count--;
+
+            // the brain asked again or the entity was reused
+            if (request.path->request != request.ticket) {
+                continue;
+            }
+
+            request.path->status = navigation_find_path(nav, request.start, request.end, request.path);
+            nav->stats.paths_solved++;
+
+            if (std::chrono::high_resolution_clock::now() - start > budget) {
+                break;
+            }
+        }
+        nav->stats.paths_waiting = nav->pending_count;
+    }
+}
@@ -6,6 +6,7 @@
 #include "App/Game/Entity/entity.hpp"
 #include "App/Game/Entity/ztd_entity_prefab.hpp"
 #include "App/Game/Rendering/render_system.hpp"
+#include "App/Game/World/navigation.hpp"
 
 
 struct game_state_t;
@@ -15,13 +16,13 @@ struct world_generator_t;
 namespace ztd {
 
     enum physics_layers : u32 {
-        none = 0ui32,
-        player = 1ui32,
-        enemy = 2ui32,
-        player_bullets = 4ui32,
-        enemy_bullets = 8ui32,
-        environment = (1ui32 << 31ui32),
-        everything = 0xffff'ffffui32,        
+        none = 0u,
+        player = 1u,
+        enemy = 2u,
+        player_bullets = 4u,
+        enemy_bullets = 8u,
+        environment = (1u << 31u),
+        everything = 0xffff'ffffu,        
     };
 
     constexpr u32 player_collision_group = ~physics_layers::player_bullets;
@@ -45,13 +46,33 @@ namespace ztd {
 
     static constexpr u64 max_entities = 15000;
 
+    // Note(Zack): packed lists so passes only walk the live entities instead of every slot up
+    // to entity_capacity. alive is kept up to date on create and destroy, the others are rebuilt
+    // from it into the frame arena the first time they are asked for after anything changed.
+    enum entity_list {
+        entity_list_alive,
+        entity_list_kinematic,
+        entity_list_brain,
+        entity_list_renderable,
+        entity_list_particle,
+        entity_list_SIZE
+    };
+
+    struct entity_list_t {
+        entity_t**  entities{0};
+        u32         count{0};
+
+        entity_t** begin() const { return entities; }
+        entity_t** end() const { return entities + count; }
+    };
+
     struct entity_block_t {
         entity_block_t* next;
         entity_block_t* prev;
 
         entity_id   id;
         entity_t    entities[32];
-        u32         free_mask{~0ui32};
+        u32         free_mask{~0u};
 
         math::rect3d_t aabb;
 
@@ -61,7 +82,7 @@ namespace ztd {
                     return i;
                 }
             }
-            return ~0ui32;
+            return ~0u;
         }
     };
 
@@ -116,7 +137,15 @@ namespace ztd {
         game_state_t* game_state;
 
         luau::vm_t L{};
-        luau::bytecode_t world_code = {};
+        luau::bytecode_t world_code = {}; // entity hook dispatcher, compiled once
+
+        luau::ref_t script_update{};    // _world.update
+        luau::ref_t script_dispatch{};  // calls every entity hook from one pcall
+        luau::ref_t script_hooks{};     // entity -> hook function
+        luau::ref_t script_pending_hooks{}; // hooks set during dispatch, merged once it returns
+        u32         script_hook_count{0};
+        u32         script_pending_count{0};
+        b32         script_dispatching{0};
 
         arena_t arena;
         arena_t particle_arena;
@@ -131,8 +160,19 @@ namespace ztd {
         ztd::entity_t* entity_id_hash[max_entities*2];
         ztd::entity_t* free_entities{0};
 
+        ztd::entity_t* alive_entities[max_entities]; // dying entities stay until world_kill_free_queue
+        u32            alive_count{0};
+        entity_list_t  entity_lists[entity_list_SIZE]{};
+        b32            entity_lists_dirty{1};
+
         event_t* events{0};
 
+        // per job thread scratch, index 0 is the main thread and uses the members above
+        utl::job_system_t* jobs{0};
+        frame_arena_t   job_frame_arenas[utl::job_max_threads];
+        event_t*        job_events[utl::job_max_threads]{};
+        u64             frame_seed{0}; // for rngs that cant share entropy across threads
+
         // umm           brain_count{0};
         umm           brain_capacity{0};
         // brain_t  brains[4096];
@@ -150,14 +190,27 @@ namespace ztd {
 
         particle_cache_t* particle_cache{0};
 
+        wep::projectile_pool_t* projectiles{0};
+
+        nav::navigation_t* navigation{0};
+
         struct effects_buffer_t {
             m44* blood_splats{0};
             rendering::instance_extra_data_t* blood_colors{0};
             u32 blood_entity{0};
             umm blood_splat_count{0};
             umm blood_splat_max{0};
+
+            m44* projectile_instances{0}; // one per pool slot, right after the blood splats
+            u32 projectile_entity{0};
         } effects;
 
+        // stands in for the render system's instance buffers when the game runs headless
+        struct headless_scene_t {
+            utl::pool_t<m44> instances;
+            utl::pool_t<rendering::instance_extra_data_t> instance_colors;
+        } headless;
+
         f32 time() const {
             return game_state->time;
         }
@@ -171,19 +224,52 @@ namespace ztd {
         // world_t() = default;
     };
 
+    inline utl::pool_t<m44>&
+    world_instance_pool(world_t* world) {
+        auto* rs = world->render_system();
+        return rs ? rs->scene_context->instance_storage_buffer.pool : world->headless.instances;
+    }
+
+    inline utl::pool_t<rendering::instance_extra_data_t>&
+    world_instance_color_pool(world_t* world) {
+        auto* rs = world->render_system();
+        return rs ? rs->scene_context->instance_color_storage_buffer.pool : world->headless.instance_colors;
+    }
+
+    inline arena_t*
+    world_frame_arena(world_t* world) {
+        const u32 thread = utl::job_thread_index;
+        return thread ? &world->job_frame_arenas[thread].get() : &world->frame_arena.get();
+    }
+
     event_t* new_event(world_t* world, entity_t* entity, event_type type) {
-        auto* arena = &world->frame_arena.get();
+        auto* arena = world_frame_arena(world);
 
         tag_struct(auto* event, event_t, arena);
 
         event->type = type;
         event->entity = entity;
 
-        node_push(event, world->events);
+        if (const u32 thread = utl::job_thread_index) {
+            node_push(event, world->job_events[thread]);
+        } else {
+            node_push(event, world->events);
+        }
 
         return event;
     }
 
+    // call on the main thread once jobs that can make events are done
+    static void
+    world_merge_job_events(world_t* world) {
+        range_u32(t, 1, utl::job_max_threads) {
+            while (auto* event = world->job_events[t]) {
+                world->job_events[t] = event->next;
+                node_push(event, world->events);
+            }
+        }
+    }
+
     static void 
     add_entity_to_id_hash(world_t* world, entity_t* entity) {
         // todo(zack): better hash,
@@ -207,31 +293,85 @@ namespace ztd {
     // }
 
 
-    static entity_t*
-    world_create_entity(world_t* world) {
+    static void
+    world_add_alive_entity(world_t* world, entity_t* entity) {
+        assert(world->alive_count < array_count(world->alive_entities));
+        entity->alive_index = world->alive_count;
+        world->alive_entities[world->alive_count++] = entity;
+        world->entity_lists_dirty = 1;
+    }
+
+    static void
+    world_remove_alive_entity(world_t* world, entity_t* entity) {
+        const u32 index = entity->alive_index;
+        assert(index < world->alive_count && world->alive_entities[index] == entity);
+        auto* last = world->alive_entities[--world->alive_count];
+        world->alive_entities[index] = last;
+        last->alive_index = index;
+        world->entity_lists_dirty = 1;
+    }
+
+    // the returned list stays valid for the rest of the frame, entities created while walking it
+    // are not in it. only alive is kept live and it is safe to walk while creating entities.
+    static entity_list_t
+    world_entities(world_t* world, entity_list list) {
+        if (list == entity_list_alive) {
+            return entity_list_t{world->alive_entities, world->alive_count};
+        }
+        if (world->entity_lists_dirty) {
+            TIMED_BLOCK(WorldRebuildEntityLists);
+            auto* arena = &world->frame_arena.get();
+            range_u32(l, entity_list_kinematic, entity_list_SIZE) {
+                world->entity_lists[l].entities = push_struct<entity_t*>(arena, world->alive_count);
+                world->entity_lists[l].count = 0;
+            }
+            range_u32(i, 0, world->alive_count) {
+                auto* e = world->alive_entities[i];
+                auto push = [&](entity_list l) {
+                    world->entity_lists[l].entities[world->entity_lists[l].count++] = e;
+                };
+                if (e->physics.rigidbody && (e->physics.flags & PhysicsEntityFlags_Kinematic)) push(entity_list_kinematic);
+                if (e->brain_id != uid::invalid_id) push(entity_list_brain);
+                if (e->is_renderable()) push(entity_list_renderable);
+                if (e->gfx.particle_system) push(entity_list_particle);
+            }
+            world->entity_lists_dirty = 0;
+        }
+        return world->entity_lists[list];
+    }
+
+    // fills entities with count new entities, the free list is used up first and the rest
+    // come off the end of the entity array in one go
+    static void
+    world_create_entities(world_t* world, entity_t** entities, u32 count) {
         TIMED_FUNCTION;
         assert(world);
-        assert(world->entity_capacity < array_count(world->entities));
-        entity_t* e{0};
+        u32 created = 0;
+        while (created < count && world->free_entities) {
+            node_pop(entities[created], world->free_entities);
+            assert(entities[created]);
+            created++;
+        }
+        assert(world->entity_capacity + (count - created) <= array_count(world->entities));
+        while (created < count) {
+            entities[created++] = world->entities + world->entity_capacity++;
+        }
+        world->entity_count += count;
 
-        if (world->free_entities) {
-            node_pop(e, world->free_entities);
-            world->entity_count++;
-            assert(e);
-            new (e) entity_t;
-            e->id = world->next_entity_id++;
-            add_entity_to_id_hash(world, e);
-        } else {
-            e = world->entities + world->entity_capacity++;
-            world->entity_count++;
-            assert(e);
+        range_u32(i, 0, count) {
+            auto* e = entities[i];
             new (e) entity_t;
             e->id = world->next_entity_id++;
             add_entity_to_id_hash(world, e);
+            e->world = world;
+            world_add_alive_entity(world, e);
         }
+    }
 
-        e->world = world;
-        // e->gfx.particle_system = 0;
+    static entity_t*
+    world_create_entity(world_t* world) {
+        entity_t* e{0};
+        world_create_entities(world, &e, 1);
         return e;
     }
 
@@ -246,26 +386,124 @@ namespace ztd {
         assert(world);
 
         entity->brain.type = type;
-        brain_init(&world->arena, entity, &entity->brain);
+
+        // blackboards insert keys while ticking on job threads, so they cant share the world arena
+        arena_t* brain_arena = &world->arena;
+        if (type == brain_type::person) {
+            tag_struct(brain_arena, arena_t, &world->arena, arena_sub_arena(&world->arena, kilobytes(16)));
+        }
+        brain_init(brain_arena, entity, &entity->brain);
         auto brain_id = entity->brain.id = entity->brain_id = world_new_brain(world, type);
         ztd_info(__FUNCTION__, "Brain {} activated", brain_id);
     }
         
+    // returns 0 if the prefab has no rigidbody
+    inline b32
+    prefab_rigidbody_type(const ztd::prefab_t& def, physics::rigidbody_type* type) {
+        if (!def.physics) return 0;
+        const auto flags = def.physics->flags;
+        if (flags & PhysicsEntityFlags_Character) {
+            *type = physics::rigidbody_type::CHARACTER;
+        } else if (flags & (PhysicsEntityFlags_Static | PhysicsEntityFlags_Trigger)) {
+            *type = physics::rigidbody_type::STATIC;
+        } else if (flags & PhysicsEntityFlags_Kinematic) {
+            *type = physics::rigidbody_type::KINEMATIC;
+        } else if (flags & PhysicsEntityFlags_Dynamic) {
+            *type = physics::rigidbody_type::DYNAMIC;
+        } else {
+            return 0;
+        }
+        return 1;
+    }
+
+    struct world_mesh_geometry_t {
+        v3f* vertices{0};
+        u32  vertex_count{0};
+        u32* indices{0};
+        u32  index_count{0};
+    };
+
+    // Note(Zack): The custom physics backend cant read the physx cooked meshes, its convex and trimesh
+    // colliders are built from the render mesh in res.pack instead, same geometry the navmesh bakes.
+    // Read straight from the pack since headless has no render system, indices are rebased so
+    // every mesh in the file ends up in one list.
+    static world_mesh_geometry_t
+    world_load_mesh_geometry(arena_t* arena, utl::res::pack_file_t* resource_file, std::string_view mesh_name) {
+        world_mesh_geometry_t result{};
+        std::byte* file_data = mesh_name.empty() ? nullptr : utl::res::pack_file_get_file_by_name(resource_file, mesh_name);
+        if (file_data == nullptr) {
+            return result;
+        }
+
+        const auto read_header = [](utl::memory_blob_t& blob) -> u64 {
+            const auto meta = blob.deserialize<u64>();
+            const auto vers = blob.deserialize<u64>();
+            const auto mesh = blob.deserialize<u64>();
+            if (meta != utl::res::magic::meta || vers != utl::res::magic::vers || mesh != utl::res::magic::mesh) {
+                return 0;
+            }
+            return blob.deserialize<u64>();
+        };
+
+        utl::memory_blob_t blob{file_data};
+        const u64 mesh_count = read_header(blob);
+        range_u64(m, 0, mesh_count) {
+            blob.deserialize<std::string>();
+            const u64 vertex_count = blob.deserialize<u64>();
+            blob.advance(sizeof(gfx::vertex_t) * vertex_count);
+            const u64 index_count = blob.deserialize<u64>();
+            blob.advance(sizeof(u32) * index_count);
+            result.vertex_count += safe_truncate_u64(vertex_count);
+            result.index_count += safe_truncate_u64((index_count / 3) * 3);
+        }
+        if (result.vertex_count == 0) {
+            return result;
+        }
+
+        result.vertices = push_struct<v3f>(arena, result.vertex_count);
+        result.indices = push_struct<u32>(arena, result.index_count);
+
+        blob = utl::memory_blob_t{file_data};
+        read_header(blob);
+        u32 v = 0;
+        u32 t = 0;
+        range_u64(m, 0, mesh_count) {
+            blob.deserialize<std::string>();
+            const u64 vertex_count = blob.deserialize<u64>();
+            const auto* vertices = (const gfx::vertex_t*)blob.read_data();
+            range_u64(k, 0, vertex_count) {
+                result.vertices[v + k] = vertices[k].pos;
+            }
+            blob.advance(sizeof(gfx::vertex_t) * vertex_count);
+
+            const u64 index_count = blob.deserialize<u64>();
+            const auto* indices = (const u32*)blob.read_data();
+            range_u64(k, 0, (index_count / 3) * 3) {
+                result.indices[t++] = v + indices[k];
+            }
+            blob.advance(sizeof(u32) * index_count);
+            v += safe_truncate_u64(vertex_count);
+        }
+        assert(v == result.vertex_count && t == result.index_count);
+        return result;
+    }
+
+    // entity comes from world_create_entity(s), rb is 0 unless the caller already batch created it
     static entity_t*
-    spawn(
+    spawn_into(
         world_t* world,
         rendering::system_t* rs,
         const ztd::prefab_t& def,
-        const v3f& pos = {},
-        const m33& basis = m33{1.0f}
+        entity_t* entity,
+        physics::rigidbody_t* rb,
+        const v3f& pos,
+        const m33& basis
     ) {
         using namespace std::string_view_literals;
         TIMED_FUNCTION;
         utl::res::pack_file_t* resource_file = world->game_state->resource_file;
         auto* mod_loader = &world->game_state->modding.loader;
 
-        entity_t* entity = world_create_entity(world);
-
         entity->coroutine = std::nullopt;
 
         assert(entity);
@@ -274,15 +512,15 @@ namespace ztd {
         assert(entity->first_child == nullptr);
         assert(entity->next_child == nullptr);
 
-        entity_init(entity, rendering::get_mesh_id(rs, def.gfx.mesh_name.view()));
+        entity_init(entity, rs ? rendering::get_mesh_id(rs, def.gfx.mesh_name.view()) : u64(-1));
 
         entity->flags = def.flags;
 
         entity->gfx.material_id = def.gfx.material_id;
-        entity->gfx.gfx_id  = rendering::register_entity(rs);
+        entity->gfx.gfx_id  = rs ? rendering::register_entity(rs) : 0;
         entity->gfx.gfx_entity_count = 1;
 
-        if (def.gfx.albedo_texture != ""sv) {
+        if (rs && def.gfx.albedo_texture != ""sv) {
             auto aid = (u32)rs->texture_cache.get_id(def.gfx.albedo_texture.view());
             if (aid == 0) {
                 tag_array(auto* texture, char, &rs->arena, def.gfx.albedo_texture.size()+1);
@@ -293,7 +531,7 @@ namespace ztd {
             entity->gfx.albedo_id = aid;
         }
 
-        if (def.gfx.mesh_name != ""sv) {
+        if (rs && def.gfx.mesh_name != ""sv) {
             auto& mesh_list = rendering::get_mesh(rs, def.gfx.mesh_name.view());
             entity->gfx.gfx_entity_count = (u32)mesh_list.count;
 
@@ -329,13 +567,14 @@ namespace ztd {
         }
 
         if (def.emitter) {
-            entity->gfx.particle_system = particle_system_create(&world->particle_arena, def.emitter->max_count);
-            entity->gfx.instance(
-                world->render_system()->scene_context->instance_storage_buffer.pool,
-                world->render_system()->scene_context->instance_color_storage_buffer.pool, def.emitter->max_count, 1);
+            // seeded from the world so a seeded world replays its particles too
+            entity->gfx.particle_system = particle_system_create(&world->particle_arena, def.emitter->max_count, 0, world->entropy.rand());
+            entity->gfx.instance(world_instance_pool(world), world_instance_color_pool(world), def.emitter->max_count, 1);
 
-            range_u32(gi, 0, entity->gfx.gfx_entity_count) {
-                rendering::set_entity_instance_data(rs, entity->gfx.gfx_id + gi, entity->gfx.instance_offset(0), def.emitter->max_count);
+            if (rs) {
+                range_u32(gi, 0, entity->gfx.gfx_entity_count) {
+                    rendering::set_entity_instance_data(rs, entity->gfx.gfx_id + gi, entity->gfx.instance_offset(0), def.emitter->max_count);
+                }
             }
 
             particle_system_settings_t& settings = *entity->gfx.particle_system;
@@ -351,7 +590,7 @@ namespace ztd {
                 player_init(
                     entity,
                     &world->camera, 
-                    def.gfx.mesh_name.view() != ""sv ? rendering::get_mesh_id(rs, def.gfx.mesh_name.view()) : 0
+                    rs && def.gfx.mesh_name.view() != ""sv ? rendering::get_mesh_id(rs, def.gfx.mesh_name.view()) : 0
                 );
                 world->player = entity;
             } break;
@@ -384,15 +623,9 @@ namespace ztd {
         }
 
         if (def.physics) {
-            physics::rigidbody_t* rb{0};
-            if (def.physics->flags & PhysicsEntityFlags_Character) {
-                rb = world->physics->create_rigidbody(world->physics, entity, physics::rigidbody_type::CHARACTER, entity->transform.origin, entity->transform.get_orientation());
-            } else if (def.physics->flags & (PhysicsEntityFlags_Static | PhysicsEntityFlags_Trigger)) {
-                rb = world->physics->create_rigidbody(world->physics, entity, physics::rigidbody_type::STATIC, entity->transform.origin, entity->transform.get_orientation());
-            } else if (def.physics->flags & PhysicsEntityFlags_Kinematic) {
-                rb = world->physics->create_rigidbody(world->physics, entity, physics::rigidbody_type::KINEMATIC, entity->transform.origin, entity->transform.get_orientation());
-            } else if (def.physics->flags & PhysicsEntityFlags_Dynamic) {
-                rb = world->physics->create_rigidbody(world->physics, entity, physics::rigidbody_type::DYNAMIC, entity->transform.origin, entity->transform.get_orientation());
+            physics::rigidbody_type rb_type;
+            if (rb == nullptr && prefab_rigidbody_type(def, &rb_type)) {
+                rb = world->physics->create_rigidbody(world->physics, entity, rb_type, entity->transform.origin, entity->transform.get_orientation());
             }
             if (!rb) {
                 ztd_error(__FUNCTION__, "Failed to spawn rigidbody!");
@@ -406,8 +639,8 @@ namespace ztd {
             rb->on_trigger = def.physics->on_trigger.get(mod_loader);
             rb->on_trigger_end = def.physics->on_trigger_end.get(mod_loader);
             
-            rb->position = pos;
-            rb->orientation = entity->global_transform().get_orientation();
+            rb->position() = pos;
+            rb->orientation() = entity->global_transform().get_orientation();
             std::string collider_name;
             for (size_t i = 0; i < array_count(def.physics->shapes); i++) {
                 if (def.physics->shapes[i] == std::nullopt) continue;
@@ -421,7 +654,21 @@ namespace ztd {
                         collider_name = fmt_str("{}.convex.physx", def.gfx.mesh_name.data());
                         physics::collider_convex_info_t ci;
                         ci.mesh = utl::res::pack_file_get_file_by_name(resource_file, collider_name);
-                        if (ci.mesh == nullptr) {
+                        if (world->physics->type == physics::backend_type::CUSTOM) {
+                            const auto geometry = world_load_mesh_geometry(&world->frame_arena.get(), resource_file, def.gfx.mesh_name.view());
+                            ci.mesh = nullptr;
+                            ci.size = 0;
+                            ci.vertices = geometry.vertices;
+                            ci.vertex_count = geometry.vertex_count;
+                            if (ci.vertices == nullptr) {
+                                ztd_warn(__FUNCTION__, "Error loading convex mesh geometry: {}", def.gfx.mesh_name.view());
+                            } else {
+                                collider = world->physics->create_collider(
+                                    world->physics,
+                                    rb, shape, &ci
+                                );
+                            }
+                        } else if (ci.mesh == nullptr) {
                             ztd_warn(__FUNCTION__, "Error loading convex physics mesh: {}", collider_name);
                         } else {
                             ci.size = safe_truncate_u64(utl::res::pack_file_get_file_size(resource_file, collider_name));
@@ -435,7 +682,23 @@ namespace ztd {
                         collider_name = fmt_str("{}.trimesh.physx", def.gfx.mesh_name.data());
                         physics::collider_trimesh_info_t ci;
                         ci.mesh = utl::res::pack_file_get_file_by_name(resource_file, collider_name);
-                        if (ci.mesh == nullptr) {
+                        if (world->physics->type == physics::backend_type::CUSTOM) {
+                            const auto geometry = world_load_mesh_geometry(&world->frame_arena.get(), resource_file, def.gfx.mesh_name.view());
+                            ci.mesh = nullptr;
+                            ci.size = 0;
+                            ci.vertices = geometry.vertices;
+                            ci.vertex_count = geometry.vertex_count;
+                            ci.indices = geometry.indices;
+                            ci.index_count = geometry.index_count;
+                            if (ci.vertices == nullptr || ci.index_count == 0) {
+                                ztd_warn(__FUNCTION__, "Error loading trimesh mesh geometry: {}", def.gfx.mesh_name.view());
+                            } else {
+                                collider = world->physics->create_collider(
+                                    world->physics,
+                                    rb, shape, &ci
+                                );
+                            }
+                        } else if (ci.mesh == nullptr) {
                             ztd_warn(__FUNCTION__, "Error loading trimesh physics mesh: {}", collider_name);
                         } else {
                             ci.size = safe_truncate_u64(utl::res::pack_file_get_file_size(resource_file, collider_name));
@@ -498,7 +761,7 @@ namespace ztd {
 
         range_u64(i, 0, def.children.size()) {
             if (def.children[i].entity) {
-                auto child = spawn(world, rs, *def.children[i].entity);
+                auto child = spawn_into(world, rs, *def.children[i].entity, world_create_entity(world), nullptr, v3f{}, m33{1.0f});
                 entity->add_child(child);
                 child->transform.origin = def.children[i].offset;
             }
@@ -507,6 +770,17 @@ namespace ztd {
         return entity;
     }
 
+    static entity_t*
+    spawn(
+        world_t* world,
+        rendering::system_t* rs,
+        const ztd::prefab_t& def,
+        const v3f& pos = {},
+        const m33& basis = m33{1.0f}
+    ) {
+        return spawn_into(world, rs, def, world_create_entity(world), nullptr, pos, basis);
+    }
+
     static entity_t*
     tag_spawn_(
         world_t* world,
@@ -518,6 +792,7 @@ namespace ztd {
         const v3f& pos = {},
         const m33& basis = m33{1.0f}
     ) {
+        TIMED_BLOCK(WorldSpawn);
         auto* e = spawn(world, world->render_system(), def, pos, basis);
         e->_DEBUG_meta = ztd::DEBUG_entity_meta_info_t {
             .prefab_name = prefab_name,
@@ -535,14 +810,120 @@ namespace ztd {
 
 namespace ztd {
 
+    // Note(Zack): entity hooks live in one lua table keyed by entity, a small compiled dispatcher
+    // walks it so the whole batch costs a single pcall per frame instead of one per entity
+    constexpr std::string_view world_entity_hook_dispatcher = R"(
+return function(hooks, dt: number)
+    for entity, hook in hooks do
+        hook(entity, dt)
+    end
+end
+)";
+
+    static void
+    world_init_scripts(world_t* world) {
+        auto& L = world->L;
+        if (world->world_code.bytecode == nullptr) {
+            world->world_code.bytecode = luau_compile(
+                world_entity_hook_dispatcher.data(), world_entity_hook_dispatcher.size(), 0, &world->world_code.length
+            );
+            assert(world->world_code.bytecode);
+        }
+        L.load_ref(world->world_code, &world->script_dispatch);
+
+        lua_newtable(L.L);
+        L.make_ref(&world->script_hooks);
+        lua_newtable(L.L);
+        L.make_ref(&world->script_pending_hooks);
+        world->script_hook_count = 0;
+        world->script_pending_count = 0;
+    }
+
+    // expects the hook function on top of the lua stack and pops it, no hook clears it
+    // Note(Zack): lua only allows clearing keys of a table that is being walked, so hooks set
+    // while the dispatcher runs are queued in script_pending_hooks and merged after it returns
+    static void
+    world_set_entity_hook(world_t* world, entity_t* e, b32 has_hook = 0) {
+        auto* L = world->L.L;
+        if (!has_hook) {
+            lua_pushnil(L);
+        }
+        const b32 queue_hook = has_hook && world->script_dispatching;
+        world->L.push(queue_hook ? world->script_pending_hooks : world->script_hooks);
+        lua_pushlightuserdata(L, e);
+        lua_pushvalue(L, -3);
+        lua_rawset(L, -3);
+        lua_pop(L, 2);
+
+        if (queue_hook) {
+            world->script_pending_count++;
+        } else if (!has_hook && world->script_pending_count) {
+            // a clear wins over anything queued earlier in the same dispatch
+            world->L.push(world->script_pending_hooks);
+            lua_pushlightuserdata(L, e);
+            lua_pushnil(L);
+            lua_rawset(L, -3);
+            lua_pop(L, 1);
+        }
+
+        if (has_hook && (e->flags & EntityFlags_ScriptHook) == 0) {
+            e->flags |= EntityFlags_ScriptHook;
+            world->script_hook_count++;
+        } else if (!has_hook && (e->flags & EntityFlags_ScriptHook)) {
+            e->flags &= ~EntityFlags_ScriptHook;
+            world->script_hook_count--;
+        }
+    }
+
+    static void
+    world_merge_pending_hooks(world_t* world) {
+        auto* L = world->L.L;
+        world->L.push(world->script_hooks);
+        world->L.push(world->script_pending_hooks);
+        lua_pushnil(L);
+        while (lua_next(L, -2)) {
+            // hooks pending key value -> hooks pending key key value
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, -5);
+        }
+        lua_pop(L, 2);
+
+        lua_newtable(L);
+        world->L.make_ref(&world->script_pending_hooks);
+        world->script_pending_count = 0;
+    }
+
+    static void
+    world_update_scripts(world_t* world, f32 dt) {
+        TIMED_FUNCTION;
+        auto& L = world->L;
+        if (L.resolve(&world->script_update, "_world", "update")) {
+            L.call(world->script_update, dt);
+        }
+        if (world->script_hook_count) {
+            world->script_dispatching = 1;
+            L.call(world->script_dispatch, world->script_hooks, dt);
+            world->script_dispatching = 0;
+        }
+        if (world->script_pending_count) {
+            world_merge_pending_hooks(world);
+        }
+    }
+
     static void 
     world_free(world_t*& world) {
+        nav::navigation_destroy(world->navigation, world->jobs);
         arena_clear(&world->particle_arena);
-        arena_clear(&world->L.user_data.allocator.arena);
+        world->L.user_data.allocator.clear();
+        free(world->world_code.bytecode);
+        world->world_code = {};
         
-        world->render_system()->scene_context->instance_storage_buffer.pool.clear();
-        world->render_system()->scene_context->entities.pool.clear();
-        world->render_system()->scene_context->entity_count = 0;
+        if (auto* rs = world->render_system()) {
+            rs->scene_context->instance_storage_buffer.pool.clear();
+            rs->scene_context->entities.pool.clear();
+            rs->scene_context->entity_count = 0;
+        }
         
         arena_clear(&world->arena);
         world = nullptr;
@@ -550,17 +931,35 @@ namespace ztd {
 
     void world_init_effects(world_t* world) {
         auto* rs = world->render_system();
-        rs->scene_context->instance_storage_buffer.pool.clear();
-        rs->scene_context->instance_color_storage_buffer.pool.clear();
-        world->effects.blood_splats = rs->scene_context->instance_storage_buffer.pool.allocate(world->effects.blood_splat_max = 1024*2);
-        world->effects.blood_colors = rs->scene_context->instance_color_storage_buffer.pool.allocate(world->effects.blood_splat_max);
+        auto& instances = world_instance_pool(world);
+        auto& instance_colors = world_instance_color_pool(world);
+        instances.clear();
+        instance_colors.clear();
+        world->effects.blood_splats = instances.allocate(world->effects.blood_splat_max = 1024*2);
+        world->effects.blood_colors = instance_colors.allocate(world->effects.blood_splat_max);
         std::fill(world->effects.blood_colors, world->effects.blood_colors + world->effects.blood_splat_max + 1, rendering::instance_extra_data_t{});
+
+        constexpr u32 projectile_max = wep::projectile_pool_t::capacity;
+        world->effects.projectile_instances = instances.allocate(projectile_max);
+        auto* projectile_colors = instance_colors.allocate(projectile_max);
+        std::fill(projectile_colors, projectile_colors + projectile_max, rendering::instance_extra_data_t{});
+
+        if (rs == nullptr) {
+            return;
+        }
+
         auto blood_id = world->effects.blood_entity = rendering::register_entity(rs);
         auto blood_mid = rendering::get_mesh_id(rs, "res/models/misc/bloodsplat_02.gltf");
         auto& mesh = rendering::get_mesh(rs, blood_mid);
         rendering::initialize_entity(rs, blood_id, mesh.meshes->vertex_start, mesh.meshes->index_start);
         rendering::set_entity_material(rs, blood_id, 9);
         rendering::set_entity_albedo(rs, blood_id, safe_truncate_u64(mesh.meshes->material.albedo_id));
+
+        auto projectile_id = world->effects.projectile_entity = rendering::register_entity(rs);
+        auto& projectile_mesh = rendering::get_mesh(rs, rendering::get_mesh_id(rs, "res/models/particles/particle_03.gltf"));
+        rendering::initialize_entity(rs, projectile_id, projectile_mesh.meshes->vertex_start, projectile_mesh.meshes->index_start);
+        rendering::set_entity_material(rs, projectile_id, 7); // unlit material @hardcode
+        rendering::set_entity_albedo(rs, projectile_id, safe_truncate_u64(projectile_mesh.meshes->material.albedo_id));
     }
     
     static world_t*
@@ -583,13 +982,31 @@ namespace ztd {
         world->frame_arena.arena[0] = arena_sub_arena(&world->arena, frame_arena_size);
         world->frame_arena.arena[1] = arena_sub_arena(&world->arena, frame_arena_size);
 
+        if (world->render_system() == nullptr) {
+            constexpr u32 headless_instance_count = 1 << 16;
+            tag_array(auto* instances, m44, &world->arena, headless_instance_count);
+            tag_array(auto* instance_colors, rendering::instance_extra_data_t, &world->arena, headless_instance_count);
+            world->headless.instances = utl::pool_t<m44>{instances, headless_instance_count};
+            world->headless.instance_colors = utl::pool_t<rendering::instance_extra_data_t>{instance_colors, headless_instance_count};
+        }
+
+        world->jobs = game_state->game_memory->jobs;
+        const u32 job_threads = world->jobs ? world->jobs->thread_count : 1;
+        range_u32(t, 1, job_threads) {
+            world->job_frame_arenas[t] = arena_create_frame_arena(&world->arena, kilobytes(64));
+        }
+
         world_init_effects(world);
 
+        tag_struct(world->projectiles, wep::projectile_pool_t, &world->arena);
+        world->navigation = nav::navigation_create(&world->arena);
+
         world->L.user_data.allocator.arena = arena_create(kilobytes(256));
-        world->L.user_data.allocator.arena.settings.alignment = 0;
+        world->L.user_data.allocator.arena.settings.alignment = 0; // class sizes keep blocks 16 byte aligned
 
         world->L.init(world);
         world->L.user_data.user_data = world;
+        world_init_scripts(world);
 
         world->L.makelibrary(world->L.loadfile("res/lua/world.lua"), "_World");
         // world->L.makelibrary(world->L.loadfile("res/lua/waveworld.lua"), "_Level");
@@ -622,7 +1039,31 @@ namespace ztd {
                 (u32)glm::min(world->effects.blood_splat_count, world->effects.blood_splat_max),
                 0
             );
-        } 
+        }
+    }
+
+    void world_render_projectiles(
+        world_t* world
+    ) {
+        const auto* pool = world->projectiles;
+        if (!pool || pool->count == 0) {
+            return;
+        }
+        auto* rs = world->render_system();
+        auto* instances = world->effects.projectile_instances;
+        range_u32(i, 0, pool->count) {
+            instances[i] = math::transform_t{pool->position[i]}.to_matrix();
+        }
+        const u32 instance_offset = safe_truncate_u64(u64(instances - &rs->scene_context->instance_storage_buffer.pool[0]));
+        rendering::submit_job(
+            rs,
+            rendering::get_mesh_id(rs, "res/models/particles/particle_03.gltf"),
+            7, // unlit material @hardcode
+            pool->count == 1 ? instances[0] : m44{1.0f}, // single instances use the job transform
+            world->effects.projectile_entity, 1,
+            pool->count,
+            instance_offset
+        );
     }
 
     // static world_t* 
@@ -674,11 +1115,9 @@ namespace ztd {
     static entity_t*
     find_entity_by_name(world_t* world, std::string_view name) {
         TIMED_FUNCTION;
-        range_u64(i, 0, world->entity_capacity) {
-            if (world->entities[i].is_alive()) {
-                if (world->entities[i].name.sv() == name) {
-                    return world->entities + i;
-                }
+        for (auto* e: world_entities(world, entity_list_alive)) {
+            if (e->is_alive() && e->name.sv() == name) {
+                return e;
             }
         }
          
@@ -706,10 +1145,17 @@ namespace ztd {
         world->frame_arena.active += 1;
         arena_clear(&world->frame_arena.get());
         world->events = 0;
+        range_u32(t, 1, utl::job_max_threads) {
+            auto& job_arena = world->job_frame_arenas[t];
+            job_arena.active = world->frame_arena.active;
+            if (job_arena.get().start) arena_clear(&job_arena.get());
+            world->job_events[t] = 0;
+        }
+        world->frame_seed = world->entropy.rand();
+        world->entity_lists_dirty = 1; // lists live in the frame arena we just cleared
         std::fill(world->render_groups.begin(), world->render_groups.end(), gfx::render_group_t{});
 
-        for (size_t i{0}; i < world->entity_capacity; i++) {
-            auto* e = world->entities + i;
+        for (auto* e: world_entities(world, entity_list_alive)) {
             if (e->is_alive() == false) {
                 continue;
             }
@@ -729,39 +1175,274 @@ namespace ztd {
     }
 
     static void
-    world_update_brain(world_t* world, entity_t* entity, f32 dt) {
+    world_update_brain(world_t* world, entity_t* entity, const brain_tunables_t& tunables, f32 dt) {
         auto* brain = &entity->brain;
         assert(brain && brain->id != uid::invalid_id && "Not a valid brain");
         
         switch(brain->type) {
-            case brain_type::player: player_behavior(world, entity, brain, dt); break;
-            case brain_type::flyer:  skull_behavior(world, entity, brain, dt); break;
-            case brain_type::person: person_behavior(world, entity, brain, dt); break;
+            case brain_type::player: player_behavior(world, entity, brain, tunables, dt); break;
+            case brain_type::flyer:  skull_behavior(world, entity, brain, tunables, dt); break;
+            case brain_type::person: person_behavior(world, entity, brain, tunables, dt); break;
             case_invalid_default;
         }
     }
 
+    // these brains only touch their own entity, blackboard and rigidbody velocity, anything shared
+    // is deferred to world_apply_brain so they can tick on job threads
+    inline b32
+    world_brain_is_parallel(brain_type type) {
+        return type == brain_type::flyer || type == brain_type::person;
+    }
+
+    // how far a brain looks around for enemies each tick, 0 if it doesnt
+    inline f32
+    world_brain_nearby_radius(brain_type type) {
+        switch (type) {
+            case brain_type::flyer:  return 120.0f;
+            case brain_type::person: return 20.0f;
+            default: return 0.0f;
+        }
+    }
+
+    // Note(Zack): every brains neighbourhood goes through one overlap_batch so the backend walks
+    // its broadphase once per frame, each brain then reads its slice from entity_t::nearby
+    // main thread, before the brains tick
     static void
-    world_update_kinematic_physics(world_t* world) {
+    world_query_brain_nearby(world_t* world, arena_t* arena, entity_t** brains, u64 brain_count) {
         TIMED_FUNCTION;
-        // const auto* input = &world->game_state->game_memory->input;
-        for (size_t i{0}; i < world->entity_capacity; i++) {
-            auto* e = world->entities + i;
-            if (e->is_alive() == false) {
+        auto* queries = push_struct<physics::overlap_query_t>(arena, brain_count);
+        auto* owners = push_struct<u64>(arena, brain_count);
+        u64 query_count = 0;
+        range_u64(b, 0, brain_count) {
+            auto* e = brains[b];
+            e->nearby = {};
+            const f32 radius = world_brain_nearby_radius(e->brain.type);
+            if (radius == 0.0f) {
                 continue;
             }
-            if (e->physics.flags & ztd::PhysicsEntityFlags_Dying) {
-                e->physics.flags = 0;
-                world->physics->remove_rigidbody(world->physics, e->physics.rigidbody);
-                e->physics.rigidbody = 0;
+            owners[query_count] = b;
+            queries[query_count++] = physics::overlap_query_t{
+                .type = physics::collider_shape_type::SPHERE,
+                .origin = e->global_transform().origin,
+                .radius = radius,
+            };
+        }
+        if (query_count == 0) {
+            return;
+        }
+
+        const u64 hit_capacity = query_count * nearby_hit_count;
+        auto* hits = push_struct<physics::overlap_batch_hit_t>(arena, hit_capacity);
+        const u64 hit_count = world->physics->overlap_batch({queries, query_count}, {hits, hit_capacity});
+
+        // hits are grouped by query in query order
+        for (u64 h = 0; h < hit_count;) {
+            const u32 q = hits[h].query;
+            u64 end = h + 1;
+            while (end < hit_count && hits[end].query == q) {
+                end++;
+            }
+            brains[owners[q]]->nearby = {hits + h, end - h};
+            h = end;
+        }
+    }
+
+    // main thread, after the parallel brain ticks
+    static void
+    world_apply_brain(world_t* world, entity_t* entity) {
+        auto* rb = entity->physics.rigidbody;
+        if (rb && (entity->physics.flags & PhysicsEntityFlags_SetVelocity)) {
+            rb->set_velocity(entity->physics.velocity);
+            entity->physics.flags &= ~PhysicsEntityFlags_SetVelocity;
+        }
+        if (rb && entity->brain.type == brain_type::person) {
+            entity->transform.look_at(entity->transform.origin + rb->velocity() * planes::xz);
+        }
+    }
+
+    template <typename BoxFn, typename MeshFn>
+    static void
+    world_for_each_navigation_shape(world_t* world, BoxFn&& box_fn, MeshFn&& mesh_fn) {
+        auto* rs = world->render_system();
+        range_u32(i, 0, world->alive_count) {
+            auto* e = world->alive_entities[i];
+            auto* rb = e->physics.rigidbody;
+            if (e->is_alive() == false || rb == nullptr ||
+                (e->physics.flags & PhysicsEntityFlags_Static) == 0 ||
+                (e->physics.flags & PhysicsEntityFlags_Trigger)
+            ) {
                 continue;
             }
-            if (e->physics.rigidbody && e->physics.flags & ztd::PhysicsEntityFlags_Kinematic) {
-                world->physics->set_rigidbody(0, e->physics.rigidbody);
-                e->transform.origin = e->physics.rigidbody->position;
-                e->transform.basis = glm::toMat3(e->physics.rigidbody->orientation);
+
+            const auto transform = e->global_transform();
+            b32 use_mesh = 0;
+            range_u64(c, 0, rb->collider_count) {
+                if (rb->colliders[c].type == physics::collider_shape_type::BOX) {
+                    box_fn(transform, rb->colliders[c].box);
+                } else {
+                    use_mesh = 1;
+                }
+            }
+            if (rs && use_mesh && e->gfx.mesh_id != -1) {
+                mesh_fn(transform, rendering::get_mesh(rs, e->gfx.mesh_id));
+            }
+        }
+    }
+
+    // Note(Zack): The navmesh is baked from the static rigidbodies. Box colliders are used as is,
+    // every other shape falls back to the render mesh since that is what the convex and trimesh
+    // colliders were cooked from.
+    static void
+    world_gather_navigation_geometry(world_t* world) {
+        TIMED_FUNCTION;
+        auto* rs = world->render_system();
+        // only the mesh fallback reads these and it never runs without a render system
+        const auto* vertices = rs ? rs->scene_context->vertices.pool.data() : nullptr;
+        const auto* indices = rs ? rs->scene_context->indices.pool.data() : nullptr;
+
+        constexpr i32 box_indices[] = {
+            1, 3, 7, 1, 7, 5,   0, 4, 6, 0, 6, 2,
+            2, 6, 7, 2, 7, 3,   0, 1, 5, 0, 5, 4,
+            4, 5, 7, 4, 7, 6,   0, 2, 3, 0, 3, 1,
+        };
+        constexpr u32 box_triangle_count = array_count(box_indices) / 3;
+
+        u32 vertex_count = 0;
+        u32 triangle_count = 0;
+        world_for_each_navigation_shape(world,
+            [&](const math::transform_t&, const math::rect3d_t&) {
+                vertex_count += 8;
+                triangle_count += box_triangle_count;
+            },
+            [&](const math::transform_t&, const gfx::mesh_list_t& mesh) {
+                range_u64(m, 0, mesh.count) {
+                    vertex_count += mesh.meshes[m].vertex_count;
+                    triangle_count += mesh.meshes[m].index_count / 3;
+                }
+            }
+        );
+
+        auto* geometry = nav::navigation_begin_geometry(world->navigation, vertex_count, triangle_count);
+        u32 v = 0;
+        u32 t = 0;
+        world_for_each_navigation_shape(world,
+            [&](const math::transform_t& transform, const math::rect3d_t& box) {
+                range_u32(k, 0, 8) {
+                    const v3f corner{
+                        (k & 1) ? box.max.x : box.min.x,
+                        (k & 2) ? box.max.y : box.min.y,
+                        (k & 4) ? box.max.z : box.min.z,
+                    };
+                    geometry->vertices[v + k] = transform.xform(corner);
+                    geometry->aabb.expand(geometry->vertices[v + k]);
+                }
+                range_u32(k, 0, array_count(box_indices)) {
+                    geometry->indices[t * 3 + k] = (i32)v + box_indices[k];
+                }
+                v += 8;
+                t += box_triangle_count;
+            },
+            [&](const math::transform_t& transform, const gfx::mesh_list_t& mesh) {
+                range_u64(m, 0, mesh.count) {
+                    const auto& view = mesh.meshes[m];
+                    range_u32(k, 0, view.vertex_count) {
+                        geometry->vertices[v + k] = transform.xform(vertices[view.vertex_start + k].pos);
+                        geometry->aabb.expand(geometry->vertices[v + k]);
+                    }
+                    // mesh indices are relative to the meshes first vertex
+                    range_u32(k, 0, (view.index_count / 3) * 3) {
+                        geometry->indices[t * 3 + k] = (i32)(v + indices[view.index_start + k]);
+                    }
+                    v += view.vertex_count;
+                    t += view.index_count / 3;
+                }
+            }
+        );
+        assert(v == vertex_count && t == triangle_count);
+    }
+
+    // area = 0 rebuilds the whole navmesh, tiles are built on the job threads and swapped in by world_update_navigation
+    static void
+    world_rebuild_navigation(world_t* world, const math::rect3d_t* area = 0) {
+        nav::navigation_request_rebuild(world->navigation, area);
+    }
+
+    // main thread, after the brains have queued their path requests
+    static void
+    world_update_navigation(world_t* world, f32 budget_ms) {
+        TIMED_FUNCTION;
+        auto* nav = world->navigation;
+        if (nav->rebuild_pending && nav::navigation_is_building(nav) == false) {
+            world_gather_navigation_geometry(world);
+            nav::navigation_start_rebuild(nav, world->jobs);
+        }
+        nav::navigation_update(nav, budget_ms);
+    }
+
+    static void
+    world_update_transform_tree(entity_t* entity, const math::transform_t* parent_global, b32 parent_changed) {
+        const b32 changed = parent_changed || 
+            (entity->flags & EntityFlags_DirtyTransform) ||
+            std::memcmp(&entity->transform, &entity->_cached_transform, sizeof(math::transform_t)) != 0;
+
+        if (changed) {
+            entity->_cached_transform = entity->transform;
+            entity->_global_transform = parent_global ?
+                math::transform_t{parent_global->to_matrix() * entity->transform.to_matrix()} :
+                entity->transform;
+            entity->flags &= ~EntityFlags_DirtyTransform;
+        }
+
+        for (auto* child = entity->first_child; child; child = child->next_child) {
+            world_update_transform_tree(child, &entity->_global_transform, changed);
+        }
+    }
+
+    // parents before children, only subtrees that moved since the last call are rebuilt
+    static void
+    world_update_transforms(world_t* world) {
+        TIMED_FUNCTION;
+        for (auto* e: world_entities(world, entity_list_alive)) {
+            if (e->parent == nullptr) {
+                world_update_transform_tree(e, nullptr, 0);
+            }
+        }
+    }
+
+    static void
+    world_update_kinematic_physics(world_t* world) {
+        TIMED_FUNCTION;
+        // const auto* input = &world->game_state->game_memory->input;
+        // Note(Zack): dynamic bodies are written back by the backend, only kinematic ones are pushed from here
+        // so resting bodies cost nothing
+        for (auto* e: world_entities(world, entity_list_kinematic)) {
+            if (e->is_alive() == false || (e->physics.flags & PhysicsEntityFlags_Dying)) {
+                continue;
             }
+            world->physics->set_rigidbody(0, e->physics.rigidbody);
+            e->transform.origin = e->physics.rigidbody->position();
+            e->transform.basis = glm::toMat3(e->physics.rigidbody->orientation());
+        }
+    }
+
+    // queue_free and queue_impulse come from collision callbacks and weapons, they are applied
+    // after the step. returns 0 if the body is resting and nothing else needs to look at it
+    static b32
+    world_apply_physics_requests(world_t* world, entity_t* e) {
+        auto* rb = e->physics.rigidbody;
+        if (e->physics.flags & PhysicsEntityFlags_Dying) {
+            e->physics.flags = 0;
+            world->physics->remove_rigidbody(world->physics, rb);
+            e->physics.rigidbody = 0;
+            world->entity_lists_dirty = 1;
+            return 0;
+        }
+        if (e->physics.flags & PhysicsEntityFlags_Impulse) {
+            rb->add_impulse(e->physics.impulse);
+            e->physics.impulse = {};
+            e->physics.flags &= ~PhysicsEntityFlags_Impulse;
         }
+        return !rb->is_sleeping();
     }
 
     static void
@@ -770,8 +1451,13 @@ namespace ztd {
         assert(world->entity_count > 0);
         assert(e->id != uid::invalid_id);
 
+        if (e->flags & EntityFlags_ScriptHook) {
+            world_set_entity_hook(world, e);
+        }
+
         e->flags = EntityFlags_Dead;
         remove_entity_from_id_hash(world, e);
+        world_remove_alive_entity(world, e);
 
         if (e->parent) {
             e->parent->remove_child(e);
@@ -799,8 +1485,9 @@ namespace ztd {
 
     static void
     world_kill_free_queue(world_t* world) {
-        for (size_t i{0}; i < world->entity_capacity; i++) {
-            auto* e = world->entities + i;
+        // backwards so the swap remove only moves entities we already checked
+        for (u32 i = world->alive_count; i-- > 0;) {
+            auto* e = world->alive_entities[i];
             if (e->flags & EntityFlags_Dying) {
                 world_destroy_entity(world, e);
             }
@@ -809,8 +1496,8 @@ namespace ztd {
 
     static void
     world_destroy_all(world_t* w) {
-        range_u64(i, 0, w->entity_capacity) {
-            auto* e = w->entities + i;
+        range_u32(i, 0, w->alive_count) {
+            auto* e = w->alive_entities[i];
             if (e->is_alive()) {
                 e->queue_free();
             }
@@ -818,6 +1505,7 @@ namespace ztd {
         world_kill_free_queue(w);
         w->entity_count = 0;
         w->entity_capacity = 0;
+        w->alive_count = 0;
     }
 
     static void 
@@ -833,7 +1521,7 @@ namespace ztd {
 
 #if ZTD_INTERNAL
     #define tag_spawn(world, prefab, ...) \
-        tag_spawn_((world), (prefab), #prefab, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+        tag_spawn_((world), (prefab), #prefab, __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__)
 #else 
     // #define tag_spawn(world, ...) 
         // spawn((world), (world)->render_system(), __VA_ARGS__)
@@ -841,14 +1529,106 @@ namespace ztd {
 
 // World Loading Stuff
 
+namespace ztd {
+
+    // only pure render prefabs can share an entity, physics, brains and behaviour all need their own
+    inline b32
+    prefab_is_instanceable(const ztd::prefab_t& def) {
+        return def.type == entity_type::environment
+            && def.gfx.mesh_name[0]
+            && !def.physics
+            && !def.emitter
+            && !def.coroutine
+            && !def.stats
+            && !def.weapon
+            && def.brain_type == brain_type::invalid
+            && def.on_hit_effect.name[0] == 0
+            && def.child_count() == 0;
+    }
+
+    // one entity per placement, the entities are reserved together and their rigidbodies
+    // go through one create_rigidbody_batch call instead of a create per placement
+    static void
+    world_spawn_placements(world_t* world, const ztd::prefab_t& def, std::span<const math::transform_t> transforms) {
+        TIMED_BLOCK(WorldSpawn);
+        auto scratch = begin_temporary_memory(arena_get_scratch());
+        defer { end_temporary_memory(scratch); };
+
+        const u32 count = safe_truncate_u64(transforms.size());
+        auto* entities = push_struct<entity_t*>(scratch.arena, count);
+        auto* rigidbodies = push_struct<physics::rigidbody_t*>(scratch.arena, count);
+        world_create_entities(world, entities, count);
+
+        physics::rigidbody_type rb_type;
+        if (prefab_rigidbody_type(def, &rb_type)) {
+            auto* bodies = push_struct<physics::rigidbody_create_t>(scratch.arena, count);
+            range_u32(i, 0, count) {
+                bodies[i] = physics::rigidbody_create_t{entities[i], rb_type, transforms[i].origin, transforms[i].get_orientation()};
+            }
+            world->physics->create_rigidbody_batch(
+                std::span<const physics::rigidbody_create_t>{bodies, count}, 
+                std::span<physics::rigidbody_t*>{rigidbodies, count}
+            );
+        }
+
+        auto* rs = world->render_system();
+        range_u32(i, 0, count) {
+            auto* e = spawn_into(world, rs, def, entities[i], rigidbodies[i], transforms[i].origin, transforms[i].basis);
+            e->_DEBUG_meta = ztd::DEBUG_entity_meta_info_t {
+                .prefab_name = def.type_name.data(),
+                .file_name = __FILE__,
+                .function = __FUNCTION__,
+                .line_number = __LINE__,
+                .game_time = world->time(),
+            };
+        }
+    }
+
+    // Note(Zack): spawns every placement of one prefab, instanceable prefabs become a single entity
+    // drawing each placement as an instance so the mesh and gfx entity are only resolved once
+    static void
+    world_spawn_instances(world_t* world, const ztd::prefab_t& def, std::span<const math::transform_t> transforms) {
+        TIMED_FUNCTION;
+        if (transforms.size() == 1) {
+            tag_spawn(world, def, transforms[0].origin, transforms[0].basis);
+            return;
+        }
+        if (!prefab_is_instanceable(def)) {
+            world_spawn_placements(world, def, transforms);
+            return;
+        }
+
+        auto* rs = world->render_system();
+        const u32 count = safe_truncate_u64(transforms.size());
+        auto* entity = tag_spawn(world, def);
+        entity->gfx.instance(world_instance_pool(world), world_instance_color_pool(world), count);
+        if (rs) {
+            range_u32(gi, 0, entity->gfx.gfx_entity_count) {
+                rendering::set_entity_instance_data(rs, entity->gfx.gfx_id + gi, entity->gfx.instance_offset(0), count);
+            }
+        }
+
+        const auto mesh_aabb = entity->aabb;
+        entity->aabb = {};
+        range_u32(i, 0, count) {
+            entity->gfx.instance_buffer[i] = transforms[i].to_matrix();
+            entity->aabb.expand(transforms[i].xform_aabb(mesh_aabb));
+        }
+    }
+};
+
+// Version 2 stores a table of unique prefabs, each followed by the transforms of its placements.
+// Version 1 stored a full prefab and a transform for every placement.
 struct world_save_file_header_t {
-    u64 prefab_count{0};
-    u64 VERSION{1};
+    u64 prefab_count{0}; // placements
+    u64 VERSION{2};
 
     u32 light_probe_count{0};
     v3f light_probe_min{};
     v3f light_probe_max{};
     f32 light_probe_grid_size{1.6f};
+
+    u64 prefab_table_count{0}; // @version 2 - added
 };
 
 template<>
@@ -866,11 +1646,43 @@ utl::memory_blob_t::deserialize<world_save_file_header_t>() {
             result.light_probe_max = deserialize<v3f>();
             result.light_probe_grid_size = deserialize<f32>();
         }
+        if (result.VERSION >= 2) {
+            result.prefab_table_count = deserialize<u64>();
+        }
     }
 
     return result;
 }
 
+// calls callback(prefab, transforms) once per prefab, version 1 files hand over one placement at a time
+void world_file_for_each_prefab(
+    utl::memory_blob_t& blob, 
+    const world_save_file_header_t& header, 
+    arena_t* arena, 
+    auto&& callback
+) {
+    if (header.VERSION >= 2) {
+        range_u64(i, 0, header.prefab_table_count) {
+            auto prefab = blob.deserialize<ztd::prefab_t>(arena);
+            const u64 count = blob.deserialize<u64>();
+
+            // the file isnt aligned, copy the transforms out before handing them over
+            tag_array(auto* transforms, math::transform_t, arena, count);
+            utl::copy(transforms, blob.read_data(), sizeof(math::transform_t) * count);
+            blob.advance(sizeof(math::transform_t) * count);
+
+            callback(prefab, std::span<const math::transform_t>{transforms, count});
+        }
+    } else {
+        range_u64(i, 0, header.prefab_count) {
+            auto prefab = blob.deserialize<ztd::prefab_t>(arena);
+            const auto transform = blob.deserialize<math::transform_t>();
+
+            callback(prefab, std::span<const math::transform_t>{&transform, 1});
+        }
+    }
+}
+
 void load_world_file(ztd::world_t* world, const char* name) {
     arena_t* arena = &world->arena;
 
@@ -880,14 +1692,11 @@ void load_world_file(ztd::world_t* world, const char* name) {
     auto header = blob.deserialize<world_save_file_header_t>();
     
     ztd_info(__FUNCTION__, "Loading world '{}' - save file version: {}", name, header.VERSION);
-    range_u64(i, 0, header.prefab_count) {
-        auto prefab = blob.deserialize<ztd::prefab_t>(arena);
-        auto transform = blob.deserialize<math::transform_t>();
+    world_file_for_each_prefab(blob, header, arena, [&](const ztd::prefab_t& prefab, std::span<const math::transform_t> transforms) {
+        ztd::world_spawn_instances(world, prefab, transforms);
+    });
 
-        ztd::tag_spawn(world, prefab, transform.origin, transform.basis);
-    }
-
-    if (header.light_probe_count > 0) {
+    if (header.light_probe_count > 0 && world->render_system()) {
         math::rect3d_t probe_aabb{
             .min = header.light_probe_min,
             .max = header.light_probe_max,
@@ -898,6 +1707,7 @@ void load_world_file(ztd::world_t* world, const char* name) {
     }
 }
 
+// callback(world, prefab, transforms) is called once per unique prefab
 void load_world_file(ztd::world_t* world, const char* name, auto&& callback) {
     arena_t* arena = &world->arena;
 
@@ -908,14 +1718,11 @@ void load_world_file(ztd::world_t* world, const char* name, auto&& callback) {
     auto header = blob.deserialize<world_save_file_header_t>();
     
     ztd_info(__FUNCTION__, "Loading world '{}' - save file version: {}", name, header.VERSION);
-    range_u64(i, 0, header.prefab_count) {
-        auto prefab = blob.deserialize<ztd::prefab_t>(arena);
-        auto transform = blob.deserialize<math::transform_t>();
-
-        callback(world, prefab, transform.origin, transform.basis);
-    }
+    world_file_for_each_prefab(blob, header, arena, [&](const ztd::prefab_t& prefab, std::span<const math::transform_t> transforms) {
+        callback(world, prefab, transforms);
+    });
 
-    if (header.light_probe_count > 0) {
+    if (header.light_probe_count > 0 && world->render_system()) {
         math::rect3d_t probe_aabb{
             .min = header.light_probe_min,
             .max = header.light_probe_max,
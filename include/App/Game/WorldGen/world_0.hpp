@@ -8,7 +8,9 @@ generate_world_test(arena_t* arena) {
     tag_struct(auto* generator, world_generator_t, arena);
     generator->arena = arena;
     generator->add_step("Environment", WORLD_STEP_TYPE_LAMBDA(environment) {
-       world->render_system()->environment_storage_buffer.pool[0].fog_density = 0.01f;
+       if (auto* rs = world->render_system()) {
+           rs->environment_storage_buffer.pool[0].fog_density = 0.01f;
+       }
     });
     generator->add_step("Player", WORLD_STEP_TYPE_LAMBDA(player) {
         auto* player = ztd::tag_spawn(world, ztd::db::characters::assassin, axis::up * 3.0f);
@@ -102,8 +104,7 @@ generate_forest(arena_t* arena) {
     generator->add_step("Planting Trees", WORLD_STEP_TYPE_LAMBDA(environment) {
         auto* tree = ztd::tag_spawn(world, ztd::db::environmental::tree_01, axis::down);
         constexpr u32 tree_count = 4000;
-        tree->gfx.instance(world->render_system()->scene_context->instance_storage_buffer.pool, 
-            world->render_system()->scene_context->instance_color_storage_buffer.pool, tree_count);
+        tree->gfx.instance(ztd::world_instance_pool(world), ztd::world_instance_color_pool(world), tree_count);
         
         for (size_t i = 0; i < tree_count; i++) {
             // tree->gfx.dynamic_instance_buffer[i + tree_count] = 
@@ -119,10 +120,7 @@ generate_forest(arena_t* arena) {
         return;
         auto* grass = ztd::tag_spawn(world, ztd::db::environmental::grass_02);
         constexpr u32 grass_count = 90'000;
-        grass->gfx.instance(
-            world->render_system()->scene_context->instance_storage_buffer.pool, 
-            world->render_system()->scene_context->instance_color_storage_buffer.pool, 
-            grass_count);
+        grass->gfx.instance(ztd::world_instance_pool(world), ztd::world_instance_color_pool(world), grass_count);
         grass->gfx.material_id = 4;
         
         for (size_t i = 0; i < grass_count; i++) {
@@ -156,10 +154,8 @@ generate_sponza(arena_t* arena) {
 
 auto SPAWN_FIRE_PARTICLE(auto* world, auto pos, auto mat, auto size) {
     auto* ps = ztd::tag_spawn(world, ztd::db::particle::plasma, pos);
-    ps->gfx.particle_system = particle_system_create(&world->particle_arena, 64);
-    ps->gfx.instance(
-        world->render_system()->scene_context->instance_storage_buffer.pool,
-        world->render_system()->scene_context->instance_color_storage_buffer.pool, 64, 1);
+    ps->gfx.particle_system = particle_system_create(&world->particle_arena, 64, 0, world->entropy.rand());
+    ps->gfx.instance(ztd::world_instance_pool(world), ztd::world_instance_color_pool(world), 64, 1);
     ps->gfx.material_id = mat;
     ps->gfx.particle_system->acceleration = v3f{axis::up*9.81f*0.1f};
     ps->gfx.particle_system->spawn_rate = 0.02f;
@@ -219,11 +215,8 @@ generate_particle_test(arena_t* arena) {
 
             teapot_particle->gfx.material_id = 4;
             // teapot_particle->coroutine->start();
-            teapot_particle->gfx.particle_system = particle_system_create(&world->particle_arena, 30000);
-            teapot_particle->gfx.instance(
-                world->render_system()->scene_context->instance_storage_buffer.pool, 
-                world->render_system()->scene_context->instance_color_storage_buffer.pool, 
-                30000, 1);
+            teapot_particle->gfx.particle_system = particle_system_create(&world->particle_arena, 30000, 0, world->entropy.rand());
+            teapot_particle->gfx.instance(ztd::world_instance_pool(world), ztd::world_instance_color_pool(world), 30000, 1);
 
             teapot_particle->gfx.particle_system->spawn_rate = 0.02f;
             teapot_particle->gfx.particle_system->scale_over_life_time = math::range_t(1.0f, 0.0f);
@@ -352,7 +345,7 @@ generate_world_1(arena_t* arena) {
             auto* person = ztd::tag_spawn(world, cultist, spos);
             // person->physics.rigidbody->set_layer(ztd::physics_layers::e);
         }
-        // person->physics.rigidbody->set_group(~1ui32);
+        // person->physics.rigidbody->set_group(~1u);
     });
 
     generator->add_step("World Geometry", WORLD_STEP_TYPE_LAMBDA(environment) {
@@ -478,8 +471,8 @@ generate_world_0(arena_t* arena) {
                     skull = ztd::tag_spawn(world, ztd::db::bads::skull, self->global_transform().origin + axis::up * 15.0f + planes::xz * utl::rng::random_s::randv());
                     skull->physics.rigidbody->set_gravity(false);
                     skull->physics.rigidbody->set_ccd(true);
-                    skull->physics.rigidbody->set_layer(1ui32);
-                    // skull->physics.rigidbody->set_group(~1ui32);
+                    skull->physics.rigidbody->set_layer(1u);
+                    // skull->physics.rigidbody->set_group(~1u);
                     *count -= 1;
                     co_yield(co);
                 }
@@ -607,11 +600,14 @@ ztd::entity_t* spawn_torch(ztd::world_t* world, v3f pos, f32 rotation = 0.0f) {
     torch->transform.set_rotation(v3f{0.0f, rotation, 0.0f});
     torch->gfx.material_id = 1;
     torch->first_child->add_child(SPAWN_FIRE_PARTICLE(world, v3f{0.0f}, 5, 4.0f));
-    rendering::create_point_light(
-        world->render_system(),
-        torch->first_child->global_transform().origin,
-        50.0f, 55.0f, v3f{1.5f, .9f, .3f} * utl::rng::random_s::randv()
-    );
+    const v3f light_color = v3f{1.5f, .9f, .3f} * utl::rng::random_s::randv(); // drawn either way so headless runs see the same rng
+    if (auto* rs = world->render_system()) {
+        rendering::create_point_light(
+            rs,
+            torch->first_child->global_transform().origin,
+            50.0f, 55.0f, light_color
+        );
+    }
     return torch;
 }   
 ztd::entity_t* spawn_door(ztd::world_t* world, v3f pos, f32 rotation = 0.0f) {
@@ -620,8 +616,8 @@ ztd::entity_t* spawn_door(ztd::world_t* world, v3f pos, f32 rotation = 0.0f) {
     // prefab.children[0].entity = &null_prefab;
     auto* torch = ztd::tag_spawn(world, prefab, pos);
     torch->transform.set_rotation(v3f{0.0f, rotation, 0.0f});
-    torch->physics.rigidbody->orientation = glm::toQuat(torch->transform.basis);
-    torch->physics.rigidbody->position = torch->global_transform().origin;
+    torch->physics.rigidbody->orientation() = glm::toQuat(torch->transform.basis);
+    torch->physics.rigidbody->position() = torch->global_transform().origin;
     world->physics->set_rigidbody(0, torch->physics.rigidbody);
     torch->gfx.material_id = 1;
     
@@ -1094,8 +1090,10 @@ generate_world_maze(arena_t* arena) {
     tag_struct(auto* generator, world_generator_t, arena);
     generator->arena = arena;
     generator->add_step("Environment", WORLD_STEP_TYPE_LAMBDA(environment) {
-       world->render_system()->environment_storage_buffer.pool[0].fog_density = 0.01f;
-       world->render_system()->environment_storage_buffer.pool[0].sun.direction = v4f{0.0};
+       if (auto* rs = world->render_system()) {
+           rs->environment_storage_buffer.pool[0].fog_density = 0.01f;
+           rs->environment_storage_buffer.pool[0].sun.direction = v4f{0.0};
+       }
     });
     generator->add_step("Player", WORLD_STEP_TYPE_LAMBDA(player) {
         auto* player = ztd::tag_spawn(world, ztd::db::characters::assassin, axis::up * 3.0f + axis::forward * 15.0f);
@@ -1107,8 +1105,10 @@ generate_world_maze(arena_t* arena) {
         module_generator_t* mgen = new module_generator_t{world};
         mgen->generate();
 
-        world->render_system()->light_probes.grid_size = 5.0f;
-        rendering::update_probe_aabb(world->render_system(), mgen->aabb());
+        if (auto* rs = world->render_system()) {
+            rs->light_probes.grid_size = 5.0f;
+            rendering::update_probe_aabb(rs, mgen->aabb());
+        }
 
         delete mgen;
 
@@ -3,5 +3,27 @@
 #include "App/Game/WorldGen/world_0.hpp"
 #include "App/Game/WorldGen/town_01.hpp"
 
+// generators that can be picked by name with --world, these ones also run without a render system
+struct named_world_generator_t {
+    std::string_view name;
+    world_generator_t* (*generate)(arena_t*);
+};
+
+global_variable named_world_generator_t gs_named_world_generators[] = {
+    { "forest",         generate_forest },
+    { "particle_test",  generate_particle_test },
+    { "maze",           generate_world_maze },
+    { "crash_test",     generate_crash_test },
+};
+
+static world_generator_t*
+generate_world_by_name(arena_t* arena, std::string_view name) {
+    for (const auto& generator: gs_named_world_generators) {
+        if (generator.name == name) {
+            return generator.generate(arena);
+        }
+    }
+    return nullptr;
+}
 
 #undef WORLD_GEN_FUNCTION
\ No newline at end of file
@@ -491,4 +491,24 @@ struct game_state_t {
     }
 };
 
+// skeletal meshes are decoded the first time something asks for them instead of at startup
+inline loaded_skeletal_mesh_t*
+game_state_get_skeletal_mesh(game_state_t* game_state, std::string_view name) {
+    b32 had = 0;
+    auto* arena = &game_state->mesh_arena;
+    const auto file_id = utl::res::pack_file_find_file(game_state->resource_file, name);
+    if (file_id == utl::res::pack_file_t::invalid) {
+        return nullptr;
+    }
+    // key has to outlive the trie, use the name stored in the pack table
+    const std::string_view file_name = game_state->resource_file->table[file_id].name.sv();
+    auto* mesh = utl::hash_get(&game_state->animations, file_name, arena, &had);
+    if (!had) {
+        utl::memory_blob_t blob{utl::res::pack_file_get_file(game_state->resource_file, file_id)};
+        *mesh = blob.deserialize<loaded_skeletal_mesh_t>(arena);
+        mesh->name.push(arena, file_name);
+    }
+    return mesh;
+}
+
 #endif
@@ -5,7 +5,7 @@
 
 #include "ztd_core.hpp"
 
-#include <vulkan\vulkan.h>
+#include <vulkan/vulkan.h>
 
 #include <vector>
 #include <functional>
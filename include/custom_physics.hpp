@@ -5,27 +5,1619 @@
 
 #include <unordered_map>
 
+// Note(Zack): In process rigidbody backend, this is what headless and test builds run on.
+// rigidbody_t is the simulation state, the backend only keeps derived data (shapes, bounds, contacts).
+// A step is deterministic for a given fixed dt, everything is single threaded and bodies are
+// visited in broadphase order with ties broken by rigidbody index.
+
 namespace physics {
+
+constexpr f32 custom_gravity                    = 9.81f;
+constexpr f32 custom_fixed_dt                   = 1.0f / 60.0f;
+constexpr u32 custom_max_substeps               = 4;
+constexpr u32 custom_solver_iterations          = 8;
+constexpr f32 custom_baumgarte                  = 0.2f;
+constexpr f32 custom_linear_slop                = 0.005f;
+constexpr f32 custom_aabb_margin                = 0.05f;
+constexpr f32 custom_friction                   = 0.5f; // same as the physx default material
+constexpr f32 custom_restitution                = 0.1f;
+constexpr f32 custom_restitution_threshold      = 1.0f;
+constexpr f32 custom_character_height           = 1.9f;
+constexpr f32 custom_character_radius           = 1.0f;
+constexpr f32 custom_character_skin             = 0.01f;
+constexpr f32 custom_character_push_force       = 1000.0f;
+// physx_simulate moves controllers by velocity * dt * 100, gameplay is tuned around that
+constexpr f32 custom_character_velocity_scale   = 100.0f;
+constexpr f32 custom_impulse_scale              = 10.0f; // matches physx_rigidbody_add_impulse
+
+// islands whose bodies all stay under these speeds for custom_time_to_sleep go to sleep
+constexpr f32 custom_sleep_linear_velocity      = 0.05f;
+constexpr f32 custom_sleep_angular_velocity     = 0.05f;
+constexpr f32 custom_time_to_sleep              = 0.5f;
+
+constexpr u32 custom_max_contacts               = 1 << 15;
+constexpr u32 custom_max_touches                = 1 << 14;
+constexpr u32 custom_max_mesh_contacts          = 8;
+constexpr u32 custom_query_batch_size           = 256; // queries swept together, keeps the batch scratch on the stack
+constexpr u32 custom_max_hull_vertices          = 256;
+constexpr u32 custom_bvh_leaf_size              = 4;
+
+// Note(Zack): The custom backend cant read physx cooked meshes, convex and trimesh colliders take
+// the geometry from the collider info (the world builds it from the render mesh) or a blob with
+// this header followed by v3f vertices[vertex_count] and u32 indices[index_count].
+// Convex hulls are point clouds so they have no indices.
+struct custom_mesh_header_t {
+    u64 magic;
+    u32 vertex_count;
+    u32 index_count;
+};
+
+constexpr u64 custom_mesh_magic = utl::res::magic::make_magic("CUSTMESH");
+
+enum CustomBodyFlags {
+    CustomBodyFlags_InScene = BIT(0),
+    CustomBodyFlags_Gravity = BIT(1),
+    CustomBodyFlags_CCD     = BIT(2),
+    CustomBodyFlags_InOrder = BIT(3), // has a slot in the broadphase order, cleared when compacted
+    CustomBodyFlags_Moved   = BIT(4), // teleported by gameplay this step, wakes what it touches
+    CustomBodyFlags_Unsorted = BIT(5), // bounds changed since the last broadphase sort, see custom_broadphase_query
+};
+
+struct custom_bvh_node_t {
+    math::rect3d_t aabb{};
+    u32 first{0}; // first triangle for leaves, left child for interior nodes
+    u32 count{0}; // 0 for interior nodes
+};
+
+struct custom_shape_t {
+    collider_shape_type type{collider_shape_type::NONE};
+    b32 active{1};
+
+    // pose relative to the body
+    v3f  origin{0.0f};
+    quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+
+    f32 radius{0.0f};       // sphere, capsule
+    f32 half_height{0.0f};  // capsule, along local y
+    v3f half_size{0.0f};    // box
+
+    v3f* vertices{0};       // convex, trimesh
+    u32  vertex_count{0};
+    u32* indices{0};        // trimesh
+    u32  triangle_count{0};
+    custom_bvh_node_t* nodes{0};
+    u32  node_count{0};
+
+    math::rect3d_t local_aabb{}; // shape space
+};
+
+struct custom_body_t {
+    u32 flags{0};
+    f32 inverse_mass{0.0f};
+    v3f inverse_inertia{0.0f}; // body space diagonal
+    m33 world_inverse_inertia{0.0f};
+
+    math::rect3d_t local_aabb{}; // body space, union of all shapes
+    math::rect3d_t aabb{};       // world space
+
+    f32 sleep_timer{0.0f};
+    u32 dynamic_slot{~0u};       // index in custom_backend_t::dynamic_bodies, ~0 when asleep or out of the scene
+
+    custom_shape_t character{};  // capsule for CHARACTER bodies
+};
+
+struct custom_contact_t {
+    u32 a{0}, b{0};     // rigidbody index
+    v3f normal{0.0f};   // from a to b
+    v3f point{0.0f};
+    f32 depth{0.0f};    // negative for speculative contacts
+
+    v3f ra{0.0f}, rb{0.0f};
+    v3f tangent[2]{};
+    f32 normal_mass{0.0f};
+    f32 tangent_mass[2]{};
+    f32 bias{0.0f};
+    f32 normal_impulse{0.0f};
+    f32 tangent_impulse[2]{};
+};
+
+struct custom_touch_t {
+    u64 key{0};
+    rigidbody_t* a{0};
+    rigidbody_t* b{0};
+    collider_t* ca{0};
+    collider_t* cb{0};
+    b32 trigger{0};
+};
+
+struct custom_backend_t {
+    custom_body_t*      bodies{0};  // parallel to api_t::rigidbodies
+
+    u32*                order{0};   // in scene bodies sorted by aabb.min.x
+    u32                 order_count{0};
+    b32                 order_dirty{0};
+    f32                 max_extent_x{0.0f};
+    f32*                order_min_x{0}; // aabb.min.x of each order slot at the last sort
+    u32                 sorted_count{0}; // order slots covered by the last sort
+
+    u32*                unsorted{0}; // in order bodies whose bounds changed since the last sort
+    u32                 unsorted_count{0};
+
+    u32*                dynamic_bodies{0}; // awake in scene DYNAMIC bodies
+    u32                 dynamic_count{0};
+
+    u32*                moved_bodies{0};
+    u32                 moved_count{0};
+
+    u32*                island_parent{0};  // union find over dynamic_bodies, by body index
+    f32*                island_sleep_time{0};
+
+    // per body integration scalars, same indices as api_t::body_state, zero for bodies that dont integrate
+    f32*                integrate{0};
+    f32*                inverse_mass{0};
+    f32*                gravity{0};
+    f32*                linear_damping{0};
+    u32                 integrate_count{0}; // one past the last integrating body, rounded up to 8
+
+    custom_contact_t*   contacts{0};
+    u32                 contact_count{0};
+
+    custom_touch_t*     touches[2]{};
+    u32                 touch_count[2]{};
+    u32                 touch_frame{0};
+
+    f32                 fixed_dt{custom_fixed_dt}; // 0 steps with whatever dt the game passes in
+    f32                 accumulator{0.0f};
+    u64                 step_count{0};
+};
+
+inline static custom_backend_t*
+get_custom(const api_t* api) {
+    assert(api->type == backend_type::CUSTOM);
+    return (custom_backend_t*)api->backend;
+}
+
+inline static u32
+custom_body_index(const api_t* api, const rigidbody_t* rb) {
+    return rb->index;
+}
+
+inline static custom_body_t*
+custom_get_body(const rigidbody_t* rb) {
+    return (custom_body_t*)rb->api_data;
+}
+
+inline static b32
+custom_should_collide(const rigidbody_t* a, const rigidbody_t* b) {
+    return (a->layer & b->group) && (b->layer & a->group);
+}
+
+inline static u32
+custom_body_shape_count(const rigidbody_t* rb) {
+    return rb->type == rigidbody_type::CHARACTER ? 1 : safe_truncate_u64(rb->collider_count);
+}
+
+// characters have no colliders, same as the physx controllers
+inline static custom_shape_t*
+custom_body_shape(const rigidbody_t* rb, u32 i, collider_t** collider) {
+    if (rb->type == rigidbody_type::CHARACTER) {
+        *collider = 0;
+        return &custom_get_body(rb)->character;
+    }
+    *collider = (collider_t*)&rb->colliders[i];
+    return (custom_shape_t*)rb->colliders[i].shape;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Geometry
+////////////////////////////////////////////////////////////////////////////////////
+
+enum struct custom_core_type {
+    SEGMENT, BOX, HULL, TRIANGLE
+};
+
+// world space shape, spheres and capsules are a segment core plus radius
+struct custom_world_shape_t {
+    custom_core_type type{custom_core_type::SEGMENT};
+    v3f center{0.0f};
+    m33 basis{1.0f};
+    f32 radius{0.0f};
+    v3f segment[2]{};
+    v3f half_size{0.0f};
+    const v3f* points{0};   // hull points in shape space
+    u32 point_count{0};
+    v3f triangle[3]{};
+};
+
+static custom_world_shape_t
+custom_world_shape(const custom_shape_t* shape, const v3f& position, const quat& orientation) {
+    custom_world_shape_t result{};
+    result.center = position + orientation * shape->origin;
+    result.basis = glm::toMat3(orientation * shape->rotation);
+
+    switch(shape->type) {
+        case collider_shape_type::SPHERE: {
+            result.type = custom_core_type::SEGMENT;
+            result.segment[0] = result.segment[1] = result.center;
+            result.radius = shape->radius;
+        }   break;
+        case collider_shape_type::CAPSULE: {
+            result.type = custom_core_type::SEGMENT;
+            const v3f axis = result.basis[1] * shape->half_height;
+            result.segment[0] = result.center - axis;
+            result.segment[1] = result.center + axis;
+            result.radius = shape->radius;
+        }   break;
+        case collider_shape_type::BOX: {
+            result.type = custom_core_type::BOX;
+            result.half_size = shape->half_size;
+        }   break;
+        case collider_shape_type::CONVEX: {
+            result.type = custom_core_type::HULL;
+            result.points = shape->vertices;
+            result.point_count = shape->vertex_count;
+        }   break;
+        case_invalid_default;
+    }
+    return result;
+}
+
+static custom_world_shape_t
+custom_world_triangle(const v3f& a, const v3f& b, const v3f& c) {
+    custom_world_shape_t result{};
+    result.type = custom_core_type::TRIANGLE;
+    result.triangle[0] = a;
+    result.triangle[1] = b;
+    result.triangle[2] = c;
+    result.center = (a + b + c) / 3.0f;
+    return result;
+}
+
+static v3f
+custom_support(const custom_world_shape_t& s, const v3f& d) {
+    switch(s.type) {
+        case custom_core_type::SEGMENT: {
+            return glm::dot(s.segment[0], d) >= glm::dot(s.segment[1], d) ? s.segment[0] : s.segment[1];
+        }
+        case custom_core_type::BOX: {
+            v3f result = s.center;
+            range_u32(i, 0, 3) {
+                result += s.basis[i] * (glm::dot(s.basis[i], d) >= 0.0f ? s.half_size[i] : -s.half_size[i]);
+            }
+            return result;
+        }
+        case custom_core_type::HULL: {
+            const v3f local_d = glm::transpose(s.basis) * d;
+            u32 best = 0;
+            f32 best_dot = -std::numeric_limits<f32>::max();
+            range_u32(i, 0, s.point_count) {
+                const f32 p_dot = glm::dot(s.points[i], local_d);
+                if (p_dot > best_dot) {
+                    best_dot = p_dot;
+                    best = i;
+                }
+            }
+            return s.center + s.basis * s.points[best];
+        }
+        case custom_core_type::TRIANGLE: {
+            const f32 d0 = glm::dot(s.triangle[0], d);
+            const f32 d1 = glm::dot(s.triangle[1], d);
+            const f32 d2 = glm::dot(s.triangle[2], d);
+            if (d0 >= d1 && d0 >= d2) return s.triangle[0];
+            return d1 >= d2 ? s.triangle[1] : s.triangle[2];
+        }
+    }
+    return s.center;
+}
+
+static u32
+custom_core_vertices(const custom_world_shape_t& s, v3f* out) {
+    switch(s.type) {
+        case custom_core_type::SEGMENT: {
+            out[0] = s.segment[0];
+            out[1] = s.segment[1];
+            return 2;
+        }
+        case custom_core_type::BOX: {
+            range_u32(i, 0, 8) {
+                const v3f sign{(i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f};
+                out[i] = s.center + s.basis * (sign * s.half_size);
+            }
+            return 8;
+        }
+        case custom_core_type::HULL: {
+            range_u32(i, 0, s.point_count) {
+                out[i] = s.center + s.basis * s.points[i];
+            }
+            return s.point_count;
+        }
+        case custom_core_type::TRIANGLE: {
+            range_u32(i, 0, 3) {
+                out[i] = s.triangle[i];
+            }
+            return 3;
+        }
+    }
+    return 0;
+}
+
+static math::rect3d_t
+custom_world_shape_aabb(const custom_world_shape_t& s) {
+    math::rect3d_t result{};
+    switch(s.type) {
+        case custom_core_type::SEGMENT: {
+            result.expand(s.segment[0] - v3f{s.radius});
+            result.expand(s.segment[0] + v3f{s.radius});
+            result.expand(s.segment[1] - v3f{s.radius});
+            result.expand(s.segment[1] + v3f{s.radius});
+        }   break;
+        case custom_core_type::BOX: {
+            result = math::transform_t{s.basis, s.center}.xform_aabb(math::rect3d_t{-s.half_size, s.half_size});
+        }   break;
+        case custom_core_type::HULL: {
+            range_u32(i, 0, s.point_count) {
+                result.expand(s.center + s.basis * s.points[i]);
+            }
+        }   break;
+        case custom_core_type::TRIANGLE: {
+            range_u32(i, 0, 3) {
+                result.expand(s.triangle[i]);
+            }
+        }   break;
+    }
+    return result;
+}
+
+// returns squared distance, c0 and c1 are the closest points on each segment
+static f32
+custom_closest_segment_segment(v3f p1, v3f q1, v3f p2, v3f q2, v3f* c1, v3f* c2) {
+    constexpr f32 epsilon = 1e-8f;
+    const v3f d1 = q1 - p1;
+    const v3f d2 = q2 - p2;
+    const v3f r = p1 - p2;
+    const f32 a = glm::dot(d1, d1);
+    const f32 e = glm::dot(d2, d2);
+    const f32 f = glm::dot(d2, r);
+    f32 s = 0.0f, t = 0.0f;
+
+    if (a <= epsilon && e <= epsilon) {
+        s = t = 0.0f;
+    } else if (a <= epsilon) {
+        t = glm::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        const f32 c = glm::dot(d1, r);
+        if (e <= epsilon) {
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            const f32 b = glm::dot(d1, d2);
+            const f32 denom = a*e - b*b;
+            s = denom != 0.0f ? glm::clamp((b*f - c*e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b*s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = glm::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    *c1 = p1 + d1 * s;
+    *c2 = p2 + d2 * t;
+    return glm::length2(*c1 - *c2);
+}
+
+inline static v3f
+custom_any_perpendicular(const v3f& n) {
+    const v3f t = glm::abs(n.x) < 0.57735f ? v3f{1.0f, 0.0f, 0.0f} : v3f{0.0f, 1.0f, 0.0f};
+    return glm::normalize(glm::cross(n, t));
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// GJK / EPA
+////////////////////////////////////////////////////////////////////////////////////
+
+struct custom_gjk_vertex_t {
+    v3f w{0.0f}; // a - b
+    v3f a{0.0f};
+    v3f b{0.0f};
+};
+
+struct custom_simplex_t {
+    custom_gjk_vertex_t v[4]{};
+    f32 bary[4]{};
+    u32 count{0};
+};
+
+inline static custom_gjk_vertex_t
+custom_minkowski_support(const custom_world_shape_t& A, const custom_world_shape_t& B, const v3f& d) {
+    custom_gjk_vertex_t result;
+    result.a = custom_support(A, d);
+    result.b = custom_support(B, -d);
+    result.w = result.a - result.b;
+    return result;
+}
+
+// closest point to the origin on triangle abc, returns barycentrics
+static v3f
+custom_closest_on_triangle(const v3f& a, const v3f& b, const v3f& c, f32 bary[3]) {
+    const v3f ab = b - a;
+    const v3f ac = c - a;
+    const v3f ap = -a;
+    const f32 d1 = glm::dot(ab, ap);
+    const f32 d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        bary[0] = 1.0f; bary[1] = 0.0f; bary[2] = 0.0f;
+        return a;
+    }
+    const v3f bp = -b;
+    const f32 d3 = glm::dot(ab, bp);
+    const f32 d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        bary[0] = 0.0f; bary[1] = 1.0f; bary[2] = 0.0f;
+        return b;
+    }
+    const f32 vc = d1*d4 - d3*d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        const f32 v = d1 / (d1 - d3);
+        bary[0] = 1.0f - v; bary[1] = v; bary[2] = 0.0f;
+        return a + ab * v;
+    }
+    const v3f cp = -c;
+    const f32 d5 = glm::dot(ab, cp);
+    const f32 d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        bary[0] = 0.0f; bary[1] = 0.0f; bary[2] = 1.0f;
+        return c;
+    }
+    const f32 vb = d5*d2 - d1*d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        const f32 w = d2 / (d2 - d6);
+        bary[0] = 1.0f - w; bary[1] = 0.0f; bary[2] = w;
+        return a + ac * w;
+    }
+    const f32 va = d3*d6 - d5*d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        const f32 w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        bary[0] = 0.0f; bary[1] = 1.0f - w; bary[2] = w;
+        return b + (c - b) * w;
+    }
+    const f32 denom = 1.0f / (va + vb + vc);
+    const f32 v = vb * denom;
+    const f32 w = vc * denom;
+    bary[0] = 1.0f - v - w; bary[1] = v; bary[2] = w;
+    return a + ab * v + ac * w;
+}
+
+// drops simplex vertices with zero weight
+static void
+custom_simplex_reduce(custom_simplex_t* s) {
+    u32 count = 0;
+    range_u32(i, 0, s->count) {
+        if (s->bary[i] > 0.0f) {
+            s->v[count] = s->v[i];
+            s->bary[count] = s->bary[i];
+            count++;
+        }
+    }
+    s->count = count;
+}
+
+// updates the simplex to the smallest feature closest to the origin,
+// returns 1 when the origin is inside the tetrahedron
+static b32
+custom_simplex_solve(custom_simplex_t* s, v3f* closest) {
+    switch(s->count) {
+        case 1: {
+            s->bary[0] = 1.0f;
+            *closest = s->v[0].w;
+        }   break;
+        case 2: {
+            const v3f a = s->v[0].w;
+            const v3f ab = s->v[1].w - a;
+            const f32 len2 = glm::dot(ab, ab);
+            const f32 t = len2 > 0.0f ? glm::clamp(glm::dot(-a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+            s->bary[0] = 1.0f - t;
+            s->bary[1] = t;
+            *closest = a + ab * t;
+        }   break;
+        case 3: {
+            *closest = custom_closest_on_triangle(s->v[0].w, s->v[1].w, s->v[2].w, s->bary);
+        }   break;
+        case 4: {
+            constexpr u32 faces[4][4] = { {0,1,2,3}, {0,3,1,2}, {0,2,3,1}, {1,3,2,0} };
+            f32 best = std::numeric_limits<f32>::max();
+            b32 inside = 1;
+            custom_simplex_t best_simplex{};
+            range_u32(f, 0, 4) {
+                const v3f& a = s->v[faces[f][0]].w;
+                const v3f& b = s->v[faces[f][1]].w;
+                const v3f& c = s->v[faces[f][2]].w;
+                const v3f& d = s->v[faces[f][3]].w;
+                const v3f n = glm::cross(b - a, c - a);
+                const f32 sign_p = glm::dot(-a, n);
+                const f32 sign_d = glm::dot(d - a, n);
+                // degenerate tetrahedrons count as outside so we fall back to the faces
+                if (sign_p * sign_d < 0.0f || glm::abs(sign_d) < 1e-12f) {
+                    inside = 0;
+                    f32 bary[3];
+                    const v3f p = custom_closest_on_triangle(a, b, c, bary);
+                    const f32 dist = glm::dot(p, p);
+                    if (dist < best) {
+                        best = dist;
+                        *closest = p;
+                        best_simplex.count = 3;
+                        range_u32(i, 0, 3) {
+                            best_simplex.v[i] = s->v[faces[f][i]];
+                            best_simplex.bary[i] = bary[i];
+                        }
+                    }
+                }
+            }
+            if (inside) {
+                return 1;
+            }
+            *s = best_simplex;
+        }   break;
+        case_invalid_default;
+    }
+    custom_simplex_reduce(s);
+    return 0;
+}
+
+struct custom_gjk_result_t {
+    b32 overlap{0};
+    f32 distance{0.0f};
+    v3f point_a{0.0f};
+    v3f point_b{0.0f};
+    custom_simplex_t simplex{};
+};
+
+// distance between the cores, radius is ignored
+static custom_gjk_result_t
+custom_gjk(const custom_world_shape_t& A, const custom_world_shape_t& B) {
+    custom_gjk_result_t result{};
+    auto& s = result.simplex;
+
+    v3f d = B.center - A.center;
+    if (glm::length2(d) < 1e-12f) {
+        d = axis::up;
+    }
+    s.v[0] = custom_minkowski_support(A, B, -d);
+    s.count = 1;
+    v3f v = s.v[0].w;
+    s.bary[0] = 1.0f;
+
+    constexpr u32 max_iterations = 64;
+    range_u32(iteration, 0, max_iterations) {
+        const f32 v2 = glm::dot(v, v);
+        if (v2 < 1e-10f) {
+            result.overlap = 1;
+            return result;
+        }
+
+        const auto w = custom_minkowski_support(A, B, -v);
+        if (v2 - glm::dot(v, w.w) <= 1e-6f * v2) {
+            break;
+        }
+        b32 duplicate = 0;
+        range_u32(i, 0, s.count) {
+            if (glm::length2(s.v[i].w - w.w) < 1e-12f) {
+                duplicate = 1;
+            }
+        }
+        if (duplicate) {
+            break;
+        }
+
+        s.v[s.count++] = w;
+        if (custom_simplex_solve(&s, &v)) {
+            result.overlap = 1;
+            return result;
+        }
+    }
+
+    range_u32(i, 0, s.count) {
+        result.point_a += s.v[i].a * s.bary[i];
+        result.point_b += s.v[i].b * s.bary[i];
+    }
+    result.distance = glm::sqrt(glm::dot(v, v));
+    return result;
+}
+
+// GJK can end with the origin on a lower dimensional simplex, grow it into a tetrahedron for EPA
+static b32
+custom_simplex_expand(const custom_world_shape_t& A, const custom_world_shape_t& B, custom_simplex_t* s) {
+    constexpr v3f axes[6] = {
+        v3f{1.0f, 0.0f, 0.0f}, v3f{-1.0f, 0.0f, 0.0f},
+        v3f{0.0f, 1.0f, 0.0f}, v3f{0.0f, -1.0f, 0.0f},
+        v3f{0.0f, 0.0f, 1.0f}, v3f{0.0f, 0.0f, -1.0f},
+    };
+    if (s->count == 0) {
+        return 0;
+    }
+    if (s->count == 1) {
+        for (const v3f& d : axes) {
+            const auto w = custom_minkowski_support(A, B, d);
+            if (glm::length2(w.w - s->v[0].w) > 1e-8f) {
+                s->v[s->count++] = w;
+                break;
+            }
+        }
+    }
+    if (s->count == 2) {
+        const v3f line = s->v[1].w - s->v[0].w;
+        const v3f perp = custom_any_perpendicular(glm::normalize(line));
+        const quat rot = glm::angleAxis(glm::pi<f32>() / 3.0f, glm::normalize(line));
+        v3f d = perp;
+        range_u32(i, 0, 6) {
+            const auto w = custom_minkowski_support(A, B, d);
+            if (glm::length2(glm::cross(w.w - s->v[0].w, line)) > 1e-8f) {
+                s->v[s->count++] = w;
+                break;
+            }
+            d = rot * d;
+        }
+    }
+    if (s->count == 3) {
+        const v3f n = glm::cross(s->v[1].w - s->v[0].w, s->v[2].w - s->v[0].w);
+        auto w = custom_minkowski_support(A, B, n);
+        if (glm::abs(glm::dot(w.w - s->v[0].w, n)) < 1e-8f) {
+            w = custom_minkowski_support(A, B, -n);
+        }
+        s->v[s->count++] = w;
+    }
+    if (s->count < 4) {
+        return 0;
+    }
+    const f32 volume = glm::dot(s->v[3].w - s->v[0].w, glm::cross(s->v[1].w - s->v[0].w, s->v[2].w - s->v[0].w));
+    return glm::abs(volume) > 1e-10f;
+}
+
+struct custom_epa_result_t {
+    v3f normal{0.0f}; // from A to B
+    f32 depth{0.0f};
+    v3f point_a{0.0f};
+    v3f point_b{0.0f};
+};
+
+static b32
+custom_epa(const custom_world_shape_t& A, const custom_world_shape_t& B, custom_simplex_t simplex, custom_epa_result_t* result) {
+    if (custom_simplex_expand(A, B, &simplex) == 0) {
+        return 0;
+    }
+
+    constexpr u32 max_vertices = 64;
+    constexpr u32 max_faces = 128;
+    constexpr u32 max_iterations = 32;
+
+    struct face_t {
+        u32 i[3];
+        v3f n;
+        f32 d;
+    };
+    struct edge_t {
+        u32 a, b;
+    };
+
+    custom_gjk_vertex_t vertices[max_vertices];
+    face_t faces[max_faces];
+    edge_t edges[max_faces * 3];
+    u32 vertex_count = 4;
+    u32 face_count = 0;
+
+    range_u32(i, 0, 4) {
+        vertices[i] = simplex.v[i];
+    }
+
+    const auto make_face = [&](u32 a, u32 b, u32 c) {
+        face_t f{{a, b, c}};
+        const v3f n = glm::cross(vertices[b].w - vertices[a].w, vertices[c].w - vertices[a].w);
+        const f32 len = glm::length(n);
+        if (len > 1e-12f) {
+            f.n = n / len;
+            f.d = glm::dot(f.n, vertices[a].w);
+        } else {
+            f.n = v3f{0.0f};
+            f.d = std::numeric_limits<f32>::max();
+        }
+        return f;
+    };
+
+    constexpr u32 tetra[4][4] = { {0,1,2,3}, {0,3,1,2}, {0,2,3,1}, {1,3,2,0} };
+    range_u32(f, 0, 4) {
+        auto face = make_face(tetra[f][0], tetra[f][1], tetra[f][2]);
+        if (glm::dot(face.n, vertices[tetra[f][3]].w - vertices[tetra[f][0]].w) > 0.0f) {
+            face = make_face(tetra[f][0], tetra[f][2], tetra[f][1]);
+        }
+        faces[face_count++] = face;
+    }
+
+    u32 closest = 0;
+    range_u32(iteration, 0, max_iterations) {
+        closest = 0;
+        range_u32(f, 1, face_count) {
+            if (faces[f].d < faces[closest].d) {
+                closest = f;
+            }
+        }
+        const face_t& face = faces[closest];
+        if (face.d == std::numeric_limits<f32>::max()) {
+            return 0;
+        }
+
+        const auto w = custom_minkowski_support(A, B, face.n);
+        if (glm::dot(w.w, face.n) - face.d < 1e-4f || vertex_count == max_vertices) {
+            break;
+        }
+
+        const u32 new_index = vertex_count++;
+        vertices[new_index] = w;
+
+        u32 edge_count = 0;
+        const auto add_edge = [&](u32 a, u32 b) {
+            range_u32(e, 0, edge_count) {
+                if (edges[e].a == b && edges[e].b == a) {
+                    edges[e] = edges[--edge_count];
+                    return;
+                }
+            }
+            edges[edge_count++] = edge_t{a, b};
+        };
+
+        for (u32 f = 0; f < face_count;) {
+            if (glm::dot(faces[f].n, w.w - vertices[faces[f].i[0]].w) > 0.0f) {
+                add_edge(faces[f].i[0], faces[f].i[1]);
+                add_edge(faces[f].i[1], faces[f].i[2]);
+                add_edge(faces[f].i[2], faces[f].i[0]);
+                faces[f] = faces[--face_count];
+            } else {
+                f++;
+            }
+        }
+
+        if (face_count + edge_count > max_faces) {
+            return 0;
+        }
+        range_u32(e, 0, edge_count) {
+            faces[face_count++] = make_face(edges[e].a, edges[e].b, new_index);
+        }
+        if (face_count == 0) {
+            return 0;
+        }
+    }
+
+    const face_t& face = faces[closest];
+    const v3f& a = vertices[face.i[0]].w;
+    const v3f& b = vertices[face.i[1]].w;
+    const v3f& c = vertices[face.i[2]].w;
+
+    // barycentrics of the origin projected onto the closest face
+    const v3f p = face.n * face.d;
+    const v3f v0 = b - a, v1 = c - a, v2 = p - a;
+    const f32 d00 = glm::dot(v0, v0);
+    const f32 d01 = glm::dot(v0, v1);
+    const f32 d11 = glm::dot(v1, v1);
+    const f32 d20 = glm::dot(v2, v0);
+    const f32 d21 = glm::dot(v2, v1);
+    const f32 denom = d00 * d11 - d01 * d01;
+    f32 v = 0.0f, u = 0.0f;
+    if (glm::abs(denom) > 1e-12f) {
+        v = (d11 * d20 - d01 * d21) / denom;
+        u = (d00 * d21 - d01 * d20) / denom;
+    }
+    const f32 t = 1.0f - v - u;
+
+    result->normal = face.n;
+    result->depth = face.d;
+    result->point_a = vertices[face.i[0]].a * t + vertices[face.i[1]].a * v + vertices[face.i[2]].a * u;
+    result->point_b = vertices[face.i[0]].b * t + vertices[face.i[1]].b * v + vertices[face.i[2]].b * u;
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Narrowphase
+////////////////////////////////////////////////////////////////////////////////////
+
+struct custom_manifold_t {
+    v3f normal{0.0f}; // from A to B
+    v3f points[4]{};
+    f32 depths[4]{};
+    u32 count{0};
+};
+
+// polygon of the vertices furthest along dir, ordered around their centroid
+static u32
+custom_support_feature(const custom_world_shape_t& s, const v3f& dir, v3f* out, u32 max_count) {
+    constexpr f32 tolerance = 0.01f;
+    v3f vertices[custom_max_hull_vertices];
+    const u32 vertex_count = custom_core_vertices(s, vertices);
+
+    f32 best = -std::numeric_limits<f32>::max();
+    range_u32(i, 0, vertex_count) {
+        best = glm::max(best, glm::dot(vertices[i], dir));
+    }
+
+    u32 count = 0;
+    range_u32(i, 0, vertex_count) {
+        if (glm::dot(vertices[i], dir) >= best - tolerance && count < max_count) {
+            out[count++] = vertices[i];
+        }
+    }
+
+    if (count > 2) {
+        v3f centroid{0.0f};
+        range_u32(i, 0, count) { centroid += out[i]; }
+        centroid /= f32(count);
+        const v3f u = custom_any_perpendicular(dir);
+        const v3f v = glm::cross(dir, u);
+        f32 angles[custom_max_hull_vertices];
+        range_u32(i, 0, count) {
+            const v3f p = out[i] - centroid;
+            angles[i] = glm::atan(glm::dot(p, v), glm::dot(p, u));
+        }
+        range_u32(i, 1, count) {
+            for (u32 j = i; j > 0 && angles[j] < angles[j-1]; j--) {
+                std::swap(angles[j], angles[j-1]);
+                std::swap(out[j], out[j-1]);
+            }
+        }
+    }
+    return count;
+}
+
+// clips the incident feature against the side planes of the reference face
+static u32
+custom_clip_polygon(const v3f* reference, u32 reference_count, const v3f& n, const v3f* incident, u32 incident_count, v3f* out) {
+    constexpr u32 max_points = 32;
+    v3f buffer[2][max_points];
+    u32 count = glm::min(incident_count, max_points);
+    range_u32(i, 0, count) {
+        buffer[0][i] = incident[i];
+    }
+
+    u32 src = 0;
+    range_u32(e, 0, reference_count) {
+        const v3f a = reference[e];
+        const v3f b = reference[(e + 1) % reference_count];
+        v3f plane_n = glm::cross(n, b - a);
+        // orient towards the inside of the reference polygon
+        const v3f inside = reference[(e + 2) % reference_count];
+        if (glm::dot(plane_n, inside - a) < 0.0f) {
+            plane_n = -plane_n;
+        }
+
+        const v3f* in = buffer[src];
+        v3f* clipped = buffer[!src];
+        u32 clipped_count = 0;
+
+        if (count == 1) {
+            if (glm::dot(in[0] - a, plane_n) >= 0.0f) {
+                clipped[clipped_count++] = in[0];
+            }
+        } else {
+            // segments are clipped once, polygons wrap around
+            const u32 edge_count = count == 2 ? 1 : count;
+            range_u32(i, 0, edge_count) {
+                const v3f p0 = in[i];
+                const v3f p1 = in[(i + 1) % count];
+                const f32 d0 = glm::dot(p0 - a, plane_n);
+                const f32 d1 = glm::dot(p1 - a, plane_n);
+                if (d0 >= 0.0f && clipped_count < max_points) {
+                    clipped[clipped_count++] = p0;
+                }
+                if ((d0 >= 0.0f) != (d1 >= 0.0f) && clipped_count < max_points) {
+                    clipped[clipped_count++] = p0 + (p1 - p0) * (d0 / (d0 - d1));
+                }
+                if (count == 2 && d1 >= 0.0f && clipped_count < max_points) {
+                    clipped[clipped_count++] = p1;
+                }
+            }
+        }
+        count = clipped_count;
+        src = !src;
+        if (count == 0) {
+            break;
+        }
+    }
+
+    range_u32(i, 0, count) {
+        out[i] = buffer[src][i];
+    }
+    return count;
+}
+
+static void
+custom_manifold_add(custom_manifold_t* m, const v3f& point, f32 depth) {
+    if (m->count < array_count(m->points)) {
+        m->points[m->count] = point;
+        m->depths[m->count] = depth;
+        m->count++;
+    } else {
+        // keep the deepest points
+        u32 shallowest = 0;
+        range_u32(i, 1, m->count) {
+            if (m->depths[i] < m->depths[shallowest]) shallowest = i;
+        }
+        if (depth > m->depths[shallowest]) {
+            m->points[shallowest] = point;
+            m->depths[shallowest] = depth;
+        }
+    }
+}
+
+static b32
+custom_polytope_manifold(const custom_world_shape_t& A, const custom_world_shape_t& B, const v3f& n, custom_manifold_t* m) {
+    constexpr u32 max_feature = 16;
+    v3f feature_a[max_feature], feature_b[max_feature];
+    const u32 count_a = custom_support_feature(A, n, feature_a, max_feature);
+    const u32 count_b = custom_support_feature(B, -n, feature_b, max_feature);
+
+    const b32 a_is_reference = count_a >= 3;
+    if (!a_is_reference && count_b < 3) {
+        return 0;
+    }
+
+    const v3f* reference = a_is_reference ? feature_a : feature_b;
+    const u32 reference_count = a_is_reference ? count_a : count_b;
+    const v3f* incident = a_is_reference ? feature_b : feature_a;
+    const u32 incident_count = a_is_reference ? count_b : count_a;
+
+    v3f reference_center{0.0f};
+    range_u32(i, 0, reference_count) { reference_center += reference[i]; }
+    reference_center /= f32(reference_count);
+
+    v3f clipped[32];
+    const u32 clipped_count = custom_clip_polygon(reference, reference_count, n, incident, incident_count, clipped);
+
+    m->normal = n;
+    m->count = 0;
+    range_u32(i, 0, clipped_count) {
+        const f32 depth = a_is_reference
+            ? -glm::dot(clipped[i] - reference_center, n)
+            :  glm::dot(clipped[i] - reference_center, n);
+        if (depth >= -custom_linear_slop) {
+            const v3f point = clipped[i] + n * (a_is_reference ? depth : -depth) * 0.5f;
+            custom_manifold_add(m, point, depth);
+        }
+    }
+    return m->count > 0;
+}
+
+// margin > 0 produces speculative contacts for shapes that are still apart
+static b32
+custom_collide(const custom_world_shape_t& A, const custom_world_shape_t& B, f32 margin, custom_manifold_t* m) {
+    m->count = 0;
+    const f32 radius = A.radius + B.radius;
+
+    if (A.type == custom_core_type::SEGMENT && B.type == custom_core_type::SEGMENT) {
+        v3f pa, pb;
+        const f32 dist2 = custom_closest_segment_segment(A.segment[0], A.segment[1], B.segment[0], B.segment[1], &pa, &pb);
+        if (dist2 >= math::sqr(radius + margin)) {
+            return 0;
+        }
+        const f32 dist = glm::sqrt(dist2);
+        const v3f n = dist > 1e-6f ? (pb - pa) / dist : axis::up;
+        m->normal = n;
+        custom_manifold_add(m, ((pa + n * A.radius) + (pb - n * B.radius)) * 0.5f, radius - dist);
+        return 1;
+    }
+
+    const auto gjk = custom_gjk(A, B);
+    if (!gjk.overlap) {
+        if (gjk.distance >= radius + margin || gjk.distance < 1e-6f) {
+            return 0;
+        }
+        const v3f n = (gjk.point_b - gjk.point_a) / gjk.distance;
+        m->normal = n;
+        if (radius == 0.0f && custom_polytope_manifold(A, B, n, m)) {
+            return 1;
+        }
+        custom_manifold_add(m, ((gjk.point_a + n * A.radius) + (gjk.point_b - n * B.radius)) * 0.5f, radius - gjk.distance);
+        return 1;
+    }
+
+    custom_epa_result_t epa{};
+    if (custom_epa(A, B, gjk.simplex, &epa) == 0) {
+        // touching cores, push apart along the line between the shapes
+        const v3f d = B.center - A.center;
+        const f32 len = glm::length(d);
+        m->normal = len > 1e-6f ? d / len : axis::up;
+        custom_manifold_add(m, (A.center + B.center) * 0.5f, radius);
+        return 1;
+    }
+
+    m->normal = epa.normal;
+    if (radius == 0.0f && custom_polytope_manifold(A, B, epa.normal, m)) {
+        return 1;
+    }
+    const v3f pa = epa.point_a + epa.normal * A.radius;
+    const v3f pb = epa.point_b - epa.normal * B.radius;
+    custom_manifold_add(m, (pa + pb) * 0.5f, epa.depth + radius);
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Triangle meshes
+////////////////////////////////////////////////////////////////////////////////////
+
+inline static void
+custom_mesh_triangle(const custom_shape_t* shape, u32 t, v3f* a, v3f* b, v3f* c) {
+    *a = shape->vertices[shape->indices[t*3+0]];
+    *b = shape->vertices[shape->indices[t*3+1]];
+    *c = shape->vertices[shape->indices[t*3+2]];
+}
+
+static void
+custom_build_bvh(arena_t* arena, custom_shape_t* shape) {
+    TIMED_FUNCTION;
+    const u32 triangle_count = shape->triangle_count;
+
+    tag_array(shape->nodes, custom_bvh_node_t, arena, glm::max(triangle_count * 2, 1u));
+    tag_array(u32* order, u32, arena, glm::max(triangle_count, 1u));
+    tag_array(v3f* centroids, v3f, arena, glm::max(triangle_count, 1u));
+
+    range_u32(t, 0, triangle_count) {
+        v3f a, b, c;
+        custom_mesh_triangle(shape, t, &a, &b, &c);
+        centroids[t] = (a + b + c) / 3.0f;
+        order[t] = t;
+    }
+
+    shape->node_count = 1;
+    shape->nodes[0].first = 0;
+    shape->nodes[0].count = triangle_count;
+
+    u32 stack[64];
+    u32 stack_count = 0;
+    stack[stack_count++] = 0;
+
+    while (stack_count) {
+        const u32 node_index = stack[--stack_count];
+        auto* node = shape->nodes + node_index;
+        const u32 first = node->first;
+        const u32 count = node->count;
+
+        node->aabb = {};
+        math::rect3d_t centroid_bounds{};
+        range_u32(i, first, first + count) {
+            v3f a, b, c;
+            custom_mesh_triangle(shape, order[i], &a, &b, &c);
+            node->aabb.expand(a);
+            node->aabb.expand(b);
+            node->aabb.expand(c);
+            centroid_bounds.expand(centroids[order[i]]);
+        }
+        if (count <= custom_bvh_leaf_size) {
+            continue;
+        }
+
+        const v3f extent = centroid_bounds.size();
+        const u32 split_axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        const u32 mid = first + count / 2;
+        // median split keeps the tree depth at log2(n), which bounds the stack
+        std::nth_element(order + first, order + mid, order + first + count, [&](u32 l, u32 r) {
+            return centroids[l][split_axis] < centroids[r][split_axis] ||
+                (centroids[l][split_axis] == centroids[r][split_axis] && l < r);
+        });
+
+        const u32 left = shape->node_count;
+        shape->node_count += 2;
+        shape->nodes[left].first = first;
+        shape->nodes[left].count = mid - first;
+        shape->nodes[left + 1].first = mid;
+        shape->nodes[left + 1].count = first + count - mid;
+
+        node->first = left;
+        node->count = 0;
+
+        assert(stack_count + 2 <= array_count(stack));
+        stack[stack_count++] = left + 1;
+        stack[stack_count++] = left;
+    }
+
+    // leaves reference triangles through order, bake it into the index buffer
+    tag_array(u32* sorted_indices, u32, arena, glm::max(triangle_count * 3, 1u));
+    range_u32(i, 0, triangle_count) {
+        range_u32(k, 0, 3) {
+            sorted_indices[i*3+k] = shape->indices[order[i]*3+k];
+        }
+    }
+    shape->indices = sorted_indices;
+}
+
+template <typename Fn>
+static void
+custom_bvh_query(const custom_shape_t* shape, const math::rect3d_t& aabb, Fn&& fn) {
+    if (shape->node_count == 0) return;
+    u32 stack[64];
+    u32 stack_count = 0;
+    stack[stack_count++] = 0;
+    while (stack_count) {
+        const auto* node = shape->nodes + stack[--stack_count];
+        if (!node->aabb.intersect(aabb)) {
+            continue;
+        }
+        if (node->count) {
+            range_u32(t, node->first, node->first + node->count) {
+                fn(t);
+            }
+        } else {
+            stack[stack_count++] = node->first + 1;
+            stack[stack_count++] = node->first;
+        }
+    }
+}
+
+// returns entry distance along the ray or a negative number on a miss
+inline static f32
+custom_ray_aabb(const v3f& ro, const v3f& inv_rd, const math::rect3d_t& aabb, f32 max_t) {
+    const v3f t0 = (aabb.min - ro) * inv_rd;
+    const v3f t1 = (aabb.max - ro) * inv_rd;
+    const v3f tmin = glm::min(t0, t1);
+    const v3f tmax = glm::max(t0, t1);
+    const f32 enter = glm::max(glm::max(tmin.x, tmin.y), glm::max(tmin.z, 0.0f));
+    const f32 exit = glm::min(glm::min(tmax.x, tmax.y), glm::min(tmax.z, max_t));
+    return enter <= exit ? enter : -1.0f;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Impl
+////////////////////////////////////////////////////////////////////////////////////
+
+static math::rect3d_t
+custom_shape_body_aabb(const custom_shape_t* shape) {
+    return math::transform_t{shape->origin, shape->rotation}.xform_aabb(shape->local_aabb);
+}
+
+static void
+custom_update_mass(rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+
+    body->local_aabb = {};
+    range_u32(i, 0, custom_body_shape_count(rb)) {
+        collider_t* collider;
+        const auto* shape = custom_body_shape(rb, i, &collider);
+        if (shape && shape->type != collider_shape_type::NONE) {
+            body->local_aabb.expand(custom_shape_body_aabb(shape));
+        }
+    }
+    if (body->local_aabb.min.x > body->local_aabb.max.x) {
+        body->local_aabb = math::rect3d_t{v3f{-0.5f}, v3f{0.5f}};
+    }
+
+    if (rb->type == rigidbody_type::DYNAMIC && rb->mass > 0.0f) {
+        // solid box over the body bounds
+        const v3f s = body->local_aabb.size();
+        const v3f inertia = v3f{
+            s.y*s.y + s.z*s.z,
+            s.x*s.x + s.z*s.z,
+            s.x*s.x + s.y*s.y,
+        } * (rb->mass / 12.0f);
+
+        body->inverse_mass = 1.0f / rb->mass;
+        body->inverse_inertia = v3f{
+            inertia.x > 0.0f ? 1.0f / inertia.x : 0.0f,
+            inertia.y > 0.0f ? 1.0f / inertia.y : 0.0f,
+            inertia.z > 0.0f ? 1.0f / inertia.z : 0.0f,
+        };
+        rb->inertia = m33{1.0f};
+        rb->inverse_inertia = m33{1.0f};
+        range_u32(i, 0, 3) {
+            rb->inertia[i][i] = inertia[i];
+            rb->inverse_inertia[i][i] = body->inverse_inertia[i];
+        }
+    } else {
+        body->inverse_mass = 0.0f;
+        body->inverse_inertia = v3f{0.0f};
+        rb->inertia = rb->inverse_inertia = m33{0.0f};
+    }
+}
+
+inline static void
+custom_mark_unsorted(custom_backend_t* backend, const rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+    if ((body->flags & CustomBodyFlags_InOrder) && (body->flags & CustomBodyFlags_Unsorted) == 0) {
+        body->flags |= CustomBodyFlags_Unsorted;
+        backend->unsorted[backend->unsorted_count++] = rb->index;
+    }
+}
+
+inline static void
+custom_update_body_bounds(rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+    body->aabb = math::transform_t{rb->position(), rb->orientation()}.xform_aabb(body->local_aabb);
+    body->aabb.pull(v3f{custom_aabb_margin});
+    custom_mark_unsorted(get_custom(rb->api), rb);
+}
+
+inline static void
+custom_update_world_inertia(rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+    const m33 r = glm::toMat3(rb->orientation());
+    m33 local{0.0f};
+    range_u32(i, 0, 3) {
+        local[i][i] = body->inverse_inertia[i];
+    }
+    body->world_inverse_inertia = r * local * glm::transpose(r);
+}
+
+static void
+custom_set_character_shape(rigidbody_t* rb, f32 height, f32 radius) {
+    auto* shape = &custom_get_body(rb)->character;
+    shape->type = collider_shape_type::CAPSULE;
+    shape->radius = radius;
+    shape->half_height = height * 0.5f;
+    shape->local_aabb = math::rect3d_t{
+        -v3f{radius, shape->half_height + radius, radius},
+         v3f{radius, shape->half_height + radius, radius}
+    };
+    custom_update_mass(rb);
+    custom_update_body_bounds(rb);
+}
+
+inline static math::transform_t*
+custom_entity_transform(const api_t* api, const rigidbody_t* rb) {
+    if (api->entity_transform_offset == 0 || rb->user_data == 0) {
+        return nullptr;
+    }
+    return (math::transform_t*)((u8*)rb->user_data + api->entity_transform_offset);
+}
+
+inline static b32
+custom_is_awake(const rigidbody_t* rb) {
+    return rb->type != rigidbody_type::STATIC && (rb->flags & rigidbody_flags::IS_SLEEPING) == 0;
+}
+
+static void
+custom_dynamic_list_add(custom_backend_t* backend, rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+    if (body->dynamic_slot != ~0u) return;
+    body->dynamic_slot = backend->dynamic_count;
+    backend->dynamic_bodies[backend->dynamic_count++] = rb->index;
+}
+
+static void
+custom_dynamic_list_remove(api_t* api, custom_backend_t* backend, rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+    if (body->dynamic_slot == ~0u) return;
+    const u32 last = backend->dynamic_bodies[--backend->dynamic_count];
+    backend->dynamic_bodies[body->dynamic_slot] = last;
+    backend->bodies[last].dynamic_slot = body->dynamic_slot;
+    body->dynamic_slot = ~0u;
+
+    backend->integrate[rb->index] = 0.0f;
+    backend->inverse_mass[rb->index] = 0.0f;
+    backend->gravity[rb->index] = 0.0f;
+    backend->linear_damping[rb->index] = 0.0f;
+}
+
+static void
+custom_wake_body(custom_backend_t* backend, rigidbody_t* rb) {
+    auto* body = custom_get_body(rb);
+    body->sleep_timer = 0.0f;
+    if ((rb->flags & rigidbody_flags::IS_SLEEPING) == 0) return;
+    rb->flags &= ~rigidbody_flags::IS_SLEEPING;
+    if (body->flags & CustomBodyFlags_InScene) {
+        custom_dynamic_list_add(backend, rb);
+    }
+}
+
+static void
+custom_sleep_body(api_t* api, custom_backend_t* backend, rigidbody_t* rb) {
+    rb->flags |= rigidbody_flags::IS_SLEEPING;
+    rb->velocity() = v3f{0.0f};
+    rb->angular_velocity() = v3f{0.0f};
+    custom_dynamic_list_remove(api, backend, rb);
+}
+
+// anything pushing on a body wakes it
+inline static void
+custom_wake(rigidbody_t* rb) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        custom_wake_body(get_custom(rb->api), rb);
+    }
+}
+
+void custom_rigidbody_wake(rigidbody_t* rb) {
+    custom_wake(rb);
+}
+
+void custom_rigidbody_set_collision_flags(rigidbody_t* rb) {
+    // layer and group are read straight from the rigidbody during the broadphase
+}
+
+void custom_rigidbody_set_character_radius(rigidbody_t* rb, f32 x) {
+    if (rb->type == rigidbody_type::CHARACTER) {
+        custom_set_character_shape(rb, custom_get_body(rb)->character.half_height * 2.0f, x);
+    }
+}
+
+void custom_rigidbody_set_character_height(rigidbody_t* rb, f32 x) {
+    if (rb->type == rigidbody_type::CHARACTER) {
+        custom_set_character_shape(rb, x, custom_get_body(rb)->character.radius);
+    }
+}
+
+void custom_rigidbody_set_mass(rigidbody_t* rb, f32 x) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        rb->mass = x;
+        custom_update_mass(rb);
+        custom_wake(rb);
+    }
+}
+
+void custom_rigidbody_set_ccd(rigidbody_t* rb, bool x) {
+    auto* body = custom_get_body(rb);
+    if (x) {
+        body->flags |= CustomBodyFlags_CCD;
+    } else {
+        body->flags &= ~CustomBodyFlags_CCD;
+    }
+}
+
+void custom_rigidbody_set_gravity(rigidbody_t* rb, bool x) {
+    auto* body = custom_get_body(rb);
+    if (x) {
+        body->flags |= CustomBodyFlags_Gravity;
+    } else {
+        body->flags &= ~CustomBodyFlags_Gravity;
+    }
+    custom_wake(rb);
+}
+
+void custom_rigidbody_set_velocity(rigidbody_t* rb, const v3f& v) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        rb->velocity() = v;
+        custom_wake(rb);
+    }
+}
+
+void custom_rigidbody_add_impulse(rigidbody_t* rb, const v3f& v) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        rb->velocity() += v * custom_impulse_scale * custom_get_body(rb)->inverse_mass;
+        custom_wake(rb);
+    } else if (rb->type == rigidbody_type::CHARACTER) {
+        rb->velocity() += v / rb->mass;
+    }
+}
+
+void custom_rigidbody_add_force(rigidbody_t* rb, const v3f& v) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        rb->force() += v;
+        custom_wake(rb);
+    }
+}
+
+void custom_rigidbody_add_force_at_point(rigidbody_t* rb, const v3f& v, const v3f& p) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        rb->force() += v;
+        rb->torque() += glm::cross(p - rb->position(), v);
+        custom_wake(rb);
+    }
+}
+
+void custom_collider_set_transform(const collider_t* collider, const math::transform_t& transform) {
+    auto* shape = (custom_shape_t*)collider->shape;
+    shape->origin = transform.origin;
+    shape->rotation = transform.get_orientation();
+    custom_update_mass(collider->rigidbody);
+    custom_update_body_bounds(collider->rigidbody);
+    custom_wake(collider->rigidbody);
+}
+
+math::transform_t custom_collider_get_transform(const collider_t* collider) {
+    const auto* shape = (custom_shape_t*)collider->shape;
+    return math::transform_t{shape->origin, shape->rotation};
+}
+
+void custom_collider_set_active(collider_t* collider, bool x) {
+    ((custom_shape_t*)collider->shape)->active = x;
+    custom_wake(collider->rigidbody);
+}
+
+void custom_collider_set_trigger(collider_t* collider, bool x) {
+    collider->is_trigger = x;
+    custom_wake(collider->rigidbody);
+}
+
+// wakes sleeping bodies whose bounds touch aabb, the order can be unsorted here so this is a linear scan
+static void
+custom_wake_overlapping(api_t* api, custom_backend_t* backend, const math::rect3d_t& aabb) {
+    range_u32(i, 0, backend->order_count) {
+        auto* other = &api->rigidbodies[backend->order[i]];
+        if (other->is_sleeping() && backend->bodies[backend->order[i]].aabb.intersect(aabb)) {
+            custom_wake_body(backend, other);
+        }
+    }
+}
+
 void
 custom_remove_rigidbody(api_t* api, rigidbody_t* rb) {
+    auto* backend = get_custom(api);
+    auto* body = custom_get_body(rb);
+    assert(body);
+
+    if ((body->flags & CustomBodyFlags_InScene) == 0) {
+        return;
+    }
+
+    body->flags &= ~CustomBodyFlags_InScene;
+    backend->order_dirty = 1;
+
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        custom_dynamic_list_remove(api, backend, rb);
+    }
+
+    // whatever was resting on this body has lost its support
+    custom_wake_overlapping(api, backend, body->aabb);
+
+    if (rb->type == rigidbody_type::CHARACTER) {
+        for (u64 i = 0; i < api->character_count; i++) {
+            if (api->characters[i] == rb) {
+                std::swap(api->characters[i], api->characters[--api->character_count]);
+                break;
+            }
+        }
+    }
 }
 
 void
 custom_add_rigidbody(api_t* api, rigidbody_t* rb) {
+    auto* backend = get_custom(api);
+    auto* body = custom_get_body(rb);
+    assert(body);
+
+    if (body->flags & CustomBodyFlags_InScene) {
+        return;
+    }
+
+    body->flags |= CustomBodyFlags_InScene;
+    custom_update_body_bounds(rb);
+
+    if ((body->flags & CustomBodyFlags_InOrder) == 0) {
+        assert(backend->order_count < PHYSICS_MAX_RIGIDBODY_COUNT);
+        body->flags |= CustomBodyFlags_InOrder;
+        backend->order[backend->order_count++] = custom_body_index(api, rb);
+        backend->order_dirty = 1;
+        custom_mark_unsorted(backend, rb);
+    }
+
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        rb->flags &= ~rigidbody_flags::IS_SLEEPING;
+        body->sleep_timer = 0.0f;
+        custom_dynamic_list_add(backend, rb);
+    }
+
+    if (rb->type == rigidbody_type::CHARACTER) {
+        assert(api->character_count < PHYSICS_MAX_CHARACTER_COUNT);
+        api->characters[api->character_count++] = rb;
+    }
 }
 
+// index is a slot the caller already took off rigidbody_count
 static rigidbody_t*
 custom_create_rigidbody_impl(
     api_t* api,
+    u32 index,
     rigidbody_type type,
-    void* data
+    void* data,
+    v3f position,
+    quat orientation
 ) {
-    assert(api->rigidbody_count < PHYSICS_MAX_RIGIDBODY_COUNT);
-    rigidbody_t* rb = &api->rigidbodies[api->rigidbody_count++];
-    *rb = rigidbody_t{api};
+    auto* backend = get_custom(api);
+    rigidbody_t* rb = &api->rigidbodies[index];
+    *rb = rigidbody_t{api, index};
+    rb->reset_state(position, orientation);
+
+    auto* body = backend->bodies + index;
+    *body = custom_body_t{};
+    body->flags = CustomBodyFlags_Gravity;
+
+    rb->type = type;
+    rb->user_data = data;
+    rb->api_data = body;
+
+    if (type == rigidbody_type::CHARACTER) {
+        custom_set_character_shape(rb, custom_character_height, custom_character_radius);
+    } else {
+        custom_update_mass(rb);
+    }
+
+    custom_add_rigidbody(api, rb);
     return rb;
 }
 
+// render meshes have far more points than a hull needs, keeps the point furthest along each of
+// max_count directions spread over the sphere, the hull is the same wherever those directions hit a corner
+static u32
+custom_reduce_hull(const v3f* points, u32 point_count, v3f* out, u32 max_count) {
+    constexpr f32 golden_angle = 2.39996323f;
+    u32 count = 0;
+    range_u32(d, 0, max_count) {
+        const f32 y = 1.0f - 2.0f * (f32(d) + 0.5f) / f32(max_count);
+        const f32 r = glm::sqrt(glm::max(0.0f, 1.0f - y * y));
+        const v3f dir{glm::cos(golden_angle * f32(d)) * r, y, glm::sin(golden_angle * f32(d)) * r};
+
+        u32 best = 0;
+        range_u32(i, 1, point_count) {
+            if (glm::dot(points[i], dir) > glm::dot(points[best], dir)) {
+                best = i;
+            }
+        }
+        b32 seen = 0;
+        range_u32(k, 0, count) {
+            seen |= out[k] == points[best];
+        }
+        if (!seen) {
+            out[count++] = points[best];
+        }
+    }
+    return count;
+}
+
+static b32
+custom_load_geometry(
+    arena_t* arena,
+    custom_shape_t* shape,
+    const v3f* vertices,
+    u32 vertex_count,
+    const u32* indices,
+    u32 index_count,
+    b32 triangles
+) {
+    if (vertices == nullptr || vertex_count == 0 || (triangles && (indices == nullptr || index_count < 3))) {
+        return 0;
+    }
+
+    // copy out of the caller so the collider outlives the resource file
+    if (!triangles && vertex_count > custom_max_hull_vertices) {
+        tag_array(shape->vertices, v3f, arena, custom_max_hull_vertices);
+        shape->vertex_count = custom_reduce_hull(vertices, vertex_count, shape->vertices, custom_max_hull_vertices);
+    } else {
+        tag_array(shape->vertices, v3f, arena, vertex_count);
+        utl::copy(shape->vertices, vertices, sizeof(v3f) * vertex_count);
+        shape->vertex_count = vertex_count;
+    }
+
+    range_u32(i, 0, shape->vertex_count) {
+        shape->local_aabb.expand(shape->vertices[i]);
+    }
+
+    if (triangles) {
+        shape->triangle_count = index_count / 3;
+        tag_array(shape->indices, u32, arena, shape->triangle_count * 3);
+        utl::copy(shape->indices, indices, sizeof(u32) * shape->triangle_count * 3);
+        range_u32(i, 0, shape->triangle_count * 3) {
+            if (shape->indices[i] >= vertex_count) {
+                shape->triangle_count = 0;
+                return 0;
+            }
+        }
+        custom_build_bvh(arena, shape);
+    }
+    return 1;
+}
+
+static b32
+custom_load_mesh(arena_t* arena, custom_shape_t* shape, std::byte* data, size_t size, b32 triangles) {
+    if (data == nullptr || size < sizeof(custom_mesh_header_t)) {
+        return 0;
+    }
+    custom_mesh_header_t header;
+    utl::copy(&header, data, sizeof(header));
+    if (header.magic != custom_mesh_magic) {
+        return 0;
+    }
+    const size_t expected = sizeof(header) + sizeof(v3f) * header.vertex_count + sizeof(u32) * header.index_count;
+    if (expected > size) {
+        return 0;
+    }
+    const auto* vertices = (const v3f*)(data + sizeof(header));
+    const auto* indices = (const u32*)(data + sizeof(header) + sizeof(v3f) * header.vertex_count);
+    return custom_load_geometry(arena, shape, vertices, header.vertex_count, indices, header.index_count, triangles);
+}
+
 static void
 custom_create_collider_impl(
     api_t* api,
@@ -34,58 +1626,1400 @@ custom_create_collider_impl(
     void* info
 ) {
     assert(rigidbody->collider_count < RIGIDBODY_MAX_COLLIDER_COUNT);
-    local_persist u64 s_collider_id = 1; 
+    assert(rigidbody->type != rigidbody_type::CHARACTER);
+    local_persist u64 s_collider_id = 1;
     collider_t* col = &rigidbody->colliders[rigidbody->collider_count++];
     *col = {};
     col->id = s_collider_id++;
+    col->rigidbody = rigidbody;
+
+    tag_struct(auto* shape, custom_shape_t, api->arena);
+    col->shape = shape;
+
+    switch (col->type = shape->type = type) {
+        case collider_shape_type::CONVEX: {
+            auto* ci = (collider_convex_info_t*)info;
+            const b32 loaded = ci->vertices
+                ? custom_load_geometry(api->arena, shape, ci->vertices, ci->vertex_count, 0, 0, 0)
+                : custom_load_mesh(api->arena, shape, ci->mesh, ci->size, 0);
+            if (!loaded) {
+                ztd_warn(__FUNCTION__, "Convex collider has no geometry or custom mesh blob, collider disabled");
+                shape->type = collider_shape_type::NONE;
+            }
+        }   break;
+        case collider_shape_type::TRIMESH: {
+            auto* ci = (collider_trimesh_info_t*)info;
+            const b32 loaded = ci->vertices
+                ? custom_load_geometry(api->arena, shape, ci->vertices, ci->vertex_count, ci->indices, ci->index_count, 1)
+                : custom_load_mesh(api->arena, shape, ci->mesh, ci->size, 1);
+            if (!loaded) {
+                ztd_warn(__FUNCTION__, "Trimesh collider has no geometry or custom mesh blob, collider disabled");
+                shape->type = collider_shape_type::NONE;
+            }
+        }   break;
+        case collider_shape_type::SPHERE: {
+            auto* ci = (collider_sphere_info_t*)info;
+            shape->origin = ci->origin;
+            shape->radius = ci->radius;
+            shape->local_aabb = math::rect3d_t{v3f{-ci->radius}, v3f{ci->radius}};
+
+            col->sphere.origin = ci->origin;
+            col->sphere.radius = ci->radius;
+        }   break;
+        case collider_shape_type::CAPSULE: {
+            auto* ci = (collider_capsule_info_t*)info;
+            shape->origin = ci->origin;
+            shape->radius = ci->radius;
+            shape->half_height = ci->height * 0.5f;
+            const v3f extent{ci->radius, shape->half_height + ci->radius, ci->radius};
+            shape->local_aabb = math::rect3d_t{-extent, extent};
+
+            col->sphere.origin = ci->origin;
+            col->sphere.radius = ci->radius;
+        }   break;
+        case collider_shape_type::BOX: {
+            // size is a half extent, same as PxBoxGeometry
+            auto* ci = (collider_box_info_t*)info;
+            shape->origin = ci->origin;
+            shape->rotation = ci->rot;
+            shape->half_size = ci->size;
+            shape->local_aabb = math::rect3d_t{-ci->size, ci->size};
+
+            col->box = {};
+            col->box.expand(ci->origin + ci->size);
+            col->box.expand(ci->origin - ci->size);
+        }   break;
+        case_invalid_default;
+    }
+
+    custom_update_mass(rigidbody);
+    custom_update_body_bounds(rigidbody);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Simulation
+////////////////////////////////////////////////////////////////////////////////////
+
+// keeps the order array sorted by aabb.min.x, bodies barely move between steps so this is close to linear
+static void
+custom_broadphase_sort(api_t* api, custom_backend_t* backend) {
+    TIMED_FUNCTION;
+    if (backend->order_dirty) {
+        u32 count = 0;
+        range_u32(i, 0, backend->order_count) {
+            auto* body = backend->bodies + backend->order[i];
+            if (body->flags & CustomBodyFlags_InScene) {
+                backend->order[count++] = backend->order[i];
+            } else {
+                body->flags &= ~CustomBodyFlags_InOrder;
+            }
+        }
+        backend->order_count = count;
+        backend->order_dirty = 0;
+    }
+
+    backend->max_extent_x = 0.0f;
+    range_u32(i, 0, backend->order_count) {
+        auto* rb = &api->rigidbodies[backend->order[i]];
+        if (custom_is_awake(rb)) {
+            custom_update_body_bounds(rb);
+        }
+        const auto& aabb = backend->bodies[backend->order[i]].aabb;
+        backend->max_extent_x = glm::max(backend->max_extent_x, aabb.max.x - aabb.min.x);
+    }
+
+    const auto less = [backend](u32 l, u32 r) {
+        const f32 lx = backend->bodies[l].aabb.min.x;
+        const f32 rx = backend->bodies[r].aabb.min.x;
+        return lx < rx || (lx == rx && l < r);
+    };
+    range_u32(i, 1, backend->order_count) {
+        const u32 key = backend->order[i];
+        u32 j = i;
+        while (j > 0 && less(key, backend->order[j-1])) {
+            backend->order[j] = backend->order[j-1];
+            j--;
+        }
+        backend->order[j] = key;
+    }
+
+    range_u32(i, 0, backend->order_count) {
+        backend->order_min_x[i] = backend->bodies[backend->order[i]].aabb.min.x;
+    }
+    backend->sorted_count = backend->order_count;
+    range_u32(i, 0, backend->unsorted_count) {
+        backend->bodies[backend->unsorted[i]].flags &= ~CustomBodyFlags_Unsorted;
+    }
+    backend->unsorted_count = 0;
+}
+
+// first position in the sorted order that can overlap an aabb starting at min_x
+static u32
+custom_broadphase_lower_bound(const custom_backend_t* backend, f32 min_x) {
+    const f32 x = min_x - backend->max_extent_x;
+    u32 lo = 0, hi = backend->sorted_count;
+    while (lo < hi) {
+        const u32 mid = (lo + hi) / 2;
+        if (backend->order_min_x[mid] < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
 }
 
+// calls fn(rb) for every in scene body whose bounds touch aabb. The order is searched with the keys
+// from the last sort, bodies that moved or were added since then are checked one by one.
+// Api is api_t or const api_t so fn gets a rigidbody with the same constness
+template <typename Api, typename Fn>
+static void
+custom_broadphase_query(Api* api, const custom_backend_t* backend, const math::rect3d_t& aabb, Fn&& fn) {
+    for (u32 o = custom_broadphase_lower_bound(backend, aabb.min.x);
+        o < backend->sorted_count && backend->order_min_x[o] <= aabb.max.x; o++
+    ) {
+        const auto* body = backend->bodies + backend->order[o];
+        if (body->flags & CustomBodyFlags_Unsorted) continue;
+        if ((body->flags & CustomBodyFlags_InScene) == 0 || !body->aabb.intersect(aabb)) continue;
+        fn(&api->rigidbodies[backend->order[o]]);
+    }
+    range_u32(u, 0, backend->unsorted_count) {
+        const auto* body = backend->bodies + backend->unsorted[u];
+        if ((body->flags & CustomBodyFlags_InScene) == 0 || !body->aabb.intersect(aabb)) continue;
+        fn(&api->rigidbodies[backend->unsorted[u]]);
+    }
+}
+
+inline static u64
+custom_touch_key(const api_t* api, const rigidbody_t* a, u32 shape_a, const rigidbody_t* b, u32 shape_b) {
+    const u64 ka = (u64(custom_body_index(api, a)) << 4) | shape_a;
+    const u64 kb = (u64(custom_body_index(api, b)) << 4) | shape_b;
+    return (ka << 32) | kb;
+}
+
+static void
+custom_add_touch(api_t* api, custom_backend_t* backend, rigidbody_t* a, u32 shape_a, collider_t* ca, rigidbody_t* b, u32 shape_b, collider_t* cb, b32 trigger) {
+    const u32 frame = backend->touch_frame % 2;
+    if (backend->touch_count[frame] >= custom_max_touches) {
+        return;
+    }
+    auto& touch = backend->touches[frame][backend->touch_count[frame]++];
+    touch.key = custom_touch_key(api, a, shape_a, b, shape_b);
+    touch.a = a;
+    touch.b = b;
+    touch.ca = ca;
+    touch.cb = cb;
+    touch.trigger = trigger;
+}
+
+static void
+custom_add_contacts(api_t* api, custom_backend_t* backend, rigidbody_t* a, rigidbody_t* b, const custom_manifold_t& m) {
+    range_u32(i, 0, m.count) {
+        if (backend->contact_count >= custom_max_contacts) {
+            local_persist b32 warned = 0;
+            if (!warned) {
+                ztd_warn(__FUNCTION__, "Contact buffer full ({}), dropping contacts", custom_max_contacts);
+                warned = 1;
+            }
+            return;
+        }
+        auto& c = backend->contacts[backend->contact_count++];
+        c = custom_contact_t{};
+        c.a = custom_body_index(api, a);
+        c.b = custom_body_index(api, b);
+        c.normal = m.normal;
+        c.point = m.points[i];
+        c.depth = m.depths[i];
+    }
+}
+
+// collides one shape against a trimesh, returns the manifold from a to the mesh
+static b32
+custom_collide_mesh(const custom_world_shape_t& A, const custom_shape_t* mesh, const v3f& mesh_position, const quat& mesh_orientation, f32 margin, custom_manifold_t* result) {
+    const math::transform_t mesh_transform{mesh_position + mesh_orientation * mesh->origin, mesh_orientation * mesh->rotation};
+    auto query = custom_world_shape_aabb(A);
+    query.pull(v3f{margin});
+    const auto local_query = mesh_transform.inverse().xform_aabb(query);
+
+    custom_manifold_t best{};
+    u32 contact_count = 0;
+    result->count = 0;
+    custom_bvh_query(mesh, local_query, [&](u32 t) {
+        if (contact_count >= custom_max_mesh_contacts) return;
+        v3f a, b, c;
+        custom_mesh_triangle(mesh, t, &a, &b, &c);
+        const auto tri = custom_world_triangle(mesh_transform.xform(a), mesh_transform.xform(b), mesh_transform.xform(c));
+        custom_manifold_t m{};
+        if (custom_collide(A, tri, margin, &m)) {
+            range_u32(i, 0, m.count) {
+                if (result->count == 0) {
+                    result->normal = m.normal;
+                }
+                custom_manifold_add(result, m.points[i], m.depths[i]);
+                contact_count++;
+            }
+            if (best.count == 0 || m.depths[0] > best.depths[0]) {
+                best = m;
+            }
+        }
+    });
+    // contacts from many triangles share the deepest normal, this keeps stacks on meshes stable
+    if (best.count) {
+        result->normal = best.normal;
+    }
+    return result->count > 0;
+}
+
+// bodies that can disturb a sleeping body they touch
+inline static b32
+custom_is_mover(const rigidbody_t* rb) {
+    switch (rb->type) {
+        case rigidbody_type::DYNAMIC:   return !rb->is_sleeping();
+        case rigidbody_type::CHARACTER: return 1;
+        default:                        return (custom_get_body(rb)->flags & CustomBodyFlags_Moved) != 0;
+    }
+}
+
+// pairs where neither body is active are skipped, their touches carry over from the last step
+inline static b32
+custom_is_active(const rigidbody_t* rb) {
+    return custom_is_awake(rb) || (custom_get_body(rb)->flags & CustomBodyFlags_Moved);
+}
+
+static void
+custom_narrowphase_pair(api_t* api, custom_backend_t* backend, rigidbody_t* a, rigidbody_t* b, f32 dt) {
+    auto* body_a = custom_get_body(a);
+    auto* body_b = custom_get_body(b);
+
+    const b32 a_character = a->type == rigidbody_type::CHARACTER;
+    const b32 b_character = b->type == rigidbody_type::CHARACTER;
+    const b32 wake_a = a->is_sleeping() && custom_is_mover(b);
+    const b32 wake_b = b->is_sleeping() && custom_is_mover(a);
+    b32 solve = (body_a->inverse_mass + body_b->inverse_mass) > 0.0f && !a->is_sleeping() && !b->is_sleeping();
+
+    f32 margin = 0.0f;
+    if (solve && ((body_a->flags | body_b->flags) & CustomBodyFlags_CCD)) {
+        margin = glm::length(b->velocity() - a->velocity()) * dt;
+    }
+
+    range_u32(i, 0, custom_body_shape_count(a)) {
+        collider_t* ca;
+        auto* shape_a = custom_body_shape(a, i, &ca);
+        if (!shape_a || !shape_a->active || shape_a->type == collider_shape_type::NONE) continue;
+
+        range_u32(j, 0, custom_body_shape_count(b)) {
+            collider_t* cb;
+            auto* shape_b = custom_body_shape(b, j, &cb);
+            if (!shape_b || !shape_b->active || shape_b->type == collider_shape_type::NONE) continue;
+
+            const b32 trigger_a = ca && ca->is_trigger;
+            const b32 trigger_b = cb && cb->is_trigger;
+            if (trigger_a && trigger_b) continue;
+
+            const b32 trigger = trigger_a || trigger_b;
+            if (!trigger) {
+                if (!custom_should_collide(a, b)) continue;
+                // character controllers resolve their own contacts against non dynamic bodies
+                if ((a_character && b->type != rigidbody_type::DYNAMIC) || (b_character && a->type != rigidbody_type::DYNAMIC)) continue;
+            }
+
+            if (shape_a->type == collider_shape_type::TRIMESH && shape_b->type == collider_shape_type::TRIMESH) continue;
+
+            custom_manifold_t m{};
+            b32 hit = 0;
+            if (shape_b->type == collider_shape_type::TRIMESH) {
+                const auto world_a = custom_world_shape(shape_a, a->position(), a->orientation());
+                hit = custom_collide_mesh(world_a, shape_b, b->position(), b->orientation(), trigger ? 0.0f : margin, &m);
+            } else if (shape_a->type == collider_shape_type::TRIMESH) {
+                const auto world_b = custom_world_shape(shape_b, b->position(), b->orientation());
+                hit = custom_collide_mesh(world_b, shape_a, a->position(), a->orientation(), trigger ? 0.0f : margin, &m);
+                m.normal = -m.normal;
+            } else {
+                const auto world_a = custom_world_shape(shape_a, a->position(), a->orientation());
+                const auto world_b = custom_world_shape(shape_b, b->position(), b->orientation());
+                hit = custom_collide(world_a, world_b, trigger ? 0.0f : margin, &m);
+            }
+            if (!hit) continue;
+
+            f32 deepest = -std::numeric_limits<f32>::max();
+            range_u32(k, 0, m.count) {
+                deepest = glm::max(deepest, m.depths[k]);
+            }
+            const b32 touching = deepest > -custom_linear_slop;
+
+            if (trigger) {
+                if (deepest > 0.0f) {
+                    // the trigger is always reported first, like physx
+                    if (trigger_a) {
+                        custom_add_touch(api, backend, a, i, ca, b, j, cb, 1);
+                    } else {
+                        custom_add_touch(api, backend, b, j, cb, a, i, ca, 1);
+                    }
+                }
+                continue;
+            }
+
+            if (touching) {
+                custom_add_touch(api, backend, a, i, ca, b, j, cb, 0);
+                if (wake_a || wake_b) {
+                    if (wake_a) custom_wake_body(backend, a);
+                    if (wake_b) custom_wake_body(backend, b);
+                    solve = (body_a->inverse_mass + body_b->inverse_mass) > 0.0f && !a->is_sleeping() && !b->is_sleeping();
+                }
+            }
+            if (solve) {
+                custom_add_contacts(api, backend, a, b, m);
+            }
+        }
+    }
+}
+
+static void
+custom_find_contacts(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    backend->contact_count = 0;
+
+    // resting pairs arent collided again, keep their touches so no end callbacks fire
+    const u32 frame = backend->touch_frame % 2;
+    backend->touch_count[frame] = 0;
+    range_u32(t, 0, backend->touch_count[!frame]) {
+        const auto& touch = backend->touches[!frame][t];
+        if (!custom_is_active(touch.a) && !custom_is_active(touch.b) &&
+            (custom_get_body(touch.a)->flags & custom_get_body(touch.b)->flags & CustomBodyFlags_InScene)) {
+            backend->touches[frame][backend->touch_count[frame]++] = touch;
+        }
+    }
+
+    range_u32(i, 0, backend->order_count) {
+        auto* a = &api->rigidbodies[backend->order[i]];
+        const auto& aabb_a = backend->bodies[backend->order[i]].aabb;
+
+        range_u32(j, i + 1, backend->order_count) {
+            const auto& aabb_b = backend->bodies[backend->order[j]].aabb;
+            if (aabb_b.min.x > aabb_a.max.x) {
+                break;
+            }
+            auto* b = &api->rigidbodies[backend->order[j]];
+            if (!custom_is_active(a) && !custom_is_active(b)) {
+                continue;
+            }
+            if (!aabb_a.intersect(aabb_b)) {
+                continue;
+            }
+            custom_narrowphase_pair(api, backend, a, b, dt);
+        }
+    }
+}
+
+inline static void
+custom_apply_impulse(rigidbody_t* rb, custom_body_t* body, const v3f& impulse, const v3f& r) {
+    if (rb->type != rigidbody_type::DYNAMIC) return;
+    rb->velocity() += impulse * body->inverse_mass;
+    rb->angular_velocity() += body->world_inverse_inertia * glm::cross(r, impulse);
+}
+
+inline static v3f
+custom_relative_velocity(const rigidbody_t* a, const rigidbody_t* b, const custom_contact_t& c) {
+    const v3f va = a->velocity() + glm::cross(a->angular_velocity(), c.ra);
+    const v3f vb = b->velocity() + glm::cross(b->angular_velocity(), c.rb);
+    return vb - va;
+}
+
+static void
+custom_solve_contacts(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    const f32 inv_dt = 1.0f / dt;
+
+    range_u32(i, 0, backend->contact_count) {
+        auto& c = backend->contacts[i];
+        const auto* a = &api->rigidbodies[c.a];
+        const auto* b = &api->rigidbodies[c.b];
+        const auto* body_a = backend->bodies + c.a;
+        const auto* body_b = backend->bodies + c.b;
+
+        c.ra = c.point - a->position();
+        c.rb = c.point - b->position();
+
+        const auto effective_mass = [&](const v3f& axis_) {
+            const v3f rna = glm::cross(c.ra, axis_);
+            const v3f rnb = glm::cross(c.rb, axis_);
+            const f32 k = body_a->inverse_mass + body_b->inverse_mass +
+                glm::dot(rna, body_a->world_inverse_inertia * rna) +
+                glm::dot(rnb, body_b->world_inverse_inertia * rnb);
+            return k > 0.0f ? 1.0f / k : 0.0f;
+        };
+
+        c.tangent[0] = custom_any_perpendicular(c.normal);
+        c.tangent[1] = glm::cross(c.normal, c.tangent[0]);
+        c.normal_mass = effective_mass(c.normal);
+        c.tangent_mass[0] = effective_mass(c.tangent[0]);
+        c.tangent_mass[1] = effective_mass(c.tangent[1]);
+
+        // positive normal velocity separates the bodies
+        const f32 vn = glm::dot(custom_relative_velocity(a, b, c), c.normal);
+        if (c.depth > 0.0f) {
+            c.bias = custom_baumgarte * inv_dt * glm::max(c.depth - custom_linear_slop, 0.0f);
+        } else {
+            c.bias = c.depth * inv_dt; // speculative, allow closing the gap
+        }
+        if (vn < -custom_restitution_threshold) {
+            c.bias = glm::max(c.bias, -custom_restitution * vn);
+        }
+    }
+
+    range_u32(iteration, 0, custom_solver_iterations) {
+        range_u32(i, 0, backend->contact_count) {
+            auto& c = backend->contacts[i];
+            auto* a = &api->rigidbodies[c.a];
+            auto* b = &api->rigidbodies[c.b];
+            auto* body_a = backend->bodies + c.a;
+            auto* body_b = backend->bodies + c.b;
+
+            range_u32(t, 0, 2) {
+                const f32 vt = glm::dot(custom_relative_velocity(a, b, c), c.tangent[t]);
+                const f32 max_friction = custom_friction * c.normal_impulse;
+                const f32 old_impulse = c.tangent_impulse[t];
+                c.tangent_impulse[t] = glm::clamp(old_impulse - vt * c.tangent_mass[t], -max_friction, max_friction);
+                const v3f impulse = c.tangent[t] * (c.tangent_impulse[t] - old_impulse);
+                custom_apply_impulse(a, body_a, -impulse, c.ra);
+                custom_apply_impulse(b, body_b, impulse, c.rb);
+            }
+
+            const f32 vn = glm::dot(custom_relative_velocity(a, b, c), c.normal);
+            const f32 old_impulse = c.normal_impulse;
+            c.normal_impulse = glm::max(old_impulse + c.normal_mass * (c.bias - vn), 0.0f);
+            const v3f impulse = c.normal * (c.normal_impulse - old_impulse);
+            custom_apply_impulse(a, body_a, -impulse, c.ra);
+            custom_apply_impulse(b, body_b, impulse, c.rb);
+        }
+    }
+}
+
+#if defined(__AVX2__)
+// spreads 8 per body scalars over the 24 floats of 8 packed v3fs
+inline static void
+custom_expand_v3_lanes(__m256 s, __m256 out[3]) {
+    out[0] = _mm256_permutevar8x32_ps(s, _mm256_setr_epi32(0,0,0,1,1,1,2,2));
+    out[1] = _mm256_permutevar8x32_ps(s, _mm256_setr_epi32(2,3,3,3,4,4,4,5));
+    out[2] = _mm256_permutevar8x32_ps(s, _mm256_setr_epi32(5,5,6,6,6,7,7,7));
+}
+#endif
+
+// linear velocity for every body below integrate_count, 8 bodies at a time.
+// Bodies that dont integrate have zeroed scalars so they pass through unchanged
+static void
+custom_integrate_linear_velocity(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    f32* velocity = (f32*)api->body_state.velocity.data();
+    f32* force = (f32*)api->body_state.force.data();
+    const u32 count = backend->integrate_count;
+
+#if defined(__AVX2__)
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    // which of the 24 floats in a block are y components
+    const __m256 y_lanes[3] = {
+        _mm256_setr_ps(0,1,0,0,1,0,0,1),
+        _mm256_setr_ps(0,0,1,0,0,1,0,0),
+        _mm256_setr_ps(1,0,0,1,0,0,1,0),
+    };
+
+    for (u32 i = 0; i < count; i += 8) {
+        const __m256 active = _mm256_loadu_ps(backend->integrate + i);
+        if (_mm256_movemask_ps(_mm256_cmp_ps(active, zero, _CMP_NEQ_OQ)) == 0) {
+            continue;
+        }
+
+        __m256 inverse_mass[3], gravity[3], damping[3];
+        custom_expand_v3_lanes(_mm256_mul_ps(_mm256_loadu_ps(backend->inverse_mass + i), dt8), inverse_mass);
+        custom_expand_v3_lanes(_mm256_mul_ps(_mm256_loadu_ps(backend->gravity + i), dt8), gravity);
+        custom_expand_v3_lanes(_mm256_div_ps(one, _mm256_add_ps(one, _mm256_mul_ps(_mm256_loadu_ps(backend->linear_damping + i), dt8))), damping);
+
+        range_u32(k, 0, 3) {
+            f32* v = velocity + i * 3 + k * 8;
+            f32* f = force + i * 3 + k * 8;
+            __m256 vel = _mm256_loadu_ps(v);
+            vel = _mm256_add_ps(vel, _mm256_mul_ps(_mm256_loadu_ps(f), inverse_mass[k]));
+            vel = _mm256_sub_ps(vel, _mm256_mul_ps(y_lanes[k], gravity[k]));
+            _mm256_storeu_ps(v, _mm256_mul_ps(vel, damping[k]));
+            _mm256_storeu_ps(f, zero);
+        }
+    }
+#else
+    range_u32(i, 0, count) {
+        if (backend->integrate[i] == 0.0f) continue;
+        const f32 damping = 1.0f / (1.0f + dt * backend->linear_damping[i]);
+        range_u32(k, 0, 3) {
+            f32 v = velocity[i*3+k] + force[i*3+k] * backend->inverse_mass[i] * dt;
+            if (k == 1) v -= backend->gravity[i] * dt;
+            velocity[i*3+k] = v * damping;
+            force[i*3+k] = 0.0f;
+        }
+    }
+#endif
+}
+
+static void
+custom_integrate_linear_position(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    f32* position = (f32*)api->body_state.position.data();
+    const f32* velocity = (const f32*)api->body_state.velocity.data();
+    const u32 count = backend->integrate_count;
+
+#if defined(__AVX2__)
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    const __m256 zero = _mm256_setzero_ps();
+    for (u32 i = 0; i < count; i += 8) {
+        const __m256 active = _mm256_loadu_ps(backend->integrate + i);
+        if (_mm256_movemask_ps(_mm256_cmp_ps(active, zero, _CMP_NEQ_OQ)) == 0) {
+            continue;
+        }
+        __m256 step[3];
+        custom_expand_v3_lanes(_mm256_mul_ps(active, dt8), step);
+        range_u32(k, 0, 3) {
+            f32* p = position + i * 3 + k * 8;
+            const __m256 v = _mm256_loadu_ps(velocity + i * 3 + k * 8);
+            _mm256_storeu_ps(p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(v, step[k])));
+        }
+    }
+#else
+    range_u32(i, 0, count) {
+        const f32 step = backend->integrate[i] * dt;
+        range_u32(k, 0, 3) {
+            position[i*3+k] += velocity[i*3+k] * step;
+        }
+    }
+#endif
+}
+
+// refreshes the per body integration scalars and does the rotational half, which needs the
+// world inertia and doesnt vectorize across bodies
+static void
+custom_integrate_velocities(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    u32 integrate_count = 0;
+    range_u32(d, 0, backend->dynamic_count) {
+        const u32 i = backend->dynamic_bodies[d];
+        auto* rb = &api->rigidbodies[i];
+        auto* body = backend->bodies + i;
+
+        backend->integrate[i] = 1.0f;
+        backend->inverse_mass[i] = body->inverse_mass;
+        backend->gravity[i] = (body->flags & CustomBodyFlags_Gravity) ? custom_gravity : 0.0f;
+        backend->linear_damping[i] = rb->linear_dampening;
+        integrate_count = glm::max(integrate_count, i + 1);
+
+        custom_update_world_inertia(rb);
+        auto& angular_velocity = rb->angular_velocity();
+        auto& torque = rb->torque();
+        angular_velocity += body->world_inverse_inertia * torque * dt;
+        angular_velocity *= 1.0f / (1.0f + dt * rb->angular_dampening);
+        torque = v3f{0.0f};
+    }
+    backend->integrate_count = (integrate_count + 7) & ~7u;
+
+    custom_integrate_linear_velocity(api, backend, dt);
+}
+
+static void
+custom_integrate_positions(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    custom_integrate_linear_position(api, backend, dt);
+
+    range_u32(d, 0, backend->dynamic_count) {
+        const u32 i = backend->dynamic_bodies[d];
+        const v3f& w = api->body_state.angular_velocity[i];
+        quat& q = api->body_state.orientation[i];
+        q += (glm::quat(0.0f, w) * q) * (0.5f * dt);
+        q = glm::normalize(q);
+    }
+}
+
+// kinematic capsule sweep, mirrors the physx controller: collide and slide against everything
+// and report ground/wall contacts through the rigidbody flags
+static void
+custom_move_characters(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    constexpr u32 max_iterations = 4;
+    constexpr f32 ground_slope = 0.7f;
+
+    range_u64(c, 0, api->character_count) {
+        auto* rb = api->characters[c];
+        if (!rb) continue;
+        auto* body = custom_get_body(rb);
+
+        const v3f start = rb->position();
+        const v3f displacement = rb->velocity() * dt * custom_character_velocity_scale;
+        const f32 vm = glm::length(rb->velocity());
+        const f32 move_length = glm::length(displacement);
+
+        b32 down = 0, side = 0, up = 0;
+        rb->position() += displacement;
+
+        rigidbody_t* hits[16];
+        u32 hit_count = 0;
+
+        range_u32(iteration, 0, max_iterations) {
+            custom_shape_t skin = body->character;
+            skin.radius += custom_character_skin;
+            const auto capsule = custom_world_shape(&skin, rb->position(), quat{1.0f, 0.0f, 0.0f, 0.0f});
+            const auto query = custom_world_shape_aabb(capsule);
+
+            b32 resolved = 1;
+            custom_broadphase_query(api, backend, query, [&](rigidbody_t* other) {
+                if (other == rb || !custom_should_collide(rb, other)) return;
+
+                range_u32(s, 0, custom_body_shape_count(other)) {
+                    collider_t* collider;
+                    auto* shape = custom_body_shape(other, s, &collider);
+                    if (!shape || !shape->active || shape->type == collider_shape_type::NONE) continue;
+                    if (collider && collider->is_trigger) continue;
+
+                    custom_manifold_t m{};
+                    b32 hit = 0;
+                    if (shape->type == collider_shape_type::TRIMESH) {
+                        hit = custom_collide_mesh(capsule, shape, other->position(), other->orientation(), 0.0f, &m);
+                    } else {
+                        hit = custom_collide(capsule, custom_world_shape(shape, other->position(), other->orientation()), 0.0f, &m);
+                    }
+                    if (!hit) continue;
+
+                    f32 depth = 0.0f;
+                    range_u32(k, 0, m.count) {
+                        depth = glm::max(depth, m.depths[k]);
+                    }
+                    if (depth <= 0.0f) continue;
+
+                    // normal points from the character to what it hit
+                    if (m.normal.y < -ground_slope) {
+                        down = 1;
+                    } else if (m.normal.y > ground_slope) {
+                        up = 1;
+                    } else {
+                        side = 1;
+                        if (other->type == rigidbody_type::DYNAMIC && move_length > 0.0f) {
+                            const v3f push = glm::normalize(v3f{m.normal.x, 0.0f, m.normal.z} + v3f{1e-6f, 0.0f, 0.0f});
+                            custom_wake(other);
+                            other->force() += push * move_length * custom_character_push_force;
+                        }
+                    }
+
+                    const f32 push_out = depth - custom_character_skin;
+                    if (push_out > 0.0f && other->type != rigidbody_type::DYNAMIC) {
+                        rb->position() -= m.normal * push_out;
+                        resolved = 0;
+                    }
+
+                    b32 reported = 0;
+                    range_u32(h, 0, hit_count) {
+                        reported |= hits[h] == other;
+                    }
+                    if (!reported && hit_count < array_count(hits)) {
+                        hits[hit_count++] = other;
+                        if (rb->on_collision) {
+                            rb->on_collision(rb, other, 0, collider);
+                        }
+                        if (other->on_collision) {
+                            other->on_collision(other, rb, collider, 0);
+                        }
+                    }
+                }
+            });
+            if (resolved) break;
+        }
+
+        if (down) {
+            rb->flags |= rigidbody_flags::IS_ON_GROUND;
+        } else {
+            rb->flags &= ~rigidbody_flags::IS_ON_GROUND;
+        }
+        if (side) {
+            rb->velocity() = rb->position() - start;
+            rb->flags |= rigidbody_flags::IS_ON_WALL;
+        } else {
+            if (up) {
+                rb->velocity() = rb->position() - start;
+            }
+            rb->flags &= ~rigidbody_flags::IS_ON_WALL;
+        }
+        if (glm::length(rb->velocity()) > vm) {
+            rb->velocity() = glm::normalize(rb->velocity()) * vm;
+        }
+
+        custom_update_body_bounds(rb);
+        if (auto* transform = custom_entity_transform(api, rb)) {
+            transform->origin = rb->position();
+        }
+    }
+}
+
+// compares this steps touching pairs with the last and fires the begin/end callbacks
+static void
+custom_dispatch_touches(api_t* api, custom_backend_t* backend) {
+    TIMED_FUNCTION;
+    const u32 frame = backend->touch_frame % 2;
+    auto* current = backend->touches[frame];
+    auto* last = backend->touches[!frame];
+    u32 current_count = backend->touch_count[frame];
+    const u32 last_count = backend->touch_count[!frame];
+
+    std::sort(current, current + current_count, [](const custom_touch_t& l, const custom_touch_t& r) {
+        return l.key < r.key;
+    });
+    // a carried over touch can be found again when one of its bodies wakes mid step
+    current_count = safe_truncate_u64(std::unique(current, current + current_count, [](const custom_touch_t& l, const custom_touch_t& r) {
+        return l.key == r.key;
+    }) - current);
+    backend->touch_count[frame] = current_count;
+
+    const auto in_scene = [](const rigidbody_t* rb) {
+        return (custom_get_body(rb)->flags & CustomBodyFlags_InScene) != 0;
+    };
+
+    const auto begin = [](const custom_touch_t& t) {
+        if (t.trigger) {
+            if (t.a->on_trigger) t.a->on_trigger(t.a, t.b, t.ca, t.cb);
+        } else {
+            if (t.a->on_collision) t.a->on_collision(t.a, t.b, t.ca, t.cb);
+            if (t.b->on_collision) t.b->on_collision(t.b, t.a, t.cb, t.ca);
+        }
+    };
+    const auto end = [](const custom_touch_t& t) {
+        if (t.trigger) {
+            if (t.a->on_trigger_end) t.a->on_trigger_end(t.a, t.b, t.ca, t.cb);
+        } else {
+            if (t.a->on_collision_end) t.a->on_collision_end(t.a, t.b, t.ca, t.cb);
+            if (t.b->on_collision_end) t.b->on_collision_end(t.b, t.a, t.cb, t.ca);
+        }
+    };
+
+    u32 i = 0, j = 0;
+    while (i < current_count || j < last_count) {
+        if (j == last_count || (i < current_count && current[i].key < last[j].key)) {
+            begin(current[i++]);
+        } else if (i == current_count || last[j].key < current[i].key) {
+            if (in_scene(last[j].a) && in_scene(last[j].b)) {
+                end(last[j]);
+            }
+            j++;
+        } else {
+            i++; j++;
+        }
+    }
+
+    backend->touch_frame++;
+}
+
+inline static u32
+custom_island_find(u32* parent, u32 i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// dynamic bodies joined by contacts form islands, an island sleeps once all of its bodies
+// have been slow for custom_time_to_sleep. Static and kinematic bodies dont join islands
+static void
+custom_update_islands(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    auto* parent = backend->island_parent;
+    auto* island_time = backend->island_sleep_time;
+
+    range_u32(d, 0, backend->dynamic_count) {
+        const u32 i = backend->dynamic_bodies[d];
+        parent[i] = i;
+        island_time[i] = std::numeric_limits<f32>::max();
+    }
+
+    range_u32(c, 0, backend->contact_count) {
+        const auto& contact = backend->contacts[c];
+        if (backend->bodies[contact.a].dynamic_slot == ~0u || backend->bodies[contact.b].dynamic_slot == ~0u) {
+            continue;
+        }
+        const u32 ra = custom_island_find(parent, contact.a);
+        const u32 rb = custom_island_find(parent, contact.b);
+        if (ra != rb) {
+            // lowest index is the root so the result doesnt depend on contact order
+            parent[glm::max(ra, rb)] = glm::min(ra, rb);
+        }
+    }
+
+    constexpr f32 linear2 = custom_sleep_linear_velocity * custom_sleep_linear_velocity;
+    constexpr f32 angular2 = custom_sleep_angular_velocity * custom_sleep_angular_velocity;
+    range_u32(d, 0, backend->dynamic_count) {
+        const u32 i = backend->dynamic_bodies[d];
+        auto* body = backend->bodies + i;
+        const b32 resting =
+            glm::length2(api->body_state.velocity[i]) < linear2 &&
+            glm::length2(api->body_state.angular_velocity[i]) < angular2;
+        body->sleep_timer = resting ? body->sleep_timer + dt : 0.0f;
+
+        const u32 root = custom_island_find(parent, i);
+        island_time[root] = glm::min(island_time[root], body->sleep_timer);
+    }
+
+    // backwards, sleeping swaps the last body into the current slot
+    for (u32 d = backend->dynamic_count; d-- > 0;) {
+        const u32 i = backend->dynamic_bodies[d];
+        if (island_time[custom_island_find(parent, i)] >= custom_time_to_sleep) {
+            auto* rb = &api->rigidbodies[i];
+            custom_sleep_body(api, backend, rb);
+            custom_update_body_bounds(rb);
+        }
+    }
+}
+
+static void
+custom_step(api_t* api, custom_backend_t* backend, f32 dt) {
+    TIMED_FUNCTION;
+    custom_broadphase_sort(api, backend);
+    custom_move_characters(api, backend, dt);
+    custom_integrate_velocities(api, backend, dt);
+    custom_broadphase_sort(api, backend);
+    custom_find_contacts(api, backend, dt);
+    custom_solve_contacts(api, backend, dt);
+    custom_integrate_positions(api, backend, dt);
+    custom_update_islands(api, backend, dt);
+    custom_dispatch_touches(api, backend);
+
+    range_u32(i, 0, backend->moved_count) {
+        backend->bodies[backend->moved_bodies[i]].flags &= ~CustomBodyFlags_Moved;
+    }
+    backend->moved_count = 0;
+    backend->step_count++;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Queries
+////////////////////////////////////////////////////////////////////////////////////
+
+// ray against a single shape, rd is normalized
+static b32
+custom_raycast_shape(const custom_shape_t* shape, const rigidbody_t* rb, const v3f& ro, const v3f& rd, f32 max_t, f32* t, v3f* normal) {
+    if (shape->type == collider_shape_type::TRIMESH) {
+        const math::transform_t transform{rb->position() + rb->orientation() * shape->origin, rb->orientation() * shape->rotation};
+        const auto inverse = transform.inverse();
+        const math::ray_t local_ray{inverse.xform(ro), glm::normalize(inverse.basis * rd)};
+        const v3f inv_rd = 1.0f / local_ray.direction;
+
+        b32 hit = 0;
+        f32 best = max_t;
+        u32 stack[64];
+        u32 stack_count = 0;
+        stack[stack_count++] = 0;
+        while (stack_count && shape->node_count) {
+            const auto* node = shape->nodes + stack[--stack_count];
+            if (custom_ray_aabb(local_ray.origin, inv_rd, node->aabb, best) < 0.0f) continue;
+            if (node->count) {
+                range_u32(tri, node->first, node->first + node->count) {
+                    math::triangle_t triangle;
+                    custom_mesh_triangle(shape, tri, &triangle.p[0], &triangle.p[1], &triangle.p[2]);
+                    f32 tri_t;
+                    if (math::intersect(local_ray, triangle, tri_t) && tri_t < best) {
+                        best = tri_t;
+                        v3f n = triangle.normal();
+                        if (glm::dot(n, local_ray.direction) > 0.0f) n = -n;
+                        *normal = glm::normalize(transform.basis * n);
+                        hit = 1;
+                    }
+                }
+            } else {
+                stack[stack_count++] = node->first + 1;
+                stack[stack_count++] = node->first;
+            }
+        }
+        *t = best;
+        return hit;
+    }
+
+    const auto world = custom_world_shape(shape, rb->position(), rb->orientation());
+
+    if (world.type == custom_core_type::BOX) {
+        const v3f local_o = glm::transpose(world.basis) * (ro - world.center);
+        const v3f local_d = glm::transpose(world.basis) * rd;
+        const f32 enter = custom_ray_aabb(local_o, 1.0f / local_d, math::rect3d_t{-world.half_size, world.half_size}, max_t);
+        if (enter < 0.0f) return 0;
+        const v3f p = (local_o + local_d * enter) / world.half_size;
+        const v3f ap = glm::abs(p);
+        v3f n{0.0f};
+        if (ap.x >= ap.y && ap.x >= ap.z) n.x = glm::sign(p.x);
+        else if (ap.y >= ap.z) n.y = glm::sign(p.y);
+        else n.z = glm::sign(p.z);
+        *t = enter;
+        *normal = enter > 0.0f ? world.basis * n : -rd;
+        return 1;
+    }
+
+    if (world.type == custom_core_type::SEGMENT && world.segment[0] == world.segment[1]) {
+        const v3f oc = ro - world.center;
+        const f32 b = glm::dot(oc, rd);
+        const f32 c = glm::dot(oc, oc) - world.radius * world.radius;
+        if (c <= 0.0f) {
+            *t = 0.0f;
+            *normal = -rd;
+            return 1;
+        }
+        const f32 h = b*b - c;
+        if (h < 0.0f) return 0;
+        const f32 enter = -b - glm::sqrt(h);
+        if (enter < 0.0f || enter > max_t) return 0;
+        *t = enter;
+        *normal = glm::normalize(ro + rd * enter - world.center);
+        return 1;
+    }
+
+    // conservative advancement for capsules and hulls
+    f32 travelled = 0.0f;
+    range_u32(iteration, 0, 64) {
+        custom_world_shape_t point{};
+        point.segment[0] = point.segment[1] = point.center = ro + rd * travelled;
+        const auto gjk = custom_gjk(point, world);
+        const f32 dist = gjk.overlap ? 0.0f : gjk.distance - world.radius;
+        if (dist < 1e-4f) {
+            *t = travelled;
+            const v3f n = gjk.point_a - gjk.point_b;
+            *normal = gjk.overlap || glm::length2(n) < 1e-12f ? -rd : glm::normalize(n);
+            return 1;
+        }
+        travelled += dist;
+        if (travelled > max_t) return 0;
+    }
+    return 0;
+}
+
+static b32
+custom_overlap_shape(const custom_shape_t* shape, const rigidbody_t* rb, const custom_world_shape_t& query) {
+    custom_manifold_t m{};
+    if (shape->type == collider_shape_type::TRIMESH) {
+        return custom_collide_mesh(query, shape, rb->position(), rb->orientation(), 0.0f, &m);
+    }
+    return custom_collide(query, custom_world_shape(shape, rb->position(), rb->orientation()), 0.0f, &m);
+}
+
+// Batches are swept against the broadphase in one pass, queries are sorted by aabb.min.x so
+// each body only visits the queries whose x range can reach it. This doesnt rely on the body
+// order being sorted, set_rigidbody can move bodies between steps.
+// Nothing is written outside the result spans so separate spans can run on separate threads.
+struct custom_batch_query_t {
+    math::rect3d_t aabb{};
+    u32 index{0};   // into the callers span
+};
+
+inline static void
+custom_sort_batch(custom_batch_query_t* queries, u32 count, f32* max_extent_x) {
+    std::sort(queries, queries + count, [](const custom_batch_query_t& l, const custom_batch_query_t& r) {
+        return l.aabb.min.x < r.aabb.min.x || (l.aabb.min.x == r.aabb.min.x && l.index < r.index);
+    });
+    *max_extent_x = 0.0f;
+    range_u32(i, 0, count) {
+        *max_extent_x = glm::max(*max_extent_x, queries[i].aabb.max.x - queries[i].aabb.min.x);
+    }
+}
+
+// first sorted query that can overlap an aabb starting at min_x
+static u32
+custom_batch_lower_bound(const custom_batch_query_t* queries, u32 count, f32 min_x, f32 max_extent_x) {
+    const f32 x = min_x - max_extent_x;
+    u32 lo = 0, hi = count;
+    while (lo < hi) {
+        const u32 mid = (lo + hi) / 2;
+        if (queries[mid].aabb.min.x < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// visits every in scene body once, calling fn(rb, query) for each sorted query whose aabb touches the body
+template <typename Fn>
+static void
+custom_sweep_batch(const api_t* api, const custom_backend_t* backend, const custom_batch_query_t* queries, u32 count, f32 max_extent_x, Fn&& fn) {
+    range_u32(i, 0, backend->order_count) {
+        const auto* body = backend->bodies + backend->order[i];
+        if ((body->flags & CustomBodyFlags_InScene) == 0) continue;
+
+        const auto* rb = &api->rigidbodies[backend->order[i]];
+        for (u32 q = custom_batch_lower_bound(queries, count, body->aabb.min.x, max_extent_x);
+            q < count && queries[q].aabb.min.x <= body->aabb.max.x; q++
+        ) {
+            if (queries[q].aabb.intersect(body->aabb)) {
+                fn(rb, queries[q]);
+            }
+        }
+    }
+}
+
+static custom_world_shape_t
+custom_overlap_query_shape(const overlap_query_t& query) {
+    custom_world_shape_t result{};
+    result.center = query.origin;
+    switch (query.type) {
+        case collider_shape_type::SPHERE: {
+            result.type = custom_core_type::SEGMENT;
+            result.segment[0] = result.segment[1] = query.origin;
+            result.radius = query.radius;
+        }   break;
+        case collider_shape_type::BOX: {
+            result.type = custom_core_type::BOX;
+            result.basis = glm::toMat3(query.rotation);
+            result.half_size = query.half_size;
+        }   break;
+        case_invalid_default;
+    }
+    return result;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////
 // Export
 ////////////////////////////////////////////////////////////////////////////////////
 
+inline static custom_backend_t*
+custom_init_backend(custom_backend_t* backend, arena_t* arena) {
+    assert(backend);
+    tag_array(backend->bodies, custom_body_t, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->order, u32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->order_min_x, f32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->unsorted, u32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->dynamic_bodies, u32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->moved_bodies, u32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->island_parent, u32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->island_sleep_time, f32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->integrate, f32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->inverse_mass, f32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->gravity, f32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->linear_damping, f32, arena, PHYSICS_MAX_RIGIDBODY_COUNT);
+    tag_array(backend->contacts, custom_contact_t, arena, custom_max_contacts);
+    tag_array(backend->touches[0], custom_touch_t, arena, custom_max_touches);
+    tag_array(backend->touches[1], custom_touch_t, arena, custom_max_touches);
+    return backend;
+}
+
 void
-custom_create_scene(api_t* api, const void* filter = 0) {
-    ztd_info(__FUNCTION__, "Creating scene");
+custom_destroy_scene(api_t* api) {
+    auto* backend = get_custom(api);
+    range_u32(i, 0, backend->order_count) {
+        backend->bodies[backend->order[i]].flags &= ~(CustomBodyFlags_InScene | CustomBodyFlags_InOrder | CustomBodyFlags_Unsorted);
+    }
+    range_u32(i, 0, backend->integrate_count) {
+        backend->integrate[i] = backend->inverse_mass[i] = backend->gravity[i] = backend->linear_damping[i] = 0.0f;
+    }
+    range_u32(i, 0, backend->dynamic_count) {
+        backend->bodies[backend->dynamic_bodies[i]].dynamic_slot = ~0u;
+    }
+    range_u32(i, 0, backend->moved_count) {
+        backend->bodies[backend->moved_bodies[i]].flags &= ~CustomBodyFlags_Moved;
+    }
+    backend->order_count = 0;
+    backend->sorted_count = 0;
+    backend->unsorted_count = 0;
+    backend->dynamic_count = 0;
+    backend->moved_count = 0;
+    backend->integrate_count = 0;
+    backend->touch_count[0] = backend->touch_count[1] = 0;
+    api->character_count = 0;
 }
 
 void
-custom_destroy_scene(api_t*) {
-    assert(0);
+custom_create_scene(api_t* api, const void* filter = 0) {
+    ztd_info(__FUNCTION__, "Creating scene");
+    auto* backend = get_custom(api);
+    custom_destroy_scene(api);
+    backend->contact_count = 0;
+    backend->accumulator = 0.0f;
+    backend->step_count = 0;
 }
 
 rigidbody_t*
 custom_create_rigidbody(api_t* api, void* entity, rigidbody_type type, const v3f& p, const quat& q) {
-    return custom_create_rigidbody_impl(api, type, entity);
+    TIMED_FUNCTION;
+    assert(api->rigidbody_count < PHYSICS_MAX_RIGIDBODY_COUNT);
+    const u32 index = safe_truncate_u64(api->rigidbody_count++);
+    return custom_create_rigidbody_impl(api, index, type, entity, p, q);
+}
+
+void
+custom_create_rigidbody_batch(api_t* api, std::span<const rigidbody_create_t> bodies, std::span<rigidbody_t*> results) {
+    TIMED_FUNCTION;
+    assert(api->rigidbody_count + bodies.size() <= PHYSICS_MAX_RIGIDBODY_COUNT);
+    const u32 first = safe_truncate_u64(api->rigidbody_count);
+    api->rigidbody_count += bodies.size();
+    range_u64(i, 0, bodies.size()) {
+        const auto& body = bodies[i];
+        results[i] = custom_create_rigidbody_impl(api, first + safe_truncate_u64(i), body.type, body.user_data, body.position, body.orientation);
+    }
 }
 
 collider_t*
 custom_create_collider(api_t* api, rigidbody_t* rigidbody, collider_shape_type type, void* collider_info) {
+    TIMED_FUNCTION;
     custom_create_collider_impl(api, rigidbody, type, collider_info);
     return &rigidbody->colliders[rigidbody->collider_count-1];
 }
 
 raycast_result_t
 custom_raycast_world(const api_t* api, v3f ro, v3f rd, u32 layer) {
-    return {};
+    TIMED_FUNCTION;
+    const auto* backend = get_custom(api);
+    const f32 dist = glm::length(rd);
+    if (dist == 0.0f) {
+        ztd_warn(__FUNCTION__, "Ray direction is zero");
+        return {};
+    }
+    rd /= dist;
+    const v3f inv_rd = 1.0f / rd;
+
+    math::rect3d_t bounds{};
+    bounds.expand(ro);
+    bounds.expand(ro + rd * dist);
+
+    raycast_result_t result{};
+    f32 best = dist;
+    custom_broadphase_query(api, backend, bounds, [&](const rigidbody_t* rb) {
+        if ((rb->layer & layer) == 0) return;
+        if (custom_ray_aabb(ro, inv_rd, custom_get_body(rb)->aabb, best) < 0.0f) return;
+
+        range_u32(s, 0, custom_body_shape_count(rb)) {
+            collider_t* collider;
+            const auto* shape = custom_body_shape(rb, s, &collider);
+            if (!shape || !shape->active || shape->type == collider_shape_type::NONE) continue;
+            if (collider && collider->is_trigger) continue;
+
+            f32 t;
+            v3f normal;
+            if (custom_raycast_shape(shape, rb, ro, rd, best, &t, &normal) && t <= best) {
+                best = t;
+                result.hit = true;
+                result.distance = t;
+                result.point = ro + rd * t;
+                result.normal = normal;
+                result.user_data = rb;
+            }
+        }
+    });
+    return result;
+}
+
+overlap_hitbuffer_t*
+custom_sphere_overlap_world(const api_t* api, arena_t* arena, v3f o, f32 radius, u32 layer) {
+    TIMED_FUNCTION;
+    const auto* backend = get_custom(api);
+
+    custom_world_shape_t sphere{};
+    sphere.center = sphere.segment[0] = sphere.segment[1] = o;
+    sphere.radius = radius;
+    const auto query = custom_world_shape_aabb(sphere);
+
+    overlap_hitbuffer_t* buffer = nullptr;
+    constexpr u32 max_hits = 512; // same as the physx backend
+    custom_broadphase_query(api, backend, query, [&](const rigidbody_t* rb) {
+        if ((rb->layer & layer) == 0) return;
+
+        range_u32(s, 0, custom_body_shape_count(rb)) {
+            collider_t* collider;
+            const auto* shape = custom_body_shape(rb, s, &collider);
+            if (!shape || !shape->active || shape->type == collider_shape_type::NONE) continue;
+            if (collider && collider->is_trigger) continue;
+            if (!custom_overlap_shape(shape, rb, sphere)) continue;
+
+            if (!buffer) {
+                tag_struct(buffer, overlap_hitbuffer_t, arena);
+                tag_array(buffer->hits, overlap_hit_t, arena, max_hits);
+            }
+            if (buffer->hit_count < max_hits) {
+                buffer->hits[buffer->hit_count++].user_data = rb;
+            }
+            break;
+        }
+    });
+    return buffer;
+}
+
+void
+custom_raycast_batch(const api_t* api, std::span<const raycast_query_t> queries, std::span<raycast_result_t> results) {
+    TIMED_FUNCTION;
+    const auto* backend = get_custom(api);
+
+    struct ray_t {
+        v3f ro, rd, inv_rd;
+        f32 best;
+    };
+
+    for (u64 first = 0; first < queries.size(); first += custom_query_batch_size) {
+        custom_batch_query_t batch[custom_query_batch_size];
+        ray_t rays[custom_query_batch_size];
+        u32 count = 0;
+
+        range_u64(i, first, glm::min(first + custom_query_batch_size, queries.size())) {
+            const auto& query = queries[i];
+            results[i] = {};
+            const f32 dist = glm::length(query.rd);
+            if (dist == 0.0f) continue;
+
+            auto& ray = rays[i - first];
+            ray.ro = query.ro;
+            ray.rd = query.rd / dist;
+            ray.inv_rd = 1.0f / ray.rd;
+            ray.best = dist;
+
+            auto& q = batch[count++];
+            q.index = safe_truncate_u64(i - first);
+            q.aabb = {};
+            q.aabb.expand(query.ro);
+            q.aabb.expand(query.ro + query.rd);
+        }
+
+        f32 max_extent_x;
+        custom_sort_batch(batch, count, &max_extent_x);
+
+        custom_sweep_batch(api, backend, batch, count, max_extent_x, [&](const rigidbody_t* rb, const custom_batch_query_t& q) {
+            const u64 index = first + q.index;
+            auto& ray = rays[q.index];
+            if ((rb->layer & queries[index].layer) == 0) return;
+            if (custom_ray_aabb(ray.ro, ray.inv_rd, custom_get_body(rb)->aabb, ray.best) < 0.0f) return;
+
+            range_u32(s, 0, custom_body_shape_count(rb)) {
+                collider_t* collider;
+                const auto* shape = custom_body_shape(rb, s, &collider);
+                if (!shape || !shape->active || shape->type == collider_shape_type::NONE) continue;
+                if (collider && collider->is_trigger) continue;
+
+                f32 t;
+                v3f normal;
+                if (custom_raycast_shape(shape, rb, ray.ro, ray.rd, ray.best, &t, &normal) && t <= ray.best) {
+                    ray.best = t;
+                    auto& result = results[index];
+                    result.hit = true;
+                    result.distance = t;
+                    result.point = ray.ro + ray.rd * t;
+                    result.normal = normal;
+                    result.user_data = rb;
+                }
+            }
+        });
+    }
+}
+
+u64
+custom_overlap_batch(const api_t* api, std::span<const overlap_query_t> queries, std::span<overlap_batch_hit_t> hits) {
+    TIMED_FUNCTION;
+    const auto* backend = get_custom(api);
+    u64 hit_count = 0;
+    b32 full = 0;
+
+    for (u64 first = 0; first < queries.size(); first += custom_query_batch_size) {
+        custom_batch_query_t batch[custom_query_batch_size];
+        custom_world_shape_t shapes[custom_query_batch_size];
+        u32 count = 0;
+
+        range_u64(i, first, glm::min(first + custom_query_batch_size, queries.size())) {
+            shapes[i - first] = custom_overlap_query_shape(queries[i]);
+            auto& q = batch[count++];
+            q.index = safe_truncate_u64(i - first);
+            q.aabb = custom_world_shape_aabb(shapes[i - first]);
+        }
+
+        f32 max_extent_x;
+        custom_sort_batch(batch, count, &max_extent_x);
+
+        const u64 chunk_start = hit_count;
+        custom_sweep_batch(api, backend, batch, count, max_extent_x, [&](const rigidbody_t* rb, const custom_batch_query_t& q) {
+            const u64 index = first + q.index;
+            if ((rb->layer & queries[index].layer) == 0) return;
+
+            range_u32(s, 0, custom_body_shape_count(rb)) {
+                collider_t* collider;
+                const auto* shape = custom_body_shape(rb, s, &collider);
+                if (!shape || !shape->active || shape->type == collider_shape_type::NONE) continue;
+                if (collider && collider->is_trigger) continue;
+                if (!custom_overlap_shape(shape, rb, shapes[q.index])) continue;
+
+                if (hit_count < hits.size()) {
+                    hits[hit_count++] = overlap_batch_hit_t{rb, safe_truncate_u64(index)};
+                } else {
+                    full = 1;
+                }
+                break;
+            }
+        });
+
+        // the sweep is body major, regroup this chunks hits by query. rigidbodies live in one
+        // array so the pointer compare keeps hits in body index order
+        std::sort(hits.begin() + chunk_start, hits.begin() + hit_count, [](const overlap_batch_hit_t& l, const overlap_batch_hit_t& r) {
+            return l.query < r.query || (l.query == r.query && l.user_data < r.user_data);
+        });
+    }
+
+    if (full) {
+        ztd_warn(__FUNCTION__, "Hit buffer full ({}), dropped hits", hits.size());
+    }
+    return hit_count;
 }
 
 void
 custom_simulate(api_t* api, f32 dt) {
+    TIMED_FUNCTION;
+    auto* backend = get_custom(api);
+
+    if (backend->fixed_dt > 0.0f) {
+        backend->accumulator += dt;
+        u32 steps = 0;
+        while (backend->accumulator >= backend->fixed_dt && steps < custom_max_substeps) {
+            custom_step(api, backend, backend->fixed_dt);
+            backend->accumulator -= backend->fixed_dt;
+            steps++;
+        }
+        // drop time we couldnt catch up on instead of spiraling
+        if (steps == custom_max_substeps) {
+            backend->accumulator = glm::min(backend->accumulator, backend->fixed_dt);
+        }
+    } else if (dt > 0.0f) {
+        custom_step(api, backend, dt);
+    }
+
+    if (api->entity_transform_offset) {
+        range_u32(i, 0, backend->dynamic_count) {
+            auto* rb = &api->rigidbodies[backend->dynamic_bodies[i]];
+            if (auto* transform = custom_entity_transform(api, rb)) {
+                transform->origin = rb->position();
+                transform->basis = glm::toMat3(rb->orientation());
+            }
+        }
+    }
 }
 
+// rigidbody_t is the simulation state here, syncing only refreshes derived data
 void
 custom_sync_rigidbody(api_t* api, rigidbody_t* rb) {
+    assert(rb && rb->api_data);
+    rb->orientation() = glm::normalize(rb->orientation());
+    custom_update_body_bounds(rb);
 }
 
+// set -> sim -> sync
 void
 custom_set_rigidbody(api_t* api, rigidbody_t* rb) {
-    const auto& p = rb->position;
-    const auto& q = rb->orientation;
-    const auto& v = rb->velocity;
-    const auto& av = rb->angular_velocity;
+    assert(rb && rb->api_data);
+    auto* backend = get_custom(rb->api);
+    auto* body = custom_get_body(rb);
+    const auto last_aabb = body->aabb;
+
+    rb->orientation() = glm::normalize(rb->orientation());
+    custom_update_body_bounds(rb);
+
+    const b32 moved = last_aabb.min != body->aabb.min || last_aabb.max != body->aabb.max;
+    if (moved) {
+        custom_wake(rb);
+        if ((body->flags & CustomBodyFlags_Moved) == 0) {
+            body->flags |= CustomBodyFlags_Moved;
+            backend->moved_bodies[backend->moved_count++] = rb->index;
+        }
+    }
 }
 
 };
-#endif
\ No newline at end of file
+#endif
@@ -38,8 +38,20 @@ class rigidbody_event_callback : public physx::PxSimulationEventCallback {
     virtual ~rigidbody_event_callback() = default;
 
     virtual void onConstraintBreak(PxConstraintInfo* constraints, PxU32 count) {}
-	virtual void onWake(PxActor** actors, PxU32 count) {}
-	virtual void onSleep(PxActor** actors, PxU32 count) {}
+	virtual void onWake(PxActor** actors, PxU32 count) {
+        for(PxU32 i=0; i < count; i++) {
+            if (auto* rb = (rigidbody_t*)actors[i]->userData) {
+                rb->flags &= ~rigidbody_flags::IS_SLEEPING;
+            }
+        }
+    }
+	virtual void onSleep(PxActor** actors, PxU32 count) {
+        for(PxU32 i=0; i < count; i++) {
+            if (auto* rb = (rigidbody_t*)actors[i]->userData) {
+                rb->flags |= rigidbody_flags::IS_SLEEPING;
+            }
+        }
+    }
 	virtual void onTrigger(PxTriggerPair* pairs, PxU32 count) {
         TIMED_FUNCTION;
         using namespace physx;
@@ -235,6 +247,13 @@ void physx_rigidbody_set_gravity(rigidbody_t* rb, bool x) {
     }
 }
 
+void physx_rigidbody_wake(rigidbody_t* rb) {
+    if (rb->type == rigidbody_type::DYNAMIC) {
+        ((PxRigidDynamic*)rb->api_data)->wakeUp();
+        rb->flags &= ~rigidbody_flags::IS_SLEEPING;
+    }
+}
+
 void physx_rigidbody_set_velocity(rigidbody_t* rb, const v3f& v) {
     if (rb->type == rigidbody_type::DYNAMIC) {
         PxRigidDynamic* actor = (PxRigidDynamic*)rb->api_data;
@@ -249,7 +268,7 @@ void physx_rigidbody_add_impulse(rigidbody_t* rb, const v3f& v) {
         const PxVec3 pos = pvec(v3f{0.0});
         PxRigidBodyExt::addForceAtLocalPos(*actor, pvec(v * 10.0f), pos, PxForceMode::eIMPULSE);
     } else if (rb->type == rigidbody_type::CHARACTER) {
-        rb->velocity += v / rb->mass;
+        rb->velocity() += v / rb->mass;
     }
 }
 
@@ -350,8 +369,10 @@ physx_create_rigidbody_impl(
 ) {
     const auto* ps = get_physx(api);
     assert(api->rigidbody_count < PHYSICS_MAX_RIGIDBODY_COUNT);
-    rigidbody_t* rb = &api->rigidbodies[api->rigidbody_count++];
-    *rb = rigidbody_t{api};
+    const u32 index = safe_truncate_u64(api->rigidbody_count++);
+    rigidbody_t* rb = &api->rigidbodies[index];
+    *rb = rigidbody_t{api, index};
+    rb->reset_state(position, orientation);
     
     const auto t = cast_transform(math::transform_t{position, orientation});
     switch (rb->type = type) {
@@ -362,6 +383,8 @@ physx_create_rigidbody_impl(
 
             if (rb->type == rigidbody_type::KINEMATIC) {
                 body->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
+            } else {
+                body->setActorFlag(PxActorFlag::eSEND_SLEEP_NOTIFIES, true);
             }
 
             physx_add_rigidbody(api, rb);
@@ -552,6 +575,18 @@ physx_create_rigidbody(api_t* api, void* entity, rigidbody_type type, const v3f&
     return rb;
 }
 
+// physx creates actors one at a time anyway, this only saves the indirect call per body
+void
+physx_create_rigidbody_batch(api_t* api, std::span<const rigidbody_create_t> bodies, std::span<rigidbody_t*> results) {
+    TIMED_FUNCTION;
+    assert(api->rigidbody_count + bodies.size() <= PHYSICS_MAX_RIGIDBODY_COUNT);
+    range_u64(i, 0, bodies.size()) {
+        const auto& body = bodies[i];
+        results[i] = physx_create_rigidbody_impl(api, body.type, body.user_data, body.position, body.orientation);
+        results[i]->api = api;
+    }
+}
+
 collider_t*
 physx_create_collider(api_t* api, rigidbody_t* rigidbody, collider_shape_type type, void* collider_info) {
     TIMED_FUNCTION;
@@ -663,6 +698,53 @@ physx_raycast_world(const api_t* api, v3f ro, v3f rd, u32 layer) {
     return result;
 }
 
+// PhysX already walks its own scene tree per query, batching here just drops the
+// indirect call and the per query hit buffer allocation
+void
+physx_raycast_batch(const api_t* api, std::span<const raycast_query_t> queries, std::span<raycast_result_t> results) {
+    TIMED_FUNCTION;
+    range_u64(i, 0, queries.size()) {
+        results[i] = queries[i].rd == v3f{0.0f} ? raycast_result_t{} : physx_raycast_world(api, queries[i].ro, queries[i].rd, queries[i].layer);
+    }
+}
+
+u64
+physx_overlap_batch(const api_t* api, std::span<const overlap_query_t> queries, std::span<overlap_batch_hit_t> hits) {
+    TIMED_FUNCTION;
+    auto* ps = get_physx(api);
+    const PxU32 touch_size = 512;
+    PxOverlapHit touches[touch_size];
+    u64 hit_count = 0;
+
+    range_u64(i, 0, queries.size()) {
+        const auto& query = queries[i];
+        PxTransform pose{};
+        pose.p = pvec(query.origin);
+        pose.q = {query.rotation.x, query.rotation.y, query.rotation.z, query.rotation.w};
+
+        PxQueryFilterData filter{};
+        filter.data.word0 = query.layer;
+
+        PxOverlapBuffer buffer(touches, touch_size);
+        bool status = false;
+        switch (query.type) {
+            case collider_shape_type::SPHERE: status = ps->world->scene->overlap(PxSphereGeometry{query.radius}, pose, buffer, filter); break;
+            case collider_shape_type::BOX:    status = ps->world->scene->overlap(PxBoxGeometry{pvec(query.half_size)}, pose, buffer, filter); break;
+            case_invalid_default;
+        }
+        if (!status) continue;
+
+        range_u32(t, 0, buffer.getNbTouches()) {
+            if (hit_count == hits.size()) {
+                ztd_warn(__FUNCTION__, "Hit buffer full ({}), dropped hits", hits.size());
+                return hit_count;
+            }
+            hits[hit_count++] = overlap_batch_hit_t{buffer.getTouch(t).actor->userData, safe_truncate_u64(i)};
+        }
+    }
+    return hit_count;
+}
+
 auto dampen(auto currentValue, auto targetValue, float dampingFactor, float deltaTime) {
     auto valueDifference = targetValue - currentValue;
 
@@ -702,15 +784,15 @@ physx_simulate(api_t* api, f32 dt) {
             auto* controller = (physx::PxController*)rb->api_data;
             auto* transform = (math::transform_t*)((u8*)rb->user_data + api->entity_transform_offset);
             // rb->integrate(dt, 9.81f * 0.1f * 0.0f);
-            auto v = rb->velocity * dt * 100.0f;
-            f32 vm = glm::length(rb->velocity);
+            auto v = rb->velocity() * dt * 100.0f;
+            f32 vm = glm::length(rb->velocity());
             const auto [lpx,lpy,lpz] = controller->getPosition();
 
             const PxU32 move_flags = controller->move(
                 {v.x, v.y, v.z}, 0.0f, 0.0f, {0, &gs_move_filter}
             );
             const auto [px,py,pz] = controller->getPosition();
-            rb->position = v3f{px,py,pz};
+            rb->position() = v3f{px,py,pz};
 
             if(move_flags & PxControllerCollisionFlag::eCOLLISION_DOWN) {
                 rb->flags |= rigidbody_flags::IS_ON_GROUND;
@@ -718,18 +800,18 @@ physx_simulate(api_t* api, f32 dt) {
                 rb->flags &= ~rigidbody_flags::IS_ON_GROUND;
             }
             if(move_flags & PxControllerCollisionFlag::eCOLLISION_SIDES) {
-                rb->velocity = (rb->position - v3f{lpx, lpy, lpz});
+                rb->velocity() = (rb->position() - v3f{lpx, lpy, lpz});
                 rb->flags |= rigidbody_flags::IS_ON_WALL;
             } else {
                 if(move_flags & PxControllerCollisionFlag::eCOLLISION_UP) {
-                    rb->velocity = (v3f{px,py,pz} - v3f{lpx, lpy, lpz});
-                    // rb->velocity.y = 0.0f;
+                    rb->velocity() = (v3f{px,py,pz} - v3f{lpx, lpy, lpz});
+                    // rb->velocity().y = 0.0f;
                 }
                 rb->flags &= ~rigidbody_flags::IS_ON_WALL;
             }
-            if (glm::length(rb->velocity) > vm) { rb->velocity = glm::normalize(rb->velocity) * vm; }
+            if (glm::length(rb->velocity()) > vm) { rb->velocity() = glm::normalize(rb->velocity()) * vm; }
 
-            transform->origin = rb->position;
+            transform->origin = rb->position();
         }
     }
 
@@ -755,12 +837,12 @@ physx_simulate(api_t* api, f32 dt) {
             if (body->type == rigidbody_type::DYNAMIC) {
                 if (auto* rb = active_actors[i]->is<physx::PxRigidBody>()) {
                     auto t = rb->getGlobalPose();
-                    body->position = transform->origin = v3f{t.p.x, t.p.y, t.p.z};
-                    transform->basis = glm::toMat3(body->orientation = quat{t.q.w, t.q.x, t.q.y, t.q.z});
+                    body->position() = transform->origin = v3f{t.p.x, t.p.y, t.p.z};
+                    transform->basis = glm::toMat3(body->orientation() = quat{t.q.w, t.q.x, t.q.y, t.q.z});
                     const auto [vx,vy,vz] = rb->getLinearVelocity();
                     const auto [ax,ay,az] = rb->getAngularVelocity();
-                    body->velocity = v3f{vx,vy,vz};
-                    body->angular_velocity = v3f{ax,ay,az};
+                    body->velocity() = v3f{vx,vy,vz};
+                    body->angular_velocity() = v3f{ax,ay,az};
                 }
             } else if (body->type == rigidbody_type::CHARACTER) {
                 // if you are wondering, yes we actually make it to here
@@ -784,20 +866,20 @@ physx_sync_rigidbody(api_t* api, rigidbody_t* rb) {
 
     if (rb->type == rigidbody_type::DYNAMIC) {
         physx::PxTransform t = ((physx::PxRigidActor*)rb->api_data)->getGlobalPose();
-        rb->position = v3f{t.p.x, t.p.y, t.p.z};
-        rb->orientation = glm::quat{t.q.w, t.q.x, t.q.y, t.q.z};
+        rb->position() = v3f{t.p.x, t.p.y, t.p.z};
+        rb->orientation() = glm::quat{t.q.w, t.q.x, t.q.y, t.q.z};
         if (rb->type == physics::rigidbody_type::DYNAMIC) {
             auto* rigid = (physx::PxRigidBody*)rb->api_data;
             const auto [vx,vy,vz] = rigid->getLinearVelocity();
             const auto [ax,ay,az] = rigid->getAngularVelocity();
-            rb->velocity = v3f{vx,vy,vz};
-            rb->angular_velocity = v3f{ax,ay,az};
+            rb->velocity() = v3f{vx,vy,vz};
+            rb->angular_velocity() = v3f{ax,ay,az};
         }
     } else if (rb->type == rigidbody_type::CHARACTER) {
         auto* controller = ((physx::PxController*)rb->api_data);
-        const auto& v = rb->velocity;
+        const auto& v = rb->velocity();
         const auto [px,py,pz]  = controller->getPosition();
-        rb->position = v3f{px,py,pz};
+        rb->position() = v3f{px,py,pz};
     }
     // rb->flags &= ~rigidbody_flags::SKIP_SYNC;
 }
@@ -806,10 +888,10 @@ physx_sync_rigidbody(api_t* api, rigidbody_t* rb) {
 void
 physx_set_rigidbody(api_t* api, rigidbody_t* rb) {
     TIMED_FUNCTION;
-    const auto& p = rb->position;
-    const auto& q = rb->orientation;
-    const auto& v = rb->velocity;
-    const auto& av = rb->angular_velocity;
+    const auto& p = rb->position();
+    const auto& q = rb->orientation();
+    const auto& v = rb->velocity();
+    const auto& av = rb->angular_velocity();
     
     if (rb->type == rigidbody_type::CHARACTER) {
         auto* controller = (physx::PxController*)rb->api_data;
@@ -26,7 +26,7 @@ struct skeleton_t {
         return *this;
     }
 
-    constexpr [[nodiscard]] bone_id_t 
+    [[nodiscard]] constexpr bone_id_t 
     find_bone_id(string_id_t bone_hash) const {
         for (i32 i = 0; i < bone_count; i++) {
             if (bones[i].name_hash == bone_hash) return i;
@@ -34,7 +34,7 @@ struct skeleton_t {
         return -1;
     }
     
-    constexpr [[nodiscard]] const skeleton_bone_t& 
+    [[nodiscard]] constexpr const skeleton_bone_t& 
     find_bone(string_id_t bone_name) const {
         return bones[find_bone_id(bone_name)];
     }
@@ -55,38 +55,60 @@ struct keyframe {
 template <typename T>
 using anim_pool_t = keyframe<T>[512];
 
+// returns i where pool[i].time <= time <= pool[i+1].time, needs count >= 2 and time inside the pool.
+// starts from the cursor so forward playback only steps a key or two, falls back to a binary search on seeks
+template <typename T>
+inline u64
+anim_pool_find_key(const anim_pool_t<T>& pool, u64 count, f32 time, u64 cursor) {
+    constexpr u64 max_forward_steps = 4;
+    if (cursor < count - 1 && pool[cursor].time <= time) {
+        range_u64(step, 0, max_forward_steps) {
+            if (time <= pool[cursor+1].time) {
+                return cursor;
+            }
+            if (++cursor == count - 1) {
+                break;
+            }
+        }
+    }
+
+    auto* key = std::upper_bound(pool + 1, pool + count, time, [](f32 t, const keyframe<T>& k) {
+        return t < k.time;
+    });
+    return std::min(u64(key - pool) - 1, count - 2);
+}
+
 template <typename T>
 inline T
-anim_pool_get_time_value(anim_pool_t<T>& pool, u64 count, f32 time) {
+anim_pool_get_time_value(const anim_pool_t<T>& pool, u64 count, f32 time, u32* cursor = 0) {
     if (count == 0) {
         return T{};
     } else if (count == 1) {
         return pool[0].value;
     }
 
-    if (time <= 0.0f) {
+    if (time <= pool[0].time) {
         return pool[0].value;
     } else if (time >= pool[count-1].time) {
         return pool[count-1].value;
     }
 
-    for (size_t i = 0; i < count - 1; i++) {
-        if (pool[i].time <= time && time <= pool[i+1].time) {
-            const f32 d = (pool[i+1].time - pool[i].time);
-            const f32 p = time - pool[i].time;
-            if constexpr (std::is_same_v<T, glm::quat>) {
-                return glm::slerp(pool[i].value, pool[i+1].value, p/d);
-            } else {
-                return glm::mix(
-                    pool[i].value,
-                    pool[i+1].value,
-                    p/d
-                );
-            }
-        }
+    const u64 i = anim_pool_find_key(pool, count, time, cursor ? *cursor : 0);
+    if (cursor) {
+        *cursor = u32(i);
     }
 
-    return T{};
+    const f32 d = (pool[i+1].time - pool[i].time);
+    const f32 p = time - pool[i].time;
+    if constexpr (std::is_same_v<T, glm::quat>) {
+        return glm::slerp(pool[i].value, pool[i+1].value, p/d);
+    } else {
+        return glm::mix(
+            pool[i].value,
+            pool[i+1].value,
+            p/d
+        );
+    }
 }
 
 struct bone_timeline_t {
@@ -117,10 +139,11 @@ struct bone_timeline_t {
     char name[1024]{};
     bone_id_t id{};
 
-    m44 update(f32 time) {
-        m44 translation = glm::translate(m44{1.0f}, anim_pool_get_time_value(positions, position_count, time));
-        m44 rotation = glm::toMat4(anim_pool_get_time_value(rotations, rotation_count, time));
-        m44 scale = glm::scale(m44{1.0f}, anim_pool_get_time_value(scales, scale_count, time));
+    // cursors are the last key used for positions, rotations and scales
+    m44 update(f32 time, u32* cursors = 0) {
+        m44 translation = glm::translate(m44{1.0f}, anim_pool_get_time_value(positions, position_count, time, cursors ? cursors + 0 : 0));
+        m44 rotation = glm::toMat4(anim_pool_get_time_value(rotations, rotation_count, time, cursors ? cursors + 1 : 0));
+        m44 scale = glm::scale(m44{1.0f}, anim_pool_get_time_value(scales, scale_count, time, cursors ? cursors + 2 : 0));
         return transform = translation * rotation * scale;
     }
 
@@ -165,13 +188,17 @@ struct animator_t {
     skeleton_t* skeleton{nullptr};
     std::array<m44, skeleton_t::max_bones_()> matrices;
 
+    // per node key cursors, animations are shared so these cant live in the timelines
+    u32 key_cursors[skeleton_t::max_bones_()][3]{};
+
     void update(float dt) {
         if (animation) {
             time += dt * animation->ticks_per_second;
             time = fmod(time, animation->duration-1.0f);
 
-            for (auto& node : animation->nodes) {
-                const auto& bone_transform = node.bone ? node.bone->update(time) : node.transform;
+            range_u64(n, 0, animation->node_count) {
+                auto& node = animation->nodes[n];
+                const auto& bone_transform = node.bone ? node.bone->update(time, key_cursors[n]) : node.transform;
                 const auto& parent_transform = (node.parent >= 0) ?
                     animation->nodes[node.parent].transform : m44(1.0f);
                 node.transform = parent_transform * bone_transform;
@@ -187,6 +214,7 @@ struct animator_t {
     void play_animation(animation_t* p_animation) {
 		animation = p_animation;
         std::fill(matrices.begin(), matrices.end(), m44(1.0f));
+        std::memset(key_cursors, 0, sizeof(key_cursors));
 		time = 0.0f;
 	}
 
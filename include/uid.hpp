@@ -39,7 +39,7 @@ namespace uid {
 	constexpr id_type new_generation(id_type id)
 	{
 		const id_type generation{ uid::generation(id) + 1 };
-		assert(generation < ((1ui64 << internal::generation_bits)-1));
+		assert(generation < ((1ull << internal::generation_bits)-1));
 		return index(id) | (generation << internal::index_bits);
 	}
 
@@ -12,18 +12,18 @@
 #define fmt_sv fmt::format
 #define println(...) do { fmt::print(__VA_ARGS__); } while(0)
 
-#define ztd_info(cat, str, ...) do { fmt::print(fg(fmt::color::white) | fmt::emphasis::bold, fmt_str("[info][{}]: {}\n", cat, str), __VA_ARGS__); } while(0)
-#define ztd_warn(cat, str, ...) do { fmt::print(stderr, fg(fmt::color::yellow) | fmt::emphasis::bold, fmt_str("[warn][{}]: {}\n", cat, str), __VA_ARGS__); } while(0)
-#define ztd_error(cat, str, ...) do { fmt::print(stderr, fg(fmt::color::red) | fmt::emphasis::bold, fmt_str("[error][{}]: {}\n", cat, str), __VA_ARGS__); } while(0)
-#define ztd_profile(cat, str, ...) do { fmt::print(stderr, fg(fmt::color::blue) | fmt::emphasis::bold, fmt_str("[profile][{}]: {}\n", cat, str), __VA_ARGS__); } while(0)
+#define ztd_info(cat, str, ...) do { fmt::print(fg(fmt::color::white) | fmt::emphasis::bold, fmt_str("[info][{}]: {}\n", cat, str), ##__VA_ARGS__); } while(0)
+#define ztd_warn(cat, str, ...) do { fmt::print(stderr, fg(fmt::color::yellow) | fmt::emphasis::bold, fmt_str("[warn][{}]: {}\n", cat, str), ##__VA_ARGS__); } while(0)
+#define ztd_error(cat, str, ...) do { fmt::print(stderr, fg(fmt::color::red) | fmt::emphasis::bold, fmt_str("[error][{}]: {}\n", cat, str), ##__VA_ARGS__); } while(0)
+#define ztd_profile(cat, str, ...) do { fmt::print(stderr, fg(fmt::color::blue) | fmt::emphasis::bold, fmt_str("[profile][{}]: {}\n", cat, str), ##__VA_ARGS__); } while(0)
 
 
 
 #define array_count(arr) (sizeof((arr)) / (sizeof((arr)[0])))
 // #define array_count(arr) ((u32)std::size((arr)))
-#define kilobytes(x) (x*1024ull)
-#define megabytes(x) (kilobytes(x)*1024ull)
-#define gigabytes(x) (megabytes(x)*1024ull)
+#define kilobytes(x) (x*size_t(1024))
+#define megabytes(x) (kilobytes(x)*size_t(1024))
+#define gigabytes(x) (megabytes(x)*size_t(1024))
 #define terabytes(x) (gigabytes(x)*1024ull)
 #define align16(val) ((val + 15) & ~15)
 #define align4(val) ((val + 3) & ~3)
@@ -47,15 +47,14 @@
 #elif defined(_WIN64) || defined(_WIN32)
     #include <process.h>
 
-
-#if ZTD_INTERNAL
-
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include "Windows.h"
 #undef near
 #undef far
 
+#if ZTD_INTERNAL
+
 bool check_for_debugger()
 {
     return IsDebuggerPresent();
@@ -83,7 +82,19 @@ bool check_for_debugger()
 #elif defined(__unix__) || defined(__unix) \
       || (defined(__APPLE__) && defined(__MACH__))
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <signal.h>
+    #include <immintrin.h>
     #define RAND_GETPID getpid()
+
+bool check_for_debugger()
+{
+    return false;
+}
+
+    #define __debugbreak() raise(SIGTRAP)
 #else
     #define RAND_GETPID 0
 #endif
@@ -97,8 +108,12 @@ bool check_for_debugger()
 #include <fstream>
 #include <chrono>
 #include <functional>
+#include <algorithm>
+#include <bit>
 #include <ranges>
 #include <mutex>
+#include <atomic>
+#include <thread>
 #include <charconv>
 #include <string>
 #include <string_view>
@@ -257,6 +272,8 @@ struct stack_string
         }
         buffer[s] = '\0'; // Ensure null-terminated.
     }
+    // Note(Zack): literal -> string_view -> stack_string is two user conversions, msvc allows it gcc doesnt
+    constexpr stack_string(const CharType* str) : stack_string(std::basic_string_view<CharType>{str}) {}
 
     constexpr const CharType* data() const {
         return buffer;
@@ -447,30 +464,145 @@ struct arena_block_footer_t {
     size_t used{0};
 };
 
-struct allocation_tag_t {
-    const char* type_name;
-    const char* file_name;
-    const char* function_name;
-    u64 line_number;
+// Note(Zack): Tagged allocations used to carry their callsite strings and a 320 byte poison pad each,
+// small allocations ended up mostly tag. The callsite now lives once in a side table and every
+// Nth allocation from a site gets a guard pushed after it instead.
+#ifndef ZTD_ALLOCATION_GUARD_INTERVAL
+    #define ZTD_ALLOCATION_GUARD_INTERVAL 64 // 1 guards every allocation
+#endif
+
+struct allocation_site_t {
+    const char* type_name{0};
+    const char* file_name{0};
+    const char* function_name{0};
+    u64 line_number{0};
+    u64 type_size{0};
 
-    u64 count;
-    u64 type_size;
-    u64 block_id; // might not be needed
-    allocation_tag_t* next;
+    std::atomic<u64> allocations{0};
+    std::atomic<u64> bytes{0};
+};
+
+// Note(Zack): Tags outlive the module that pushed them, the game dll reloads and the exe tags the job system.
+// The table is shared through Platform.arena_shared and sites copy their strings into it, a reloaded dll
+// registers its sites again and finds them by key so old tags still resolve.
+struct allocation_site_table_t {
+    static constexpr u32 capacity = 4096;
+    static constexpr u64 string_capacity = kilobytes(512);
+
+    std::atomic<u32>  count{1}; // 0 is where sites go once the table is full
+    std::atomic<u64>  string_top{0};
+    allocation_site_t sites[capacity];
+    std::atomic<u64>  keys[capacity]{}; // written once a site is filled in, 0 is unpublished
+    char              strings[string_capacity];
+};
+
+// only used when there is no platform, tests and tools
+inline allocation_site_table_t allocation_site_table_local{};
+
+inline allocation_site_table_t* allocation_site_table(); // after platform_api_t
+
+inline const char*
+allocation_site_intern(allocation_site_table_t* table, const char* text) {
+    const u64 size = std::strlen(text) + 1;
+    const u64 offset = table->string_top.fetch_add(size, std::memory_order_relaxed);
+    if (offset + size > allocation_site_table_t::string_capacity) {
+        return "?";
+    }
+    char* result = table->strings + offset;
+    std::memcpy(result, text, size);
+    return result;
+}
 
-    u64 pad[40] = {};
+// call once per callsite, the tag macros keep the index in a function static
+inline u32
+allocation_site_register(const char* type_name, u64 type_size, const char* file_name, const char* function_name, u64 line_number) {
+    auto* table = allocation_site_table();
 
-    void poison() {
-        range_u64(i, 0, array_count(pad)) {
-            pad[i] = ~0ui64;
+    u64 key = 0xcbf29ce484222325;
+    auto mix = [&](const char* text) {
+        for (; *text; text++) {
+            key = (key ^ u8(*text)) * 0x100000001b3;
+        }
+        key = (key ^ 0xff) * 0x100000001b3;
+    };
+    mix(type_name);
+    mix(file_name);
+    mix(function_name);
+    key = ((key ^ line_number) * 0x100000001b3) | 1;
+
+    const u32 count = std::min(table->count.load(std::memory_order_acquire), allocation_site_table_t::capacity);
+    range_u32(i, 1, count) {
+        if (table->keys[i].load(std::memory_order_acquire) == key) {
+            return i;
         }
     }
 
-    b32 overflowed() const {
-        range_u64(i, 0, array_count(pad)) {
-            if (pad[i] != ~0) return true;
+    const u32 index = table->count.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= allocation_site_table_t::capacity) {
+        table->count.store(allocation_site_table_t::capacity, std::memory_order_relaxed);
+        auto& overflow = table->sites[0];
+        overflow.type_name = "unknown";
+        overflow.file_name = "too many allocation sites";
+        overflow.function_name = "";
+        overflow.type_size = 1;
+        return 0;
+    }
+    auto& site = table->sites[index];
+    site.type_name = allocation_site_intern(table, type_name);
+    site.file_name = allocation_site_intern(table, file_name);
+    site.function_name = allocation_site_intern(table, function_name);
+    site.line_number = line_number;
+    site.type_size = type_size;
+    table->keys[index].store(key, std::memory_order_release);
+    return index;
+}
+
+inline const allocation_site_t&
+allocation_site_get(u32 index) {
+    return allocation_site_table()->sites[index];
+}
+
+inline u32
+allocation_site_count() {
+    return std::min(allocation_site_table()->count.load(std::memory_order_relaxed), allocation_site_table_t::capacity);
+}
+
+// bytes, not words, so it can sit right after an allocation of any size
+struct allocation_guard_t {
+    static constexpr u8 poison = 0xfd;
+
+    u8 bytes[16] = {
+        poison, poison, poison, poison, poison, poison, poison, poison,
+        poison, poison, poison, poison, poison, poison, poison, poison,
+    };
+
+    b32 intact() const {
+        for (u8 b: bytes) {
+            if (b != poison) {
+                return 0;
+            }
         }
-        return false;
+        return 1;
+    }
+};
+
+struct allocation_tag_t {
+    allocation_tag_t*   next{0};
+    allocation_guard_t* guard{0}; // only on sampled allocations
+    u64 count{0};
+    u32 site{0};
+    u32 block_id{0};
+
+    const allocation_site_t& callsite() const {
+        return allocation_site_get(site);
+    }
+
+    u64 size() const {
+        return callsite().type_size * count;
+    }
+
+    b32 overflowed() const {
+        return guard && !guard->intact();
     }
 };
 
@@ -481,6 +613,9 @@ struct arena_t {
 
     u32 block_count{0};
 
+    size_t prior_used{0};   // bytes used in the blocks under this one
+    size_t high_water{0};   // most bytes ever in use at once
+
     allocation_tag_t* tags{0};
 
     arena_settings_t settings{};
@@ -514,7 +649,12 @@ using temp_arena_t = arena_t;
 
 #define case_invalid_default default: assert(!"Invalid Default Case!"); break
 #define no_mangle extern "C"
-#define export_dll __declspec(dllexport)
+#if _WIN32
+    #define export_dll __declspec(dllexport)
+#else
+    #define export_dll __attribute__((visibility("default")))
+    #define __cdecl
+#endif
 #define export_fn(rt_type) no_mangle export_dll rt_type __cdecl
 
 template<typename Fn>
@@ -606,7 +746,7 @@ safe_truncate_u64(u64 value) {
 
 constexpr u64 
 BIT(u64 x) {
-	return 1ui64 << x;
+	return 1ull << x;
 }
 
 namespace mouse_button_id {
@@ -886,6 +1026,9 @@ struct app_config_t {
     // param 2: vk surface
     using vk_create_surface_cb = void(*)(void*, void*, void*); 
     vk_create_surface_cb create_vk_surface{nullptr};
+
+    // set by the headless host, no window, gpu or audio device so the game only simulates
+    b32 headless{0};
 };
 
 struct audio_settings_t {
@@ -904,9 +1047,6 @@ namespace utl {
 };
 
 
-#if ZTD_INTERNAL
-
-
 inline u64
 get_nano_time() {
     std::chrono::time_point<std::chrono::high_resolution_clock> time_stamp = std::chrono::high_resolution_clock::now();
@@ -914,14 +1054,33 @@ get_nano_time() {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(time_stamp.time_since_epoch()).count();
 }
 
+#if ZTD_INTERNAL
+
+#include <atomic>
+#if _WIN32
+    #include <intrin.h>
+#else
+    #include <x86intrin.h>
+    #include <unistd.h>
+#endif
+
+inline u64
+get_debug_thread_id() {
+#if _WIN32
+    return GetCurrentThreadId();
+#else
+    return (u64)gettid();
+#endif
+}
+
 struct debug_record_t {
     const char* file_name;
     const char* func_name;
     int         line_num;
-    u64         cycle_count{0};
-    u64         hit_count{0};
+    std::atomic<u64> cycle_count{0};
+    std::atomic<u64> hit_count{0};
 
-    u16         hist_id{0};
+    std::atomic<u16> hist_id{0}; // wraps at a multiple of the history size
     u64         history[1024];
 
     u16         set_breakpoint{0};
@@ -934,7 +1093,7 @@ enum debug_event_type {
 };
 
 struct debug_event_t {
-    u64         clock_count{0};
+    u64         clock_count{0}; // rdtsc
     u64         thread_id{0};
     u16         core_index{0};
     u16         record_index{0};
@@ -944,13 +1103,33 @@ struct debug_event_t {
 };
 
 #define MAX_DEBUG_EVENT_COUNT (16*65536)
+#define MAX_DEBUG_THREAD_EVENT_COUNT (16384)
+#define MAX_DEBUG_THREAD_COUNT (32)
 #define MAX_DEBUG_RECORD_COUNT (256)
 #define MAX_USER_DATA_SIZE (megabytes(64))
 
-#include <atomic>
+// Note(Zack): every thread that opens a timed block gets its own ring and is the only writer,
+// the main thread collates them into the table's event ring once a frame so recording never
+// shares a cache line or a counter with another thread
+struct debug_thread_events_t {
+    u64                     thread_id{0};
+    alignas(64) std::atomic<u64> write_index{0};
+    alignas(64) u64         read_index{0}; // collator only
+    debug_event_t           events[MAX_DEBUG_THREAD_EVENT_COUNT];
+};
+
 struct debug_table_t {
-    std::atomic<u64> event_index{0};
+    u64             event_index{0}; // only the collator writes events
     debug_event_t   events[MAX_DEBUG_EVENT_COUNT];
+    u64             dropped_event_count{0};
+
+    std::atomic<u32>        thread_count{0};
+    debug_thread_events_t   threads[MAX_DEBUG_THREAD_COUNT];
+
+    // rdtsc to wall time, measured between the first and latest collation
+    u64             calibration_cycles{0};
+    u64             calibration_nanoseconds{0};
+    f64             cycles_per_microsecond{0.0};
 
     u64             record_count{0};
     debug_record_t  records[MAX_DEBUG_RECORD_COUNT];
@@ -962,17 +1141,78 @@ struct debug_table_t {
 
 extern debug_table_t gs_debug_table;
 
+// rdtscp also hands back TSC_AUX which the os fills with the processor number
+inline u64
+get_debug_cycles(u16* core_index) {
+    u32 aux;
+    const u64 cycles = __rdtscp(&aux);
+    *core_index = (u16)aux;
+    return cycles;
+}
+
+// every module has its own table and its own copy of this, so slots are per module
+inline debug_thread_events_t*
+get_debug_thread_events(debug_table_t* table) {
+    thread_local debug_thread_events_t* thread_events = 0;
+    if (thread_events == nullptr) [[unlikely]] {
+        const u32 slot = table->thread_count.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= MAX_DEBUG_THREAD_COUNT) {
+            return nullptr;
+        }
+        thread_events = table->threads + slot;
+        thread_events->thread_id = get_debug_thread_id();
+    }
+    return thread_events;
+}
+
 inline void
 record_debug_event(int record_index, debug_event_type event_type) {
-    u64 index = gs_debug_table.event_index;
-    gs_debug_table.event_index = (gs_debug_table.event_index + 1) % MAX_DEBUG_EVENT_COUNT;
-    assert(index < MAX_DEBUG_EVENT_COUNT);
-    debug_event_t* event = gs_debug_table.events + index;
-    event->clock_count = get_nano_time();
-    event->core_index = 0; // todo
-    event->thread_id = 0; // todo
+    auto* thread_events = get_debug_thread_events(&gs_debug_table);
+    if (thread_events == nullptr) [[unlikely]] {
+        return;
+    }
+    const u64 index = thread_events->write_index.load(std::memory_order_relaxed);
+    debug_event_t* event = thread_events->events + (index % MAX_DEBUG_THREAD_EVENT_COUNT);
+    event->clock_count = get_debug_cycles(&event->core_index);
+    event->thread_id = thread_events->thread_id;
     event->type = event_type;
     event->record_index = (u16)record_index;
+    thread_events->write_index.store(index + 1, std::memory_order_release);
+}
+
+// main thread at the frame boundary, appends a frame marker and every event the threads
+// recorded since the last call, events a thread overwrote before collation are counted as dropped
+inline void
+collate_debug_events(debug_table_t* table) {
+    auto* frame = table->events + (table->event_index++ % MAX_DEBUG_EVENT_COUNT);
+    *frame = {};
+    frame->clock_count = get_debug_cycles(&frame->core_index);
+    frame->thread_id = get_debug_thread_id();
+    frame->type = DebugEventType_BeginFrame;
+
+    const u64 now = get_nano_time();
+    if (table->calibration_cycles == 0) {
+        table->calibration_cycles = frame->clock_count;
+        table->calibration_nanoseconds = now;
+    } else if (now > table->calibration_nanoseconds) {
+        table->cycles_per_microsecond = 
+            f64(frame->clock_count - table->calibration_cycles) / (f64(now - table->calibration_nanoseconds) / 1000.0);
+    }
+
+    const u32 thread_count = std::min(table->thread_count.load(std::memory_order_acquire), (u32)MAX_DEBUG_THREAD_COUNT);
+    range_u32(t, 0, thread_count) {
+        auto* thread_events = table->threads + t;
+        const u64 end = thread_events->write_index.load(std::memory_order_acquire);
+        u64 begin = thread_events->read_index;
+        if (end - begin > MAX_DEBUG_THREAD_EVENT_COUNT) {
+            table->dropped_event_count += end - begin - MAX_DEBUG_THREAD_EVENT_COUNT;
+            begin = end - MAX_DEBUG_THREAD_EVENT_COUNT;
+        }
+        for (u64 i = begin; i < end; i++) {
+            table->events[table->event_index++ % MAX_DEBUG_EVENT_COUNT] = thread_events->events[i % MAX_DEBUG_THREAD_EVENT_COUNT];
+        }
+        thread_events->read_index = end;
+    }
 }
 
 extern size_t gs_main_debug_record_size;
@@ -982,18 +1222,20 @@ extern size_t gs_main_debug_record_size;
 
 struct timed_block_t {
     debug_record_t* record;
+    u64 start;
     i32 counter;
     timed_block_t(i32 _counter, const char* _file_name, i32 _line_number, const char* _function_name) {
         counter = _counter;
         record = gs_debug_table.records + _counter;
-        record->file_name = _file_name;
-        record->line_num = _line_number;
-        record->func_name = _function_name;
+        if (record->hit_count.fetch_add(1, std::memory_order_relaxed) == 0) [[unlikely]] {
+            record->file_name = _file_name;
+            record->line_num = _line_number;
+            record->func_name = _function_name;
+        }
 
         record_debug_event(_counter, DebugEventType_BeginBlock);
 
-        record->cycle_count = get_nano_time();
-        record->hit_count++;
+        start = get_nano_time();
 
         if (record->set_breakpoint && check_for_debugger()) [[unlikely]] {
             __debugbreak();
@@ -1001,8 +1243,10 @@ struct timed_block_t {
     }
 
     ~timed_block_t() {
-        record->history[record->hist_id] = record->cycle_count = get_nano_time() - record->cycle_count;
-        record->hist_id = (record->hist_id + 1) % array_count(record->history);
+        const u64 elapsed = get_nano_time() - start;
+        const u16 hist_id = u16(record->hist_id.fetch_add(1, std::memory_order_relaxed) % array_count(record->history));
+        record->history[hist_id] = elapsed;
+        record->cycle_count.store(elapsed, std::memory_order_relaxed);
 
         record_debug_event(counter, DebugEventType_EndBlock);
     }
@@ -1017,6 +1261,8 @@ struct timed_block_t {
 
 #include "ztd_physics.hpp"
 
+struct arena_shared_state_t;
+
 struct platform_api_t {
     using allocate_memory_function = void*(*)(umm);
     using free_memory_function = void(*)(void*);
@@ -1050,10 +1296,31 @@ struct platform_api_t {
         closure_t play_sound;
         closure_t stop_sound;
     } audio;
+
+    arena_shared_state_t* arena_shared{0}; // owned by the exe, see arena_shared_state_init
 };
 
 extern platform_api_t Platform;
 
+// Note(Zack): The exe outlives every dll, so its own allocator tables are handed to the physics dll and
+// every reload of the game dll through Platform. Modules without a platform use their own.
+struct arena_block_cache_t;
+struct arena_scratch_registry_t;
+
+struct arena_shared_state_t {
+    allocation_site_table_t*  allocation_sites{0};
+    arena_block_cache_t*      block_cache{0};
+    arena_scratch_registry_t* scratch_registry{0};
+};
+
+inline allocation_site_table_t*
+allocation_site_table() {
+    return Platform.arena_shared ? Platform.arena_shared->allocation_sites : &allocation_site_table_local;
+}
+
+
+namespace utl { struct job_system_t; };
+
 struct game_memory_t {
     platform_api_t platform;
 
@@ -1069,16 +1336,14 @@ struct game_memory_t {
     void* imgui_context{0};
 
     physics::api_t* physics{nullptr};
+
+    utl::job_system_t* jobs{nullptr}; // owned by the platform, workers outlive dll reloads
 };
 
 using app_func_t = void(__cdecl *)(game_memory_t*);
 
 struct app_dll_t {
-#if _WIN32
-    void* dll{nullptr};
-#else
-#error "no linux"
-#endif
+    void* dll{nullptr}; // HMODULE on win32, dlopen handle everywhere else
     app_func_t on_update{nullptr};
     app_func_t on_render{nullptr};
     app_func_t on_init{nullptr};
@@ -1315,7 +1580,7 @@ T*
 copy(T* dst, const S* src) {
     static_assert(std::is_trivially_copyable_v<T>);
     static_assert(std::is_trivially_copyable_v<S>);
-    return (utl::copy(dst, src, std::min(sizeof T, sizeof S)), dst);
+    return (utl::copy(dst, src, std::min(sizeof(T), sizeof(S))), dst);
 }
 
 constexpr void*
@@ -1355,6 +1620,117 @@ arena_create(umm minimum_block_size = 0) noexcept {
     return arena;
 }
 
+// Note(Zack): Arena blocks are recycled through one process wide cache instead of going back to the
+// platform. Blocks are powers of two from 64Kb and every size has a lock free stack threaded through
+// the free blocks themselves, the head packs a 16 bit tag above the 48 bit address so pops cant ABA.
+// Cached blocks are never unmapped, so reading next from a block another thread just popped is harmless.
+// The exe's cache is shared through Platform.arena_shared, blocks a dll releases outlive its reload.
+struct arena_block_cache_t {
+    static constexpr umm min_block_size = kilobytes(64);
+    static constexpr u32 class_count = 16; // 64Kb to 2Gb
+
+    struct free_block_t {
+        free_block_t* next;
+    };
+
+    std::atomic<u64> heads[class_count]{};
+    std::atomic<u64> cached_bytes{0};
+    umm              max_cached_bytes{megabytes(256)};
+
+    struct stats_t {
+        std::atomic<u64> hits{0};
+        std::atomic<u64> misses{0};
+        std::atomic<u64> releases{0};
+    } stats;
+
+    static u32 block_class(umm size) {
+        const umm blocks = (std::max(size, min_block_size) + min_block_size - 1) / min_block_size;
+        return (u32)std::bit_width(blocks - 1);
+    }
+
+    static umm class_size(u32 block_class) {
+        return min_block_size << block_class;
+    }
+
+    static free_block_t* unpack(u64 head) {
+        return (free_block_t*)(head & ((1ull << 48) - 1));
+    }
+
+    static u64 pack(free_block_t* block, u64 tag) {
+        assert(((umm)block >> 48) == 0);
+        return (umm)block | (tag << 48);
+    }
+};
+
+inline std::atomic<arena_block_cache_t*> arena_block_cache{0};
+
+inline arena_block_cache_t*
+arena_get_block_cache() {
+    if (Platform.arena_shared) [[likely]] {
+        return Platform.arena_shared->block_cache;
+    }
+    auto* cache = arena_block_cache.load(std::memory_order_acquire);
+    if (cache) [[likely]] {
+        return cache;
+    }
+    assert(Platform.allocate);
+    auto* fresh = new (Platform.allocate(sizeof(arena_block_cache_t))) arena_block_cache_t{};
+    if (arena_block_cache.compare_exchange_strong(cache, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return fresh;
+    }
+    fresh->~arena_block_cache_t();
+    Platform.free(fresh);
+    return cache;
+}
+
+// any thread, returns a block of at least size bytes and writes back how big it really is.
+// recycled blocks are not cleared, same as memory that was rewound inside a block
+inline void*
+arena_block_acquire(umm* size) {
+    auto* cache = arena_get_block_cache();
+    const u32 block_class = arena_block_cache_t::block_class(*size);
+    if (block_class < arena_block_cache_t::class_count) {
+        *size = arena_block_cache_t::class_size(block_class);
+
+        auto& head = cache->heads[block_class];
+        u64 top = head.load(std::memory_order_acquire);
+        while (auto* block = arena_block_cache_t::unpack(top)) {
+            const u64 next = arena_block_cache_t::pack(block->next, (top >> 48) + 1);
+            if (head.compare_exchange_weak(top, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                cache->cached_bytes.fetch_sub(*size, std::memory_order_relaxed);
+                cache->stats.hits.fetch_add(1, std::memory_order_relaxed);
+                return block;
+            }
+        }
+    }
+    cache->stats.misses.fetch_add(1, std::memory_order_relaxed);
+    assert(Platform.allocate);
+    return Platform.allocate(*size);
+}
+
+// any thread
+inline void
+arena_block_release(void* memory, umm size) {
+    auto* cache = arena_get_block_cache();
+    const u32 block_class = arena_block_cache_t::block_class(size);
+    const b32 cacheable = block_class < arena_block_cache_t::class_count && arena_block_cache_t::class_size(block_class) == size;
+    if (!cacheable || cache->cached_bytes.fetch_add(size, std::memory_order_relaxed) + size > cache->max_cached_bytes) {
+        if (cacheable) {
+            cache->cached_bytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+        Platform.free(memory);
+        return;
+    }
+
+    auto* block = (arena_block_cache_t::free_block_t*)memory;
+    auto& head = cache->heads[block_class];
+    u64 top = head.load(std::memory_order_relaxed);
+    do {
+        block->next = arena_block_cache_t::unpack(top);
+    } while (!head.compare_exchange_weak(top, arena_block_cache_t::pack(block, (top >> 48) + 1), std::memory_order_release, std::memory_order_relaxed));
+    cache->stats.releases.fetch_add(1, std::memory_order_relaxed);
+}
+
 static void 
 arena_add_tag(arena_t* arena, allocation_tag_t* tag) {
     if (arena->settings.fixed) {
@@ -1362,11 +1738,30 @@ arena_add_tag(arena_t* arena, allocation_tag_t* tag) {
     } else {
         assert(arena->block_count);
         tag->block_id = arena->block_count - 1;
-        tag->poison();
     }
     node_push(tag, arena->tags);
 }
 
+// walks the tags pushed after last, stops at the first broken guard
+static allocation_tag_t*
+arena_find_overflow(arena_t* arena, allocation_tag_t* last = 0) {
+    for (auto* tag = arena->tags; tag && tag != last; tag = tag->next) {
+        if (tag->overflowed()) {
+            return tag;
+        }
+    }
+    return 0;
+}
+
+static void
+arena_check_guards(arena_t* arena, allocation_tag_t* last = 0) {
+    if (auto* tag = arena_find_overflow(arena, last)) {
+        const auto& site = tag->callsite();
+        ztd_error(__FUNCTION__, "Allocation overflowed: {}[{}] {}:{}", site.type_name, tag->count, site.file_name, site.line_number);
+        assert(0 && "Allocation overflow");
+    }
+}
+
 inline size_t
 arena_get_remaining(arena_t* arena) noexcept {
     return arena->size - arena->top;
@@ -1412,40 +1807,44 @@ arena_get_footer(arena_t* arena) {
     ((f64((arena)->top) / f64((arena)->size)) * 100.0)))
     
 
-inline std::byte*
-push_bytes(arena_t* arena, size_t bytes) {
-    if (!arena->settings.fixed) {
-        if (arena->top + bytes >= arena->size) [[unlikely]] {
-            umm block_size = std::max(bytes + sizeof(arena_block_footer_t), arena->settings.minimum_block_size);
-            block_size = std::max(block_size, kilobytes(64));
-            
-            // arena->settings.minimum_block_size = std::max(block_size, arena->settings.minimum_block_size);
+constexpr umm arena_max_growth_block_size = megabytes(64);
 
-            // if ((arena->block_count % 10) == 1) {
-            //     arena->settings.minimum_block_size *= 2;
-            // }
+// each block is at least twice the last one, so long lived arenas settle on a few big blocks
+inline void
+arena_push_block(arena_t* arena, size_t bytes) {
+    umm block_size = std::max(bytes + sizeof(arena_block_footer_t), arena->settings.minimum_block_size);
+    block_size = std::max(block_size, kilobytes(64));
+    if (arena->start) {
+        block_size = std::max(block_size, std::min((arena->size + sizeof(arena_block_footer_t)) * 2, arena_max_growth_block_size));
+    }
 
-            arena_block_footer_t footer;
-            footer.base = arena->start;
-            footer.size = arena->size;
-            footer.used = arena->top;
+    arena_block_footer_t footer;
+    footer.base = arena->start;
+    footer.size = arena->size;
+    footer.used = arena->top;
 
-            if (!arena->settings.allocate) {
-                assert(Platform.allocate);
-                arena->settings.allocate = Platform.allocate;
-                arena->settings.free = Platform.free;
-            }
+    if (arena->settings.allocate) {
+        arena->start = (std::byte*)arena->settings.allocate(block_size);
+    } else {
+        arena->start = (std::byte*)arena_block_acquire(&block_size);
+    }
+    assert(arena->start);
+    arena->prior_used += footer.used;
+    arena->top = 0;
+    arena->size = block_size - sizeof(arena_block_footer_t);
 
-            arena->start = (std::byte*)arena->settings.allocate(block_size);
-            assert(arena->start);
-            arena->top = 0;
-            arena->size = block_size - sizeof(arena_block_footer_t);
+    // always written, a recycled block can still hold the footer of its last owner
+    *arena_get_footer(arena) = footer;
 
-            if (footer.base) {
-                *arena_get_footer(arena) = footer;
-            }
+    arena->block_count++;
+}
 
-            arena->block_count++;
+inline std::byte*
+push_bytes(arena_t* arena, size_t bytes) {
+    if (!arena->settings.fixed) {
+        const size_t aligned_top = arena->settings.alignment ? align_2n(arena->top, arena->settings.alignment) : arena->top;
+        if (!arena->start || aligned_top + bytes >= arena->size) [[unlikely]] {
+            arena_push_block(arena, bytes + arena->settings.alignment);
         }
     }
 
@@ -1458,45 +1857,53 @@ push_bytes(arena_t* arena, size_t bytes) {
 
     arena->top += bytes;
     assert(arena->top <= arena->size && "Arena overflow");
+    arena->high_water = std::max(arena->high_water, arena->prior_used + arena->top);
 
     return start;
 }
 
-static allocation_tag_t*
-get_allocation_tag(void* ptr) {
-    auto* tag = ((allocation_tag_t*)ptr)-1;
-    // if (tag->magic == std::string_view{"ATAG"}) {
-    return tag;
-    // }
-    // return 0;
-}
+#define ZTD_ALLOCATION_SITE(type) \
+    [](const char* function_name) { \
+        static const u32 site = allocation_site_register(#type, sizeof(type), __FILE__, function_name, (u64)__LINE__); \
+        return site; \
+    }(__FUNCTION__)
 
 #if ZTD_INTERNAL
     #define tag_struct(src, type, arena, ...) \
-        arena_add_tag((arena), push_struct<allocation_tag_t>((arena), 1, allocation_tag_t{#type, __FILE__, __FUNCTION__, (u64)__LINE__, 1, sizeof(type)}));\
-        src = push_struct<type>((arena), 1, __VA_ARGS__)
+        src = push_tagged<type>((arena), ZTD_ALLOCATION_SITE(type), 1, ##__VA_ARGS__)
 #else 
     #define tag_struct(src, type, arena, ...) \
-        src = push_struct<type>((arena), 1, __VA_ARGS__)
+        src = push_struct<type>((arena), 1, ##__VA_ARGS__)
 #endif
 
 
 #if ZTD_INTERNAL
     #define tag_array(src, type, arena, count, ...) \
-        arena_add_tag((arena), push_struct<allocation_tag_t>((arena), 1, allocation_tag_t{#type, __FILE__, __FUNCTION__, (u64)__LINE__, (count), sizeof(type)}));\
-        src = push_struct<type>((arena), (count), __VA_ARGS__)
+        src = push_tagged<type>((arena), ZTD_ALLOCATION_SITE(type), (count), ##__VA_ARGS__)
 #else 
     #define tag_array(src, type, arena, count, ...) \
-        src = push_struct<type>((arena), (count), __VA_ARGS__)
+        src = push_struct<type>((arena), (count), ##__VA_ARGS__)
 #endif
 
+// Note(Zack): gcc deletes the default ctor of aggregates holding an anonymous union with non-trivial
+// members (event_t, render_command_t, particle settings), building from T{} is the same thing and compiles everywhere
+template <typename T>
+inline T*
+construct_default(void* p) {
+    if constexpr (std::is_aggregate_v<T>) {
+        return new (p) T(T{});
+    } else {
+        return new (p) T();
+    }
+}
+
 template <typename T>
 inline T*
 push_struct(arena_t* arena, size_t count = 1) {
     // static_assert(std::is_trivially_copyable_v<T>);
     T* t = reinterpret_cast<T*>(push_bytes(arena, sizeof(T) * count));
     for (size_t i = 0; i < count; i++) {
-        new (t + i) T();
+        construct_default<T>(t + i);
     }
     return t;
 }
@@ -1511,17 +1918,48 @@ push_struct(arena_t* arena, size_t count, Args&& ... args) {
     return t;
 }
 
+template <typename T, typename ... Args>
+inline T*
+push_tagged(arena_t* arena, u32 site_index, size_t count, Args&& ... args) {
+    auto* tag = push_struct<allocation_tag_t>(arena);
+    tag->site = site_index;
+    tag->count = count;
+    arena_add_tag(arena, tag);
+
+    auto& site = allocation_site_table()->sites[site_index];
+    const u64 sample = site.allocations.fetch_add(1, std::memory_order_relaxed);
+    site.bytes.fetch_add(sizeof(T) * count, std::memory_order_relaxed);
+
+    // the guard goes in the same push so nothing, not even alignment, sits between it and the data
+    const b32 guarded = sample % ZTD_ALLOCATION_GUARD_INTERVAL == 0;
+    const size_t data_size = sizeof(T) * count;
+    std::byte* bytes = push_bytes(arena, data_size + (guarded ? sizeof(allocation_guard_t) : 0));
+
+    T* t = reinterpret_cast<T*>(bytes);
+    for (size_t i = 0; i < count; i++) {
+        if constexpr (sizeof...(Args) == 0) {
+            construct_default<T>(t + i);
+        } else {
+            new (t + i) T(std::forward<Args>(args)...);
+        }
+    }
+    if (guarded) {
+        tag->guard = new (bytes + data_size) allocation_guard_t{};
+    }
+    return t;
+}
+
 template <typename T>
 inline T*
 bootstrap_arena_(umm offset, umm minimum_block_size = 0) {
-    arena_t arena = arena_create(std::max(sizeof(T) + sizeof(arena_block_footer_t) + sizeof(allocation_tag_t), minimum_block_size));
+    arena_t arena = arena_create(std::max(sizeof(T) + sizeof(arena_block_footer_t) + sizeof(allocation_tag_t) + sizeof(allocation_guard_t), minimum_block_size));
     tag_struct(auto* obj, T, &arena);
     // auto* obj = push_struct<T>(&arena);
     *((arena_t*)((u8*)obj + offset)) = arena;
     return obj;
 }
 
-#define bootstrap_arena(type, ...) bootstrap_arena_<type>(offsetof(type, arena), __VA_ARGS__)
+#define bootstrap_arena(type, ...) bootstrap_arena_<type>(offsetof(type, arena), ##__VA_ARGS__)
 
 
 // todo add file and line for tagging
@@ -1567,22 +2005,29 @@ void
 arena_free_block(arena_t* arena) {
     assert(arena->block_count);
     auto* block = (void*)arena->start;
+    const umm block_size = arena->size + sizeof(arena_block_footer_t);
 
     auto* footer = arena_get_footer(arena);
 
     arena->start = footer->base;
     arena->top = footer->used;
     arena->size = footer->size;
-
-    assert(arena->settings.free);
+    arena->prior_used -= footer->used;
 
     arena->block_count--;
 
-    arena->settings.free(block);
+    if (arena->settings.free) {
+        arena->settings.free(block);
+    } else {
+        arena_block_release(block, block_size);
+    }
 }
 
 inline void
 arena_clear(arena_t* arena) {
+#if ZTD_INTERNAL
+    arena_check_guards(arena);
+#endif
     arena->tags = 0;
     // ztd_warn(__FUNCTION__, "Arena cleared: {}", (void*)arena);
     if (arena->settings.fixed) {
@@ -1614,6 +2059,9 @@ void
 end_temporary_memory(temporary_arena_t memory) {
     // return;
     auto* arena = memory.arena;
+#if ZTD_INTERNAL
+    arena_check_guards(arena, memory.last_tag);
+#endif
     while(arena->start != memory.base) {
         arena_free_block(arena);
     }
@@ -1622,6 +2070,105 @@ end_temporary_memory(temporary_arena_t memory) {
     // arena->temporary_count--;
 }
 
+// Note(Zack): Every thread gets two scratch arenas for temporaries, use them with begin_temporary_memory
+// and end_temporary_memory like any other arena. Pass the arena a result is being pushed to as conflict,
+// so a function that was handed one scratch arena grabs the other. Their blocks come from the block cache
+// so growing and rewinding them doesnt touch the platform once it is warm.
+struct arena_scratch_thread_t {
+    arena_t             arenas[2]{};
+    std::thread::id     thread_id{};
+    std::atomic<b32>    ready{0};
+    std::atomic<u64>    high_water{0}; // published every time the thread grabs a scratch arena
+};
+
+struct arena_scratch_registry_t {
+    static constexpr u32 max_threads = 64;
+
+    std::atomic<u32>        thread_count{0};
+    arena_scratch_thread_t  threads[max_threads];
+};
+
+struct arena_scratch_stats_t {
+    std::thread::id thread_id{};
+    u64             high_water{0};
+};
+
+inline arena_scratch_registry_t arena_scratch_registry_local{}; // only used when there is no platform
+inline thread_local arena_scratch_thread_t* arena_scratch_thread = 0;
+inline thread_local arena_scratch_thread_t arena_scratch_unregistered{}; // once the registry is full
+
+inline arena_scratch_registry_t*
+arena_get_scratch_registry() {
+    return Platform.arena_shared ? Platform.arena_shared->scratch_registry : &arena_scratch_registry_local;
+}
+
+inline arena_scratch_thread_t*
+arena_get_scratch_thread() {
+    if (arena_scratch_thread) [[likely]] {
+        return arena_scratch_thread;
+    }
+    auto* registry = arena_get_scratch_registry();
+    const auto thread_id = std::this_thread::get_id();
+
+    // thread locals are per module, another module or an earlier load of this dll may have set this thread up
+    const u32 count = std::min(registry->thread_count.load(std::memory_order_acquire), arena_scratch_registry_t::max_threads);
+    range_u32(i, 0, count) {
+        auto* thread = &registry->threads[i];
+        if (thread->ready.load(std::memory_order_acquire) && thread->thread_id == thread_id) {
+            arena_scratch_thread = thread;
+            return thread;
+        }
+    }
+
+    const u32 slot = registry->thread_count.fetch_add(1, std::memory_order_relaxed);
+    auto* thread = slot < arena_scratch_registry_t::max_threads ? &registry->threads[slot] : &arena_scratch_unregistered;
+    thread->thread_id = thread_id;
+    range_u32(i, 0, 2) {
+        thread->arenas[i] = arena_create(kilobytes(256));
+        // keep the first block, rewinding a temporary to it wont hand it back
+        arena_push_block(&thread->arenas[i], 0);
+    }
+    thread->ready.store(1, std::memory_order_release);
+    arena_scratch_thread = thread;
+    return thread;
+}
+
+// this threads scratch arena, never the same one as conflict
+inline arena_t*
+arena_get_scratch(const arena_t* conflict = 0) {
+    auto* thread = arena_get_scratch_thread();
+    thread->high_water.store(std::max(thread->arenas[0].high_water, thread->arenas[1].high_water), std::memory_order_relaxed);
+    return conflict == &thread->arenas[0] ? &thread->arenas[1] : &thread->arenas[0];
+}
+
+// high water marks of every thread that has used its scratch arenas, returns how many were written
+inline u32
+arena_get_scratch_stats(std::span<arena_scratch_stats_t> out) {
+    auto* registry = arena_get_scratch_registry();
+    const u32 count = std::min(registry->thread_count.load(std::memory_order_acquire), arena_scratch_registry_t::max_threads);
+    u32 written = 0;
+    range_u32(i, 0, count) {
+        if (written == out.size()) {
+            break;
+        }
+        const auto& thread = registry->threads[i];
+        if (thread.ready.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        out[written++] = arena_scratch_stats_t{thread.thread_id, thread.high_water.load(std::memory_order_relaxed)};
+    }
+    return written;
+}
+
+// platform only, after Platform.allocate is set and before any dll is loaded
+inline void
+arena_shared_state_init(arena_shared_state_t* shared) {
+    shared->allocation_sites = &allocation_site_table_local;
+    shared->block_cache = arena_get_block_cache();
+    shared->scratch_registry = &arena_scratch_registry_local;
+    Platform.arena_shared = shared;
+}
+
 arena_t* co_stack(coroutine_t* coro, frame_arena_t& frame_arena) {
     // if (coro->running == false) return 0;
     if (coro->stack) {
@@ -1651,6 +2198,8 @@ T* co_push_stack_(coroutine_t* coro, arena_t* arena, umm count = 1) {
 #define co_push_stack(coro, stack, type) co_push_stack_<type>(coro, stack) 
 #define co_push_array_stack(coro, stack, type, count) co_push_stack_<type>(coro, stack, count) 
 
+#include "ztd_jobs.hpp"
+
 namespace utl {
     // Todo(Zack): Merge blocks
 struct allocator_t {
@@ -1760,6 +2309,101 @@ struct allocator_t {
     }
 };
 
+// Note(Zack): segregated free lists for lots of small short lived allocations (script vms).
+// 16 byte steps up to 256, then powers of 2. Blocks are bumped from the arena and recycled
+// through their class, freed blocks hold the next pointer. Callers pass the size back on free,
+// so there are no headers, clearing the arena resets everything.
+struct size_class_allocator_t {
+    static constexpr u64 small_step = 16;
+    static constexpr u64 small_max = 256;
+    static constexpr u64 small_class_count = small_max / small_step;
+    static constexpr u64 class_count = small_class_count + 32;
+
+    struct free_block_t {
+        free_block_t* next;
+    };
+
+    struct stats_t {
+        u64 bytes_requested{0}; // what callers asked for
+        u64 bytes_in_use{0};    // rounded up to the class size
+        u64 bytes_reserved{0};  // taken from the arena
+        u64 allocations{0};
+        u64 frees{0};
+        u64 in_place_reallocations{0};
+        u64 class_in_use[class_count]{};
+    };
+
+    arena_t arena{};
+    free_block_t* free_lists[class_count]{};
+    stats_t stats{};
+
+    static u64 size_class(u64 size) {
+        if (size <= small_max) {
+            return (std::max<u64>(size, 1) + small_step - 1) / small_step - 1;
+        }
+        return small_class_count + u64(std::bit_width(size - 1) - std::bit_width(small_max));
+    }
+
+    static u64 class_size(u64 size_class) {
+        if (size_class < small_class_count) {
+            return (size_class + 1) * small_step;
+        }
+        return small_max << (size_class - small_class_count + 1);
+    }
+
+    void* allocate(u64 size) {
+        const u64 c = size_class(size);
+        assert(c < class_count);
+        void* result;
+        if (auto* block = free_lists[c]) {
+            free_lists[c] = block->next;
+            result = block;
+        } else {
+            result = push_bytes(&arena, class_size(c));
+            stats.bytes_reserved += class_size(c);
+        }
+        stats.bytes_requested += size;
+        stats.bytes_in_use += class_size(c);
+        stats.allocations++;
+        stats.class_in_use[c]++;
+        return result;
+    }
+
+    void free(void* ptr, u64 size) {
+        if (!ptr) return;
+        const u64 c = size_class(size);
+        auto* block = (free_block_t*)ptr;
+        block->next = free_lists[c];
+        free_lists[c] = block;
+        stats.bytes_requested -= size;
+        stats.bytes_in_use -= class_size(c);
+        stats.frees++;
+        stats.class_in_use[c]--;
+    }
+
+    void* reallocate(void* ptr, u64 old_size, u64 new_size) {
+        if (ptr && size_class(old_size) == size_class(new_size)) {
+            stats.bytes_requested += new_size;
+            stats.bytes_requested -= old_size;
+            stats.in_place_reallocations++;
+            return ptr;
+        }
+        void* result = allocate(new_size);
+        if (ptr) {
+            utl::copy(result, ptr, std::min(old_size, new_size));
+            free(ptr, old_size);
+        }
+        return result;
+    }
+
+    // drops every block, the arena is cleared too
+    void clear() {
+        arena_clear(&arena);
+        std::fill(free_lists, free_lists + class_count, nullptr);
+        stats = {};
+    }
+};
+
 }
 
 template <typename T>
@@ -1913,7 +2557,7 @@ Value* hash_get(hash_trie_t<Key,Value>** map, Key key, arena_t* arena=0, b32* ha
 }
 
 template <typename Key, typename Value>
-void hash_foreach(hash_trie_t<Key,Value>* map, std::function<void(typename Key,typename Value*)> func) {
+void hash_foreach(hash_trie_t<Key,Value>* map, std::function<void(Key,Value*)> func) {
     if (!map) {
         return;
     }
@@ -1925,13 +2569,115 @@ void hash_foreach(hash_trie_t<Key,Value>* map, std::function<void(typename Key,t
     }
 }
 
-struct string_builder_t {
-    temporary_arena_t memory{};
+// Note(Zack): arena backed array that grows a chunk at a time, elements never move
+// so pointers and indices handed out stay valid, lookup is a shift and a mask
+template <typename T, u64 ChunkShift = 6, u64 MaxChunks = 1024>
+struct chunked_array_t {
+    static constexpr u64 chunk_size = 1ull << ChunkShift;
+    static constexpr u64 chunk_mask = chunk_size - 1;
 
-    char* string{0};
-    u64   size{0};
+    T*  chunks[MaxChunks]{};
+    u64 count{0};
 
-    static string_builder_t begin(arena_t* arena) {
+    u64 size() const {
+        return count;
+    }
+
+    u64 push_back(arena_t* arena, const T& value) {
+        const u64 chunk = count >> ChunkShift;
+        assert(chunk < MaxChunks && "Chunked array is full");
+        if (chunks[chunk] == nullptr) {
+            tag_array(chunks[chunk], T, arena, chunk_size);
+        }
+        chunks[chunk][count & chunk_mask] = value;
+        return count++;
+    }
+
+    T& operator[](u64 index) {
+        assert(index < count);
+        return chunks[index >> ChunkShift][index & chunk_mask];
+    }
+
+    const T& operator[](u64 index) const {
+        assert(index < count);
+        return chunks[index >> ChunkShift][index & chunk_mask];
+    }
+};
+
+static constexpr u64 invalid_hash = ~0ull;
+
+// open addressing sid -> u64 table, doubles when 3/4 full.
+// the old slots are left in the arena, so size it up front if the arena is long lived
+struct sid_hash_t {
+    struct slot_t {
+        sid_t key{invalid_hash};
+        u64   value{invalid_hash};
+    };
+
+    slot_t* slots{0};
+    u64     capacity{0}; // power of 2
+    u64     count{0};
+};
+
+inline void
+sid_hash_create(sid_hash_t* hash, arena_t* arena, u64 capacity = 256) {
+    capacity = std::max<u64>(capacity, 16);
+    assert((capacity & (capacity - 1)) == 0 && "Capacity must be a power of 2");
+    tag_array(hash->slots, sid_hash_t::slot_t, arena, capacity);
+    hash->capacity = capacity;
+    hash->count = 0;
+}
+
+inline sid_hash_t::slot_t*
+sid_hash_probe(const sid_hash_t* hash, sid_t key) {
+    const u64 mask = hash->capacity - 1;
+    for (u64 i = utl::rng::fnv_hash_u64(key) & mask;; i = (i + 1) & mask) {
+        auto* slot = hash->slots + i;
+        if (slot->key == key || slot->key == invalid_hash) {
+            return slot;
+        }
+    }
+}
+
+inline void
+sid_hash_add(sid_hash_t* hash, arena_t* arena, sid_t key, u64 value) {
+    assert(key != invalid_hash);
+    if (hash->capacity == 0) {
+        sid_hash_create(hash, arena);
+    }
+    if ((hash->count + 1) * 4 > hash->capacity * 3) {
+        const sid_hash_t old = *hash;
+        sid_hash_create(hash, arena, old.capacity * 2);
+        range_u64(i, 0, old.capacity) {
+            if (old.slots[i].key != invalid_hash) {
+                *sid_hash_probe(hash, old.slots[i].key) = old.slots[i];
+                hash->count++;
+            }
+        }
+    }
+    auto* slot = sid_hash_probe(hash, key);
+    if (slot->key == invalid_hash) {
+        slot->key = key;
+        hash->count++;
+    }
+    slot->value = value;
+}
+
+inline u64
+sid_hash_find(const sid_hash_t* hash, sid_t key) {
+    if (hash->count == 0) {
+        return invalid_hash;
+    }
+    return sid_hash_probe(hash, key)->value;
+}
+
+struct string_builder_t {
+    temporary_arena_t memory{};
+
+    char* string{0};
+    u64   size{0};
+
+    static string_builder_t begin(arena_t* arena) {
         string_builder_t builder {
             .memory = begin_temporary_memory(arena)
         };
@@ -2166,7 +2912,7 @@ struct pool_t : pool_base_t {
     T* create(size_t p_count) {
         T* o = allocate(p_count);
         for (size_t i = 0; i < p_count; i++) {
-            new (o+i) T();
+            construct_default<T>(o+i);
         }
         return o;
     }
@@ -2513,16 +3259,16 @@ struct any_t {
     #undef ANY_T_RETURN_TYPE
 
     union {
-        u8 u8;
-        u16 u16;
-        u32 u32;
-        u64 u64;
-        i8 i8;
-        i16 i16;
-        i32 i32;
-        i64 i64;
-        f32 f32;
-        f64 f64;
+        ::u8 u8;
+        ::u16 u16;
+        ::u32 u32;
+        ::u64 u64;
+        ::i8 i8;
+        ::i16 i16;
+        ::i32 i32;
+        ::i64 i64;
+        ::f32 f32;
+        ::f64 f64;
     } data;
 
 
@@ -2586,21 +3332,21 @@ namespace packing {
     } 
 
     u32 pack_rgbe(v3f rgb) {
-        const f32 max_val = std::bit_cast<f32>(0x477f8000ui32);
-        const f32 min_val = std::bit_cast<f32>(0x37800000ui32);
+        const f32 max_val = std::bit_cast<f32>(0x477f8000u);
+        const f32 min_val = std::bit_cast<f32>(0x37800000u);
         rgb = glm::clamp(rgb, v3f{0.0f}, v3f{max_val});
 
         float max_channel = glm::max(glm::max(min_val, rgb.r), glm::max(rgb.g, rgb.b));
 
-        float bias = std::bit_cast<f32>((std::bit_cast<u32>(max_channel) + 0x07804000ui32) & 0x7f800000ui32);
+        float bias = std::bit_cast<f32>((std::bit_cast<u32>(max_channel) + 0x07804000u) & 0x7f800000u);
 
         v3u RGB;
         RGB.x = std::bit_cast<u32>(rgb.x+bias);
         RGB.y = std::bit_cast<u32>(rgb.y+bias);
         RGB.z = std::bit_cast<u32>(rgb.z+bias);
-        u32 e = (std::bit_cast<u32>(bias) << 4) + 0x10000000ui32;
+        u32 e = (std::bit_cast<u32>(bias) << 4) + 0x10000000u;
 
-        return e | RGB.b << 18 | RGB.g << 9 | (RGB.r & 0x1ffui32);
+        return e | RGB.b << 18 | RGB.g << 9 | (RGB.r & 0x1ffu);
     }
 
     v3f unpack_rgbe(u32 p) {
@@ -2738,7 +3484,7 @@ struct draw_mesh_command_t {
 
     u64 mesh_id{0};
     u32 material_id{0};
-    u32 albedo_id{~0ui32};
+    u32 albedo_id{~0u};
     u32 gfx_id{0};
     u64 gfx_count{0};
 
@@ -3149,6 +3895,106 @@ font_render(
     utl::pool_t<u32>* indices,
     color32 text_color);
 
+// laid out glyph quads for one string, relative to the whole pixel part of the cursor
+struct text_run_t {
+    struct quad_t {
+        math::rect2d_t screen;
+        math::rect2d_t texture;
+    };
+
+    quad_t* quads{0};
+    u32     quad_count{0};
+    f32     cursor_y{0.0f}; // how far drawing moves the cursor down
+    v2f     size{0.0f};     // font_get_size of the text
+};
+
+// Note(Zack): debug panels redraw the same strings every frame, so laid out runs are kept
+// in two generations. A run used this frame is moved into the current generation,
+// anything not drawn for a whole frame is dropped when its generation is cleared.
+struct text_cache_t {
+    frame_arena_t   memory;
+    utl::sid_hash_t runs[2];
+    u64             hits{0};
+    u64             misses{0};
+};
+
+inline text_cache_t*
+text_cache_create(arena_t* arena, size_t bytes) {
+    tag_struct(auto* cache, text_cache_t, arena);
+    cache->memory = arena_create_frame_arena(arena, bytes);
+    utl::sid_hash_create(&cache->runs[0], &cache->memory.arena[0]);
+    utl::sid_hash_create(&cache->runs[1], &cache->memory.arena[1]);
+    return cache;
+}
+
+inline void
+text_cache_next_frame(text_cache_t* cache) {
+    cache->memory.active++;
+    auto& arena = cache->memory.get();
+    arena_clear(&arena);
+    utl::sid_hash_create(&cache->runs[cache->memory.active % 2], &arena, cache->runs[cache->memory.active % 2].capacity);
+    cache->hits = cache->misses = 0;
+}
+
+inline u64
+text_cache_key(u32 font_id, std::string_view text, v2f fraction) {
+    u64 key = sid(text);
+    key = utl::rng::fnv_hash_u64(key ^ font_id);
+    key = utl::rng::fnv_hash_u64(key ^ ((u64)std::bit_cast<u32>(fraction.x) << 32 | std::bit_cast<u32>(fraction.y)));
+    return key == utl::invalid_hash ? 0 : key;
+}
+
+// reserves a run in the current generation, null when the generation is full
+inline text_run_t*
+text_cache_push_run(text_cache_t* cache, u64 key, u64 bytes) {
+    auto& arena = cache->memory.get();
+    auto& runs = cache->runs[cache->memory.active % 2];
+    // leave room for the hash to double
+    const u64 hash_growth = runs.capacity * 2 * sizeof(utl::sid_hash_t::slot_t);
+    if (arena_get_remaining(&arena) < bytes + hash_growth + 64) {
+        return nullptr;
+    }
+    auto* run = (text_run_t*)push_bytes(&arena, align_2n(bytes, 8));
+    utl::sid_hash_add(&runs, &arena, key, (u64)run);
+    return run;
+}
+
+inline text_run_t*
+text_cache_find(text_cache_t* cache, u64 key) {
+    const u64 current = utl::sid_hash_find(&cache->runs[cache->memory.active % 2], key);
+    if (current != utl::invalid_hash) {
+        return (text_run_t*)current;
+    }
+
+    const u64 last = utl::sid_hash_find(&cache->runs[(cache->memory.active + 1) % 2], key);
+    if (last == utl::invalid_hash) {
+        return nullptr;
+    }
+
+    // still in use, carry it over to this frame
+    const auto* old_run = (text_run_t*)last;
+    const u64 bytes = sizeof(text_run_t) + sizeof(text_run_t::quad_t) * old_run->quad_count;
+    auto* run = text_cache_push_run(cache, key, bytes);
+    if (run) {
+        *run = *old_run;
+        run->quads = (text_run_t::quad_t*)(run + 1);
+        utl::copy(run->quads, old_run->quads, sizeof(text_run_t::quad_t) * old_run->quad_count);
+    }
+    return run;
+}
+
+inline v2f
+font_render_cached(
+    text_cache_t* cache,
+    font_t* font,
+    std::string_view text,
+    v2f& cursor,
+    f32 depth,
+    v2f screen_size,
+    utl::pool_t<gui::vertex_t>* vertices,
+    utl::pool_t<u32>* indices,
+    color32 text_color);
+
 
 namespace color {
 
@@ -3281,10 +4127,10 @@ namespace color {
 
     constexpr color32 to_color32(const color4& c) {
         return 
-            (u8(std::min(u16(c.x * 255.0f), 255ui16)) << 0 ) |
-            (u8(std::min(u16(c.y * 255.0f), 255ui16)) << 8 ) |
-            (u8(std::min(u16(c.z * 255.0f), 255ui16)) << 16) |
-            (u8(std::min(u16(c.w * 255.0f), 255ui16)) << 24) ;
+            (u8(std::min(u16(c.x * 255.0f), u16(255))) << 0 ) |
+            (u8(std::min(u16(c.y * 255.0f), u16(255))) << 8 ) |
+            (u8(std::min(u16(c.z * 255.0f), u16(255))) << 16) |
+            (u8(std::min(u16(c.w * 255.0f), u16(255))) << 24) ;
     }
 
     constexpr color32 to_color32(const color3& c) {
@@ -3319,11 +4165,11 @@ namespace color {
         return to_color32(v*v);
     }
 
-    constexpr color32 flatten_color(color32 c) {
+    inline color32 flatten_color(color32 c) {
         return to_color32(glm::mix(to_color3(c), v3f{0.5f}, 0.5f) ); 
     }
 
-    constexpr color32 lerp(color32 a, color32 b, f32 t) {
+    inline color32 lerp(color32 a, color32 b, f32 t) {
         return to_color32(glm::mix(to_color4(a),to_color4(b),t));
     } 
 
@@ -3691,6 +4537,7 @@ namespace gui {
         utl::pool_t<u32>* indices;
         gfx::font_t* font;
         app_input_t* input;
+        text_cache_t* text_cache{0}; // optional, draw_string lays text out from scratch without it
         v2f screen_pos{0.0f};
         v2f screen_size{};
 
@@ -3882,6 +4729,9 @@ namespace gui {
         ctx->indices = indices;
         ctx->vertices->clear();
         ctx->indices->clear();
+        if (ctx->text_cache) {
+            text_cache_next_frame(ctx->text_cache);
+        }
     }
 
     inline v2f
@@ -3893,6 +4743,21 @@ namespace gui {
         font_t* font = 0,
         color32 shadow = 0
     ) {
+        if (ctx->text_cache) {
+            // the shadow is offset by whole pixels so both passes share one cached run
+            if (shadow) {
+                auto start = *position;
+                start += v2f{2.0f};
+                font_render_cached(ctx->text_cache, font ? font : ctx->font, 
+                    text, start, ctx->draw_z, ctx->screen_size, ctx->vertices, ctx->indices, shadow
+                );
+            }
+            const v2f size = font_render_cached(ctx->text_cache, font ? font : ctx->font, 
+                text, *position, ctx->draw_z, ctx->screen_size, ctx->vertices, ctx->indices, text_color
+            );
+            ctx->depth_down();
+            return size;
+        }
         if (shadow) {
             auto start = *position;
             start += v2f{2.0f};
@@ -3951,7 +4816,7 @@ namespace gui {
 
         center->pos = ctx->ui_2d(pos);
         center->col = color;
-        center->img = ~(0ui32);
+        center->img = ~(0u);
 
         while(res%3) {
             res++;
@@ -3964,7 +4829,7 @@ namespace gui {
             v->pos = center->pos + ctx->ui_2d(v2f{glm::cos(a), glm::sin(a)} * radius);
             v->pos.z = ctx->draw_z;
             v->col = color;
-            v->img = ~(0ui32);
+            v->img = ~(0u);
 
             if (i > 0) {
                 u32* tris = ctx->indices->allocate(3);
@@ -3998,10 +4863,10 @@ namespace gui {
 
         vertex_t* v = ctx->vertices->allocate(4);
         u32* i = ctx->indices->allocate(6);
-        v[0] = vertex_t { .pos = ctx->ui_2d(a + n * (line_width * 0.5f)), .tex = v2f{0.0f, 1.0f}, .nrm=0, .img = ~(0ui32), .col = color};
-        v[1] = vertex_t { .pos = ctx->ui_2d(a - n * (line_width * 0.5f)), .tex = v2f{0.0f, 0.0f}, .nrm=0, .img = ~(0ui32), .col = color};
-        v[2] = vertex_t { .pos = ctx->ui_2d(b + n * (line_width * 0.5f)), .tex = v2f{1.0f, 0.0f}, .nrm=0, .img = ~(0ui32), .col = color};
-        v[3] = vertex_t { .pos = ctx->ui_2d(b - n * (line_width * 0.5f)), .tex = v2f{1.0f, 1.0f}, .nrm=0, .img = ~(0ui32), .col = color};
+        v[0] = vertex_t { .pos = ctx->ui_2d(a + n * (line_width * 0.5f)), .tex = v2f{0.0f, 1.0f}, .nrm=0, .img = ~(0u), .col = color};
+        v[1] = vertex_t { .pos = ctx->ui_2d(a - n * (line_width * 0.5f)), .tex = v2f{0.0f, 0.0f}, .nrm=0, .img = ~(0u), .col = color};
+        v[2] = vertex_t { .pos = ctx->ui_2d(b + n * (line_width * 0.5f)), .tex = v2f{1.0f, 0.0f}, .nrm=0, .img = ~(0u), .col = color};
+        v[3] = vertex_t { .pos = ctx->ui_2d(b - n * (line_width * 0.5f)), .tex = v2f{1.0f, 1.0f}, .nrm=0, .img = ~(0u), .col = color};
 
         i[0] = v_start + 0;
         i[1] = v_start + 1;
@@ -4014,6 +4879,52 @@ namespace gui {
         ctx->depth_down();
     }
 
+    // in screen space, points holds a start/end pair per line, everything goes out in one allocation
+    inline void
+    draw_lines(
+        ctx_t* ctx,
+        const v2f* points,
+        const u32* colors,
+        u64 line_count,
+        f32 line_width
+    ) {
+        if (line_count == 0) {
+            return;
+        }
+        const u32 v_start = safe_truncate_u64(ctx->vertices->count());
+        vertex_t* v = ctx->vertices->allocate(line_count * 4);
+        u32* i = ctx->indices->allocate(line_count * 6);
+
+        range_u64(l, 0, line_count) {
+            const v2f a = points[l * 2 + 0];
+            const v2f b = points[l * 2 + 1];
+            const v2f d{(b-a)};
+            const f32 length = glm::length(d);
+            const v2f ud{length > 0.0f ? d / length : v2f{1.0f, 0.0f}};
+            const v2f n{v2f{-ud.y, ud.x} * (line_width * 0.5f)};
+            const u32 color = colors[l];
+
+            v[0] = vertex_t { .pos = ctx->ui_2d(a + n), .tex = v2f{0.0f, 1.0f}, .nrm=0, .img = ~(0u), .col = color};
+            v[1] = vertex_t { .pos = ctx->ui_2d(a - n), .tex = v2f{0.0f, 0.0f}, .nrm=0, .img = ~(0u), .col = color};
+            v[2] = vertex_t { .pos = ctx->ui_2d(b + n), .tex = v2f{1.0f, 0.0f}, .nrm=0, .img = ~(0u), .col = color};
+            v[3] = vertex_t { .pos = ctx->ui_2d(b - n), .tex = v2f{1.0f, 1.0f}, .nrm=0, .img = ~(0u), .col = color};
+
+            const u32 s = v_start + u32(l * 4);
+            i[0] = s + 0;
+            i[1] = s + 1;
+            i[2] = s + 2;
+
+            i[3] = s + 2;
+            i[4] = s + 1;
+            i[5] = s + 3;
+
+            v += 4;
+            i += 6;
+        }
+
+        ctx->depth_down();
+    }
+
     void
     draw_curve(
         ctx_t* ctx,
@@ -4192,7 +5103,7 @@ namespace gui {
         math::triangle_t triangle,
         std::span<u32, 3> colors,
         std::span<v2f, 3> uv,
-        u32 img = ~0ui32
+        u32 img = ~0u
     ) {
         const u32 v_start = safe_truncate_u64(ctx->vertices->count());
         const u32 i_start = safe_truncate_u64(ctx->indices->count());
@@ -4322,10 +5233,10 @@ namespace gui {
 
         vertex_t* v = ctx->vertices->allocate(4);
         u32* i = ctx->indices->allocate(6);
-        v[0] = vertex_t { .pos = ctx->ui_2d(p0), .tex = v2f{0.0f, 1.0f}, .nrm = 0, .img = ~(0ui32), .col = colors[0]};
-        v[1] = vertex_t { .pos = ctx->ui_2d(p1), .tex = v2f{0.0f, 0.0f}, .nrm = 0, .img = ~(0ui32), .col = colors[1]};
-        v[2] = vertex_t { .pos = ctx->ui_2d(p2), .tex = v2f{1.0f, 0.0f}, .nrm = 0, .img = ~(0ui32), .col = colors[2]};
-        v[3] = vertex_t { .pos = ctx->ui_2d(p3), .tex = v2f{1.0f, 1.0f}, .nrm = 0, .img = ~(0ui32), .col = colors[3]};
+        v[0] = vertex_t { .pos = ctx->ui_2d(p0), .tex = v2f{0.0f, 1.0f}, .nrm = 0, .img = ~(0u), .col = colors[0]};
+        v[1] = vertex_t { .pos = ctx->ui_2d(p1), .tex = v2f{0.0f, 0.0f}, .nrm = 0, .img = ~(0u), .col = colors[1]};
+        v[2] = vertex_t { .pos = ctx->ui_2d(p2), .tex = v2f{1.0f, 0.0f}, .nrm = 0, .img = ~(0u), .col = colors[2]};
+        v[3] = vertex_t { .pos = ctx->ui_2d(p3), .tex = v2f{1.0f, 1.0f}, .nrm = 0, .img = ~(0u), .col = colors[3]};
 
         i[0] = v_start + 0;
         i[1] = v_start + 1;
@@ -4354,10 +5265,10 @@ namespace gui {
 
         vertex_t* v = ctx->vertices->allocate(4);
         u32* i = ctx->indices->allocate(6);
-        v[0] = vertex_t { .pos = ctx->ui_2d(p0), .tex = v2f{0.0f, 1.0f}, .nrm=0, .img = ~(0ui32), .col = color};
-        v[1] = vertex_t { .pos = ctx->ui_2d(p1), .tex = v2f{0.0f, 0.0f}, .nrm=0, .img = ~(0ui32), .col = color};
-        v[2] = vertex_t { .pos = ctx->ui_2d(p2), .tex = v2f{1.0f, 0.0f}, .nrm=0, .img = ~(0ui32), .col = color};
-        v[3] = vertex_t { .pos = ctx->ui_2d(p3), .tex = v2f{1.0f, 1.0f}, .nrm=0, .img = ~(0ui32), .col = color};
+        v[0] = vertex_t { .pos = ctx->ui_2d(p0), .tex = v2f{0.0f, 1.0f}, .nrm=0, .img = ~(0u), .col = color};
+        v[1] = vertex_t { .pos = ctx->ui_2d(p1), .tex = v2f{0.0f, 0.0f}, .nrm=0, .img = ~(0u), .col = color};
+        v[2] = vertex_t { .pos = ctx->ui_2d(p2), .tex = v2f{1.0f, 0.0f}, .nrm=0, .img = ~(0u), .col = color};
+        v[3] = vertex_t { .pos = ctx->ui_2d(p3), .tex = v2f{1.0f, 1.0f}, .nrm=0, .img = ~(0u), .col = color};
 
         i[0] = v_start + 0;
         i[1] = v_start + 1;
@@ -7572,16 +8483,16 @@ namespace gui {
             bool b[64];
             size_t i{0};
             for (const auto& name: names) {
-                b[i] = (*flag) & (1ui64<<i);
+                b[i] = (*flag) & (1ull<<i);
 
                 same_line(imgui);
                 checkbox(imgui, &b[i]);
                 b[i] ^= text(imgui, fmt_sv(" - {}", name));
                 // *flag ^= (b[i] << i);
                 if (b[i]) {
-                    *flag |= (1ui64 << i); // Set the corresponding bit to 1
+                    *flag |= (1ull << i); // Set the corresponding bit to 1
                 } else {
-                    *flag &= ~(1ui64 << i); // Set the corresponding bit to 0
+                    *flag &= ~(1ull << i); // Set the corresponding bit to 0
                 }
 
                 i++;
@@ -7919,6 +8830,16 @@ struct font_t {
         int   kern{0};
         int   advance{0};
     };
+
+    // baked quad for each printable ascii glyph, built once by font_load
+    struct glyph_metrics_t {
+        v2f offset{};   // from the cursor, before rounding
+        v2f size{};
+        math::rect2d_t texture{};
+        int advance{0};
+    };
+    static constexpr u32 glyph_count = 96;
+
     f32 size{12.0f};
     f32 draw_scale{};
     u32 pixel_count{512};
@@ -7929,6 +8850,9 @@ struct font_t {
     stbtt_fontinfo font_info = {};
     u32 id{0};
 
+    glyph_metrics_t glyphs[glyph_count]{};
+    int* kerning{0}; // [first * glyph_count + second], null until the tables are built
+
     void* user_data = 0;
     
     template<typename T>
@@ -7939,6 +8863,40 @@ struct font_t {
 
 // todo use stbtt_ScaleForPixelHeight
 
+// Note(Zack): stb looks up metrics and walks the kern table for every character,
+// the gui draws thousands of strings a frame so everything is pulled into flat tables once
+inline void
+font_build_glyph_tables(
+    arena_t* arena,
+    font_t* font
+) 
+#ifdef STB_TRUETYPE_IMPLEMENTATION
+{
+    const f32 inv_pixel_count = 1.0f / f32(font->pixel_count);
+    range_u32(i, 0, font_t::glyph_count) {
+        const auto& baked = font->cdata[i];
+        auto& glyph = font->glyphs[i];
+        glyph.offset = v2f{baked.xoff, baked.yoff};
+        glyph.size = v2f{f32(baked.x1 - baked.x0), f32(baked.y1 - baked.y0)};
+        glyph.texture = math::rect2d_t{
+            v2f{baked.x0, baked.y0} * inv_pixel_count,
+            v2f{baked.x1, baked.y1} * inv_pixel_count
+        };
+        int lsb;
+        stbtt_GetCodepointHMetrics(&font->font_info, i + 32, &glyph.advance, &lsb);
+    }
+
+    tag_array(font->kerning, int, arena, font_t::glyph_count * font_t::glyph_count);
+    range_u32(a, 0, font_t::glyph_count) {
+        range_u32(b, 0, font_t::glyph_count) {
+            font->kerning[a * font_t::glyph_count + b] = stbtt_GetCodepointKernAdvance(&font->font_info, a + 32, b + 32);
+        }
+    }
+}
+#else 
+{}
+#endif
+
 inline void
 font_load(
     arena_t* arena,
@@ -7961,7 +8919,11 @@ font_load(
         // font->ttf_buffer = (u8*)push_bytes(memory.arena, 1<<20);
         
         FILE* file = 0;
+#if _WIN32
         fopen_s(&file, path.data(), "rb");
+#else
+        file = fopen(path.data(), "rb");
+#endif
 
         fread(font->ttf_buffer, 1, 1<<20, file);
 
@@ -7974,6 +8936,8 @@ font_load(
 
         fclose(file);
 
+        font_build_glyph_tables(arena, font);
+
     // arena_set_mark(arena, stack_mark);
     // end_temporary_memory(memory);
 }
@@ -7985,6 +8949,21 @@ inline font_t::glyph_t
 font_get_glyph(font_t* font, f32 x, f32 y, char c, char nc = 0) 
 #ifdef STB_TRUETYPE_IMPLEMENTATION
 {
+    if (font->kerning) {
+        // same rounding as stbtt_GetBakedQuad with the opengl fill rule
+        const u32 index = u32(c - 32);
+        const auto& metrics = font->glyphs[index];
+        const v2f corner = glm::floor(v2f{x, y} + metrics.offset + 0.5f);
+        const b32 kern_pair = nc >= 32 && nc < 128;
+        return font_t::glyph_t{
+            c,
+            math::rect2d_t{corner, corner + metrics.size},
+            metrics.texture,
+            kern_pair ? font->kerning[index * font_t::glyph_count + u32(nc - 32)] : 0,
+            metrics.advance
+        };
+    }
+
     math::rect2d_t screen{};
     math::rect2d_t texture{};
     
@@ -8049,19 +9028,15 @@ font_get_size(
     return size;
 }
 
+// walks the text the same way for drawing and caching, emit(glyph) gets every visible glyph
+template <typename Emit>
 inline void
-font_render(
-    arena_t* arena,
+font_layout(
     font_t* font,
     std::string_view text,
     v2f& cursor,
-    f32 depth,
-    v2f screen_size,
-    utl::pool_t<gui::vertex_t>* vertices,
-    utl::pool_t<u32>* indices,
-    color32 text_color = color::rgba::cream
+    Emit&& emit
 ) {
-    assert(screen_size.x && screen_size.y);
     f32 start_x = cursor.x;
     cursor.y += font_get_glyph(font, cursor.x, cursor.y, ';').screen.size().y + 1;
 
@@ -8073,35 +9048,7 @@ font_render(
         if (c >= 32 && c < 128) { // this matches stb but is broken for me
             const auto glyph = font_get_glyph(font, cursor.x, cursor.y, c, nc);
 
-            const u32 v_start = safe_truncate_u64(vertices->count());
-            gui::vertex_t* v = vertices->allocate(4);            
-            u32* tris = indices->allocate(6);            
-
-            const v2f p0 = v2f{glyph.screen.min.x, glyph.screen.min.y};
-            const v2f p1 = v2f{glyph.screen.min.x, glyph.screen.max.y};
-            const v2f p2 = v2f{glyph.screen.max.x, glyph.screen.min.y};
-            const v2f p3 = v2f{glyph.screen.max.x, glyph.screen.max.y};
-            
-            const v2f c0 = v2f{glyph.texture.min.x, glyph.texture.min.y};
-            const v2f c1 = v2f{glyph.texture.min.x, glyph.texture.max.y};
-            const v2f c2 = v2f{glyph.texture.max.x, glyph.texture.min.y};
-            const v2f c3 = v2f{glyph.texture.max.x, glyph.texture.max.y};
-
-            const u32 font_id = font->id;
-            const u32 texture_bit = (u32)BIT(30);
-
-            v[0] = gui::vertex_t{ .pos = v3f(p0, depth), .tex = c0, .img = font_id|texture_bit, .col = text_color};
-            v[1] = gui::vertex_t{ .pos = v3f(p1, depth), .tex = c1, .img = font_id|texture_bit, .col = text_color};
-            v[2] = gui::vertex_t{ .pos = v3f(p2, depth), .tex = c2, .img = font_id|texture_bit, .col = text_color};
-            v[3] = gui::vertex_t{ .pos = v3f(p3, depth), .tex = c3, .img = font_id|texture_bit, .col = text_color};
-
-            tris[0] = v_start + 0;
-            tris[1] = v_start + 2;
-            tris[2] = v_start + 1;
-
-            tris[3] = v_start + 1;
-            tris[4] = v_start + 2;
-            tris[5] = v_start + 3;
+            emit(glyph);
 
             cursor.x += (f32)(glyph.kern + glyph.advance) * font->draw_scale;
         } else if (c == '\n') {
@@ -8117,6 +9064,133 @@ font_render(
     cursor.x = start_x; 
 }
 
+inline void
+font_push_quad(
+    font_t* font,
+    const math::rect2d_t& screen,
+    const math::rect2d_t& texture,
+    f32 depth,
+    utl::pool_t<gui::vertex_t>* vertices,
+    utl::pool_t<u32>* indices,
+    color32 text_color
+) {
+    const u32 v_start = safe_truncate_u64(vertices->count());
+    gui::vertex_t* v = vertices->allocate(4);            
+    u32* tris = indices->allocate(6);            
+
+    const v2f p0 = v2f{screen.min.x, screen.min.y};
+    const v2f p1 = v2f{screen.min.x, screen.max.y};
+    const v2f p2 = v2f{screen.max.x, screen.min.y};
+    const v2f p3 = v2f{screen.max.x, screen.max.y};
+    
+    const v2f c0 = v2f{texture.min.x, texture.min.y};
+    const v2f c1 = v2f{texture.min.x, texture.max.y};
+    const v2f c2 = v2f{texture.max.x, texture.min.y};
+    const v2f c3 = v2f{texture.max.x, texture.max.y};
+
+    const u32 font_id = font->id;
+    const u32 texture_bit = (u32)BIT(30);
+
+    v[0] = gui::vertex_t{ .pos = v3f(p0, depth), .tex = c0, .img = font_id|texture_bit, .col = text_color};
+    v[1] = gui::vertex_t{ .pos = v3f(p1, depth), .tex = c1, .img = font_id|texture_bit, .col = text_color};
+    v[2] = gui::vertex_t{ .pos = v3f(p2, depth), .tex = c2, .img = font_id|texture_bit, .col = text_color};
+    v[3] = gui::vertex_t{ .pos = v3f(p3, depth), .tex = c3, .img = font_id|texture_bit, .col = text_color};
+
+    tris[0] = v_start + 0;
+    tris[1] = v_start + 2;
+    tris[2] = v_start + 1;
+
+    tris[3] = v_start + 1;
+    tris[4] = v_start + 2;
+    tris[5] = v_start + 3;
+}
+
+inline void
+font_render(
+    arena_t* arena,
+    font_t* font,
+    std::string_view text,
+    v2f& cursor,
+    f32 depth,
+    v2f screen_size,
+    utl::pool_t<gui::vertex_t>* vertices,
+    utl::pool_t<u32>* indices,
+    color32 text_color = color::rgba::cream
+) {
+    assert(screen_size.x && screen_size.y);
+    font_layout(font, text, cursor, [&](const font_t::glyph_t& glyph) {
+        font_push_quad(font, glyph.screen, glyph.texture, depth, vertices, indices, text_color);
+    });
+}
+
+inline text_run_t*
+text_cache_layout(
+    text_cache_t* cache,
+    u64 key,
+    font_t* font,
+    std::string_view text,
+    v2f fraction
+) {
+    // only visible glyphs make quads, so this is an upper bound
+    const u64 bytes = sizeof(text_run_t) + sizeof(text_run_t::quad_t) * text.size();
+    auto* run = text_cache_push_run(cache, key, bytes);
+    if (!run) {
+        return nullptr;
+    }
+
+    run->quads = (text_run_t::quad_t*)(run + 1);
+    run->quad_count = 0;
+    run->size = font_get_size(font, text);
+
+    v2f cursor = fraction;
+    font_layout(font, text, cursor, [&](const font_t::glyph_t& glyph) {
+        run->quads[run->quad_count++] = text_run_t::quad_t{glyph.screen, glyph.texture};
+    });
+    run->cursor_y = cursor.y - fraction.y;
+    return run;
+}
+
+inline v2f
+font_render_cached(
+    text_cache_t* cache,
+    font_t* font,
+    std::string_view text,
+    v2f& cursor,
+    f32 depth,
+    v2f screen_size,
+    utl::pool_t<gui::vertex_t>* vertices,
+    utl::pool_t<u32>* indices,
+    color32 text_color
+) {
+    assert(screen_size.x && screen_size.y);
+
+    // runs are laid out at the fractional part of the cursor so stbs rounding stays the same,
+    // the whole pixel part is added back when the quads are pushed
+    const v2f origin = glm::floor(cursor);
+    const v2f fraction = cursor - origin;
+    const u64 key = text_cache_key(font->id, text, fraction);
+
+    auto* run = text_cache_find(cache, key);
+    if (!run) {
+        run = text_cache_layout(cache, key, font, text, fraction);
+        cache->misses++;
+    } else {
+        cache->hits++;
+    }
+
+    if (!run) { // out of cache memory this frame
+        font_render(0, font, text, cursor, depth, screen_size, vertices, indices, text_color);
+        return font_get_size(font, text);
+    }
+
+    range_u32(i, 0, run->quad_count) {
+        const auto& quad = run->quads[i];
+        font_push_quad(font, math::rect2d_t{quad.screen.min + origin, quad.screen.max + origin}, quad.texture, depth, vertices, indices, text_color);
+    }
+    cursor.y += run->cursor_y;
+    return run->size;
+}
+
 
 }; // namespace gfx
 
@@ -8130,7 +9204,11 @@ std::string unsafe_evaluate_command(std::string_view command) {
    std::string result = "";
 
    // Open pipe to file
+#if _WIN32
    FILE* pipe = _popen(command.data(), "r");
+#else
+   FILE* pipe = popen(command.data(), "r");
+#endif
    if (!pipe) {
       return "popen failed!";
    }
@@ -8143,7 +9221,11 @@ std::string unsafe_evaluate_command(std::string_view command) {
          result += buffer;
    }
 
+#if _WIN32
    _pclose(pipe);
+#else
+   pclose(pipe);
+#endif
    return result;
 }
 
@@ -8237,7 +9319,6 @@ f32 fbm(v2f uv) {
 // todo(zack): add way to make different sized ones
 static constexpr u64 hash_size = 0x0fff;
 using str_hash_t = u64[hash_size];
-static constexpr u64 invalid_hash = ~0ui64;
 
 
 inline void
@@ -8470,7 +9551,7 @@ struct free_list_t {
             T* node {nullptr};  
             node_pop(node, first_free);
             
-            new (node) T();          
+            construct_default<T>(node);          
 
             deque.push_back(node);
             
@@ -8478,7 +9559,7 @@ struct free_list_t {
             return node;
         } else {
             T* node = (T*)push_bytes(arena, sizeof(T));
-            new (node) T();
+            construct_default<T>(node);
             
             deque.push_back(node);
 
@@ -8571,10 +9652,10 @@ struct mod_loader_t {
     auto call(hash_trie_t<std::string_view, FunctionType>** cache, std::string_view name, Args ... args) {
         auto* func = hash_get(cache, name, arena);
         if (*func == 0) {
-            *func = load_function(name);
+            *func = load_function<FunctionType>(name);
             assert(*func);
         } 
-        return func(std::forward<Args>(args)...);
+        return (*func)(std::forward<Args>(args)...);
     }
 };
 
@@ -8625,11 +9706,11 @@ struct offset_pointer_t {
         offset = (std::byte*)(ptr) - (std::byte*)(&offset);
         return *this;
     }
-    offset_pointer_t<T>(const T* ptr)
+    offset_pointer_t(const T* ptr)
         : offset{(std::byte*)(ptr) - (std::byte*)(&offset)}
     {
     }
-    offset_pointer_t<T>(T* ptr)
+    offset_pointer_t(T* ptr)
         : offset{(std::byte*)(ptr) - (std::byte*)(&offset)}
     {
     }
@@ -8764,7 +9845,7 @@ struct memory_blob_t {
 
     // template <typename T>
     // void serialize(arena_t* arena, const std::optional<T>& opt) {
-    //     serialize(arena, u8{opt?1ui8:0ui8});
+    //     serialize(arena, u8{opt?u8(1):u8(0)});
     //     if (opt) {
     //         serialize(arena, *opt);
     //     }
@@ -8788,30 +9869,8 @@ struct memory_blob_t {
         serialize_offset += str.count;
     }
 
-    template <>
-    void serialize(arena_t* arena, const string_buffer& str) {
-        serialize(arena, str.count);
-
-        allocate(arena, str.count);
-        utl::copy(&data[serialize_offset], (std::byte*)str.data, str.count);
-
-        serialize_offset += str.count;
-    }
-
-    template <>
-    void serialize(arena_t* arena, const std::string_view& obj) {
-        serialize(arena, obj.size());
-
-        allocate(arena, obj.size());
-        utl::copy(&data[serialize_offset], (std::byte*)obj.data(), obj.size());
 
-        serialize_offset += obj.size();
-    }
 
-    template <>
-    void serialize(arena_t* arena, const string_t& str) {
-        serialize(arena, str.sv());
-    }
 
     template <typename T>
     void serialize(
@@ -8895,13 +9954,6 @@ struct memory_blob_t {
         return t;
     }   
     
-    template<>
-    std::string deserialize() {
-        const size_t length = deserialize<u64>();
-        std::string value((char*)&data[read_offset], length);
-        advance(length);
-        return value;
-    }
 
     // template<typename T>
     // buffer<T> deserialize() {
@@ -8928,38 +9980,8 @@ struct memory_blob_t {
     //     return result;
     // }
 
-    template<>
-    string_buffer deserialize() {
-        const size_t length = deserialize<u64>();
-        string_buffer result = {};
-        if (length > 0) {
-            result.data = (char*)&data[read_offset];
-            result.count = length;
-        }
-        advance(length);
-        return result;
-    }
 
-    template<>
-    string_buffer deserialize(arena_t* arena) {
-        const size_t length = deserialize<u64>();
-        string_buffer result = {};
-        if (length > 0) {
-            tag_array(result.data, char, arena, length);
-            result.count = length;
-            utl::copy(result.data, (char*)&data[read_offset], length);
-        }
-        advance(length);
-        return result;
-    }
 
-    template<>
-    string_t deserialize() {
-        const size_t length = deserialize<u64>();
-        string_t value(std::string_view{(char*)&data[read_offset], length});
-        advance(length);
-        return value;
-    }
 
     template<typename T>
     std::optional<T> try_deserialize() {
@@ -8984,13 +10006,86 @@ struct memory_blob_t {
     }
 };
 
+template <>
+inline void
+memory_blob_t::serialize(arena_t* arena, const string_buffer& str) {
+    serialize(arena, str.count);
+
+    allocate(arena, str.count);
+    utl::copy(&data[serialize_offset], (std::byte*)str.data, str.count);
+
+    serialize_offset += str.count;
+}
+
+template <>
+inline void
+memory_blob_t::serialize(arena_t* arena, const std::string_view& obj) {
+    serialize(arena, obj.size());
+
+    allocate(arena, obj.size());
+    utl::copy(&data[serialize_offset], (std::byte*)obj.data(), obj.size());
+
+    serialize_offset += obj.size();
+}
+
+template <>
+inline void
+memory_blob_t::serialize(arena_t* arena, const string_t& str) {
+    serialize(arena, str.sv());
+}
+
+template <>
+inline std::string
+memory_blob_t::deserialize<std::string>() {
+    const size_t length = deserialize<u64>();
+    std::string value((char*)&data[read_offset], length);
+    advance(length);
+    return value;
+}
+
+template <>
+inline string_buffer
+memory_blob_t::deserialize<string_buffer>() {
+    const size_t length = deserialize<u64>();
+    string_buffer result = {};
+    if (length > 0) {
+        result.data = (char*)&data[read_offset];
+        result.count = length;
+    }
+    advance(length);
+    return result;
+}
+
+template <>
+inline string_buffer
+memory_blob_t::deserialize<string_buffer>(arena_t* arena) {
+    const size_t length = deserialize<u64>();
+    string_buffer result = {};
+    if (length > 0) {
+        tag_array(result.data, char, arena, length);
+        result.count = length;
+        utl::copy(result.data, (char*)&data[read_offset], length);
+    }
+    advance(length);
+    return result;
+}
+
+template <>
+inline string_t
+memory_blob_t::deserialize<string_t>() {
+    const size_t length = deserialize<u64>();
+    string_t value(std::string_view{(char*)&data[read_offset], length});
+    advance(length);
+    return value;
+}
+
 #define ZYY_SERIALIZE_TYPE_1(type, a) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
     arena_t* arena, \
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a);}
+    serialize(arena, save_data.a);}
 
 #define ZYY_SERIALIZE_TYPE_2(type, a, b) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -8998,8 +10093,8 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b);}
 
 #define ZYY_SERIALIZE_TYPE_3(type, a, b, c) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9007,9 +10102,9 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c);}
 
 #define ZYY_SERIALIZE_TYPE_4(type, a, b, c, d) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9017,10 +10112,10 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d);}
 
 #define ZYY_SERIALIZE_TYPE_5(type, a, b, c, d, e) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9028,11 +10123,11 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e);}
 
 #define ZYY_SERIALIZE_TYPE_6(type, a, b, c, d, e, f) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9040,12 +10135,12 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f);}
 
 #define ZYY_SERIALIZE_TYPE_7(type, a, b, c, d, e, f, g) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9053,13 +10148,13 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g);}
 
 #define ZYY_SERIALIZE_TYPE_8(type, a, b, c, d, e, f, g, h) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9067,14 +10162,14 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h);}
 
 #define ZYY_SERIALIZE_TYPE_9(type, a, b, c, d, e, f, g, h, i) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9082,15 +10177,15 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i);}
 
 #define ZYY_SERIALIZE_TYPE_10(type, a, b, c, d, e, f, g, h, i, j) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9098,16 +10193,16 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j);}
 
 #define ZYY_SERIALIZE_TYPE_11(type, a, b, c, d, e, f, g, h, i, j, k) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9115,17 +10210,17 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k);}
 
 #define ZYY_SERIALIZE_TYPE_12(type, a, b, c, d, e, f, g, h, i, j, k, l) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9133,18 +10228,18 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k); \
-    serialize(arena, save_data.##l);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k); \
+    serialize(arena, save_data.l);}
 
 #define ZYY_SERIALIZE_TYPE_13(type, a, b, c, d, e, f, g, h, i, j, k, l, m) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9152,19 +10247,19 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k); \
-    serialize(arena, save_data.##l); \
-    serialize(arena, save_data.##m);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k); \
+    serialize(arena, save_data.l); \
+    serialize(arena, save_data.m);}
 
 #define ZYY_SERIALIZE_TYPE_14(type, a, b, c, d, e, f, g, h, i, j, k, l, m, n) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9172,20 +10267,20 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k); \
-    serialize(arena, save_data.##l); \
-    serialize(arena, save_data.##m); \
-    serialize(arena, save_data.##n);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k); \
+    serialize(arena, save_data.l); \
+    serialize(arena, save_data.m); \
+    serialize(arena, save_data.n);}
 
 #define ZYY_SERIALIZE_TYPE_15(type, a, b, c, d, e, f, g, h, i, j, k, l, m, n, o) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9193,21 +10288,21 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k); \
-    serialize(arena, save_data.##l); \
-    serialize(arena, save_data.##m); \
-    serialize(arena, save_data.##n); \
-    serialize(arena, save_data.##o);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k); \
+    serialize(arena, save_data.l); \
+    serialize(arena, save_data.m); \
+    serialize(arena, save_data.n); \
+    serialize(arena, save_data.o);}
 
 #define ZYY_SERIALIZE_TYPE_16(type, a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9215,22 +10310,22 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k); \
-    serialize(arena, save_data.##l); \
-    serialize(arena, save_data.##m); \
-    serialize(arena, save_data.##n); \
-    serialize(arena, save_data.##o); \
-    serialize(arena, save_data.##p);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k); \
+    serialize(arena, save_data.l); \
+    serialize(arena, save_data.m); \
+    serialize(arena, save_data.n); \
+    serialize(arena, save_data.o); \
+    serialize(arena, save_data.p);}
 
 #define ZYY_SERIALIZE_TYPE_17(type, a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, q) \
     template<> void ::utl::memory_blob_t::serialize<type>( \
@@ -9238,23 +10333,23 @@ struct memory_blob_t {
     const type& save_data \
 ) { \
     serialize(arena, type{}.VERSION); \
-    serialize(arena, save_data.##a); \
-    serialize(arena, save_data.##b); \
-    serialize(arena, save_data.##c); \
-    serialize(arena, save_data.##d); \
-    serialize(arena, save_data.##e); \
-    serialize(arena, save_data.##f); \
-    serialize(arena, save_data.##g); \
-    serialize(arena, save_data.##h); \
-    serialize(arena, save_data.##i); \
-    serialize(arena, save_data.##j); \
-    serialize(arena, save_data.##k); \
-    serialize(arena, save_data.##l); \
-    serialize(arena, save_data.##m); \
-    serialize(arena, save_data.##n); \
-    serialize(arena, save_data.##o); \
-    serialize(arena, save_data.##p); \
-    serialize(arena, save_data.##q);}
+    serialize(arena, save_data.a); \
+    serialize(arena, save_data.b); \
+    serialize(arena, save_data.c); \
+    serialize(arena, save_data.d); \
+    serialize(arena, save_data.e); \
+    serialize(arena, save_data.f); \
+    serialize(arena, save_data.g); \
+    serialize(arena, save_data.h); \
+    serialize(arena, save_data.i); \
+    serialize(arena, save_data.j); \
+    serialize(arena, save_data.k); \
+    serialize(arena, save_data.l); \
+    serialize(arena, save_data.m); \
+    serialize(arena, save_data.n); \
+    serialize(arena, save_data.o); \
+    serialize(arena, save_data.p); \
+    serialize(arena, save_data.q);}
 
 namespace res {
 
@@ -9267,6 +10362,7 @@ constexpr auto make_magic(const char key[8]) {
 }
     constexpr u64 meta = 0xfeedbeeff04edead;
     constexpr u64 vers = 0x2;
+    constexpr u64 pack_vers_3 = 0x3; // mappable pack, resources use vers still
     constexpr u64 mesh = 0x1212121212121212;
     constexpr u64 text = 0x1212121212121213;
     constexpr u64 skel = 0x1212691212121241;
@@ -9286,8 +10382,85 @@ struct resource_table_entry_t {
     u64 size{0};
 };
 
+// sorted by id, names are still compared on a hit in case of a collision
+struct resource_index_t {
+    sid_t id{0};
+    u64 file{0};
+};
+
+// copy on write view of a whole file, loaders patch some resources in place
+// but nothing is ever written back. unmapped by unmap_file
+struct mapped_file_t {
+    std::byte*  data{0};
+    u64         size{0};
+    void*       file{0};
+    void*       mapping{0};
+};
+
+inline b32
+map_file(mapped_file_t* mapped, std::string_view path) {
+    const std::string file_name{path};
+    *mapped = {};
+#if _WIN32
+    HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return 0;
+    }
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+    if (!mapping) {
+        CloseHandle(file);
+        return 0;
+    }
+    mapped->data = (std::byte*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!mapped->data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return 0;
+    }
+    mapped->size = size.QuadPart;
+    mapped->file = file;
+    mapped->mapping = mapping;
+#else
+    const int file = open(file_name.c_str(), O_RDONLY);
+    if (file < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return 0;
+    }
+    void* data = mmap(0, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        return 0;
+    }
+    mapped->data = (std::byte*)data;
+    mapped->size = info.st_size;
+#endif
+    return 1;
+}
+
+inline void
+unmap_file(mapped_file_t* mapped) {
+    if (!mapped->data) return;
+#if _WIN32
+    UnmapViewOfFile(mapped->data);
+    CloseHandle(mapped->mapping);
+    CloseHandle(mapped->file);
+#else
+    munmap(mapped->data, mapped->size);
+#endif
+    *mapped = {};
+}
+
 struct pack_file_t {
-    constexpr inline static u64 invalid = ~0ui64;
+    constexpr inline static u64 invalid = ~0ull;
 
     u64 meta{0};
     u64 vers{0};
@@ -9300,29 +10473,135 @@ struct pack_file_t {
     resource_table_entry_t* table{0};
 
     resource_t* resources{0};
+    resource_index_t* index{0};
+
+    mapped_file_t mapping{}; // v3 and lazy packs, resources point into this
+};
+
+// Note(Zack): v3 pack layout, everything is little endian u64s so the file can be mapped and used in place
+// [header][entry * file_count][names, null terminated][resources, each at a pack_v3_alignment offset]
+// all offsets are from the start of the file
+struct pack_v3_header_t {
+    u64 meta{magic::meta};
+    u64 vers{magic::pack_vers_3};
+    u64 file_count{0};
+    u64 resource_size{0};
+    u64 table_start{magic::table_start};
+    u64 table_offset{0};
+    u64 names_offset{0};
+    u64 data_offset{0};
+};
+
+// entries are written sorted by name_id so the table doubles as the lookup index
+struct pack_v3_entry_t {
+    u64 name_offset{0};
+    u64 name_size{0};
+    u64 file_type{0};
+    u64 size{0};
+    u64 offset{0};
+    sid_t name_id{0};
+    u64 _pad[2]{};
 };
 
+constexpr u64 pack_v3_alignment = 64;
+static_assert(sizeof(pack_v3_header_t) == 64);
+static_assert(sizeof(pack_v3_entry_t) == 64);
+
+// overflow safe, [offset, offset+size) fits in limit bytes
+inline b32
+pack_v3_range_ok(u64 offset, u64 size, u64 limit) {
+    return offset <= limit && size <= limit - offset;
+}
+
+// the mapping is untrusted, everything read through an entry is checked before the table is built
+inline b32
+pack_v3_validate(const mapped_file_t& mapped) {
+    if (mapped.size < sizeof(pack_v3_header_t)) {
+        return 0;
+    }
+    const auto* header = (const pack_v3_header_t*)mapped.data;
+    if (header->table_start != magic::table_start ||
+        header->file_count > mapped.size / sizeof(pack_v3_entry_t) ||
+        !pack_v3_range_ok(header->table_offset, header->file_count * sizeof(pack_v3_entry_t), mapped.size)
+    ) {
+        return 0;
+    }
+    const auto* entries = (const pack_v3_entry_t*)(mapped.data + header->table_offset);
+    range_u64(i, 0, header->file_count) {
+        const auto& entry = entries[i];
+        if (!pack_v3_range_ok(entry.name_offset, entry.name_size, mapped.size) ||
+            !pack_v3_range_ok(entry.offset, entry.size, mapped.size) ||
+            entry.offset % pack_v3_alignment != 0 ||
+            (i > 0 && entries[i-1].name_id > entry.name_id)
+        ) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+inline pack_file_t*
+load_pack_file_v3(
+    arena_t* arena,
+    mapped_file_t mapped
+) {
+    if (!pack_v3_validate(mapped)) {
+        ztd_error("res", "Corrupt v3 pack file");
+        unmap_file(&mapped);
+        return 0;
+    }
+    const auto* header = (const pack_v3_header_t*)mapped.data;
+    const auto* entries = (const pack_v3_entry_t*)(mapped.data + header->table_offset);
+
+    tag_struct(pack_file_t* packed_file, pack_file_t, arena);
+    packed_file->meta = header->meta;
+    packed_file->vers = header->vers;
+    packed_file->file_count = header->file_count;
+    packed_file->resource_size = header->resource_size;
+    packed_file->table_start = header->table_start;
+    packed_file->mapping = mapped;
+
+    tag_array(packed_file->table, resource_table_entry_t, arena, packed_file->file_count);
+    tag_array(packed_file->resources, resource_t, arena, packed_file->file_count);
+    tag_array(packed_file->index, resource_index_t, arena, packed_file->file_count);
+    for (size_t i = 0; i < packed_file->file_count; i++) {
+        const auto& entry = entries[i];
+        packed_file->index[i] = resource_index_t{entry.name_id, i};
+        packed_file->table[i].name.view(std::string_view{(const char*)mapped.data + entry.name_offset, entry.name_size});
+        packed_file->table[i].file_type = entry.file_type;
+        packed_file->table[i].size = entry.size;
+        packed_file->resources[i].size = entry.size;
+        packed_file->resources[i].data = mapped.data + entry.offset;
+    }
+
+    return packed_file;
+}
+
+// lazy keeps v2 packs mapped instead of copying them, pages are only read when a resource is used.
+// v3 packs are always used in place
 inline pack_file_t* 
 load_pack_file(
     arena_t* arena,
-    std::string_view path
+    std::string_view path,
+    b32 lazy = 0
 ) {
-    std::ifstream file{path.data(), std::ios::binary};
-
-    if(!file.is_open()) {
+    mapped_file_t mapped;
+    if (!map_file(&mapped, path)) {
         ztd_error("res", "Failed to open file");
         return 0;
     }
 
-    file.seekg(0, std::ios::end);
-    const size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
+    if (mapped.size >= sizeof(u64)*2 && ((u64*)mapped.data)[1] == magic::pack_vers_3) {
+        return load_pack_file_v3(arena, mapped);
+    }
 
-    std::byte* data = new std::byte[size];
-    defer {
-        delete [] data;
-    };
-    file.read((char*)data, size);
+    // v2 packs are a stream, either use the mapping or copy it into the arena once and point the resources at it
+    std::byte* data = mapped.data;
+    if (!lazy) {
+        data = (std::byte*)push_bytes(arena, mapped.size);
+        utl::copy(data, mapped.data, mapped.size);
+        unmap_file(&mapped);
+    }
     memory_blob_t loader{data};
     
     // eat meta info
@@ -9333,6 +10612,8 @@ load_pack_file(
     assert(vers == magic::vers);
 
     tag_struct(pack_file_t* packed_file, pack_file_t, arena);
+    packed_file->meta = meta;
+    packed_file->vers = vers;
 
     packed_file->file_count = loader.deserialize<u64>();
     packed_file->resource_size = loader.deserialize<u64>();
@@ -9352,21 +10633,103 @@ load_pack_file(
         entry->size = loader.deserialize<u64>();
     }
     
-    using resource_data_t = std::byte;
     tag_array(packed_file->resources, resource_t, arena, packed_file->file_count);
     loader.deserialize<u64>();
     for (size_t i = 0; i < packed_file->file_count; i++) {
         size_t resource_size = packed_file->resources[i].size = loader.deserialize<u64>();
-        tag_array(packed_file->resources[i].data, resource_data_t, arena, packed_file->resources[i].size);
-        utl::copy(packed_file->resources[i].data, loader.read_data(), resource_size);
+        packed_file->resources[i].data = loader.read_data();
         loader.advance(resource_size);
     }
+    packed_file->mapping = mapped;
+
+    // v2 packs dont store an index
+    tag_array(packed_file->index, resource_index_t, arena, packed_file->file_count);
+    for (size_t i = 0; i < packed_file->file_count; i++) {
+        packed_file->index[i] = resource_index_t{sid(packed_file->table[i].name.sv()), i};
+    }
+    std::sort(packed_file->index, packed_file->index + packed_file->file_count, [](const auto& a, const auto& b) {
+        return a.id < b.id;
+    });
 
     // ztd_info("res", "Loaded Resource File: {}", path);
 
     return packed_file;
 }
 
+inline void
+unload_pack_file(pack_file_t* packed_file) {
+    unmap_file(&packed_file->mapping);
+    packed_file->file_count = 0;
+}
+
+// writes any loaded pack as v3, used to convert old v2 packs
+inline b32
+save_pack_file_v3(
+    const pack_file_t* packed_file,
+    std::string_view path
+) {
+    std::ofstream file{std::string{path}, std::ios::binary};
+    if (!file.is_open()) {
+        ztd_error("res", "Failed to open file: {}", path);
+        return 0;
+    }
+
+    pack_v3_header_t header{};
+    header.file_count = packed_file->file_count;
+    header.resource_size = packed_file->resource_size;
+    header.table_offset = sizeof(pack_v3_header_t);
+    header.names_offset = header.table_offset + sizeof(pack_v3_entry_t) * packed_file->file_count;
+
+    u64 names_size = 0;
+    for (size_t i = 0; i < packed_file->file_count; i++) {
+        names_size += packed_file->table[i].name.size + 1;
+    }
+    header.data_offset = align_2n(header.names_offset + names_size, pack_v3_alignment);
+
+    file.write((const char*)&header, sizeof(header));
+
+    // written in index order, every loaded pack has a sorted index
+    auto file_at = [&](size_t i) {
+        return packed_file->index[i].file;
+    };
+
+    u64 name_offset = header.names_offset;
+    u64 data_offset = header.data_offset;
+    for (size_t j = 0; j < packed_file->file_count; j++) {
+        const size_t i = file_at(j);
+        pack_v3_entry_t entry{};
+        entry.name_offset = name_offset;
+        entry.name_size = packed_file->table[i].name.size;
+        entry.file_type = packed_file->table[i].file_type;
+        entry.size = packed_file->resources[i].size;
+        entry.offset = data_offset;
+        entry.name_id = packed_file->index[j].id;
+        file.write((const char*)&entry, sizeof(entry));
+
+        name_offset += entry.name_size + 1;
+        data_offset = align_2n(data_offset + entry.size, pack_v3_alignment);
+    }
+    for (size_t j = 0; j < packed_file->file_count; j++) {
+        const size_t i = file_at(j);
+        file.write(packed_file->table[i].name.c_str(), packed_file->table[i].name.size);
+        file.put(0);
+    }
+
+    const char zeros[pack_v3_alignment]{};
+    auto pad = [&] {
+        const u64 at = (u64)file.tellp();
+        file.write(zeros, align_2n(at, pack_v3_alignment) - at);
+    };
+    for (size_t j = 0; j < packed_file->file_count; j++) {
+        const size_t i = file_at(j);
+        pad();
+        file.write((const char*)packed_file->resources[i].data, packed_file->resources[i].size);
+    }
+    pad();
+
+    return file.good();
+}
+
 void pack_file_print(
     pack_file_t* packed_file
 ) {
@@ -9380,9 +10743,14 @@ size_t pack_file_find_file(
     pack_file_t* pack_file,
     std::string_view file_name
 ) {
-    for (size_t i = 0; i < pack_file->file_count; i++) {
-        if (pack_file->table[i].name.c_str() == file_name) {
-            return i;
+    const sid_t id = sid(file_name);
+    auto* end = pack_file->index + pack_file->file_count;
+    auto* it = std::lower_bound(pack_file->index, end, id, [](const resource_index_t& entry, sid_t id) {
+        return entry.id < id;
+    });
+    for (; it != end && it->id == id; it++) {
+        if (pack_file->table[it->file].name.sv() == file_name) {
+            return it->file;
         }
     }
     ztd_warn("pack_file", "Failed to find file: {}", file_name);
@@ -9393,13 +10761,11 @@ u64 pack_file_get_file_size(
     pack_file_t* pack_file,
     std::string_view file_name
 ) {
-    for (size_t i = 0; i < pack_file->file_count; i++) {
-        if (pack_file->table[i].name.c_str() == file_name) {
-            return pack_file->table[i].size;
-        }
+    const auto file_id = pack_file_find_file(pack_file, file_name);
+    if (pack_file_t::invalid == file_id) {
+        return 0;
     }
-    ztd_warn("pack_file", "Failed to find file: {}", file_name);
-    return 0;
+    return pack_file->table[file_id].size;
 }
 
 std::byte* pack_file_get_file(
@@ -9610,6 +10976,73 @@ void write_binary_file(std::string_view filename, std::span<u8> bytes) {
 
 }; // namespace utl
 
+#if ZTD_INTERNAL
+
+// Note(Zack): writes the collated events as a chrome trace (chrome://tracing or ui.perfetto.dev),
+// every table is its own process so the game and physics modules dont interleave
+inline void
+export_debug_trace(std::span<debug_table_t* const> tables, std::span<const std::string_view> names, std::string_view filename) {
+    TIMED_FUNCTION;
+    fmt::memory_buffer out;
+    auto writer = std::back_inserter(out);
+
+    // names and paths only ever need their backslashes and quotes swapped out
+    auto json_string = [&](const char* text) {
+        out.push_back('"');
+        for (const char* c = text ? text : "<Unknown>"; *c; c++) {
+            out.push_back(*c == '\\' ? '/' : *c == '"' ? '\'' : *c);
+        }
+        out.push_back('"');
+    };
+
+    u64 base = std::numeric_limits<u64>::max();
+    for (const auto* table : tables) {
+        if (table && table->calibration_cycles) {
+            base = std::min(base, table->calibration_cycles);
+        }
+    }
+
+    fmt::format_to(writer, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    b32 first = 1;
+    range_u64(pid, 0, tables.size()) {
+        const auto* table = tables[pid];
+        if (!table || table->cycles_per_microsecond == 0.0) {
+            continue;
+        }
+
+        fmt::format_to(writer, "{}{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"{}\"}}}}", 
+            first ? "" : ",\n", pid, pid < names.size() ? names[pid] : "module");
+        first = 0;
+
+        const u64 count = std::min(table->event_index, (u64)MAX_DEBUG_EVENT_COUNT);
+        range_u64(i, table->event_index - count, table->event_index) {
+            const auto& event = table->events[i % MAX_DEBUG_EVENT_COUNT];
+            // events recorded before the first collation land slightly before zero
+            const f64 ts = f64(i64(event.clock_count - base)) / table->cycles_per_microsecond;
+
+            if (event.type == DebugEventType_BeginFrame) {
+                fmt::format_to(writer, ",\n{{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"p\",\"pid\":{},\"tid\":{},\"ts\":{:.3f}}}",
+                    pid, event.thread_id, ts);
+                continue;
+            }
+
+            const auto& record = table->records[event.record_index];
+            fmt::format_to(writer, ",\n{{\"name\":");
+            json_string(record.func_name);
+            fmt::format_to(writer, ",\"ph\":\"{}\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"args\":{{\"file\":",
+                event.type == DebugEventType_BeginBlock ? 'B' : 'E', pid, event.thread_id, ts);
+            json_string(record.file_name);
+            fmt::format_to(writer, ",\"line\":{},\"core\":{}}}}}", record.line_num, event.core_index);
+        }
+    }
+    fmt::format_to(writer, "\n]}}\n");
+
+    std::ofstream file{std::string{filename}, std::ios::binary};
+    file.write(out.data(), out.size());
+}
+
+#endif
+
 
 namespace tween {
 
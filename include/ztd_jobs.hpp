@@ -0,0 +1,302 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+// Note(Zack): Work stealing job system. The platform layer owns the worker threads so they
+// survive game dll reloads, the game only ever submits jobs and waits for them inside a frame.
+// Every thread has a chase lev deque, the owner pushes and pops the bottom and idle threads
+// steal from the top. Thread 0 is whoever created the system (the main thread).
+// Job memory comes from the submitters arena, usually the frame arena, so nothing is freed.
+// Background jobs (long running work that may span frames) go into a separate queue that only the
+// main thread pushes to and only idle workers take from, job_wait never runs them so a frame never
+// ends up stalled on one.
+
+namespace utl {
+
+constexpr u32 job_max_threads = 32;
+
+using job_function = void(*)(void* data, u32 thread_index);
+
+// dependency handle, pending is the number of unfinished jobs counted against it
+struct job_counter_t {
+    std::atomic<u32> pending{0};
+
+    b32 is_done() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+struct job_t {
+    job_function            fn{0};
+    void*                   data{0};
+    job_counter_t*          counter{0};
+    const job_counter_t*    after{0};   // wont start until this is done
+};
+
+struct job_queue_t {
+    static constexpr i64 capacity = 4096;
+    static constexpr i64 mask = capacity - 1;
+    static_assert((capacity & mask) == 0);
+
+    alignas(64) std::atomic<i64> top{0};
+    alignas(64) std::atomic<i64> bottom{0};
+    alignas(64) std::atomic<job_t*> jobs[capacity]{};
+
+    // owner only
+    b32 push(job_t* job) {
+        const i64 b = bottom.load(std::memory_order_relaxed);
+        const i64 t = top.load(std::memory_order_acquire);
+        if (b - t >= capacity) {
+            return 0;
+        }
+        jobs[b & mask].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return 1;
+    }
+
+    // owner only
+    job_t* pop() {
+        const i64 b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        job_t* job = jobs[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last job, race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // any thread
+    job_t* steal() {
+        i64 t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const i64 b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        job_t* job = jobs[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return job;
+    }
+};
+
+struct job_system_t {
+    u32             thread_count{1}; // workers + the main thread
+    job_queue_t*    queues{0};
+    job_queue_t*    background{0}; // main thread pushes, workers steal when they run out of frame work
+    std::thread*    threads{0};
+
+    std::atomic<b32> running{1};
+    std::atomic<u32> epoch{0}; // bumped when work is pushed, idle workers wait on it
+};
+
+// set by the job trampolines, every module that runs jobs gets its own copy
+inline thread_local u32 job_thread_index = 0;
+
+inline void
+job_execute(job_system_t* jobs, job_t* job, u32 thread_index);
+
+inline job_t*
+job_find(job_system_t* jobs, u32 thread_index) {
+    if (auto* job = jobs->queues[thread_index].pop()) {
+        return job;
+    }
+    range_u32(i, 1, jobs->thread_count) {
+        const u32 victim = (thread_index + i) % jobs->thread_count;
+        if (auto* job = jobs->queues[victim].steal()) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+inline b32
+job_try_run_one(job_system_t* jobs, u32 thread_index) {
+    if (auto* job = job_find(jobs, thread_index)) {
+        job_execute(jobs, job, thread_index);
+        return 1;
+    }
+    return 0;
+}
+
+// runs other jobs until the counter is done, dont hold locks the jobs need while waiting
+inline void
+job_wait(job_system_t* jobs, const job_counter_t* counter) {
+    if (!counter) return;
+    u32 spins = 0;
+    while (!counter->is_done()) {
+        if (jobs && job_try_run_one(jobs, job_thread_index)) {
+            spins = 0;
+        } else if (++spins < 64) {
+            _mm_pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+inline void
+job_execute(job_system_t* jobs, job_t* job, u32 thread_index) {
+    job_wait(jobs, job->after);
+    job->fn(job->data, thread_index);
+    if (job->counter) {
+        job->counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+inline void
+job_wake_workers(job_system_t* jobs) {
+    jobs->epoch.fetch_add(1, std::memory_order_release);
+    jobs->epoch.notify_all();
+}
+
+// doesnt wake sleeping workers, call job_wake_workers after pushing a batch
+inline void
+job_push(job_system_t* jobs, job_t* job) {
+    if (job->counter) {
+        job->counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!jobs || jobs->thread_count == 1 || !jobs->queues[job_thread_index].push(job)) {
+        // no workers or the queue is full, just run it here
+        job_execute(jobs, job, job_thread_index);
+    }
+}
+
+template <typename Fn>
+struct job_range_t {
+    Fn* fn;
+    u64 begin;
+    u64 end;
+};
+
+template <typename Fn>
+void job_range_trampoline(void* data, u32 thread_index) {
+    job_thread_index = thread_index;
+    auto* range = (job_range_t<Fn>*)data;
+    (*range->fn)(range->begin, range->end);
+}
+
+template <typename Fn>
+void job_trampoline(void* data, u32 thread_index) {
+    job_thread_index = thread_index;
+    (*(Fn*)data)();
+}
+
+// runs fn() on any thread
+template <typename Fn>
+void job_run(job_system_t* jobs, arena_t* arena, Fn&& fn, job_counter_t* counter, const job_counter_t* after = 0) {
+    using fn_t = std::remove_cvref_t<Fn>;
+    auto* job = push_struct<job_t>(arena);
+    job->fn = job_trampoline<fn_t>;
+    job->data = push_struct<fn_t>(arena, 1, std::forward<Fn>(fn));
+    job->counter = counter;
+    job->after = after;
+    job_push(jobs, job);
+    if (jobs) job_wake_workers(jobs);
+}
+
+// main thread, runs fn() on a worker once it is out of frame work. returns 0 and does nothing
+// if there are no workers or the background queue is full, the caller decides what to do instead
+template <typename Fn>
+b32 job_run_background(job_system_t* jobs, arena_t* arena, Fn&& fn, job_counter_t* counter) {
+    using fn_t = std::remove_cvref_t<Fn>;
+    if (!jobs || jobs->thread_count == 1 || job_thread_index != 0) {
+        return 0;
+    }
+    auto* job = push_struct<job_t>(arena);
+    job->fn = job_trampoline<fn_t>;
+    job->data = push_struct<fn_t>(arena, 1, std::forward<Fn>(fn));
+    job->counter = counter;
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!jobs->background->push(job)) {
+        if (counter) {
+            counter->pending.fetch_sub(1, std::memory_order_release);
+        }
+        return 0;
+    }
+    job_wake_workers(jobs);
+    return 1;
+}
+
+// splits [0, count) into ranges of at most grain and calls fn(begin, end) for each on any thread,
+// ranges are handed out in order so chunk results can be merged deterministically by begin / grain
+template <typename Fn>
+void parallel_for(job_system_t* jobs, arena_t* arena, u64 count, u64 grain, Fn&& fn, job_counter_t* counter, const job_counter_t* after = 0) {
+    using fn_t = std::remove_cvref_t<Fn>;
+    if (count == 0) return;
+    grain = std::max<u64>(grain, 1);
+
+    auto* closure = push_struct<fn_t>(arena, 1, std::forward<Fn>(fn));
+    for (u64 begin = 0; begin < count; begin += grain) {
+        auto* range = push_struct<job_range_t<fn_t>>(arena, 1, job_range_t<fn_t>{closure, begin, std::min(begin + grain, count)});
+        auto* job = push_struct<job_t>(arena);
+        job->fn = job_range_trampoline<fn_t>;
+        job->data = range;
+        job->counter = counter;
+        job->after = after;
+        job_push(jobs, job);
+    }
+    if (jobs) job_wake_workers(jobs);
+}
+
+inline void
+job_worker_main(job_system_t* jobs, u32 thread_index) {
+    job_thread_index = thread_index;
+    while (jobs->running.load(std::memory_order_acquire)) {
+        const u32 epoch = jobs->epoch.load(std::memory_order_acquire);
+        if (job_try_run_one(jobs, thread_index)) {
+            continue;
+        }
+        if (auto* job = jobs->background->steal()) {
+            job_execute(jobs, job, thread_index);
+            continue;
+        }
+        jobs->epoch.wait(epoch, std::memory_order_acquire);
+    }
+}
+
+inline job_system_t*
+job_system_create(arena_t* arena, u32 worker_count) {
+    worker_count = std::min(worker_count, job_max_threads - 1);
+    tag_struct(auto* jobs, job_system_t, arena);
+    jobs->thread_count = worker_count + 1;
+    tag_array(jobs->queues, job_queue_t, arena, jobs->thread_count);
+    tag_struct(jobs->background, job_queue_t, arena);
+    tag_array(jobs->threads, std::thread, arena, worker_count);
+    range_u32(i, 0, worker_count) {
+        jobs->threads[i] = std::thread(job_worker_main, jobs, i + 1);
+    }
+    ztd_info(__FUNCTION__, "Started {} job workers", worker_count);
+    return jobs;
+}
+
+inline void
+job_system_destroy(job_system_t* jobs) {
+    if (!jobs) return;
+    jobs->running.store(0, std::memory_order_release);
+    job_wake_workers(jobs);
+    range_u32(i, 0, jobs->thread_count - 1) {
+        jobs->threads[i].join();
+        jobs->threads[i].~thread();
+    }
+    jobs->thread_count = 1;
+}
+
+};
@@ -103,7 +103,7 @@ namespace math {
         return x * x * x;
     }
 
-    constexpr v2f octahedral_mapping(v3f co) {
+    inline v2f octahedral_mapping(v3f co) {
         using namespace swizzle;
         // projection onto octahedron
         co /= glm::dot( v3f(1.0f), glm::abs(co) );
@@ -117,7 +117,7 @@ namespace math {
         return xy(co) * 0.5f + 0.5f;
     }
 
-    constexpr v3f octahedral_unmapping(v2f co) {
+    inline v3f octahedral_unmapping(v2f co) {
         using namespace swizzle;
         co = co * 2.0f - 1.0f;
 
@@ -160,7 +160,7 @@ namespace math {
     }
 
     bool fcmp(f32 a, f32 b, f32 eps = 1e-6) {
-        return std::fabsf(a-b) < eps;
+        return std::fabs(a-b) < eps;
     }
 
     namespace constants {
@@ -329,6 +329,7 @@ namespace math {
             plane_t p;
             p.n = tri.normal();
             p.d = glm::dot(tri.p[0], p.n);
+            return p;
         }
 
         f32 distance(v3f p) const {
@@ -773,7 +774,7 @@ struct transform_t {
     }
 	constexpr transform_t(const m44& mat = m44{1.0f}) : basis(mat), origin(mat[3]) {};
 	constexpr transform_t(const m33& _basis, const v3f& _origin) : basis(_basis), origin(_origin) {};
-	constexpr transform_t(const v3f& position, const v3f& scale = {1,1,1}, const v3f& rotation = {0,0,0})
+	transform_t(const v3f& position, const v3f& scale = {1,1,1}, const v3f& rotation = {0,0,0})
 	    : basis(m33(1.0f)
     ) {
 		origin = (position);
@@ -843,7 +844,7 @@ struct transform_t {
         return *this;
     }
     // in radians
-	constexpr void set_rotation(const v3f& rotation) {
+	void set_rotation(const v3f& rotation) {
         f32 scales[3];
         range_u32(i, 0, 3) {
             scales[i] = glm::length(basis[i]);
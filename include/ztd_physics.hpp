@@ -23,13 +23,21 @@ enum struct collider_shape_type {
     CONVEX, TRIMESH, SPHERE, CAPSULE, BOX, NONE, SIZE
 };
 
+// Note(Zack): mesh is the cooked blob from res.pack, backends that cant read it take the
+// geometry instead when vertices is set (the custom backend builds these from the render mesh)
 struct collider_convex_info_t {
     std::byte*  mesh;
     size_t      size;
+    const v3f*  vertices{0};
+    u32         vertex_count{0};
 };
 struct collider_trimesh_info_t {
     std::byte*  mesh;
     size_t      size;
+    const v3f*  vertices{0};
+    u32         vertex_count{0};
+    const u32*  indices{0};
+    u32         index_count{0};
 };
 
 struct collider_sphere_info_t {
@@ -37,6 +45,12 @@ struct collider_sphere_info_t {
     v3f origin;
 };
 
+struct collider_capsule_info_t {
+    f32 radius;
+    f32 height; // between the sphere centers, along local y
+    v3f origin;
+};
+
 struct collider_box_info_t {
     v3f origin;
     v3f size;
@@ -56,8 +70,9 @@ struct collider_t {
     collider_id         id{uid::invalid_id};
     void*               shape; // api data
 
+    // gcc rejects a default member initializer here since rect3d_t isnt trivial, the constructor picks sphere
     union {
-        math::sphere_t sphere{};
+        math::sphere_t sphere;
         math::rect3d_t   box;
     }; 
 
@@ -65,6 +80,8 @@ struct collider_t {
 
     u32                 is_trigger{0};
 
+    collider_t() : sphere{} {}
+
     void set_trigger(bool x);
     void set_active(bool x);
 
@@ -89,6 +106,7 @@ struct rigidbody_flags {
         ACTIVE = BIT(0),     // todo(Zack): this can be removed
         IS_ON_GROUND = BIT(1), // note(zack): these are only set for character bodies
         IS_ON_WALL = BIT(2),
+        IS_SLEEPING = BIT(3), // set by the backend, dynamic bodies only
     };
 };
 
@@ -101,20 +119,12 @@ struct rigidbody_t {
     u32             layer{0}; // collision layer
     u32             group{0xffffffff}; // what you collide with
     api_t*          api{0};
+    u32             index{0}; // slot in api_t::rigidbodies and api_t::body_state
 
     f32 mass{1.0f};
     f32 linear_dampening{0.5f};
     f32 angular_dampening{0.5f};
 
-    v3f             position{0.0f};
-    quat            orientation{};
-
-    v3f             velocity{0.0f};
-    v3f             angular_velocity{0.0f};
-
-    v3f             force{0.0f};
-    v3f             torque{0.0f};
-
     m33             inertia{0.0f}, inverse_inertia{0.0f};
 
     std::array<collider_t, RIGIDBODY_MAX_COLLIDER_COUNT>      colliders;
@@ -130,9 +140,20 @@ struct rigidbody_t {
     rigidbody_on_collision_function on_collision{0};
     rigidbody_on_collision_function on_collision_end{0};
 
-    explicit rigidbody_t(api_t* api_=0) : api{api_}, layer{1}, group{~0x0ui32} {
+    explicit rigidbody_t(api_t* api_=0, u32 index_=0) : layer{1}, group{~0x0u}, api{api_}, index{index_} {
         if (api) set_group(group);
     }
+
+    // Note(Zack): Hot state lives in api_t::body_state, these are views into it
+    inline v3f& position() const;
+    inline quat& orientation() const;
+    inline v3f& velocity() const;
+    inline v3f& angular_velocity() const;
+    inline v3f& force() const;
+    inline v3f& torque() const;
+
+    // clears the hot state of a freshly created body
+    void reset_state(const v3f& p, const quat& q);
     
     void set_layer(u32 l);
     void set_group(u32 g);
@@ -147,11 +168,11 @@ struct rigidbody_t {
 
     // transform direction from body space to world space
     inline v3f transform_direction(const v3f& direction) const
-    { return orientation * direction; }
+    { return orientation() * direction; }
 
     // transform direction from world space to body space
     inline v3f inverse_transform_direction(const v3f& direction) const
-    { return glm::inverse(orientation) * direction; }
+    { return glm::inverse(orientation()) * direction; }
 
     // get velocity and angular velocity in body space
     // inline v3f get_point_velocity(const v3f& point) const
@@ -183,28 +204,6 @@ struct rigidbody_t {
 
     inline void set_transform(const m44& transform); 
 
-    // Note(Zack): position is integrated by the api not here
-    // Note(Zack): this should probably happen there instead of in game
-    // Todo(Zack): allow custom gravity;
-    void integrate(float dt, float gravity = 0.0f, v3f gravity_direction = axis::down) {
-        v3f acceleration = force / mass;
-
-        const bool is_on_ground = flags & rigidbody_flags::IS_ON_GROUND;
-
-        if (!is_on_ground) { acceleration += gravity_direction * gravity; }
-        velocity += acceleration * dt;
-        // position += velocity * dt;
-
-        angular_velocity += inverse_inertia *
-            (torque - glm::cross(angular_velocity, inertia * angular_velocity)) * dt;
-        // orientation += (orientation * glm::quat(0.0f, angular_velocity)) * (0.5f * dt);
-        // orientation = glm::normalize(orientation);
-
-        force = v3f{0.0f};
-        torque = v3f{0.0f};
-
-    }
-
     void set_gravity(bool x);
     void set_ccd(bool x);
     void set_mass(f32 x);
@@ -244,6 +243,11 @@ struct rigidbody_t {
     bool is_on_surface() const {
         return is_on_ground() || is_on_wall();
     }
+    // sleeping bodies dont move until something touches or pushes them, gameplay can skip them
+    bool is_sleeping() const {
+        return flags & rigidbody_flags::IS_SLEEPING;
+    }
+    void wake();
 };
 
 using joint_on_break_callback = void(*)(rigidbody_t*, rigidbody_t*);
@@ -295,6 +299,49 @@ struct overlap_hitbuffer_t {
     u64             hit_count{0};
 };
 
+// Note(Zack): Batched queries, the backend walks the broadphase once for a whole span
+// instead of once per query, and results go into caller owned memory
+struct raycast_query_t {
+    v3f ro{};
+    v3f rd{};   // length is the max distance
+    u32 layer{0xffffffff};
+};
+
+struct overlap_query_t {
+    collider_shape_type type{collider_shape_type::SPHERE}; // SPHERE or BOX
+    v3f origin{};
+    f32 radius{0.0f};       // SPHERE
+    v3f half_size{0.0f};    // BOX
+    quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    u32 layer{0xffffffff};
+};
+
+struct overlap_batch_hit_t {
+    const void* user_data{0};
+    u32         query{0};   // index into the query span
+};
+
+// one body for create_rigidbody_batch, same arguments as create_rigidbody
+struct rigidbody_create_t {
+    void*           user_data{0};
+    rigidbody_type  type{rigidbody_type::STATIC};
+    v3f             position{};
+    quat            orientation{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// Note(Zack): Per body state that changes every step, split out of rigidbody_t so
+// integration and syncing only stream what they touch. Capacity is a multiple of 8
+// so simd loops can run over whole blocks.
+struct rigidbody_soa_t {
+    alignas(32) std::array<v3f, PHYSICS_MAX_RIGIDBODY_COUNT>  position;
+    alignas(32) std::array<quat, PHYSICS_MAX_RIGIDBODY_COUNT> orientation;
+    alignas(32) std::array<v3f, PHYSICS_MAX_RIGIDBODY_COUNT>  velocity;
+    alignas(32) std::array<v3f, PHYSICS_MAX_RIGIDBODY_COUNT>  angular_velocity;
+    alignas(32) std::array<v3f, PHYSICS_MAX_RIGIDBODY_COUNT>  force;
+    alignas(32) std::array<v3f, PHYSICS_MAX_RIGIDBODY_COUNT>  torque;
+};
+static_assert(PHYSICS_MAX_RIGIDBODY_COUNT % 8 == 0);
+
 struct api_t;
 
 // Note(Zack): Functions for the api to
@@ -302,10 +349,13 @@ using create_scene_function = void(*)(api_t*, const void* filter_fn);
 using destroy_scene_function = void(*)(api_t*);
 
 using create_rigidbody_function = rigidbody_t*(*)(api_t*, void* entity, rigidbody_type, const v3f& position, const quat& rotation);
+using create_rigidbody_batch_function = void(*)(api_t*, std::span<const rigidbody_create_t> bodies, std::span<rigidbody_t*> results);
 using create_collider_function = collider_t*(*)(api_t*, rigidbody_t*, collider_shape_type, void* collider_info);
 using simulate_function = void(*)(api_t*, f32 dt);
 using raycast_world_function = raycast_result_t(*)(const api_t*, v3f ro, v3f rd, u32 layer);
 using sphere_overlap_world_function = overlap_hitbuffer_t*(*)(const api_t*, arena_t* arena, v3f o, f32 radius, u32 layer);
+using raycast_batch_function = void(*)(const api_t*, std::span<const raycast_query_t> queries, std::span<raycast_result_t> results);
+using overlap_batch_function = u64(*)(const api_t*, std::span<const overlap_query_t> queries, std::span<overlap_batch_hit_t> hits);
 
 using collider_set_trigger_function = void(*)(collider_t*, bool);
 using collider_set_transform_function = void(*)(const collider_t*, const math::transform_t& transform);
@@ -325,6 +375,7 @@ using rigidbody_set_ccd_function = void(*)(rigidbody_t*, bool);
 using rigidbody_set_mass_function = void(*)(rigidbody_t*, f32);
 using rigidbody_set_float_function = void(*)(rigidbody_t*, f32);
 using rigidbody_set_collision_flags_function = void(*)(rigidbody_t*);
+using rigidbody_wake_function = void(*)(rigidbody_t*);
 
 
 struct export_dll api_t {
@@ -348,6 +399,13 @@ struct export_dll api_t {
 
     create_rigidbody_function   create_rigidbody{0};
     create_collider_function    create_collider{0};
+
+    // results[i] is the body for bodies[i], the backend reserves every slot up front
+    create_rigidbody_batch_function _create_rigidbody_batch{0};
+    void                            create_rigidbody_batch(std::span<const rigidbody_create_t> bodies, std::span<rigidbody_t*> results) {
+        assert(results.size() >= bodies.size());
+        _create_rigidbody_batch(this, bodies, results);
+    }
     create_scene_function       create_scene{0};
     destroy_scene_function      destroy_scene{0};
 
@@ -360,6 +418,19 @@ struct export_dll api_t {
     overlap_hitbuffer_t*            sphere_overlap_world(arena_t* result_arena, v3f o, f32 radius, u32 layer = 0xffffffff) {
         return _sphere_overlap_world(this, result_arena, o, radius, layer);
     }
+
+    // results[i] is the closest hit for queries[i]
+    raycast_batch_function          _raycast_batch{0};
+    void                            raycast_batch(std::span<const raycast_query_t> queries, std::span<raycast_result_t> results) const {
+        assert(results.size() >= queries.size());
+        _raycast_batch(this, queries, results);
+    }
+
+    // returns the hit count, hits are grouped by query in query order, extra hits are dropped
+    overlap_batch_function          _overlap_batch{0};
+    u64                             overlap_batch(std::span<const overlap_query_t> queries, std::span<overlap_batch_hit_t> hits) const {
+        return _overlap_batch(this, queries, hits);
+    }
     
 
     // rigidbody_set_active_function rigidbody_set_active{0};
@@ -379,9 +450,11 @@ struct export_dll api_t {
     rigidbody_set_float_function rigidbody_set_character_radius{0};
 
     rigidbody_set_collision_flags_function rigidbody_set_collision_flags{0};
+    rigidbody_wake_function rigidbody_wake{0};
 
     // TODO(Zack): Add hashes
-    std::array<rigidbody_t, PHYSICS_MAX_RIGIDBODY_COUNT> rigidbodies;
+    std::array<rigidbody_t, PHYSICS_MAX_RIGIDBODY_COUNT> rigidbodies; // cold, colliders and callbacks
+    rigidbody_soa_t body_state; // hot, same indices as rigidbodies
     size_t      rigidbody_count{0};
 
     std::array<collider_t, PHYSICS_MAX_COLLIDER_COUNT>  colliders;
@@ -431,9 +504,23 @@ math::transform_t collider_t::local_transform() const {
     return rigidbody->api->collider_get_transform(this);
 }
 
+v3f& rigidbody_t::position() const { return api->body_state.position[index]; }
+quat& rigidbody_t::orientation() const { return api->body_state.orientation[index]; }
+v3f& rigidbody_t::velocity() const { return api->body_state.velocity[index]; }
+v3f& rigidbody_t::angular_velocity() const { return api->body_state.angular_velocity[index]; }
+v3f& rigidbody_t::force() const { return api->body_state.force[index]; }
+v3f& rigidbody_t::torque() const { return api->body_state.torque[index]; }
+
+void rigidbody_t::reset_state(const v3f& p, const quat& q) {
+    position() = p;
+    orientation() = q;
+    velocity() = angular_velocity() = v3f{0.0f};
+    force() = torque() = v3f{0.0f};
+}
+
 void rigidbody_t::set_transform(const m44& transform) {
-    position = v3f{transform[3]};
-    orientation = glm::quat_cast(transform);
+    position() = v3f{transform[3]};
+    orientation() = glm::quat_cast(transform);
 
     this->api->set_rigidbody(this->api, this);
 }
@@ -447,7 +534,7 @@ void rigidbody_t::add_force_ex(const v3f& f) {
 }
 
 void rigidbody_t::set_velocity(const v3f& v) {
-    this->velocity = v;
+    this->velocity() = v;
     this->api->rigidbody_set_velocity(this, v);
 }
 
@@ -484,6 +571,11 @@ void rigidbody_t::set_mass(f32 x) {
 void rigidbody_t::set_ccd(bool x) {
     this->api->rigidbody_set_ccd(this, x);
 }
+void rigidbody_t::wake() {
+    if (is_sleeping()) {
+        this->api->rigidbody_wake(this);
+    }
+}
 
 };
 
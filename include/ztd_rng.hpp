@@ -151,8 +151,8 @@ struct xor32_random_t {
 struct pcg_random_t {
     uint64_t state;
     constexpr static uint32_t max = std::numeric_limits<uint32_t>::max();
-    constexpr static u64 mult = 6364136223846793005ui64;
-    constexpr static u64 incr = 1442695040888963407ui64;
+    constexpr static u64 mult = 6364136223846793005ull;
+    constexpr static u64 incr = 1442695040888963407ull;
 
     u32 rotr32(u32 x, u32 r) {
         return x>>r|x<<(-(i32)r&31);
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Runs the generator worlds headless with a fixed seed and checks them against bench/WORLD.json.
+# The first run on a machine writes the baselines, timings only compare on the same box.
+# Builds the host and modules first (see the Makefile), set BUILD=0 to use what is already in build/.
+frames=${FRAMES:-600}
+seed=${SEED:-1}
+status=0
+if [ "${BUILD:-1}" != 0 ]; then
+    make headless || { echo "runbench: build failed" >&2; exit 1; }
+fi
+for file in build/headless build/libcultist.so build/libztd_physics.so; do
+    if [ ! -f $file ]; then
+        echo "runbench: $file is missing, run make headless" >&2
+        exit 1
+    fi
+done
+mkdir -p bench
+for world in forest particle_test maze crash_test; do
+    if [ -f bench/$world.json ]; then
+        ./build/headless --frames $frames --bench bench/$world.last.json --baseline bench/$world.json --world $world --seed $seed || status=1
+    else
+        ./build/headless --frames $frames --bench bench/$world.json --world $world --seed $seed || status=1
+    fi
+done
+exit $status
@@ -77,34 +77,38 @@ namespace ztd::wep {
         bullet_entity->physics.rigidbody->set_layer(physics_layers::player_bullets);
         bullet_entity->physics.rigidbody->set_group(ztd::player_bullet_collision_group);
 
+        bullet_entity->stats.effect = bullet.effects;
+
         bullet_entity->coroutine->start();
 
         return bullet_entity;
     }
 
 
+    // pooled, returns 0 because there is no entity to hand back
     export_fn(ztd::entity_t*) spawn_bullet(
         ztd::world_t* world,
         const ztd::prefab_t& prefab,
         bullet_t bullet        
     ) {
-        auto* bullet_entity = ztd::tag_spawn(world, prefab, bullet.ray.at(0.5f));
-        bullet_entity->gfx.material_id = 7; // unlit material @hardcode
-        bullet_entity->stats.weapon.stats.damage = bullet.damage;
-        bullet_entity->physics.rigidbody->on_collision = bullet_on_hit;
-        bullet_entity->physics.rigidbody->add_impulse(bullet.ray.direction*20.0f);
-        bullet_entity->physics.rigidbody->set_ccd(true);
-        bullet_entity->physics.rigidbody->set_mass(0.01f);
-        
-        bullet_entity->physics.rigidbody->set_layer(physics_layers::player_bullets);
-        bullet_entity->physics.rigidbody->set_group(ztd::player_bullet_collision_group);
-
-        bullet_entity->coroutine->start();
-        bullet_entity->add_child(spawn_puff(world, bullet.ray.origin, 10));
-
-        bullet_entity->attached_sound = world->game_state->sfx->emit_event(sound_event::arcane_bolt, bullet.ray.at(0.5f));
-
-        return bullet_entity;
+        const b32 spawned = projectile_spawn(
+            world->projectiles,
+            bullet.ray.at(0.5f),
+            bullet.ray.direction * 20.0f,
+            10.0f, // plasma_bullet used co_kill_in_ten
+            bullet.damage,
+            9.81f,
+            ztd::player_bullet_collision_group,
+            bullet.effects
+        );
+        if (!spawned) {
+            ztd_warn(__FUNCTION__, "Projectile pool full ({}), dropped bullet", projectile_pool_t::capacity);
+            return 0;
+        }
+
+        world->game_state->sfx->emit_event(sound_event::arcane_bolt, bullet.ray.at(0.5f));
+
+        return 0;
     }
 
     export_fn(ztd::entity_t*) spawn_rocket(
@@ -122,12 +126,67 @@ namespace ztd::wep {
         bullet_entity->physics.rigidbody->set_mass(0.01f);
         bullet_entity->physics.rigidbody->set_layer(ztd::physics_layers::player);
         bullet_entity->physics.rigidbody->set_group(~ztd::physics_layers::player);
-        // bullet_entity->physics.rigidbody->set_layer(2ui32);
-        // bullet_entity->physics.rigidbody->set_group(~2ui32);
+        // bullet_entity->physics.rigidbody->set_layer(2u);
+        // bullet_entity->physics.rigidbody->set_group(~2u);
+
+        bullet_entity->stats.effect = bullet.effects;
 
         bullet_entity->coroutine->start();
         bullet_entity->add_child(spawn_puff(world, bullet.ray.origin, 10));
 
         return bullet_entity;
     }
+
+    void update_projectiles(ztd::world_t* world, f32 dt) {
+        TIMED_FUNCTION;
+        auto* pool = world->projectiles;
+        if (!pool || pool->count == 0 || !world->physics) {
+            return;
+        }
+
+        auto* frame_arena = &world->frame_arena.get();
+        const u32 count = pool->count;
+        auto* queries = push_struct<physics::raycast_query_t>(frame_arena, count);
+        auto* results = push_struct<physics::raycast_result_t>(frame_arena, count);
+        range_u32(i, 0, count) {
+            queries[i] = physics::raycast_query_t{
+                .ro = pool->position[i],
+                .rd = projectile_sweep(pool, i, dt),
+                .layer = pool->layer[i],
+            };
+        }
+        world->physics->raycast_batch({queries, count}, {results, count});
+
+        // backwards so the swap remove only moves projectiles that were already resolved
+        for (u32 i = count; i-- > 0;) {
+            const auto& ray = results[i];
+            if (!ray.hit) continue;
+
+            auto* rb = (physics::rigidbody_t*)ray.user_data;
+            auto* hit_entity = (ztd::entity_t*)rb->user_data;
+            const f32 damage = pool->damage[i];
+
+            if (hit_entity && hit_entity->stats.character.health.max) {
+                if (hit_entity->stats.character.health.damage(damage)) {
+                    // entity was killed
+                    hit_entity->queue_free();
+                }
+                auto* event = ztd::new_event(world, hit_entity, ztd::event_type::damage);
+                event->damage_event.point = ray.point;
+                event->damage_event.damage = damage;
+            }
+
+            auto* event = ztd::new_event(world, hit_entity, ztd::event_type::hit);
+            event->hit_event.point = ray.point;
+
+            auto* effect = pool->effect[i];
+            if (hit_entity && effect && effect->on_hit_effect) {
+                do_hit_effects(world, 0, hit_entity, effect, ray.point, ray.normal);
+            }
+
+            projectile_remove(pool, i);
+        }
+
+        projectile_integrate(pool, dt);
+    }
 }
\ No newline at end of file
@@ -61,11 +61,11 @@ generate_world_from_file(arena_t* arena, std::string_view file) {
     generator->add_step("Loading", WORLD_STEP_TYPE_LAMBDA(environment) {
         auto* file_name = (const char*)data;
 
-        load_world_file(world, file_name, [&](auto world, auto prefab, v3f o, const m33& b) {
+        load_world_file(world, file_name, [&](auto world, const auto& prefab, std::span<const math::transform_t> transforms) {
             generator->add_step(prefab.type_name.data(), WORLD_STEP_TYPE_LAMBDA(environment) {
 
             });
-            ztd::tag_spawn(world, prefab, o, b);
+            ztd::world_spawn_instances(world, prefab, transforms);
         });
     });
     return generator;
@@ -752,7 +752,7 @@ make_grid_texture(arena_t* arena, gfx::vul::texture_2d_t* tex, u32 size, v3f c1,
     u64 i = 0;
     range_u64(x, 0, size) {
         range_u64(y, 0, size) {
-            auto n = std::sinf((f32)x/(f32)size*math::constants::pi32*grid_count) * std::sinf((f32)y/(f32)size*math::constants::pi32*grid_count);
+            auto n = std::sin((f32)x/(f32)size*math::constants::pi32*grid_count) * std::sin((f32)y/(f32)size*math::constants::pi32*grid_count);
             n = glm::step(n, 0.0f); 
             auto c = glm::mix(c1,c2,n);
             auto uc = gfx::color::to_color32(c);
@@ -826,7 +826,7 @@ make_noise_texture(arena_t* arena, u32 size) {
             tex->pixels[i++] = u8(n*255.0f);
             tex->pixels[i++] = u8(n*255.0f);
             tex->pixels[i++] = u8(n*255.0f);
-            tex->pixels[i++] = 255ui8;
+            tex->pixels[i++] = u8(255);
         }
     }
 
@@ -927,34 +927,9 @@ app_init_graphics(game_memory_t* game_memory) {
     //     rendering::add_mesh(game_state->render_system, file_name, loaded_mesh);
     // }
     
+    // skeletal meshes are loaded on first use by game_state_get_skeletal_mesh
     gs_skinned_vertices = &rs->skinned_vertices.pool;
 
-    range_u64(i, 0, game_state->resource_file->file_count) {
-        arena_t* arena = &game_state->mesh_arena;
-        if (game_state->resource_file->table[i].file_type != utl::res::magic::skel) { 
-            continue; 
-        }
-
-        const char* file_name = game_state->resource_file->table[i].name.c_data;
-        std::byte*  file_data = utl::res::pack_file_get_file(game_state->resource_file, i);
-
-        gfx::mesh_list_t results;
-        utl::memory_blob_t blob{file_data};
-
-        auto& animation_file = 
-            *utl::hash_get(&game_state->animations, std::string_view{file_name}, arena) =
-            blob.deserialize<loaded_skeletal_mesh_t>(arena);
-
-        animation_file.name.push(arena, std::string_view{file_name});
-
-        gfx::anim::animator_t animator;
-
-        animator.play_animation(animation_file.animations.data + 0);
-        range_u64(_, 0, 1000) {
-            animator.update(1.0f/60.0f);
-        }
-    }
-
 
     {
         auto* arena = &game_state->texture_arena;
@@ -1248,6 +1223,7 @@ app_init_graphics(game_memory_t* game_memory) {
 
     game_state->gui.ctx.font = &game_state->default_font;
     game_state->gui.ctx.input = &game_memory->input;
+    game_state->gui.ctx.text_cache = gfx::text_cache_create(&game_state->main_arena, megabytes(2));
     game_state->gui.ctx.screen_size = v2f{
         (f32)game_memory->config.window_size[0], 
         (f32)game_memory->config.window_size[1]
@@ -1296,6 +1272,8 @@ app_on_init(game_memory_t* game_memory) {
 
 
     game_state->debug_state->debug_alerts.reserve(&game_state->debug_state->arena, 64);
+    tag_array(game_state->debug_state->draw_buffers, debug_draw_buffer_t, &game_state->debug_state->arena, debug_state_t::draw_buffer_count);
+    tag_array(game_state->debug_state->draws, debug_draw_t, &game_state->debug_state->arena, debug_state_t::draw_capacity);
 
     gs_debug_state = game_state->debug_state;    
 
@@ -1733,10 +1711,16 @@ app_on_init(game_memory_t* game_memory) {
         auto* game_state = (game_state_t*)console->user_data;
         auto* world = game_state->game_world;
 
-        tag_array(auto* arr, char, &world->arena, 1);
-        auto* tag = (allocation_tag_t*)arr;
-        tag = tag - 1;
-        tag->pad[4] = 'w';
+        // only sampled allocations get a guard, keep going until one does
+        range_u32(i, 0, ZTD_ALLOCATION_GUARD_INTERVAL) {
+            tag_array(auto* arr, char, &world->arena, 1);
+            auto* tag = world->arena.tags;
+            if (tag && tag->guard) {
+                // run off the end and into the guard
+                std::memset(arr, 'w', size_t((std::byte*)tag->guard - (std::byte*)arr) + 1);
+                break;
+            }
+        }
     }, console);
 
     console_add_command(console, "listwatch", [](void* data) {
@@ -1807,7 +1791,7 @@ app_on_init(game_memory_t* game_memory) {
     // mod_loader.load_library(".\\build\\code.dll");
     
 
-    game_state->resource_file = utl::res::load_pack_file(&game_state->mesh_arena, "./res/res.pack");
+    game_state->resource_file = utl::res::load_pack_file(&game_state->mesh_arena, "./res/res.pack", 1);
 
     
     physics::api_t* physics = game_memory->physics;
@@ -1818,7 +1802,10 @@ app_on_init(game_memory_t* game_memory) {
         physics->create_scene(physics, 0);
         ztd_info("app_init", "Created physics scene");
     }
-    app_init_graphics(game_memory);
+    // headless hosts have no gpu, the render system stays null and the world keeps its own instance pools
+    if (game_memory->config.headless == 0) {
+        app_init_graphics(game_memory);
+    }
 
     game_state->game_world = ztd::world_init(game_state, physics);
     load_engine_functions(game_state->game_world->L);
@@ -1856,12 +1843,12 @@ app_on_init(game_memory_t* game_memory) {
         end_temporary_memory(memory);
     }
 
-    game_state->sfx = fmod_sound::init(main_arena);
+    game_state->sfx = fmod_sound::init(main_arena, game_memory->config.headless);
 
     { // handle arguments
         #define command(name, shortname) name##_sid: case shortname##_sid
         #define description(desc) if (helping) { CLOG(desc); break; }
-        #define usage(how) "\n\n\tUsage: " ## how
+        #define usage(how) "\n\n\tUsage: " how
         b32 helping = 0;
         range_u64(i, 1, Platform.argument_count) {
             auto s = std::string_view{Platform.arguments[i]};
@@ -1883,6 +1870,29 @@ app_on_init(game_memory_t* game_memory) {
                         assert(!"Invalid Argument Count: Profile");
                     }
                 }   break;
+                case command("--world", "-W"): { description("Generate a world instead of the start_level" usage("--world forest|particle_test|maze|crash_test"))
+                    if (++i < Platform.argument_count) {
+                        auto* world = game_state->game_world;
+                        world->world_generator = generate_world_by_name(&world->arena, Platform.arguments[i]);
+                        if (world->world_generator == nullptr) {
+                            // stop instead of quietly loading the start_level, a bench run would measure the wrong world
+                            ztd_error(__FUNCTION__, "Unknown World: {}", Platform.arguments[i]);
+                            FLOG("Unknown World: {}", Platform.arguments[i]);
+                            game_memory->running = false;
+                        }
+                    } else {
+                        assert(!"Invalid Argument Count: World");
+                    }
+                }   break;
+                case command("--seed", "-S"): { description("Seed every rng so runs replay the same" usage("--seed NUMBER"))
+                    if (++i < Platform.argument_count) {
+                        const u64 seed = std::strtoull(Platform.arguments[i], nullptr, 10);
+                        utl::rng::random_s::state.seed(seed);
+                        game_state->game_world->entropy.seed(seed);
+                    } else {
+                        assert(!"Invalid Argument Count: Seed");
+                    }
+                }   break;
                 default: {
                     assert(!"Unknown Argument (See console)");
                     FLOG("Unknown Argument[{}]: {}", i, s);
@@ -1914,14 +1924,16 @@ app_on_deinit(game_memory_t* game_memory) {
         ztd::world_free(game_state->game_world);
     }
 
-    gfx::vul::state_t& vk_gfx = game_state->gfx;
-    vkDeviceWaitIdle(vk_gfx.device);
+    if (game_state->render_system) {
+        gfx::vul::state_t& vk_gfx = game_state->gfx;
+        vkDeviceWaitIdle(vk_gfx.device);
 
-    rendering::cleanup(game_state->render_system);
-    ztd_info(__FUNCTION__, "Render System cleaned up");
+        rendering::cleanup(game_state->render_system);
+        ztd_info(__FUNCTION__, "Render System cleaned up");
 
-    vk_gfx.cleanup();
-    ztd_info(__FUNCTION__, "Graphics API cleaned up");
+        vk_gfx.cleanup();
+        ztd_info(__FUNCTION__, "Graphics API cleaned up");
+    }
 
     arena_clear(&game_state->debug_state->arena);
     arena_clear(&game_state->debug_state->watch_arena);
@@ -2054,18 +2066,12 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
  
     // TODO(ZACK): GAME CODE HERE
 
-    if (game_state->render_system == nullptr) return;
-
     auto* rs = game_state->render_system;
     auto* world = game_state->game_world;
     
     ztd::world_update(world, dt);
 
-    // world->L.push_tablefn("_world", "update");
-    // world->L.push_float(dt);
-    // world->L.callf(2);
-    world->L.dostr(fmt_sv("_world.update({})", dt));
-    // world->L.dostr("_world:update()");
+    ztd::world_update_scripts(world, dt);
 
     // DEBUG_DIAGRAM_(v3f{axis::right * 50.0f}, 0.01f);
 
@@ -2089,14 +2095,26 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
         }
 
     }
-    ztd::world_update_kinematic_physics(world);
+    {
+        TIMED_BLOCK(GamePhysicsSync);
+        ztd::world_update_kinematic_physics(world);
+        ztd::world_update_transforms(world);
+    }
+    ztd::wep::update_projectiles(world, dt);
 
         
     {
         TIMED_BLOCK(GameplayUpdatePostSimulate);
 
-        for (size_t i{0}; i < world->entity_capacity; i++) {
-            auto* e = world->entities + i;
+        auto* frame_arena = &world->frame_arena.get();
+        const u32 job_brain_capacity = world->alive_count;
+        auto** job_brains = push_struct<ztd::entity_t*>(frame_arena, job_brain_capacity);
+        u64 job_brain_count = 0;
+        const auto brain_tunables = brain_read_tunables();
+
+        // coroutines can spawn, alive_count is reread so new entities still get their first tick
+        for (u32 i{0}; i < world->alive_count; i++) {
+            auto* e = world->alive_entities[i];
             auto brain_id = e->brain_id;
             if (e->flags & ztd::EntityFlags_Breakpoint) {
                 __debugbreak();
@@ -2115,8 +2133,8 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
 
             e->coroutine->run(world->frame_arena);
 
-            if (is_physics_object) {
-                auto physics_collider_color = gfx::color::v4::orange;
+            if (is_physics_object && ztd::world_apply_physics_requests(world, e)) {
+                const auto physics_collider_color = gfx::color::v4::orange;
                 for (u64 s = 0; s < e->physics.rigidbody->collider_count; s++) {
                     if (e->physics.rigidbody->colliders[s].type == physics::collider_shape_type::SPHERE) {
                         auto collision_sphere = e->physics.rigidbody->colliders[s].sphere;
@@ -2128,14 +2146,15 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
                         XDIAGRAM(collision_box, physics_collider_color, 0.00f);
                     }
                 }
-                if (e->physics.impulse != v3f{0.0f}) {
-                    e->physics.rigidbody->add_impulse(e->physics.impulse);
-                    e->physics.impulse = {};
-                }
             }
 
             if (brain_id != uid::invalid_id) {
-                world_update_brain(world, e, dt);
+                if (ztd::world_brain_is_parallel(e->brain.type) && job_brain_count < job_brain_capacity) {
+                    job_brains[job_brain_count++] = e;
+                } else {
+                    ztd::world_query_brain_nearby(world, frame_arena, &e, 1);
+                    world_update_brain(world, e, brain_tunables, dt);
+                }
             }
 
             if (is_pickupable) {
@@ -2167,6 +2186,30 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
             //     }
             }
         }
+
+        {
+            TIMED_BLOCK(GameplayUpdateBrains);
+            ztd::world_query_brain_nearby(world, frame_arena, job_brains, job_brain_count);
+
+            utl::job_counter_t brains_done{};
+            utl::parallel_for(world->jobs, frame_arena, job_brain_count, 8, [=](u64 begin, u64 end) {
+                range_u64(b, begin, end) {
+                    ztd::world_update_brain(world, job_brains[b], brain_tunables, dt);
+                }
+            }, &brains_done);
+            utl::job_wait(world->jobs, &brains_done);
+
+            ztd::world_merge_job_events(world);
+            range_u64(b, 0, job_brain_count) {
+                ztd::world_apply_brain(world, job_brains[b]);
+            }
+        }
+
+        {
+            TIMED_BLOCK(GameplayUpdateNavigation);
+            local_persist f32 navigation_budget_ms = 1.0f; DEBUG_WATCH(&navigation_budget_ms);
+            ztd::world_update_navigation(world, navigation_budget_ms);
+        }
     }
     if (app_on_input(game_state, input)) {
         return;
@@ -2223,9 +2266,9 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
         //         // continue;
         //     // }
             // auto* rb = e->physics.rigidbody;
-        //     e->transform.origin = rb->position + rb->velocity * accum;
-            // auto orientation = rb->orientation;
-        //     orientation += (orientation * glm::quat(0.0f, rb->angular_velocity)) * (0.5f * accum);
+        //     e->transform.origin = rb->position() + rb->velocity() * accum;
+            // auto orientation = rb->orientation();
+        //     orientation += (orientation * glm::quat(0.0f, rb->angular_velocity())) * (0.5f * accum);
         //     orientation = glm::normalize(orientation);
         //     // e->transform.set_rotation(orientation);
         // }
@@ -2248,13 +2291,17 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
     }
     
 
-    std::lock_guard lock{game_state->render_system->ticket};
+    // headless hosts have no render system, the particles and draw lists are still built so they get profiled
+    std::unique_lock<std::mutex> lock{};
+    if (rs) {
+        lock = std::unique_lock{rs->ticket};
+    }
     {
         // TIMED_BLOCK(GameplayLock);
         // lock.lock();
     }
 
-    { // @debug
+    if (rs) { // @debug
         auto* env = &game_state->render_system->environment_storage_buffer.pool[0];
         DEBUG_WATCH((v3f*)&env->fog_color);
         DEBUG_WATCH((v3f*)&env->ambient_color);
@@ -2274,11 +2321,11 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
 
         
     if (world->player) {
-        // world->player->camera_controller.transform.origin = world->player->physics.rigidbody->position + 
+        // world->player->camera_controller.transform.origin = world->player->physics.rigidbody->position() + 
         //     axis::up * world->player->camera_controller.head_height + axis::up * world->player->camera_controller.head_offset;
         // world->player->camera_controller.translate(v3f{0.0f});
 
-        rendering::set_player_position(rs, world->player->global_transform().origin);
+        if (rs) rendering::set_player_position(rs, world->player->global_transform().origin);
     
         DEBUG_SET_FOCUS(world->player->global_transform().origin);
     }
@@ -2286,117 +2333,156 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
     auto camera_position = world->camera.origin;
     auto camera_forward = world->camera.basis[2];
     
-    rs->camera_pos = camera_position;
-    rs->set_view(world->camera.inverse().to_matrix(), game_state->width(), game_state->height());
+    if (rs) {
+        rs->camera_pos = camera_position;
+        rs->set_view(world->camera.inverse().to_matrix(), game_state->width(), game_state->height());
+    }
 
     // make sure not to allocate from buffer during sweep
 
-    auto& forward_blend    = world->render_groups[0] = rendering::begin_render_group(rs, world->entity_capacity + 10'000);
-    auto& forward_additive = world->render_groups[1] = rendering::begin_render_group(rs, world->entity_capacity + 128);
+    // headless lists go in the world frame arena and are dropped with it
+    auto begin_render_group = [&](u64 reserve) {
+        if (rs) {
+            return rendering::begin_render_group(rs, reserve);
+        }
+        gfx::render_group_t group{};
+        group.commands.reserve(&world->frame_arena.get(), reserve);
+        return group;
+    };
+    auto& forward_blend    = world->render_groups[0] = begin_render_group(world->entity_capacity + 10'000);
+    auto& forward_additive = world->render_groups[1] = begin_render_group(world->entity_capacity + 128);
     forward_blend.push_command().set_blend(gfx::blend_mode::alpha_blend);
     forward_additive.push_command().set_blend(gfx::blend_mode::additive);
 
     // arena_begin_sweep(&world->render_system()->instance_storage_buffer.pool);
     // arena_begin_sweep(&world->particle_arena);
 
-    for (size_t i{0}; i < world->entity_capacity; i++) {
-        auto* e = world->entities + i;
-        const bool is_not_renderable = !e->is_renderable();
-
-        if (e->is_alive() == false) {
-            continue;
-        }
+    // Note(Zack): entities only write their own gfx entities and instance buffer slices here,
+    // so this runs across the job threads, draw commands are pushed in order afterwards
+    ztd::world_update_transforms(world);
+    const auto renderables = ztd::world_entities(world, ztd::entity_list_renderable);
+    const auto emitters = ztd::world_entities(world, ztd::entity_list_particle);
 
-        if (is_not_renderable) {
-            // ztd_warn("render", "Skipping: {} - {}", (void*)e, e->flags);
-            continue;
-        }
+    utl::job_counter_t render_prepared{};
 
-        for (u32 m = 0; m < e->gfx.gfx_entity_count; m++) {
-            rendering::set_entity_material(rs, e->gfx.gfx_id + m, e->gfx.material_id);
-        }
+    // Note(Zack): emitters are independent, each has its own rng and instance buffer slice.
+    // One job per emitter since particle counts vary a lot, idle threads steal the big ones.
+    // The particle and material jobs share a counter so they overlap, every job is timed on its own
+    // and the bench sums them by name, so the phases are cpu time across the job threads
+    utl::parallel_for(world->jobs, &world->frame_arena.get(), emitters.count, 1, [=](u64 begin, u64 end) {
+        TIMED_BLOCK(GameUpdateParticles);
+        for (size_t i{begin}; i < end; i++) {
+            auto* e = emitters.entities[i];
 
-        if (e->gfx.buffer) {
-            // arena_sweep_keep(&world->render_system()->instance_storage_buffer.pool, e->gfx.instance_end());
-        }
-
-        b32 is_particle = 0;
-        b32 is_additive = 0;
-        auto instance_count = e->gfx.instance_count();
-        auto instance_offset = e->gfx.instance_offset();
-
-        if (e->gfx.particle_system) {
-            is_particle = 1;
-            if (e->gfx.particle_system->flags & ParticleSettingsFlags_AdditiveBlend) {
-                is_additive = 1;
+            if (e->is_alive() == false) {
+                continue;
             }
+
             auto* ps = e->gfx.particle_system;
             auto transform = e->global_transform();
             // arena_sweep_keep(&world->particle_arena, (std::byte*)(ps->particles + ps->max_count));
             if (dt != 0.0f) {
-                particle_system_update(e->gfx.particle_system, transform, dt);
+                particle_system_update(ps, transform, dt);
             }
             // particle_system_sort_view(
-            //     e->gfx.particle_system, 
+            //     ps, 
             //     transform,
-            //     camera_position, camera_forward
+            //     camera_position, camera_forward,
+            //     world_frame_arena(world)
             // );
             particle_system_build_colors(
-                e->gfx.particle_system, 
+                ps, 
                 e->gfx.dynamic_color_instance_buffer, 
                 e->gfx._instance_count
             );
             particle_system_build_matrices(
-                e->gfx.particle_system, 
+                ps, 
                 transform,
                 e->gfx.dynamic_instance_buffer, 
                 e->gfx._instance_count
             );
-            range_u32(gi, 0, e->gfx.gfx_entity_count) {
-                rendering::set_entity_instance_data(rs, e->gfx.gfx_id + gi, e->gfx.instance_offset(0), ps->live_count);
+            if (rs) {
+                range_u32(gi, 0, e->gfx.gfx_entity_count) {
+                    rendering::set_entity_instance_data(rs, e->gfx.gfx_id + gi, e->gfx.instance_offset(0), ps->live_count);
+                }
             }
         }
+    }, &render_prepared);
+
+    if (rs) {
+        utl::parallel_for(world->jobs, &world->frame_arena.get(), renderables.count, 64, [=](u64 begin, u64 end) {
+            TIMED_BLOCK(GameBuildRenderList);
+            for (size_t i{begin}; i < end; i++) {
+                auto* e = renderables.entities[i];
+
+                if (e->is_alive() == false) {
+                    continue;
+                }
+
+                for (u32 m = 0; m < e->gfx.gfx_entity_count; m++) {
+                    rendering::set_entity_material(rs, e->gfx.gfx_id + m, e->gfx.material_id);
+                }
+            }
+        }, &render_prepared);
+    }
+    utl::job_wait(world->jobs, &render_prepared);
+
+    {
+        TIMED_BLOCK(GameBuildRenderList);
+        for (auto* e: renderables) {
+            if (e->is_alive() == false) {
+                continue;
+            }
+
+            if (e->gfx.buffer) {
+                // arena_sweep_keep(&world->render_system()->instance_storage_buffer.pool, e->gfx.instance_end());
+            }
 
-        v3f size = e->aabb.size()*0.5f;
-        // v4f bounds{e->aabb.center(), glm::max(glm::max(size.x, size.y), size.z) };
+            const b32 is_additive = e->gfx.particle_system && (e->gfx.particle_system->flags & ParticleSettingsFlags_AdditiveBlend);
+            auto instance_count = e->gfx.instance_count();
+            auto instance_offset = e->gfx.instance_offset();
 
-        // if (e->type == ztd::entity_type::player) continue;
+            v3f size = e->aabb.size()*0.5f;
+            // v4f bounds{e->aabb.center(), glm::max(glm::max(size.x, size.y), size.z) };
 
-        if (instance_count == 0) continue;
+            // if (e->type == ztd::entity_type::player) continue;
 
-        // auto albedo_id = std::numeric_limits<u32>::max();
+            if (instance_count == 0) continue;
 
-        // Todo(Zack): Add gfx setting for blending
+            // auto albedo_id = std::numeric_limits<u32>::max();
+
+            // Todo(Zack): Add gfx setting for blending
         
-        auto& draw_command = is_additive ? forward_additive.push_command() : forward_blend.push_command();
-        draw_command.type = gfx::render_command_type::draw_mesh;
-        auto& draw_mesh = draw_command.draw_mesh;
-            draw_mesh.mesh_id = e->gfx.mesh_id;
-            draw_mesh.material_id = e->gfx.material_id;
-            draw_mesh.transform = e->global_transform().to_matrix();
-            draw_mesh.gfx_id = e->gfx.gfx_id;
-            draw_mesh.gfx_count = e->gfx.gfx_entity_count;
-            draw_mesh.instance_count = instance_count;
-            draw_mesh.instance_offset = instance_offset;
-            draw_mesh.albedo_id = e->gfx.albedo_id;
-
-        // rendering::submit_job(
-        //     game_state->render_system, 
-        //     e->gfx.mesh_id, 
-        //     e->gfx.material_id, // todo make material per mesh
-        //     e->global_transform().to_matrix(),
-        //     e->gfx.gfx_id,
-        //     e->gfx.gfx_entity_count,
-        //     instance_count,
-        //     e->gfx.instance_offset(),
-        //     e->gfx.albedo_id
-        // );
+            auto& draw_command = is_additive ? forward_additive.push_command() : forward_blend.push_command();
+            draw_command.type = gfx::render_command_type::draw_mesh;
+            auto& draw_mesh = draw_command.draw_mesh;
+                draw_mesh.mesh_id = e->gfx.mesh_id;
+                draw_mesh.material_id = e->gfx.material_id;
+                draw_mesh.transform = e->global_transform().to_matrix();
+                draw_mesh.gfx_id = e->gfx.gfx_id;
+                draw_mesh.gfx_count = e->gfx.gfx_entity_count;
+                draw_mesh.instance_count = instance_count;
+                draw_mesh.instance_offset = instance_offset;
+                draw_mesh.albedo_id = e->gfx.albedo_id;
+
+            // rendering::submit_job(
+            //     game_state->render_system, 
+            //     e->gfx.mesh_id, 
+            //     e->gfx.material_id, // todo make material per mesh
+            //     e->global_transform().to_matrix(),
+            //     e->gfx.gfx_id,
+            //     e->gfx.gfx_entity_count,
+            //     instance_count,
+            //     e->gfx.instance_offset(),
+            //     e->gfx.albedo_id
+            // );
+        }
     }
 
     local_persist u32 show_light_probes;
     DEBUG_WATCH(&show_light_probes);
 
-    if (show_light_probes) {
+    if (show_light_probes && rs) {
         auto* probes = &rs->probe_storage_buffer.pool[0];
         auto* probe_box = &rs->light_probes;
         auto& probe_settings = rs->light_probe_settings_buffer.pool[0];
@@ -2414,8 +2500,8 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
             
             auto pos = rendering::lighting::probe_position(probe_box, &p, i);
             
-            // local_persist u32 sphere_gfx_id = ~0ui32;
-            // if (sphere_gfx_id == ~0ui32) {
+            // local_persist u32 sphere_gfx_id = ~0u;
+            // if (sphere_gfx_id == ~0u) {
             //     sphere_gfx_id = rendering::register_entity(rs);
             //     rendering::set_entity_material(rs, sphere_gfx_id, 0);
             //     rendering::initialize_entity(rs, sphere_gfx_id, mesh_list.meshes[0].vertex_start, mesh_list.meshes[0].index_start);
@@ -2441,8 +2527,14 @@ void game_on_gameplay(game_state_t* game_state, app_input_t* input, f32 dt) {
         }
     }
 
+    // headless, the lists are built but nothing draws them
+    if (rs == nullptr) {
+        return;
+    }
+
     // arena_sweep_keep(&world->render_system()->instance_storage_buffer.pool, (std::byte*)(world->effects.blood_splats + world->effects.blood_splat_max));
     ztd::world_render_bloodsplat(world);
+    ztd::world_render_projectiles(world);
 
     rendering::end_render_group(rs, world->render_groups[0]);
     rendering::end_render_group(rs, world->render_groups[1]);
@@ -2502,14 +2594,22 @@ game_on_update(game_memory_t* game_memory) {
         
         // Todo(Zack): add config setting to turn this on and off
         // try {
-            world_generator->execute(game_state->game_world, [&](){draw_gui(game_memory);});
+            world_generator->execute(game_state->game_world, [&](){
+                if (game_state->render_system) {
+                    draw_gui(game_memory);
+                }
+            });
         // } catch ( std::exception& e) {
             // DEBUG_STATE.alert(e.what());
             // ztd_error("world_generator->execute", "Exception loading world: {}", e.what());
             // game_state->game_world->world_generator->force_completion();
         // }
-        std::lock_guard lock{game_state->render_system->ticket};
-        set_ui_textures(game_state);
+        ztd::world_rebuild_navigation(game_state->game_world);
+
+        if (game_state->render_system) {
+            std::lock_guard lock{game_state->render_system->ticket};
+            set_ui_textures(game_state);
+        }
         game_memory->input.keys[key_id::F9] = 1;
     // } else {
         // local_persist f32 accum = 0.0f;
@@ -3063,6 +3163,20 @@ export_fn(void)
 app_on_update(game_memory_t* game_memory) {
     auto* game_state = get_game_state(game_memory);
 
+#if ZTD_INTERNAL
+    // frame boundary, pull in what every thread recorded during the last frame
+    collate_debug_events(&gs_debug_table);
+    if (auto* physics_table = game_memory->physics->get_debug_table()) {
+        collate_debug_events(physics_table);
+    }
+#endif
+
+#ifdef DEBUG_STATE
+    if (gs_debug_state) {
+        DEBUG_STATE.set_frame_time();
+    }
+#endif
+
     if (game_memory->input.keys[key_id::LEFT_CONTROL] && 
         game_memory->input.pressed.keys[key_id::TAB]) { 
     // if (game_memory->input.pressed.keys[key_id::F3] || 
@@ -3071,6 +3185,16 @@ app_on_update(game_memory_t* game_memory) {
         return;
     }
 
+    if (game_memory->config.headless) {
+        game_on_update(game_memory);
+#ifdef DEBUG_STATE
+        if (gs_debug_state) {
+            DEBUG_STATE.begin_frame();
+        }
+#endif
+        return;
+    }
+
     u32 image_index = wait_for_frame(game_state);
     rendering::begin_frame(game_state->render_system);
 
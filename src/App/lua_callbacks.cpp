@@ -197,6 +197,22 @@ static int l_transform_entity(lua_State* L) {
     return 0;
 }
 
+// set_entity_hook(entity, function(entity, dt) end), nil removes the hook
+static int l_set_entity_hook(lua_State* L) {
+    auto* world = get_world(L);
+    auto* e = (ztd::entity_t*)lua_touserdata(L, 1);
+    luaL_argcheck(L, e != NULL, 1, "'Entity' expected");
+
+    const b32 has_hook = lua_isfunction(L, 2);
+    lua_settop(L, 2);
+    if (!has_hook) {
+        lua_pop(L, 1);
+    }
+    ztd::world_set_entity_hook(world, e, has_hook);
+
+    return 0;
+}
+
 static int l_load_prefab(lua_State* L) {
     int nargs = lua_gettop(L);
 
@@ -319,6 +335,7 @@ static void load_engine_functions(ztd::luau::vm_t& L) {
         .add({"alert", l_alert})
         .add({"load_prefab", l_load_prefab})
         .add({"spawn_prefab", l_spawn_prefab})
+        .add({"set_entity_hook", l_set_entity_hook})
         .end().fns);
     L.register_better_type(
         ztd::luau::function_registrar_t<>{}
@@ -15,25 +15,22 @@ namespace ztd::luau {
 
     struct user_data_t {
         // change to pointer?
-        utl::allocator_t allocator{};
+        utl::size_class_allocator_t allocator{};
         const void* user_data = 0;
     };
     
+    // luau always passes the old block size back, so the allocator needs no headers
     void* lua_alloc(void* ud, void* ptr, size_t os, size_t nsize) {
         auto* user_data = (user_data_t*)ud;
-        auto* allocator = (utl::allocator_t*)&user_data->allocator;
+        auto* allocator = &user_data->allocator;
         if (nsize == 0) {
             // free(ptr);
-            if (ptr)
-                allocator->free(ptr);
+            allocator->free(ptr, os);
             return 0;
         } else {
             // auto* p = realloc(ptr, nsize);
-            auto* p = (void*)allocator->allocate(nsize);
+            auto* p = allocator->reallocate(ptr, ptr ? os : 0, nsize);
             assert(p);
-
-            utl::copy(p, ptr, os);
-            if (ptr) allocator->free(ptr);
             
             // if (log_memory) {
                 // std::print("[{}]: {} - {}{}\n", 
@@ -72,10 +69,23 @@ namespace ztd::luau {
         std::array<luaL_Reg, N+1> fns = {};
     };
 
+    // registry handle to a lua value, resolved once and reused until a chunk runs again
+    struct ref_t {
+        int ref{LUA_NOREF};
+        u32 generation{0};
+
+        b32 is_valid() const {
+            return ref != LUA_NOREF;
+        }
+    };
+
     struct vm_t {
         lua_State* L = 0;
         user_data_t user_data = {};
 
+        // bumped whenever a chunk runs, it could have rebound anything a ref_t points at
+        u32 generation{1};
+
         void init(void* world) {
             user_data.user_data = world;
             L = lua_newstate(lua_alloc, &user_data);
@@ -118,6 +128,75 @@ namespace ztd::luau {
             // lua_pop(L, args + 1);
         }
 
+        // pops the top value into a registry ref, nil and non functions leave it invalid
+        void make_ref(ref_t* ref) {
+            release_ref(ref);
+            if (lua_isfunction(L, -1) || lua_istable(L, -1)) {
+                ref->ref = lua_ref(L, -1);
+            }
+            ref->generation = generation;
+            lua_pop(L, 1);
+        }
+
+        void release_ref(ref_t* ref) {
+            if (ref->is_valid()) {
+                lua_unref(L, ref->ref);
+            }
+            ref->ref = LUA_NOREF;
+        }
+
+        // looks up table.field, only touches the globals when a chunk ran since the last lookup
+        b32 resolve(ref_t* ref, const char* table, const char* field) {
+            if (ref->generation != generation) {
+                lua_getglobal(L, table);
+                if (lua_istable(L, -1)) {
+                    lua_getfield(L, -1, field);
+                    lua_remove(L, -2);
+                }
+                make_ref(ref);
+            }
+            return ref->is_valid();
+        }
+
+        // runs a chunk and keeps its return value, the bytecode is left for the caller to cache
+        b32 load_ref(bytecode_t bytecode, ref_t* ref) {
+            generation++;
+            if (luau_load(L, "ztd", bytecode.bytecode, bytecode.length, 0) != LUA_OK ||
+                lua_pcall(L, 0, 1, 0) != LUA_OK
+            ) {
+                size_t len;
+                const char* msg = lua_tolstring(L, -1, &len);
+                ztd_error(__FUNCTION__, "Error: {}\n", std::string_view{msg, len});
+                lua_pop(L, 1);
+                release_ref(ref);
+                return 0;
+            }
+            make_ref(ref);
+            return ref->is_valid();
+        }
+
+        void push(f32 x) { lua_pushnumber(L, x); }
+        void push(void* p) { lua_pushlightuserdata(L, p); }
+        void push(const ref_t& r) { lua_getref(L, r.ref); }
+
+        // calls a resolved function with pushed arguments, no source is compiled
+        template <typename ... Args>
+        b32 call(const ref_t& fn, Args&& ... args) {
+            if (!fn.is_valid()) {
+                return 0;
+            }
+            lua_getref(L, fn.ref);
+            (push(std::forward<Args>(args)), ...);
+            if (lua_pcall(L, sizeof...(Args), 0, 0) != LUA_OK) {
+                size_t len;
+                const char* msg = lua_tolstring(L, -1, &len);
+                ztd_error(__FUNCTION__, "Error: {}\n", std::string_view{msg, len});
+                lua_pop(L, 1);
+                return 0;
+            }
+            return 1;
+        }
+
         void register_better_type(const auto&& create, const auto&& funcs, const char* name) {
             luaL_newmetatable(L, name);
 
@@ -178,6 +257,7 @@ namespace ztd::luau {
                 TIMED_BLOCK(Luau_Load);
                 r = luau_load(L, "ztd", bytecode.bytecode, bytecode.length, 0);
             }
+            generation++;
             if (r != LUA_OK) {
                 size_t len;
                 const char* msg = lua_tolstring(L, -1, &len);
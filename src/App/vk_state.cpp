@@ -1452,8 +1452,8 @@ state_t::create_pipeline_state(
 		vsosf.passOp = VK_STENCIL_OP_KEEP;
 		vsosf.depthFailOp = VK_STENCIL_OP_KEEP;
         vsosf.compareOp = VK_COMPARE_OP_NEVER;
-		vsosf.compareMask = ~0ui32;
-		vsosf.writeMask = ~0ui32;
+		vsosf.compareMask = ~0u;
+		vsosf.writeMask = ~0u;
 		vsosf.reference = 0;
 
 
@@ -1462,8 +1462,8 @@ state_t::create_pipeline_state(
 		vsosb.passOp = VK_STENCIL_OP_KEEP;
 		vsosb.depthFailOp = VK_STENCIL_OP_KEEP;
 		vsosb.compareOp = VK_COMPARE_OP_NEVER;
-		vsosb.compareMask = ~0ui32;
-		vsosb.writeMask = ~0ui32;
+		vsosb.compareMask = ~0u;
+		vsosb.writeMask = ~0u;
 		vsosb.reference = 0;
 
     VkPipelineDepthStencilStateCreateInfo			vpdssci;
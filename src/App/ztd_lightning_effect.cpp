@@ -50,7 +50,7 @@ export_fn(void) lightning_on_hit_effect(
     lightning_cache_t* cache = 0;
 
     // arena_t temp = arena_create(kilobytes(1));
-    auto memory = begin_temporary_memory(&w->arena);
+    auto memory = begin_temporary_memory(arena_get_scratch());
     arena_t* arena = memory.arena; 
     // auto mark = arena_get_mark(arena);
     arena_t stack_arena = w->frame_arena.get();
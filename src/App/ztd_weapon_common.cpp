@@ -33,19 +33,37 @@ void co_blood(coroutine_t* co, frame_arena_t& frame_arena) {
     co_begin(co);
         std::memset(spawned, 0, sizeof(u8)*ps->max_count);
         while (true) {
-            for (i=0; i < ps->live_count; i++) {
-                if (spawned[i]) {continue;}
-                v3f ro=e->global_transform().xform(ps->particles[i].position);
-                v3f rd=e->global_transform().basis * ((ps->particles[i].velocity/20.0f));
-                math::ray_t blood_ray{ro,rd};
-                DEBUG_DIAGRAM_(blood_ray, 0.0001f);
-                if (auto ray = physics->raycast_world(ro, rd); ray.hit) {
+            {
+                // every unspawned particle casts this frame, send them through one batch
+                auto memory = begin_temporary_memory(arena_get_scratch());
+                auto* queries = push_struct<physics::raycast_query_t>(memory.arena, ps->live_count);
+                auto* results = push_struct<physics::raycast_result_t>(memory.arena, ps->live_count);
+                auto* particle_ids = push_struct<u32>(memory.arena, ps->live_count);
+                u32 query_count = 0;
+
+                const auto global_transform = e->global_transform();
+                for (i=0; i < ps->live_count; i++) {
+                    if (spawned[i]) {continue;}
+                    const auto& particles = ps->particles;
+                    v3f ro=global_transform.xform(v3f{particles.position[0][i], particles.position[1][i], particles.position[2][i]});
+                    v3f rd=global_transform.basis * (v3f{particles.velocity[0][i], particles.velocity[1][i], particles.velocity[2][i]}/20.0f);
+                    math::ray_t blood_ray{ro,rd};
+                    DEBUG_DIAGRAM_(blood_ray, 0.0001f);
+                    particle_ids[query_count] = safe_truncate_u64(i);
+                    queries[query_count++] = physics::raycast_query_t{ro, rd};
+                }
+
+                physics->raycast_batch({queries, query_count}, {results, query_count});
+
+                range_u32(q, 0, query_count) {
+                    const auto& ray = results[q];
+                    if (!ray.hit) {continue;}
                     auto* rb = (physics::rigidbody_t*)ray.user_data;
                     if (rb->type==physics::rigidbody_type::STATIC) {
+                        i = particle_ids[q];
                         math::transform_t transform{ray.point + ray.normal * 0.01f};
                         math::ray_t blood_hit_ray{ray.point, ray.normal};
                         DEBUG_DIAGRAM(blood_hit_ray);
-                        DEBUG_DIAGRAM(blood_ray);
                         transform.look_at(ray.point + ray.normal);
                         auto theta = f32(i) * 1000.0f;
                         transform.set_rotation(transform.get_orientation() * quat{sinf(theta), 0.0f, 0.0f, cosf(theta)});
@@ -54,6 +72,7 @@ void co_blood(coroutine_t* co, frame_arena_t& frame_arena) {
                         spawned[i] = 1;
                     }
                 }
+                end_temporary_memory(memory);
             }
             if (co->start_time == 0) { co->start_time = co->now; } if (co->now < (co->start_time) + (f32)t) { co_yield(co); } else { break; }
         }
@@ -204,7 +223,7 @@ ztd::entity_t* explosion_at_point(
     f32 range,
     ztd::item::effect_t* effects
 ) {
-    auto memory = begin_temporary_memory(&world->arena);
+    auto memory = begin_temporary_memory(arena_get_scratch());
 
     world->game_state->sfx->emit_event(sound_event::explosion, pos);
 
@@ -230,7 +249,7 @@ ztd::entity_t* explosion_at_point(
             auto delta_length = glm::dot(delta, delta) + 1.0f;
 
             auto force = delta_normal / delta_length; 
-            n->physics.impulse += (force * 10.0f);
+            n->physics.queue_impulse(force * 10.0f);
         }
         if (n->stats.character.health.max) {
             auto blood = ztd::db::environmental::blood_01;
@@ -62,4 +62,15 @@ platform_api_t Platform;
 #if ZTD_INTERNAL
 debug_table_t gs_debug_table;
 size_t gs_main_debug_record_size = __COUNTER__;
+
+// the headless host reads the timed blocks through these, same as the physics module
+export_fn(debug_table_t*) 
+app_get_debug_table() {
+    return &gs_debug_table;
+}
+
+export_fn(size_t) 
+app_get_debug_table_size() {
+    return gs_main_debug_record_size;
+}
 #endif
\ No newline at end of file
@@ -5,7 +5,7 @@
 #endif
 
 #if ZYY_LINK_PHYSICS_API_PHYSX
-#include "App\Game\Physics\physics_world.hpp"
+#include "App/Game/Physics/physics_world.hpp"
 #include "physx_physics.hpp"
 #endif
 
@@ -64,9 +64,12 @@ init_physx(api_t* api, arena_t* arena) {
     api->remove_rigidbody   = physx_remove_rigidbody;
 
     api->create_rigidbody     = physx_create_rigidbody;
+    api->_create_rigidbody_batch = physx_create_rigidbody_batch;
     api->create_collider      = physx_create_collider;
     api->_raycast_world        = physx_raycast_world;
     api->_sphere_overlap_world = physx_sphere_overlap_world;
+    api->_raycast_batch        = physx_raycast_batch;
+    api->_overlap_batch        = physx_overlap_batch;
 
     api->create_scene       = physx_create_scene;
     api->destroy_scene      = physx_destroy_scene;
@@ -88,6 +91,7 @@ init_physx(api_t* api, arena_t* arena) {
     api->rigidbody_set_ccd = physx_rigidbody_set_ccd;
     api->rigidbody_set_mass = physx_rigidbody_set_mass;
     api->rigidbody_set_collision_flags = physx_rigidbody_set_collision_flags;
+    api->rigidbody_wake = physx_rigidbody_wake;
 
     api->
         get_debug_table_size= get_debug_table_size;
@@ -98,6 +102,12 @@ init_physx(api_t* api, arena_t* arena) {
 static void 
 init_custom(api_t* api, arena_t* arena) {
     api->arena = arena;
+    tag_struct(custom_backend_t* backend, custom_backend_t, arena);
+    api->backend = custom_init_backend(backend, arena);
+
+    api->cleanup = [](api_t* a){
+        // everything lives in the physics arena
+    };
     
     api->simulate           = custom_simulate;
     api->set_rigidbody      = custom_set_rigidbody;
@@ -106,13 +116,35 @@ init_custom(api_t* api, arena_t* arena) {
     api->add_rigidbody      = custom_add_rigidbody;
     api->remove_rigidbody   = custom_remove_rigidbody;
 
-    api->create_rigidbody   = custom_create_rigidbody;
-    api->create_collider    = custom_create_collider;
-    api->_raycast_world      = custom_raycast_world;
+    api->create_rigidbody     = custom_create_rigidbody;
+    api->_create_rigidbody_batch = custom_create_rigidbody_batch;
+    api->create_collider      = custom_create_collider;
+    api->_raycast_world        = custom_raycast_world;
+    api->_sphere_overlap_world = custom_sphere_overlap_world;
+    api->_raycast_batch        = custom_raycast_batch;
+    api->_overlap_batch        = custom_overlap_batch;
 
     api->create_scene       = custom_create_scene;
     api->destroy_scene      = custom_destroy_scene;
 
+    api->collider_set_trigger = custom_collider_set_trigger;
+    api->collider_set_active = custom_collider_set_active;
+    api->collider_set_transform = custom_collider_set_transform;
+    api->collider_get_transform = custom_collider_get_transform;
+
+    api->rigidbody_add_impulse = custom_rigidbody_add_impulse;
+    api->rigidbody_add_force = custom_rigidbody_add_force;
+    api->rigidbody_set_velocity = custom_rigidbody_set_velocity;
+    api->rigidbody_add_force_at_point = custom_rigidbody_add_force_at_point;
+    api->rigidbody_set_character_height = custom_rigidbody_set_character_height;
+    api->rigidbody_set_character_radius = custom_rigidbody_set_character_radius;
+
+    api->rigidbody_set_gravity = custom_rigidbody_set_gravity;
+    api->rigidbody_set_ccd = custom_rigidbody_set_ccd;
+    api->rigidbody_set_mass = custom_rigidbody_set_mass;
+    api->rigidbody_set_collision_flags = custom_rigidbody_set_collision_flags;
+    api->rigidbody_wake = custom_rigidbody_wake;
+
     api->
         get_debug_table_size= get_debug_table_size;
     api->get_debug_table    = get_debug_table;
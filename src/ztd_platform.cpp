@@ -834,6 +834,10 @@ main(int argc, char* argv[]) {
     Platform.arguments = (const char**)argv;
     Platform.argument_count = argc;
 
+    // allocation sites and arena blocks are shared with every dll through Platform
+    local_persist arena_shared_state_t arena_shared{};
+    arena_shared_state_init(&arena_shared);
+
     game_memory_t game_memory{};
     game_memory.platform = Platform;
 
@@ -891,7 +895,8 @@ main(int argc, char* argv[]) {
             reinterpret_cast<physics::init_function>(
                 GetProcAddress((HMODULE)physics_dll, "physics_init_api")
             );
-        init_physics(game_memory.physics, physics::backend_type::PHYSX, &Platform, &physics_arena);
+        const auto physics_backend = (physics::backend_type)utl::config_get_int(&dconfig, "physics_backend", (i32)physics::backend_type::PHYSX);
+        init_physics(game_memory.physics, physics_backend, &Platform, &physics_arena);
         *game_memory.physics->Platform = Platform;
         ztd_info("win32", "Physics Loaded");
     }
@@ -900,6 +905,19 @@ main(int argc, char* argv[]) {
         if (game_memory.physics) game_memory.physics->cleanup(game_memory.physics);
     };
 
+    // job workers live here so they arent torn down when the game dll reloads,
+    // their memory is outside game_memory.arena so the memory loop doesnt snapshot it
+    arena_t job_arena = arena_create(megabytes(2));
+    {
+        const i32 hardware_threads = (i32)std::thread::hardware_concurrency();
+        const i32 job_threads = utl::config_get_int(&dconfig, "job_threads", hardware_threads - 1);
+        game_memory.jobs = utl::job_system_create(&job_arena, (u32)std::max(job_threads, 0));
+    }
+    defer {
+        utl::job_system_destroy(game_memory.jobs);
+        arena_clear(&job_arena);
+    };
+
     game_memory.platform = Platform;
 
     app_dll_t app_dlls;
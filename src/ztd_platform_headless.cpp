@@ -0,0 +1,656 @@
+// Note(Zack): Headless platform layer for the linux build and ci boxes. No window, gpu or audio device,
+// it loads the game and physics modules like the win32 layer, then steps app_on_update at a fixed dt
+// as fast as it can and reports what every TIMED_BLOCK cost per frame.
+//
+//  ./build/headless [--frames N] [--warmup N] [--dt SECONDS] [--csv FILE] [--trace FILE]
+//                   [--bench FILE] [--baseline FILE] [--tolerance PERCENT] [game arguments]
+//
+// --bench writes the frame and phase timings as json, --baseline compares them against an older
+// result and exits with 1 when anything got slower than the tolerance. Pass the game --world and
+// --seed so every run builds and plays out the same world, runbench.sh does the generator worlds.
+//
+// make headless builds the host with the game and physics modules next to it, see the Makefile.
+
+#include "ztd_core.hpp"
+
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#if _WIN32
+    #error "Windows uses ztd_platform.cpp"
+#else
+
+#include <sys/mman.h>
+#include <dlfcn.h>
+
+platform_api_t Platform;
+
+#if ZTD_INTERNAL
+debug_table_t gs_debug_table;
+size_t gs_main_debug_record_size = __COUNTER__;
+#endif
+
+struct posix_memory_block_t {
+    size_t size{0};
+    u8 pad[56] = {}; // keeps blocks 64 byte aligned like win32_memory_block_t
+};
+
+static_assert(sizeof(posix_memory_block_t) == 64);
+
+global_variable std::atomic<u64> gs_allocated_bytes{0};
+global_variable std::atomic<u64> gs_allocated_block_count{0};
+
+// anonymous mappings come back zeroed, same as VirtualAlloc
+void* posix_alloc(size_t size) {
+    void* memory = mmap(0, size + sizeof(posix_memory_block_t), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        ztd_error(__FUNCTION__, "Failed to map {} bytes", size);
+        return nullptr;
+    }
+
+    auto* block = new (memory) posix_memory_block_t;
+    block->size = size;
+
+    gs_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    gs_allocated_block_count.fetch_add(1, std::memory_order_relaxed);
+    return block + 1;
+}
+
+void posix_free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto* block = (posix_memory_block_t*)ptr - 1;
+    gs_allocated_bytes.fetch_sub(block->size, std::memory_order_relaxed);
+    gs_allocated_block_count.fetch_sub(1, std::memory_order_relaxed);
+
+    const int result = munmap(block, block->size + sizeof(posix_memory_block_t));
+    assert(result == 0);
+}
+
+void*
+posix_load_library(const char* file) {
+    void* library = dlopen(file, RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr) {
+        ztd_warn(__FUNCTION__, "Failed to load {}: {}", file, dlerror());
+    }
+    return library;
+}
+
+void
+posix_unload_library(void* library) {
+    dlclose(library);
+}
+
+void*
+posix_load_module() {
+    return dlopen(nullptr, RTLD_NOW);
+}
+
+void*
+posix_load_proc(void* library, const char* name) {
+    return dlsym(library, name);
+}
+
+// nobody is there to click it, log and answer cancel
+i32 posix_message_box(const char* text) {
+    ztd_error("headless", "{}", text);
+    return 2;
+}
+
+void
+load_dll_functions(app_dll_t* app_dlls) {
+    assert(app_dlls->dll);
+
+    app_dlls->on_update = Platform.load_function<app_func_t>(app_dlls->dll, "app_on_update");
+    app_dlls->on_render = Platform.load_function<app_func_t>(app_dlls->dll, "app_on_render");
+    app_dlls->on_init   = Platform.load_function<app_func_t>(app_dlls->dll, "app_on_init");
+    app_dlls->on_deinit = Platform.load_function<app_func_t>(app_dlls->dll, "app_on_deinit");
+    app_dlls->on_unload = Platform.load_function<app_func_t>(app_dlls->dll, "app_on_unload");
+    app_dlls->on_reload = Platform.load_function<app_func_t>(app_dlls->dll, "app_on_reload");
+}
+
+struct headless_frame_stats_t {
+    u64 count{0};
+    f64 avg_ms{0.0};
+    f64 p50_ms{0.0};
+    f64 p99_ms{0.0};
+    f64 worst_ms{0.0};
+    f64 fps{0.0};
+};
+
+// sorts the frame times in place
+headless_frame_stats_t
+headless_frame_stats(u64* frame_nanoseconds, u64 count) {
+    headless_frame_stats_t stats{};
+    if (count == 0) {
+        return stats;
+    }
+    std::sort(frame_nanoseconds, frame_nanoseconds + count);
+    u64 total = 0;
+    range_u64(i, 0, count) {
+        total += frame_nanoseconds[i];
+    }
+    auto percentile = [&](f64 p) {
+        return f64(frame_nanoseconds[std::min(count - 1, u64(p * f64(count)))]) / 1e6;
+    };
+    stats.count = count;
+    stats.avg_ms = f64(total) / f64(count) / 1e6;
+    stats.p50_ms = percentile(0.5);
+    stats.p99_ms = percentile(0.99);
+    stats.worst_ms = f64(frame_nanoseconds[count - 1]) / 1e6;
+    stats.fps = f64(count) / (f64(total) / 1e9);
+    return stats;
+}
+
+// Note(Zack): Benchmark results are one flat json object, the run settings and then "<name>_ms" numbers.
+// A baseline is just an older result, every "_ms" number in it is checked against this run.
+struct headless_bench_value_t {
+    std::string name;
+    f64         ms{0.0};
+};
+
+struct headless_bench_t {
+    std::string_view world{"start_level"};
+    u64              seed{0};
+    u64              frame_count{0};
+    f32              dt{0.0f};
+
+    headless_bench_value_t values[16];
+    u32                    value_count{0};
+
+    void add(std::string_view name, f64 ms) {
+        assert(value_count < array_count(values));
+        values[value_count++] = headless_bench_value_t{fmt::format("{}_ms", name), ms};
+    }
+};
+
+void
+headless_write_bench(const headless_bench_t* bench, const char* path) {
+    std::ofstream file{path};
+    if (file.is_open() == false) {
+        ztd_error("headless", "Failed to open {}", path);
+        return;
+    }
+    file << "{\n";
+    file << fmt::format("    \"world\": \"{}\",\n", bench->world);
+    file << fmt::format("    \"seed\": {},\n", bench->seed);
+    file << fmt::format("    \"frames\": {},\n", bench->frame_count);
+    file << fmt::format("    \"dt\": {:.6f}", bench->dt);
+    range_u32(i, 0, bench->value_count) {
+        file << fmt::format(",\n    \"{}\": {:.6f}", bench->values[i].name, bench->values[i].ms);
+    }
+    file << "\n}\n";
+    ztd_info("headless", "Wrote benchmark to {}", path);
+}
+
+// only reads what headless_write_bench writes, no nesting or escapes
+b32
+headless_json_find(std::string_view json, std::string_view key, std::string_view* value) {
+    const std::string quoted = fmt::format("\"{}\"", key);
+    auto at = json.find(quoted);
+    if (at == std::string_view::npos || (at = json.find(':', at + quoted.size())) == std::string_view::npos) {
+        return 0;
+    }
+    auto begin = json.find_first_not_of(" \t\r\n\"", at + 1);
+    auto end = json.find_first_of(",}\r\n\"", begin);
+    if (begin == std::string_view::npos || end == std::string_view::npos) {
+        return 0;
+    }
+    *value = json.substr(begin, end - begin);
+    return 1;
+}
+
+f64
+headless_json_number(std::string_view json, std::string_view key, f64 fallback) {
+    std::string_view value;
+    return headless_json_find(json, key, &value) ? std::strtod(std::string{value}.c_str(), nullptr) : fallback;
+}
+
+// returns how many values got slower than the tolerance allows, tiny phases are mostly noise
+// so they also have to lose more than the floor before they count
+u32
+headless_compare_bench(const headless_bench_t* bench, const char* baseline_path, f64 tolerance_percent) {
+    std::ifstream file{baseline_path};
+    if (file.is_open() == false) {
+        ztd_error("headless", "Failed to open baseline {}", baseline_path);
+        return 1;
+    }
+    const std::string json{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    std::string_view baseline_world{};
+    headless_json_find(json, "world", &baseline_world);
+    const u64 baseline_seed = (u64)headless_json_number(json, "seed", 0.0);
+    const u64 baseline_frames = (u64)headless_json_number(json, "frames", 0.0);
+    if (baseline_world != bench->world || baseline_seed != bench->seed || baseline_frames != bench->frame_count) {
+        ztd_error("headless", "Baseline {} is {} seed {} for {} frames, this run is {} seed {} for {} frames",
+            baseline_path, baseline_world, baseline_seed, baseline_frames, bench->world, bench->seed, bench->frame_count);
+        return 1;
+    }
+
+    constexpr f64 noise_floor_ms = 0.02;
+    u32 regressions = 0;
+    fmt::print("\n{:<24} {:>12} {:>12} {:>10}\n", baseline_path, "baseline ms", "ms", "change");
+    range_u32(i, 0, bench->value_count) {
+        const auto& value = bench->values[i];
+        const f64 baseline = headless_json_number(json, value.name, -1.0);
+        if (baseline < 0.0) {
+            fmt::print("{:<24} {:>12} {:>12.4f}\n", value.name, "-", value.ms);
+            continue;
+        }
+        const f64 change = baseline > 0.0 ? (value.ms - baseline) / baseline * 100.0 : 0.0;
+        const b32 regressed = change > tolerance_percent && value.ms - baseline > noise_floor_ms;
+        regressions += regressed;
+        fmt::print("{:<24} {:>12.4f} {:>12.4f} {:>9.1f}%{}\n", value.name, baseline, value.ms, change, regressed ? "  REGRESSED" : "");
+    }
+    return regressions;
+}
+
+#if ZTD_INTERNAL
+
+struct headless_block_stats_t {
+    u64 total_nanoseconds{0};
+    u64 worst_frame_nanoseconds{0};
+    u64 hit_count{0};
+    u64 run_nanoseconds{0}; // warmup included, world generation happens there
+};
+
+// one per module, game and physics each record into their own table
+struct headless_table_t {
+    const char*     name{0};
+    debug_table_t*  table{0};
+    size_t          record_count{0};
+
+    u16                     last_hist_id[MAX_DEBUG_RECORD_COUNT]{};
+    headless_block_stats_t  stats[MAX_DEBUG_RECORD_COUNT]{};
+};
+
+// init time isnt a frame
+void
+headless_prime_table(headless_table_t* table) {
+    if (table->table == nullptr) {
+        return;
+    }
+    range_u64(r, 0, std::min(table->record_count, (size_t)MAX_DEBUG_RECORD_COUNT)) {
+        table->last_hist_id[r] = table->table->records[r].hist_id.load(std::memory_order_relaxed);
+    }
+}
+
+// sums what every block cost since the last sample out of the records history rings,
+// a block hit more than the history holds in one frame only counts its latest hits
+void
+headless_sample_table(headless_table_t* table, u64 frame, b32 measured, std::ofstream* csv) {
+    if (table->table == nullptr) {
+        return;
+    }
+    range_u64(r, 0, std::min(table->record_count, (size_t)MAX_DEBUG_RECORD_COUNT)) {
+        auto& record = table->table->records[r];
+        const u16 hist_id = record.hist_id.load(std::memory_order_relaxed);
+        const u16 hits = u16(hist_id - table->last_hist_id[r]);
+        table->last_hist_id[r] = hist_id;
+        if (hits == 0) {
+            continue;
+        }
+
+        constexpr u64 history_size = array_count(record.history);
+        const u64 counted = std::min((u64)hits, history_size);
+        u64 nanoseconds = 0;
+        range_u64(h, 0, counted) {
+            nanoseconds += record.history[(u64(hist_id) + 65536 - 1 - h) % history_size];
+        }
+
+        auto& stats = table->stats[r];
+        stats.run_nanoseconds += nanoseconds;
+        if (measured == 0) {
+            continue;
+        }
+        stats.total_nanoseconds += nanoseconds;
+        stats.worst_frame_nanoseconds = std::max(stats.worst_frame_nanoseconds, nanoseconds);
+        stats.hit_count += hits;
+
+        if (csv) {
+            *csv << fmt::format("{},{},{},{},{},{},{:.4f}\n",
+                frame, table->name, record.func_name, utl::trim_filename(record.file_name, '/'), record.line_num, hits, f64(nanoseconds) / 1e6);
+        }
+    }
+}
+
+void
+headless_report_table(headless_table_t* table, u64 frame_count) {
+    if (table->table == nullptr || frame_count == 0) {
+        return;
+    }
+
+    u32 order[MAX_DEBUG_RECORD_COUNT];
+    u32 count = 0;
+    range_u32(r, 0, (u32)std::min(table->record_count, (size_t)MAX_DEBUG_RECORD_COUNT)) {
+        if (table->stats[r].hit_count) {
+            order[count++] = r;
+        }
+    }
+    std::sort(order, order + count, [&](u32 a, u32 b) {
+        return table->stats[a].total_nanoseconds > table->stats[b].total_nanoseconds;
+    });
+
+    fmt::print("\n{:<40} {:>12} {:>12} {:>12}  {}\n", table->name, "hits/frame", "avg ms", "worst ms", "location");
+    range_u32(i, 0, count) {
+        const auto& record = table->table->records[order[i]];
+        const auto& stats = table->stats[order[i]];
+        fmt::print("{:<40} {:>12.2f} {:>12.4f} {:>12.4f}  {}:{}\n",
+            record.func_name,
+            f64(stats.hit_count) / f64(frame_count),
+            f64(stats.total_nanoseconds) / f64(frame_count) / 1e6,
+            f64(stats.worst_frame_nanoseconds) / 1e6,
+            utl::trim_filename(record.file_name, '/'), record.line_num
+        );
+    }
+}
+
+// Note(Zack): The phases are named TIMED_BLOCKs in the game module. Spawning mostly happens while the
+// world generates during warmup so it is the total for the run, the rest are per measured frame.
+// Blocks that share a name are summed, so phases timed inside jobs (particle, render_list) are the
+// cpu time across every job thread rather than wall time.
+struct headless_phase_t {
+    const char* name;
+    const char* block;
+    b32         whole_run;
+};
+
+global_variable headless_phase_t gs_bench_phases[] = {
+    { "spawn",          "WorldSpawn",           1 },
+    { "brain",          "GameplayUpdateBrains", 0 },
+    { "physics",        "PhysicsStep",          0 },
+    { "physics_sync",   "GamePhysicsSync",      0 },
+    { "particle",       "GameUpdateParticles",  0 },
+    { "render_list",    "GameBuildRenderList",  0 },
+};
+
+f64
+headless_phase_ms(const headless_table_t* table, const headless_phase_t& phase, u64 frame_count) {
+    if (table->table == nullptr || frame_count == 0) {
+        return 0.0;
+    }
+    u64 nanoseconds = 0;
+    range_u64(r, 0, std::min(table->record_count, (size_t)MAX_DEBUG_RECORD_COUNT)) {
+        const auto& record = table->table->records[r];
+        if (record.func_name && std::string_view{record.func_name} == phase.block) {
+            nanoseconds += phase.whole_run ? table->stats[r].run_nanoseconds : table->stats[r].total_nanoseconds;
+        }
+    }
+    return phase.whole_run ? f64(nanoseconds) / 1e6 : f64(nanoseconds) / f64(frame_count) / 1e6;
+}
+
+#endif
+
+int
+main(int argc, char* argv[]) {
+    ztd_info("headless", "Loading Platform Layer");
+    defer {
+        ztd_info("headless", "Closing Application");
+    };
+
+    u64 frame_count = 1000;
+    u64 warmup_count = 1; // the first update generates the world
+    f32 dt = 1.0f / 60.0f;
+    const char* csv_path = nullptr;
+    const char* trace_path = nullptr;
+    const char* bench_path = nullptr;
+    const char* baseline_path = nullptr;
+    f64 tolerance_percent = 10.0;
+    headless_bench_t bench{};
+
+    // everything the host doesnt know goes on to the game, it asserts on arguments it doesnt know either
+    const char** game_arguments = new const char*[argc];
+    int game_argument_count = 0;
+    game_arguments[game_argument_count++] = argv[0];
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+        const b32 has_value = i + 1 < argc;
+        if ((arg == "--frames" || arg == "-f") && has_value) {
+            frame_count = std::strtoull(argv[++i], nullptr, 10);
+        } else if ((arg == "--warmup" || arg == "-w") && has_value) {
+            warmup_count = std::strtoull(argv[++i], nullptr, 10);
+        } else if ((arg == "--dt" || arg == "-d") && has_value) {
+            dt = std::strtof(argv[++i], nullptr);
+        } else if ((arg == "--csv" || arg == "-c") && has_value) {
+            csv_path = argv[++i];
+        } else if ((arg == "--trace" || arg == "-t") && has_value) {
+            trace_path = argv[++i];
+        } else if ((arg == "--bench" || arg == "-b") && has_value) {
+            bench_path = argv[++i];
+        } else if ((arg == "--baseline" || arg == "-B") && has_value) {
+            baseline_path = argv[++i];
+        } else if (arg == "--tolerance" && has_value) {
+            tolerance_percent = std::strtod(argv[++i], nullptr);
+        } else {
+            // the game owns these but the benchmark results record them
+            if ((arg == "--world" || arg == "-W") && has_value) {
+                bench.world = argv[i + 1];
+            } else if ((arg == "--seed" || arg == "-S") && has_value) {
+                bench.seed = std::strtoull(argv[i + 1], nullptr, 10);
+            }
+            game_arguments[game_argument_count++] = argv[i];
+        }
+    }
+    defer {
+        delete [] game_arguments;
+    };
+
+    Platform.allocate = posix_alloc;
+    Platform.free = posix_free;
+    Platform.message_box = posix_message_box;
+    Platform.unload_library = posix_unload_library;
+    Platform.load_library = posix_load_library;
+    Platform.load_module = posix_load_module;
+    Platform.load_proc = posix_load_proc;
+    Platform.arguments = game_arguments;
+    Platform.argument_count = game_argument_count;
+
+    // allocation sites and arena blocks are shared with every dll through Platform
+    local_persist arena_shared_state_t arena_shared{};
+    arena_shared_state_init(&arena_shared);
+
+    game_memory_t game_memory{};
+    game_memory.platform = Platform;
+
+    game_memory.arena = arena_create(megabytes(8));
+    defer {
+        arena_clear(&game_memory.arena);
+    };
+
+    utl::config_list_t dconfig{};
+    dconfig.head = utl::load_config(&game_memory.arena, "config.ini", &dconfig.count);
+
+    auto& config = game_memory.config;
+    config.headless = 1;
+    config.window_size[0] = utl::config_get_int(&dconfig, "width", config.graphics_config.window_size.x);
+    config.window_size[1] = utl::config_get_int(&dconfig, "height", config.graphics_config.window_size.y);
+
+    void* physics_dll = Platform.load_library("./build/libztd_physics.so");
+    arena_t physics_arena = arena_create(megabytes(8));
+    defer {
+        arena_clear(&physics_arena);
+    };
+
+    if (physics_dll) {
+        ztd_info("headless", "Initializing Physics");
+        game_memory.physics = push_struct<physics::api_t>(&physics_arena);
+
+        game_memory.physics->collider_count =
+        game_memory.physics->character_count =
+        game_memory.physics->rigidbody_count = 0;
+        auto init_physics = Platform.load_function<physics::init_function>(physics_dll, "physics_init_api");
+        assert(init_physics && "Failing to load physics layer");
+        // physx isnt on the build boxes, the custom backend has no dependencies
+        const auto physics_backend = (physics::backend_type)utl::config_get_int(&dconfig, "physics_backend", (i32)physics::backend_type::CUSTOM);
+        init_physics(game_memory.physics, physics_backend, &Platform, &physics_arena);
+        *game_memory.physics->Platform = Platform;
+        ztd_info("headless", "Physics Loaded");
+    }
+
+    defer {
+        if (game_memory.physics) game_memory.physics->cleanup(game_memory.physics);
+    };
+
+    arena_t job_arena = arena_create(megabytes(2));
+    {
+        const i32 hardware_threads = (i32)std::thread::hardware_concurrency();
+        const i32 job_threads = utl::config_get_int(&dconfig, "job_threads", hardware_threads - 1);
+        game_memory.jobs = utl::job_system_create(&job_arena, (u32)std::max(job_threads, 0));
+    }
+    defer {
+        utl::job_system_destroy(game_memory.jobs);
+        arena_clear(&job_arena);
+    };
+
+    game_memory.platform = Platform;
+
+    app_dll_t app_dlls;
+    app_dlls.dll = Platform.load_library("./build/libcultist.so");
+    if (app_dlls.dll == nullptr) {
+        return 1;
+    }
+    defer {
+        Platform.unload_library(app_dlls.dll);
+    };
+    load_dll_functions(&app_dlls);
+    assert(app_dlls.on_init && app_dlls.on_update && app_dlls.on_deinit);
+
+    ztd_info("headless", "Platform Initialization Completed");
+
+    app_dlls.on_init(&game_memory);
+    if (game_memory.running == false) {
+        // the game rejected its arguments (an unknown --world), dont bench whatever it fell back to
+        ztd_error("headless", "Game stopped during init, check its arguments");
+        app_dlls.on_deinit(&game_memory);
+        return 1;
+    }
+
+#if ZTD_INTERNAL
+    auto* tables = new headless_table_t[2]{};
+    defer {
+        delete [] tables;
+    };
+    tables[0].name = "game";
+    if (auto get_table = Platform.load_function<debug_table_t*(*)()>(app_dlls.dll, "app_get_debug_table")) {
+        tables[0].table = get_table();
+        tables[0].record_count = Platform.load_function<size_t(*)()>(app_dlls.dll, "app_get_debug_table_size")();
+    }
+    tables[1].name = "physics";
+    if (game_memory.physics) {
+        tables[1].table = game_memory.physics->get_debug_table();
+        tables[1].record_count = game_memory.physics->get_debug_table_size();
+    }
+
+    std::ofstream csv_file;
+    if (csv_path) {
+        csv_file.open(csv_path);
+        csv_file << "frame,module,block,file,line,hits,ms\n";
+    }
+    std::ofstream* csv = csv_file.is_open() ? &csv_file : nullptr;
+
+    range_u64(t, 0, 2) {
+        headless_prime_table(tables + t);
+    }
+#endif
+
+    // kept out of game_memory.arena, the game owns that one
+    arena_t timing_arena = arena_create(std::max(frame_count, u64(1)) * sizeof(u64));
+    defer {
+        arena_clear(&timing_arena);
+    };
+    auto* frame_nanoseconds = push_struct<u64>(&timing_arena, std::max(frame_count, u64(1)));
+    u64 frames_run = 0;
+    f32 time = 0.0f;
+
+    range_u64(frame, 0, warmup_count + frame_count) {
+        app_input_reset(&game_memory.input); // clears time too
+        game_memory.input.dt = dt;
+        game_memory.input.time = time += dt;
+        game_memory.input.render_dt = dt;
+        game_memory.input.render_time = time;
+
+        const u64 start = get_nano_time();
+        app_dlls.on_update(&game_memory);
+        const u64 elapsed = get_nano_time() - start;
+
+        const b32 measured = frame >= warmup_count;
+        if (measured) {
+            frame_nanoseconds[frames_run++] = elapsed;
+        }
+
+#if ZTD_INTERNAL
+        range_u64(t, 0, 2) {
+            headless_sample_table(tables + t, frame, measured, csv);
+        }
+#endif
+
+        if (game_memory.running == false) {
+            ztd_warn("headless", "Game stopped itself on frame {}", frame);
+            break;
+        }
+    }
+
+    const auto frame_stats = headless_frame_stats(frame_nanoseconds, frames_run);
+    if (frames_run) {
+        fmt::print("\n{} frames at {:.4f}s dt, {} warmup\n", frames_run, dt, warmup_count);
+        fmt::print("frame ms: avg {:.4f}, p50 {:.4f}, p99 {:.4f}, worst {:.4f} ({:.1f} fps)\n",
+            frame_stats.avg_ms, frame_stats.p50_ms, frame_stats.p99_ms, frame_stats.worst_ms, frame_stats.fps
+        );
+    }
+
+    bench.frame_count = frames_run;
+    bench.dt = dt;
+    bench.add("frame_avg", frame_stats.avg_ms);
+    bench.add("frame_p99", frame_stats.p99_ms);
+
+#if ZTD_INTERNAL
+    range_u64(t, 0, 2) {
+        headless_report_table(tables + t, frames_run);
+    }
+
+    fmt::print("\n{:<24} {:>12}\n", "phase", "ms");
+    for (const auto& phase: gs_bench_phases) {
+        const f64 ms = headless_phase_ms(tables + 0, phase, frames_run);
+        fmt::print("{:<24} {:>12.4f}{}\n", phase.name, ms, phase.whole_run ? " total" : "");
+        bench.add(phase.name, ms);
+    }
+
+    if (trace_path) {
+        debug_table_t* trace_tables[] = { tables[0].table, tables[1].table };
+        const std::string_view trace_names[] = { "game", "physics" };
+        export_debug_trace(trace_tables, trace_names, trace_path);
+        ztd_info("headless", "Wrote trace to {}", trace_path);
+    }
+#endif
+
+    if ((bench_path || baseline_path) && frames_run != frame_count) {
+        ztd_error("headless", "Game stopped after {} of {} frames, not writing or comparing the benchmark", frames_run, frame_count);
+        app_dlls.on_deinit(&game_memory);
+        return 1;
+    }
+
+    if (bench_path) {
+        headless_write_bench(&bench, bench_path);
+    }
+    u32 regressions = 0;
+    if (baseline_path) {
+        regressions = headless_compare_bench(&bench, baseline_path, tolerance_percent);
+        if (regressions) {
+            ztd_error("headless", "Benchmark failed against {} ({}% tolerance)", baseline_path, tolerance_percent);
+        }
+    }
+
+    app_dlls.on_deinit(&game_memory);
+
+    ztd_info("headless", "{} platform blocks still mapped - {}{}",
+        gs_allocated_block_count.load(),
+        math::pretty_bytes(gs_allocated_bytes.load()), math::pretty_bytes_postfix(gs_allocated_bytes.load())
+    );
+
+    return regressions ? 1 : 0;
+}
+
+#endif
@@ -14,6 +14,9 @@
 
 #include "uid.hpp"
 
+#include "custom_physics.hpp"
+#include "skeleton.hpp"
+
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include "Windows.h"
@@ -206,6 +209,10 @@ int main(int argc, char** argv) {
         if (want_to_throw) throw std::exception(error.c_str());
     });
 
+    // growing arenas go through the platform
+    Platform.allocate = malloc;
+    Platform.free = free;
+
     utl::profile_t p{"Total Run Time"};
     RUN_TEST("control")
         
@@ -467,6 +474,181 @@ int main(int argc, char** argv) {
         TEST_ASSERT(math::intersect(ray, box).distance == 4.0f);
     });
 
+    RUN_TEST("custom physics")
+        using namespace physics;
+        custom_shape_t sphere{};
+        sphere.type = collider_shape_type::SPHERE;
+        sphere.radius = 1.0f;
+        custom_shape_t box{};
+        box.type = collider_shape_type::BOX;
+        box.half_size = v3f{1.0f};
+
+        const quat identity{1.0f, 0.0f, 0.0f, 0.0f};
+        custom_manifold_t m{};
+        TEST_ASSERT(custom_collide(
+            custom_world_shape(&sphere, v3f{0.0f, 1.5f, 0.0f}, identity),
+            custom_world_shape(&box, v3f{0.0f}, identity), 0.0f, &m));
+        TEST_ASSERT(glm::abs(m.depths[0] - 0.5f) < 0.01f);
+        TEST_ASSERT(glm::dot(m.normal, axis::down) > 0.99f);
+
+        // resting box face contact produces a 4 point manifold
+        TEST_ASSERT(custom_collide(
+            custom_world_shape(&box, v3f{0.0f, 1.9f, 0.0f}, identity),
+            custom_world_shape(&box, v3f{0.0f}, identity), 0.0f, &m));
+        TEST_ASSERT(m.count == 4);
+
+        const auto gjk = custom_gjk(
+            custom_world_shape(&box, v3f{3.0f, 0.0f, 0.0f}, identity),
+            custom_world_shape(&box, v3f{0.0f}, identity));
+        TEST_ASSERT(!gjk.overlap && glm::abs(gjk.distance - 1.0f) < 0.001f);
+
+        arena_t arena = arena_create(megabytes(64));
+        auto* api = push_struct<api_t>(&arena);
+        api->type = backend_type::CUSTOM;
+        api->arena = &arena;
+        api->rigidbody_set_collision_flags = custom_rigidbody_set_collision_flags;
+        tag_struct(auto* backend, custom_backend_t, &arena);
+        api->backend = custom_init_backend(backend, &arena);
+        custom_create_scene(api);
+
+        collider_box_info_t ground_info{v3f{0.0f}, v3f{10.0f, 1.0f, 10.0f}, identity};
+        auto* ground = custom_create_rigidbody(api, 0, rigidbody_type::STATIC, v3f{0.0f}, identity);
+        custom_create_collider(api, ground, collider_shape_type::BOX, &ground_info);
+
+        collider_box_info_t crate_info{v3f{0.0f}, v3f{0.5f}, identity};
+        auto* crate = custom_create_rigidbody(api, 0, rigidbody_type::DYNAMIC, v3f{0.0f, 3.0f, 0.0f}, identity);
+        custom_create_collider(api, crate, collider_shape_type::BOX, &crate_info);
+
+        range_u32(i, 0, 240) {
+            custom_simulate(api, custom_fixed_dt);
+        }
+        TEST_ASSERT(glm::abs(crate->position().y - 1.5f) < 0.05f);
+        TEST_ASSERT(glm::length(crate->velocity()) < 0.05f);
+        TEST_ASSERT(crate->is_sleeping());
+        TEST_ASSERT(get_custom(api)->dynamic_count == 0);
+
+        const auto hit = custom_raycast_world(api, v3f{0.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}, ~0u);
+        TEST_ASSERT(hit.hit && hit.user_data == crate);
+
+        custom_rigidbody_wake(crate);
+        TEST_ASSERT(!crate->is_sleeping());
+        TEST_ASSERT(get_custom(api)->dynamic_count == 1);
+
+        raycast_query_t rays[3]{
+            {v3f{0.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}},
+            {v3f{5.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}},
+            {v3f{0.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}, 0},
+        };
+        raycast_result_t ray_hits[3];
+        custom_raycast_batch(api, rays, ray_hits);
+        TEST_ASSERT(ray_hits[0].hit && ray_hits[0].user_data == crate && ray_hits[0].distance == hit.distance);
+        TEST_ASSERT(ray_hits[1].hit && ray_hits[1].user_data == ground);
+        TEST_ASSERT(!ray_hits[2].hit);
+
+        overlap_query_t overlaps[2]{};
+        overlaps[0].origin = v3f{0.0f, 1.5f, 0.0f};
+        overlaps[0].radius = 0.25f;
+        overlaps[1].type = collider_shape_type::BOX;
+        overlaps[1].origin = v3f{5.0f, 5.0f, 5.0f};
+        overlaps[1].half_size = v3f{0.5f};
+        overlap_batch_hit_t overlap_hits[8];
+        TEST_ASSERT(custom_overlap_batch(api, overlaps, overlap_hits) == 1);
+        TEST_ASSERT(overlap_hits[0].user_data == crate && overlap_hits[0].query == 0);
+
+        u32 pillar_data[2]{};
+        rigidbody_create_t pillar_bodies[2]{
+            {&pillar_data[0], rigidbody_type::STATIC, v3f{-4.0f, 0.0f, 0.0f}, identity},
+            {&pillar_data[1], rigidbody_type::STATIC, v3f{4.0f, 0.0f, 0.0f}, identity},
+        };
+        rigidbody_t* pillars[2]{};
+        const size_t body_count = api->rigidbody_count;
+        custom_create_rigidbody_batch(api, pillar_bodies, pillars);
+        TEST_ASSERT(api->rigidbody_count == body_count + 2);
+        TEST_ASSERT(pillars[0]->index == body_count && pillars[1]->index == body_count + 1);
+        TEST_ASSERT(pillars[1]->user_data == &pillar_data[1] && pillars[1]->position() == v3f(4.0f, 0.0f, 0.0f));
+
+        // a body moved after the broadphase sort is still found by the single queries
+        crate->position() = v3f{8.0f, 1.5f, 0.0f};
+        custom_set_rigidbody(api, crate);
+        const auto moved_hit = custom_raycast_world(api, v3f{8.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}, ~0u);
+        TEST_ASSERT(moved_hit.hit && moved_hit.user_data == crate);
+        const auto old_hit = custom_raycast_world(api, v3f{0.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}, ~0u);
+        TEST_ASSERT(old_hit.hit && old_hit.user_data == ground);
+        const auto* moved_overlap = custom_sphere_overlap_world(api, &arena, v3f{8.0f, 1.5f, 0.0f}, 0.25f, ~0u);
+        TEST_ASSERT(moved_overlap && moved_overlap->hit_count == 1 && moved_overlap->hits[0].user_data == crate);
+        TEST_ASSERT(!custom_sphere_overlap_world(api, &arena, v3f{-8.0f, 5.0f, 0.0f}, 0.25f, ~0u));
+
+        // mesh colliders from plain geometry, this is how the world feeds in the render mesh
+        const v3f quad_vertices[]{{-2.0f, 0.0f, -2.0f}, {2.0f, 0.0f, -2.0f}, {2.0f, 0.0f, 2.0f}, {-2.0f, 0.0f, 2.0f}};
+        const u32 quad_indices[]{0, 2, 1, 0, 3, 2};
+        collider_trimesh_info_t quad_info{};
+        quad_info.vertices = quad_vertices;
+        quad_info.vertex_count = array_count(quad_vertices);
+        quad_info.indices = quad_indices;
+        quad_info.index_count = array_count(quad_indices);
+        auto* quad = custom_create_rigidbody(api, 0, rigidbody_type::STATIC, v3f{20.0f, 2.0f, 0.0f}, identity);
+        custom_create_collider(api, quad, collider_shape_type::TRIMESH, &quad_info);
+        TEST_ASSERT(((custom_shape_t*)quad->colliders[0].shape)->type == collider_shape_type::TRIMESH);
+        const auto quad_hit = custom_raycast_world(api, v3f{20.5f, 10.0f, 0.5f}, v3f{0.0f, -20.0f, 0.0f}, ~0u);
+        TEST_ASSERT(quad_hit.hit && quad_hit.user_data == quad && glm::abs(quad_hit.distance - 8.0f) < 0.01f);
+
+        // a dense cube of points is reduced to its extreme points, the hull stays a cube
+        v3f cloud[12 * 12 * 12];
+        range_u32(i, 0, array_count(cloud)) {
+            cloud[i] = v3f{f32(i % 12), f32((i / 12) % 12), f32(i / 144)} * (2.0f / 11.0f) - 1.0f;
+        }
+        collider_convex_info_t cloud_info{};
+        cloud_info.vertices = cloud;
+        cloud_info.vertex_count = array_count(cloud);
+        auto* hull = custom_create_rigidbody(api, 0, rigidbody_type::STATIC, v3f{30.0f, 3.0f, 0.0f}, identity);
+        custom_create_collider(api, hull, collider_shape_type::CONVEX, &cloud_info);
+        const auto* hull_shape = (custom_shape_t*)hull->colliders[0].shape;
+        TEST_ASSERT(hull_shape->type == collider_shape_type::CONVEX && hull_shape->vertex_count <= custom_max_hull_vertices);
+        const auto hull_hit = custom_raycast_world(api, v3f{30.0f, 10.0f, 0.0f}, v3f{0.0f, -20.0f, 0.0f}, ~0u);
+        TEST_ASSERT(hull_hit.hit && hull_hit.user_data == hull && glm::abs(hull_hit.distance - 6.0f) < 0.01f);
+
+        arena_clear(&arena);
+    });
+
+    RUN_TEST("job system")
+        arena_t arena = arena_create(megabytes(4));
+        auto* jobs = utl::job_system_create(&arena, 3);
+
+        std::atomic<u64> sum{0};
+        utl::job_counter_t summed{};
+        utl::parallel_for(jobs, &arena, 10000, 64, [&](u64 begin, u64 end) {
+            range_u64(i, begin, end) {
+                sum.fetch_add(i, std::memory_order_relaxed);
+            }
+        }, &summed);
+
+        u64 seen = 0;
+        utl::job_counter_t after_sum{};
+        utl::job_run(jobs, &arena, [&]() {
+            seen = sum.load();
+        }, &after_sum, &summed);
+
+        utl::job_wait(jobs, &after_sum);
+        TEST_ASSERT(summed.is_done());
+        TEST_ASSERT(seen == 10000ull * 9999ull / 2);
+
+        // background jobs only ever run on a worker
+        std::atomic<u32> background_thread{0};
+        utl::job_counter_t background{};
+        TEST_ASSERT(utl::job_run_background(jobs, &arena, [&]() {
+            background_thread.store(utl::job_thread_index);
+        }, &background));
+        while (!background.is_done()) {
+            std::this_thread::yield();
+        }
+        TEST_ASSERT(background_thread.load() != 0);
+
+        utl::job_system_destroy(jobs);
+        TEST_ASSERT(utl::job_run_background(jobs, &arena, [&]() {}, &background) == 0);
+        TEST_ASSERT(background.is_done());
+        arena_clear(&arena);
+    });
+
     RUN_TEST("dynarray")
         utl::dynarray_t<std::string> array;
 
@@ -590,7 +772,7 @@ int main(int argc, char** argv) {
         data[1].id = 2;
         data[2].id = 3;
 
-        data[0].parent =~0ui64;
+        data[0].parent =~0ull;
         data[1].parent = 1;
         data[2].parent = 2;
 
@@ -611,7 +793,7 @@ int main(int argc, char** argv) {
         TEST_ASSERT(loaded_scene.entities[1].id == 2);
         TEST_ASSERT(loaded_scene.entities[2].id == 3);
 
-        TEST_ASSERT(loaded_scene.entities[0].parent == ~0ui64);
+        TEST_ASSERT(loaded_scene.entities[0].parent == ~0ull);
         TEST_ASSERT(loaded_scene.entities[1].parent == 1);
         TEST_ASSERT(loaded_scene.entities[2].parent == 2);
         
@@ -628,11 +810,66 @@ int main(int argc, char** argv) {
         };
 
         utl::res::pack_file_t* file = utl::res::load_pack_file(
-            &arena, &arena, "./res/res.pack"
+            &arena, "./res/res.pack"
         );
 
         TEST_ASSERT(file != nullptr);
         TEST_ASSERT(file->file_count > 0);
+
+        TEST_ASSERT(utl::res::save_pack_file_v3(file, "./res/test.v3.pack"));
+        utl::res::pack_file_t* mapped = utl::res::load_pack_file(
+            &arena, "./res/test.v3.pack"
+        );
+        defer {
+            utl::res::unload_pack_file(mapped);
+            std::remove("./res/test.v3.pack");
+        };
+
+        TEST_ASSERT(mapped != nullptr);
+        TEST_ASSERT(mapped->vers == utl::res::magic::pack_vers_3);
+        TEST_ASSERT(mapped->file_count == file->file_count);
+        range_u64(i, 0, file->file_count) {
+            TEST_ASSERT(utl::res::pack_file_find_file(file, file->table[i].name.sv()) == i);
+
+            // v3 tables are stored in name id order
+            const auto m = utl::res::pack_file_find_file(mapped, file->table[i].name.sv());
+            TEST_ASSERT(m != utl::res::pack_file_t::invalid);
+            TEST_ASSERT(mapped->table[m].name.sv() == file->table[i].name.sv());
+            TEST_ASSERT(mapped->resources[m].size == file->resources[i].size);
+            TEST_ASSERT(((umm)mapped->resources[m].data % utl::res::pack_v3_alignment) == 0);
+            TEST_ASSERT(std::memcmp(mapped->resources[m].data, file->resources[i].data, file->resources[i].size) == 0);
+        }
+        TEST_ASSERT(utl::res::pack_file_find_file(mapped, "not a real file") == utl::res::pack_file_t::invalid);
+    });
+
+    RUN_TEST("pack file v3 validation")
+        using namespace utl::res;
+        alignas(pack_v3_alignment) std::byte bytes[sizeof(pack_v3_header_t) + sizeof(pack_v3_entry_t) + pack_v3_alignment]{};
+        auto* header = new (bytes) pack_v3_header_t{};
+        auto* entry = new (bytes + sizeof(pack_v3_header_t)) pack_v3_entry_t{};
+        header->file_count = 1;
+        header->table_offset = sizeof(pack_v3_header_t);
+        entry->name_offset = sizeof(pack_v3_header_t) + sizeof(pack_v3_entry_t);
+        entry->name_size = 4;
+        entry->offset = sizeof(pack_v3_header_t) + sizeof(pack_v3_entry_t);
+        entry->size = pack_v3_alignment;
+
+        mapped_file_t mapped{};
+        mapped.data = bytes;
+        mapped.size = sizeof(bytes);
+        TEST_ASSERT(pack_v3_validate(mapped));
+
+        // truncated file
+        mapped.size = sizeof(bytes) - 1;
+        TEST_ASSERT(!pack_v3_validate(mapped));
+        mapped.size = sizeof(bytes);
+
+        entry->name_offset = ~0ull - 1;
+        TEST_ASSERT(!pack_v3_validate(mapped));
+        entry->name_offset = sizeof(pack_v3_header_t);
+
+        header->file_count = ~0ull / sizeof(pack_v3_entry_t);
+        TEST_ASSERT(!pack_v3_validate(mapped));
     });
 
     constexpr u64 test_size = 10000000;
@@ -695,6 +932,153 @@ int main(int argc, char** argv) {
         TEST_ASSERT(vec.back() == test_size-1);
     });
 
+    RUN_TEST("animation sampling")
+        using namespace gfx::anim;
+        constexpr u64 bone_count = 64;
+        constexpr u64 key_count = 512;
+        constexpr u64 character_count = 256;
+        constexpr u64 frame_count = 120;
+
+        auto* animation = new animation_t{};
+        auto* animators = new animator_t[character_count];
+        defer {
+            delete animation;
+            delete [] animators;
+        };
+
+        animation->duration = f32(key_count);
+        animation->node_count = bone_count;
+        range_u64(n, 0, bone_count) {
+            auto& bone = animation->nodes[n].bone.emplace();
+            bone.id = bone_id_t(n);
+            bone.position_count = bone.rotation_count = bone.scale_count = key_count;
+            range_u64(k, 0, key_count) {
+                bone.positions[k] = {f32(k), v3f{f32(k), f32(n), 0.0f}};
+                bone.rotations[k] = {f32(k), glm::quat{1.0f, 0.0f, 0.0f, 0.0f}};
+                bone.scales[k] = {f32(k), v3f{1.0f}};
+            }
+        }
+
+        range_u64(c, 0, character_count) {
+            animators[c].play_animation(animation);
+            animators[c].time = f32(c * 7 % key_count) + 0.5f;
+        }
+
+        {
+            utl::profile_t cursor_profile{"animation sampling - cursors"};
+            range_u64(f, 0, frame_count) {
+                range_u64(c, 0, character_count) {
+                    animators[c].update(1.0f/60.0f);
+                }
+            }
+        }
+
+        range_u64(c, 0, character_count) {
+            const f32 t = animators[c].time;
+            range_u64(n, 0, bone_count) {
+                const v3f expected = anim_pool_get_time_value(animation->nodes[n].bone->positions, key_count, t);
+                TEST_ASSERT(glm::distance(v3f{animators[c].matrices[n][3]}, expected) < 0.001f);
+                TEST_ASSERT(glm::abs(expected.x - t) < 0.001f);
+            }
+        }
+
+        {
+            utl::profile_t seek_profile{"animation sampling - seeks"};
+            f32 time = 0.5f;
+            range_u64(f, 0, frame_count) {
+                range_u64(c, 0, character_count) {
+                    time = fmod(time + 37.0f, f32(key_count-1));
+                    range_u64(n, 0, bone_count) {
+                        animation->nodes[n].bone->update(time);
+                    }
+                }
+            }
+        }
+    });
+
+    RUN_TEST("particle simulation")
+        constexpr size_t arena_size = megabytes(256);
+        arena_t arena = arena_create(new u8[arena_size], arena_size);
+        defer {
+            delete [] arena.start;
+        };
+
+        constexpr u32 system_count = 128;
+        constexpr u32 particle_count = 1024;
+        constexpr u32 frame_count = 60;
+        const m44 transform{1.0f};
+        const f32 dt = 1.0f / 60.0f;
+
+        auto* system = particle_system_create(&arena, 13);
+        system->template_particle.life_time = 1.0f;
+        system->template_particle.orientation = glm::quat{1.0f, 0.0f, 0.0f, 0.0f};
+        system->sphere.radius = 0.0f;
+        system->acceleration = v3f{0.0f};
+        system->velocity_random = math::rect3d_t{v3f{1.0f, 0.0f, 0.0f}, v3f{1.0f, 0.0f, 0.0f}};
+        system->scale_over_life_time = math::range_t{1.0f, 3.0f};
+        system->spawn_rate = 10.0f;
+
+        // spawns exactly one particle on the first update
+        particle_system_update(system, transform, dt);
+        TEST_ASSERT(system->live_count == 1);
+        range_u32(f, 1, 30) {
+            particle_system_update(system, transform, dt);
+        }
+        const auto particle = particle_system_get_particle(system, 0);
+        TEST_ASSERT(glm::abs(particle.position.x - 30.0f * dt) < 0.0001f);
+        TEST_ASSERT(glm::abs(particle.life_time - (1.0f - 30.0f * dt)) < 0.0001f);
+        TEST_ASSERT(glm::abs(particle.scale - (1.0f + 2.0f * 30.0f * dt)) < 0.0001f);
+        TEST_ASSERT(system->aabb.contains(particle.position));
+
+        range_u32(f, 0, 40) {
+            particle_system_update(system, transform, dt);
+        }
+        TEST_ASSERT(system->live_count == 0);
+
+        // staggered lifetimes, every other particle dies in the same frame
+        system->spawn_rate = 100.0f;
+        system->spawn_timer = 100.0f;
+        range_u32(i, 0, 13) {
+            auto p = system->template_particle;
+            p.life_time = (i & 1) ? 1.0f : 0.5f * dt;
+            p.position = v3f{f32(i)};
+            particle_system_set_particle(system, system->live_count++, p);
+        }
+        particle_system_update(system, transform, dt);
+        TEST_ASSERT(system->live_count == 6);
+        range_u32(i, 0, system->live_count) {
+            const auto alive = particle_system_get_particle(system, i);
+            TEST_ASSERT(u32(alive.position.y) & 1);
+            TEST_ASSERT(alive.life_time > 0.0f);
+        }
+
+        particle_system_t* systems[system_count];
+        range_u32(s, 0, system_count) {
+            systems[s] = particle_system_create(&arena, particle_count, 0, s + 1);
+            systems[s]->template_particle.life_time = 100.0f;
+            systems[s]->template_particle.orientation = glm::quat{1.0f, 0.0f, 0.0f, 0.0f};
+            systems[s]->angular_velocity_random = math::rect3d_t{v3f{-1.0f}, v3f{1.0f}};
+            systems[s]->velocity_random = math::rect3d_t{v3f{-1.0f}, v3f{1.0f}};
+            systems[s]->particle_color.set_type(gfx::color::color_variant_type::range);
+            systems[s]->particle_color.range = math::aabb_t<v4f>{v4f{0.0f}, v4f{1.0f}};
+            while (systems[s]->live_count < particle_count) {
+                particle_system_spawn(systems[s], transform);
+            }
+        }
+
+        {
+            utl::profile_t profile{"particle simulation - 128 x 1024"};
+            range_u32(f, 0, frame_count) {
+                range_u32(s, 0, system_count) {
+                    particle_system_update(systems[s], transform, dt);
+                }
+            }
+        }
+        range_u32(s, 0, system_count) {
+            TEST_ASSERT(systems[s]->live_count == particle_count);
+        }
+    });
+
     RUN_TEST("deque")
         constexpr size_t arena_size = megabytes(640);
         arena_t arena = arena_create(new u8[arena_size], arena_size);
@@ -732,6 +1116,310 @@ int main(int argc, char** argv) {
 
     });
 
+    RUN_TEST("chunked array and sid hash")
+        constexpr size_t arena_size = megabytes(16);
+        arena_t arena = arena_create(new u8[arena_size], arena_size);
+        defer {
+            delete [] arena.start;
+        };
+
+        constexpr u64 test_size = 5000;
+        auto* array = push_struct<utl::chunked_array_t<u64>>(&arena);
+        utl::sid_hash_t hash{};
+        utl::sid_hash_create(&hash, &arena, 16);
+
+        range_u64(i, 0, test_size) {
+            const auto name = fmt::format("res/models/mesh_{}.gltf", i);
+            const u64 id = array->push_back(&arena, i * 3);
+            TEST_ASSERT(id == i);
+            utl::sid_hash_add(&hash, &arena, sid(name), id);
+        }
+        const u64* first = &(*array)[0];
+
+        TEST_ASSERT(array->size() == test_size);
+        TEST_ASSERT(hash.count == test_size);
+        TEST_ASSERT(hash.capacity >= test_size);
+        range_u64(i, 0, test_size) {
+            const auto name = fmt::format("res/models/mesh_{}.gltf", i);
+            const u64 id = utl::sid_hash_find(&hash, sid(name));
+            TEST_ASSERT(id == i);
+            TEST_ASSERT((*array)[id] == i * 3);
+        }
+        TEST_ASSERT(first == &(*array)[0]);
+        TEST_ASSERT(utl::sid_hash_find(&hash, "not loaded"_sid) == utl::invalid_hash);
+
+        utl::sid_hash_add(&hash, &arena, "res/models/mesh_7.gltf"_sid, 42);
+        TEST_ASSERT(hash.count == test_size);
+        TEST_ASSERT(utl::sid_hash_find(&hash, "res/models/mesh_7.gltf"_sid) == 42);
+    });
+
+    RUN_TEST("size class allocator")
+        using allocator_t = utl::size_class_allocator_t;
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(1)) == 16);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(16)) == 16);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(17)) == 32);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(256)) == 256);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(257)) == 512);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(512)) == 512);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(513)) == 1024);
+        TEST_ASSERT(allocator_t::class_size(allocator_t::size_class(megabytes(3))) == megabytes(4));
+
+        auto* allocator = new allocator_t{};
+        allocator->arena = arena_create(kilobytes(256));
+        defer {
+            allocator->clear();
+            delete allocator;
+        };
+
+        void* a = allocator->allocate(24);
+        void* b = allocator->allocate(24);
+        TEST_ASSERT(a != b);
+        TEST_ASSERT(((umm)a & 15) == 0);
+        allocator->free(a, 24);
+        TEST_ASSERT(allocator->allocate(20) == a);
+
+        // shrinking or growing inside the class keeps the block
+        std::memset(b, 7, 24);
+        TEST_ASSERT(allocator->reallocate(b, 24, 30) == b);
+        TEST_ASSERT(allocator->reallocate(b, 30, 17) == b);
+        void* c = allocator->reallocate(b, 17, 100);
+        TEST_ASSERT(c != b);
+        TEST_ASSERT(((u8*)c)[16] == 7);
+        TEST_ASSERT(allocator->stats.in_place_reallocations == 2);
+
+        allocator->free(a, 20);
+        allocator->free(c, 100);
+        TEST_ASSERT(allocator->stats.bytes_in_use == 0);
+        TEST_ASSERT(allocator->stats.bytes_requested == 0);
+        TEST_ASSERT(allocator->stats.allocations == allocator->stats.frees);
+
+        // churn should be served from the free lists once warmed up
+        constexpr u64 churn_count = 100'000;
+        void* live[64]{};
+        u64 live_size[64]{};
+        utl::rng::random_t<utl::rng::xor64_random_t> rng;
+        range_u64(i, 0, churn_count) {
+            const u64 slot = rng.rand() % array_count(live);
+            allocator->free(live[slot], live_size[slot]);
+            live_size[slot] = 1 + rng.rand() % 2000;
+            live[slot] = allocator->allocate(live_size[slot]);
+        }
+        TEST_ASSERT(allocator->stats.bytes_reserved < megabytes(1));
+    });
+
+    RUN_TEST("arena block cache and scratch")
+        // blocks double as the arena grows and come back out of the cache after a rewind
+        arena_t arena = arena_create(kilobytes(64));
+        push_bytes(&arena, kilobytes(16));
+        TEST_ASSERT(arena.block_count == 1);
+        TEST_ASSERT(arena.size + sizeof(arena_block_footer_t) == kilobytes(64));
+
+        auto temp = begin_temporary_memory(&arena);
+        push_bytes(&arena, kilobytes(60));
+        TEST_ASSERT(arena.block_count == 2);
+        TEST_ASSERT(arena.size + sizeof(arena_block_footer_t) == kilobytes(128));
+        TEST_ASSERT(arena.high_water == kilobytes(76));
+        auto* second_block = arena.start;
+        end_temporary_memory(temp);
+        TEST_ASSERT(arena.block_count == 1);
+        TEST_ASSERT(arena.prior_used == 0);
+
+        const u64 hits = arena_get_block_cache()->stats.hits.load();
+        push_bytes(&arena, kilobytes(60));
+        TEST_ASSERT(arena.start == second_block);
+        TEST_ASSERT(arena_get_block_cache()->stats.hits.load() == hits + 1);
+        arena_clear(&arena);
+        TEST_ASSERT(arena.start == nullptr);
+        TEST_ASSERT(arena.prior_used == 0);
+
+        arena_t* scratch = arena_get_scratch();
+        TEST_ASSERT(arena_get_scratch() == scratch);
+        TEST_ASSERT(arena_get_scratch(scratch) != scratch);
+        {
+            auto memory = begin_temporary_memory(scratch);
+            push_bytes(memory.arena, megabytes(1));
+            end_temporary_memory(memory);
+        }
+        TEST_ASSERT(scratch->block_count == 1); // the first block is kept
+
+        // every worker gets its own scratch arenas
+        arena_t job_arena = arena_create(kilobytes(64));
+        auto* jobs = utl::job_system_create(&job_arena, 3);
+        std::atomic<u32> intact{0};
+        utl::job_counter_t done{};
+        utl::parallel_for(jobs, &job_arena, 64, 1, [&](u64 begin, u64) {
+            auto memory = begin_temporary_memory(arena_get_scratch());
+            auto* bytes = (u8*)push_bytes(memory.arena, kilobytes(512));
+            std::memset(bytes, (int)begin, kilobytes(512));
+            std::this_thread::yield();
+            if (bytes[0] == (u8)begin && bytes[kilobytes(512) - 1] == (u8)begin) {
+                intact.fetch_add(1);
+            }
+            end_temporary_memory(memory);
+        }, &done);
+        utl::job_wait(jobs, &done);
+        utl::job_system_destroy(jobs);
+        arena_clear(&job_arena);
+        TEST_ASSERT(intact.load() == 64);
+
+        arena_get_scratch(); // publishes this threads high water
+        arena_scratch_stats_t stats[arena_scratch_registry_t::max_threads];
+        const u32 stat_count = arena_get_scratch_stats(stats);
+        u64 main_high_water = 0;
+        range_u32(i, 0, stat_count) {
+            if (stats[i].thread_id == std::this_thread::get_id()) {
+                main_high_water = stats[i].high_water;
+            }
+        }
+        TEST_ASSERT(main_high_water >= megabytes(1));
+    });
+
+    RUN_TEST("allocation sites")
+        static_assert(sizeof(allocation_tag_t) == 32);
+        const u32 site = ZTD_ALLOCATION_SITE(v4f);
+        TEST_ASSERT(site != 0);
+        TEST_ASSERT(allocation_site_get(site).type_size == sizeof(v4f));
+        TEST_ASSERT(allocation_site_get(site).line_number == __LINE__ - 3);
+
+        // a reloaded module registers the same callsite again and gets the old index back
+        const auto& registered = allocation_site_get(site);
+        const std::string file_name = registered.file_name;
+        const std::string function_name = registered.function_name;
+        TEST_ASSERT(allocation_site_register("v4f", sizeof(v4f), file_name.c_str(), function_name.c_str(), registered.line_number) == site);
+        TEST_ASSERT(allocation_site_register("v4f", sizeof(v4f), file_name.c_str(), function_name.c_str(), registered.line_number + 1) != site);
+
+        arena_t arena = arena_create(kilobytes(64));
+        defer {
+            arena_clear(&arena);
+        };
+        constexpr u32 allocation_count = ZTD_ALLOCATION_GUARD_INTERVAL * 2 + 1;
+        range_u32(i, 0, allocation_count) {
+            auto* v = push_tagged<v4f>(&arena, site, 2, v4f{f32(i)});
+            TEST_ASSERT(v[1].x == f32(i));
+        }
+        TEST_ASSERT(allocation_site_get(site).allocations.load() == allocation_count);
+        TEST_ASSERT(allocation_site_get(site).bytes.load() == allocation_count * sizeof(v4f) * 2);
+
+        u64 tag_count = 0;
+        u64 guard_count = 0;
+        allocation_tag_t* guarded = 0;
+        node_for(auto, arena.tags, tag) {
+            tag_count += 1;
+            if (tag->guard) {
+                guard_count += 1;
+                guarded = tag;
+            }
+        }
+        TEST_ASSERT(tag_count == allocation_count);
+        TEST_ASSERT(guard_count == 3);
+        TEST_ASSERT(arena_find_overflow(&arena) == nullptr);
+
+        // rewinding drops the tags with the memory
+        auto temp = begin_temporary_memory(&arena);
+        push_tagged<v4f>(&arena, site, 1);
+        TEST_ASSERT(arena.tags != temp.last_tag);
+        end_temporary_memory(temp);
+        TEST_ASSERT(arena.tags == temp.last_tag);
+
+        // one byte past the data is already the guard
+        auto* data = (std::byte*)(guarded + 1);
+        TEST_ASSERT((std::byte*)guarded->guard == data + sizeof(v4f) * 2);
+        std::memset(data, 0xff, sizeof(v4f) * 2 + 1);
+        TEST_ASSERT(arena_find_overflow(&arena) == guarded);
+        *guarded->guard = allocation_guard_t{};
+    });
+
+    RUN_TEST("debug draw buffers")
+        f32 time = 1.0f;
+        auto* state = new debug_state_t{time};
+        auto* buffers = new debug_draw_buffer_t[debug_state_t::draw_buffer_count];
+        auto* draws = new debug_draw_t[debug_state_t::draw_capacity];
+        defer {
+            delete [] draws;
+            delete [] buffers;
+            delete state;
+        };
+        state->draw_buffers = buffers;
+        state->draws = draws;
+        state->set_frame_time();
+
+        state->diagram(v3f{1.0f}, "point", v4f{1.0f}, 0.0f);
+        state->diagram(math::ray_t{v3f{0.0f}, v3f{1.0f, 0.0f, 0.0f}}, "ray", v4f{1.0f}, 2.0f);
+        state->diagram(1.0f, "scalar", v4f{1.0f}); // nothing to draw
+        TEST_ASSERT(state->draw_count == 0);
+
+        state->collect_draws();
+        TEST_ASSERT(state->draw_count == 2);
+        TEST_ASSERT(state->draws[0].type == debug_draw_type::POINT);
+        TEST_ASSERT(state->draws[1].type == debug_draw_type::LINE);
+        TEST_ASSERT(state->draws[1].b == v3f(1.0f, 0.0f, 0.0f));
+
+        // the point only lives for the frame it was drawn in
+        time = 2.0f;
+        state->set_frame_time();
+        state->collect_draws();
+        TEST_ASSERT(state->draw_count == 1);
+        TEST_ASSERT(state->draws[0].type == debug_draw_type::LINE);
+
+        // a full buffer drops and counts instead of blocking
+        range_u64(i, 0, debug_draw_buffer_t::capacity + 10) {
+            state->diagram(v3f{0.0f}, "spam", v4f{1.0f}, 10.0f);
+        }
+        state->collect_draws();
+        TEST_ASSERT(state->draw_count == 1 + debug_draw_buffer_t::capacity);
+        TEST_ASSERT(state->draw_dropped == 10);
+
+        // other threads get their own buffer
+        std::thread other{[state] {
+            state->diagram(math::sphere_t{v3f{2.0f}, 1.0f}, "other", v4f{1.0f}, 10.0f);
+        }};
+        other.join();
+        state->collect_draws();
+        TEST_ASSERT(state->draw_count == 2 + debug_draw_buffer_t::capacity);
+        TEST_ASSERT(state->draws[state->draw_count - 1].type == debug_draw_type::SPHERE);
+        TEST_ASSERT(buffers[0].owner.load() != buffers[1].owner.load());
+
+        // camera at the origin looking down -z
+        const m44 vp = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f) * glm::lookAt(v3f{0.0f}, v3f{0.0f, 0.0f, -1.0f}, axis::up);
+        v4f planes[6];
+        debug_frustum_planes(vp, planes);
+        TEST_ASSERT(debug_sphere_visible(planes, v3f{0.0f, 0.0f, -10.0f}, 0.5f));
+        TEST_ASSERT(!debug_sphere_visible(planes, v3f{0.0f, 0.0f, 10.0f}, 0.5f));
+        TEST_ASSERT(!debug_sphere_visible(planes, v3f{50.0f, 0.0f, -10.0f}, 0.5f));
+        TEST_ASSERT(!debug_sphere_visible(planes, v3f{0.0f, 0.0f, -200.0f}, 0.5f));
+        // straddling the left plane still counts
+        TEST_ASSERT(debug_sphere_visible(planes, v3f{-10.5f, 0.0f, -10.0f}, 1.0f));
+    });
+
+    RUN_TEST("projectile pool")
+        auto* pool = new ztd::wep::projectile_pool_t{};
+        defer {
+            delete pool;
+        };
+
+        TEST_ASSERT(ztd::wep::projectile_spawn(pool, v3f{0.0f}, v3f{10.0f, 0.0f, 0.0f}, 1.0f, 5.0f, 0.0f, ~0u, 0));
+        TEST_ASSERT(ztd::wep::projectile_spawn(pool, v3f{1.0f}, v3f{0.0f, 10.0f, 0.0f}, 0.25f, 6.0f, 10.0f, ~0u, 0));
+        TEST_ASSERT(ztd::wep::projectile_spawn(pool, v3f{2.0f}, v3f{0.0f, 0.0f, 10.0f}, 1.0f, 7.0f, 0.0f, ~0u, 0));
+        TEST_ASSERT(pool->count == 3);
+        TEST_ASSERT(ztd::wep::projectile_sweep(pool, 0, 0.5f) == v3f(5.0f, 0.0f, 0.0f));
+
+        // removing swaps the last projectile down
+        ztd::wep::projectile_remove(pool, 0);
+        TEST_ASSERT(pool->count == 2);
+        TEST_ASSERT(pool->damage[0] == 7.0f);
+        TEST_ASSERT(pool->position[0] == v3f{2.0f});
+
+        ztd::wep::projectile_integrate(pool, 0.5f);
+        TEST_ASSERT(pool->count == 1); // the short lived one expired
+        TEST_ASSERT(pool->position[0] == v3f(2.0f, 2.0f, 7.0f));
+        TEST_ASSERT(pool->life_time[0] == 0.5f);
+
+        range_u32(i, 1, ztd::wep::projectile_pool_t::capacity) {
+            TEST_ASSERT(ztd::wep::projectile_spawn(pool, v3f{0.0f}, v3f{0.0f}, 1.0f, 1.0f, 0.0f, ~0u, 0));
+        }
+        TEST_ASSERT(!ztd::wep::projectile_spawn(pool, v3f{0.0f}, v3f{0.0f}, 1.0f, 1.0f, 0.0f, ~0u, 0));
+    });
+
     RUN_TEST("entity db")
         constexpr size_t arena_size = megabytes(1);
         arena_t arena = arena_create(new u8[arena_size], arena_size);
@@ -980,7 +1668,7 @@ int main(int argc, char** argv) {
 
         struct script_hash_t {
             script_hash_t*  next{nullptr};
-            u64             type{~0ui64};
+            u64             type{~0ull};
             script_id       id{uid::invalid_id};
         };
 